@@ -0,0 +1,212 @@
+/**
+ * \file demo_phone/virtual_devices/arena.h
+ *
+ * \brief Arena allocation for the virtual device manager and virtual devices.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#pragma once
+
+#include <jemu65c02/jemu65c02.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+extern "C" {
+# endif /*__cplusplus*/
+
+/**
+ * \brief The alignment of every allocation carved from an arena.
+ */
+#define VIRTUAL_DEVICE_ARENA_ALIGNMENT                                      16
+
+/**
+ * \brief Round a size up to the arena alignment.
+ */
+#define VIRTUAL_DEVICE_ARENA_ALIGN(size) \
+    (((size) + VIRTUAL_DEVICE_ARENA_ALIGNMENT - 1) \
+        & ~((size_t)VIRTUAL_DEVICE_ARENA_ALIGNMENT - 1))
+
+#if defined(VIRTUAL_DEVICE_STATIC)
+
+/**
+ * \brief In a static build, the number of device entries reserved for the
+ * manager in the static pool.
+ *
+ * Registering or attaching more devices than this with a manager in the
+ * default arena fails with JEMU_ERROR_OUT_OF_MEMORY, and leaves the manager
+ * unchanged.
+ */
+# ifndef VIRTUAL_DEVICE_STATIC_MAX_DEVICES
+#  define VIRTUAL_DEVICE_STATIC_MAX_DEVICES                                 8
+# endif
+
+/**
+ * \brief In a static build, the number of 256 byte pages reserved for the
+ * manager's dispatch table in the static pool.
+ *
+ * A manager in the default arena sizes its dispatch table for all of these
+ * pages when it is first finalized, so that devices can then be attached,
+ * detached, and finalized again without allocating.  Attaching a device that
+ * would take the board past this many pages fails with
+ * JEMU_ERROR_OUT_OF_MEMORY, and leaves the manager unchanged.
+ */
+# ifndef VIRTUAL_DEVICE_STATIC_MAX_PAGES
+#  define VIRTUAL_DEVICE_STATIC_MAX_PAGES                                   4
+# endif
+
+/**
+ * \brief In a static build, the number of bytes reserved in the static pool for
+ * virtual device instances and their buffers.
+ */
+# ifndef VIRTUAL_DEVICE_STATIC_DEVICE_POOL_SIZE
+#  define VIRTUAL_DEVICE_STATIC_DEVICE_POOL_SIZE                         1024
+# endif
+
+#endif /*defined(VIRTUAL_DEVICE_STATIC)*/
+
+/**
+ * \brief A bump allocator over a single contiguous block.
+ *
+ * An arena lets a whole emulated board (the device manager, its arrays and
+ * dispatch table, and each virtual device) be carved from one block, which is
+ * released all at once.  Freeing an allocation is a no-op unless it is the most
+ * recent allocation, and growing the most recent allocation extends it in
+ * place.
+ */
+typedef struct virtual_device_arena virtual_device_arena;
+
+struct virtual_device_arena
+{
+    uint8_t* base;
+    size_t size;
+    size_t offset;
+    size_t last;
+};
+
+#if defined(VIRTUAL_DEVICE_STATIC)
+
+/**
+ * \brief In a static build, the default arena used in place of the heap.
+ *
+ * Its block is a statically sized pool in .bss, large enough for a manager with
+ * \ref VIRTUAL_DEVICE_STATIC_MAX_DEVICES entries and
+ * \ref VIRTUAL_DEVICE_STATIC_MAX_PAGES dispatch pages, plus
+ * \ref VIRTUAL_DEVICE_STATIC_DEVICE_POOL_SIZE bytes for devices.
+ */
+extern virtual_device_arena virtual_device_static_arena;
+
+#endif /*defined(VIRTUAL_DEVICE_STATIC)*/
+
+/**
+ * \brief Initialize an arena over caller-provided storage, such as a static
+ * array.
+ *
+ * The arena does not own the storage, and must not be passed to
+ * \ref virtual_device_arena_release.
+ *
+ * \param arena             The arena to initialize.
+ * \param block             The storage to allocate from, which must be aligned
+ *                          to \ref VIRTUAL_DEVICE_ARENA_ALIGNMENT.
+ * \param size              The size of the storage in bytes.
+ */
+void virtual_device_arena_init(
+    virtual_device_arena* arena, void* block, size_t size);
+
+/**
+ * \brief Create an arena with the given capacity.
+ *
+ * The arena is carved from the default allocator: the heap, or in a static
+ * build, \ref virtual_device_static_arena.
+ *
+ * \note On success, the caller is given ownership of the arena and must release
+ * it by calling \ref virtual_device_arena_release when it is no longer needed.
+ * Every instance created in the arena must be released first.
+ *
+ * \param arena             Pointer to the arena pointer to set to the created
+ *                          arena on success.
+ * \param size              The capacity of the arena in bytes.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_arena_create(virtual_device_arena** arena, size_t size);
+
+/**
+ * \brief Release an arena and every allocation made from it.
+ *
+ * \note After this call, the arena pointer and every allocation made from it
+ * are no longer valid.
+ *
+ * \param arena             The arena to release.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_arena_release(virtual_device_arena* arena);
+
+/**
+ * \brief Discard every allocation made from an arena, so that it can be reused
+ * for the next board.
+ *
+ * \param arena             The arena to reset.
+ */
+void virtual_device_arena_reset(virtual_device_arena* arena);
+
+/**
+ * \brief Allocate memory from an arena.
+ *
+ * \param arena             The arena to allocate from.
+ * \param size              The size of the allocation in bytes.
+ *
+ * \returns the aligned allocation, or NULL if the arena is exhausted.
+ */
+void* virtual_device_arena_alloc(virtual_device_arena* arena, size_t size);
+
+/**
+ * \brief Allocate memory from the given arena, or from the default allocator
+ * if the arena is NULL.
+ *
+ * The default allocator is the heap, except in a static build, where it is
+ * \ref virtual_device_static_arena and the heap is never used.
+ *
+ * \param arena             The arena to allocate from, or NULL.
+ * \param size              The size of the allocation in bytes.
+ *
+ * \returns the allocation, or NULL on failure.
+ */
+void* virtual_device_alloc(virtual_device_arena* arena, size_t size);
+
+/**
+ * \brief Resize memory allocated by \ref virtual_device_alloc.
+ *
+ * \param arena             The arena the memory came from, or NULL.
+ * \param ptr               The allocation to resize.
+ * \param old_size          The current size of the allocation.
+ * \param new_size          The new size of the allocation.
+ *
+ * \returns the resized allocation, or NULL on failure, in which case the
+ * original allocation is untouched.
+ */
+void* virtual_device_realloc(
+    virtual_device_arena* arena, void* ptr, size_t old_size, size_t new_size);
+
+/**
+ * \brief Free memory allocated by \ref virtual_device_alloc.
+ *
+ * \param arena             The arena the memory came from, or NULL.
+ * \param ptr               The allocation to free.
+ */
+void virtual_device_free(virtual_device_arena* arena, void* ptr);
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+}
+# endif /*__cplusplus*/
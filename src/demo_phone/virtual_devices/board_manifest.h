@@ -0,0 +1,368 @@
+/**
+ * \file demo_phone/virtual_devices/board_manifest.h
+ *
+ * \brief Compile-time generation of a finalized device map from a board
+ * manifest.
+ *
+ * A board manifest is a constexpr array of device entries.  From it,
+ * \ref virtual_devices::board_manifest builds the sorted device entries,
+ * register keys, presence bitmap, and dispatch tables as constant data, laid
+ * out exactly as \ref virtual_device_manager_finalize builds them at runtime.
+ * An overlapping manifest fails the build.  The resulting map is passed to
+ * \ref virtual_device_manager_create_from_map, so bring-up spends no cycles
+ * building the map.
+ *
+ * \code
+ * constexpr std::array board_devices = {
+ *     virtual_devices::manifest_device(
+ *         VIA_REGISTER_IORB, VIA_REGISTER_IORA2, &via_read, &via_write,
+ *         &via_instance),
+ * };
+ * using board = virtual_devices::board_manifest<board_devices>;
+ *
+ * virtual_device_manager_create_from_map(&virt, NULL, &board::map);
+ * \endcode
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#pragma once
+
+#ifndef __cplusplus
+# error "board_manifest.h requires C++20."
+#endif /*__cplusplus*/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "virtual_device.h"
+
+namespace virtual_devices {
+
+/**
+ * \brief Describe a device in a board manifest.
+ *
+ * \param register_low      The lowest register number in the contiguous memory
+ *                          mapped register space for this device.
+ * \param register_high     The highest register number in the contiguous memory
+ *                          mapped register space for this device.
+ * \param read              The read function for the virtual device.
+ * \param write             The write function for the virtual device.
+ * \param context           The user context for the virtual device read/write
+ *                          callbacks, which must have static storage duration.
+ * \param block_read        The optional block read function for the device.
+ * \param block_write       The optional block write function for the device.
+ *
+ * \returns the device entry.
+ */
+constexpr virtual_device_entry manifest_device(
+    uint16_t register_low, uint16_t register_high,
+    JEMU_SYM(j65c02_read_fn) read, JEMU_SYM(j65c02_write_fn) write,
+    void* context, virtual_device_block_read_fn block_read = nullptr,
+    virtual_device_block_write_fn block_write = nullptr)
+{
+    virtual_device_entry entry = {};
+
+    entry.register_low = register_low;
+    entry.register_high = register_high;
+    entry.context = context;
+    entry.read = read;
+    entry.write = write;
+    entry.block_read = block_read;
+    entry.block_write = block_write;
+
+    return entry;
+}
+
+/**
+ * \brief Describe a memory region in a board manifest.
+ *
+ * \param register_low      The lowest address of the region.
+ * \param register_high     The highest address of the region.
+ * \param memory            The host memory backing the region, which must have
+ *                          static storage duration.
+ * \param memory_size       The size of the host memory.
+ * \param region_flags      The region flags.
+ *
+ * \returns the device entry.
+ */
+constexpr virtual_device_entry manifest_region(
+    uint16_t register_low, uint16_t register_high, uint8_t* memory,
+    std::size_t memory_size, uint32_t region_flags)
+{
+    virtual_device_entry entry = {};
+
+    entry.register_low = register_low;
+    entry.register_high = register_high;
+    entry.memory = memory;
+    entry.memory_size = memory_size;
+    entry.region_flags = region_flags;
+
+    return entry;
+}
+
+/**
+ * \brief Describe a partially decoded device in a board manifest, mirrored
+ * across a larger window.
+ *
+ * \param entry             The device entry for the first copy, whose range
+ *                          holds decode_mask + 1 registers.
+ * \param decode_mask       The address bits decoded by the device.
+ * \param mirror_count      The number of copies of the device in the window.
+ *
+ * \returns the device entry covering every copy.
+ */
+constexpr virtual_device_entry manifest_decoded(
+    virtual_device_entry entry, uint16_t decode_mask, std::size_t mirror_count)
+{
+    entry.register_high =
+        (uint16_t)(entry.register_low
+            + mirror_count * ((std::size_t)decode_mask + 1) - 1);
+    entry.decode_mask = decode_mask;
+
+    return entry;
+}
+
+/**
+ * \brief Return true if every range in the manifest is ordered, every decode
+ * mask tiles its range, every memory region covers its range or one decoded
+ * copy, and no two ranges overlap.
+ *
+ * \param devices           The manifest to check.
+ *
+ * \returns true if the manifest is valid.
+ */
+template <std::size_t N>
+constexpr bool manifest_valid(
+    const std::array<virtual_device_entry, N>& devices)
+{
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        if (devices[i].register_low > devices[i].register_high)
+        {
+            return false;
+        }
+
+        std::size_t range =
+            (std::size_t)(devices[i].register_high - devices[i].register_low)
+                + 1;
+        std::size_t copy_size = range;
+
+        /* a decode mask must be contiguous low bits, tiling the range. */
+        if (0 != devices[i].decode_mask)
+        {
+            copy_size = (std::size_t)devices[i].decode_mask + 1;
+            if (0 != (devices[i].decode_mask & copy_size)
+             || 0 != range % copy_size)
+            {
+                return false;
+            }
+        }
+
+        /* a memory region must cover its copy, or mirror across it. */
+        if (nullptr != devices[i].memory
+         && (0 == devices[i].memory_size
+          || (!(devices[i].region_flags & VIRTUAL_DEVICE_REGION_MIRRORED)
+                && devices[i].memory_size < copy_size)))
+        {
+            return false;
+        }
+
+        for (std::size_t j = i + 1; j < N; ++j)
+        {
+            if (devices[i].register_low <= devices[j].register_high
+             && devices[j].register_low <= devices[i].register_high)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * \brief Return the manifest sorted by low register.
+ *
+ * \param devices           The manifest to sort.
+ *
+ * \returns the sorted device entries.
+ */
+template <std::size_t N>
+constexpr std::array<virtual_device_entry, N> manifest_sort(
+    std::array<virtual_device_entry, N> devices)
+{
+    /* manifests are short; an insertion sort is enough. */
+    for (std::size_t i = 1; i < N; ++i)
+    {
+        virtual_device_entry tmp = devices[i];
+        std::size_t j = i;
+
+        for (; j > 0 && devices[j - 1].register_low > tmp.register_low; --j)
+        {
+            devices[j] = devices[j - 1];
+        }
+
+        devices[j] = tmp;
+    }
+
+    return devices;
+}
+
+/**
+ * \brief Return the number of dispatch byte tables needed by the manifest,
+ * including the shared empty table.
+ *
+ * \param devices           The manifest.
+ *
+ * \returns the number of byte tables.
+ */
+template <std::size_t N>
+constexpr std::size_t manifest_dispatch_tables(
+    const std::array<virtual_device_entry, N>& devices)
+{
+    bool used[VIRTUAL_DEVICE_PAGE_COUNT] = {};
+    std::size_t tables = 1;
+
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        for (std::size_t page =
+                devices[i].register_low >> VIRTUAL_DEVICE_PAGE_SHIFT;
+             page <= (devices[i].register_high >> VIRTUAL_DEVICE_PAGE_SHIFT);
+             ++page)
+        {
+            if (!used[page])
+            {
+                used[page] = true;
+                tables += 1;
+            }
+        }
+    }
+
+    return tables;
+}
+
+/**
+ * \brief The finalized device map for a board manifest, generated at compile
+ * time.
+ *
+ * \tparam Devices          A constexpr array of device entries, in any order.
+ */
+template <const auto& Devices>
+struct board_manifest
+{
+    static_assert(
+        manifest_valid(Devices),
+        "the board manifest has overlapping or invalid device entries");
+
+    static constexpr std::size_t device_entries = Devices.size();
+
+    static_assert(
+        device_entries < UINT16_MAX,
+        "the board manifest has too many devices to index");
+
+    static constexpr std::size_t dispatch_tables =
+        manifest_dispatch_tables(Devices);
+
+    /** \brief The device entries, sorted by low register. */
+    static constexpr std::array<virtual_device_entry, device_entries>
+        devices = manifest_sort(Devices);
+
+    /** \brief The packed low register keys. */
+    static constexpr std::array<uint16_t, device_entries> register_lows =
+        []() {
+            std::array<uint16_t, device_entries> keys = {};
+            for (std::size_t i = 0; i < device_entries; ++i)
+            {
+                keys[i] = devices[i].register_low;
+            }
+            return keys;
+        }();
+
+    /** \brief The packed high register keys. */
+    static constexpr std::array<uint16_t, device_entries> register_highs =
+        []() {
+            std::array<uint16_t, device_entries> keys = {};
+            for (std::size_t i = 0; i < device_entries; ++i)
+            {
+                keys[i] = devices[i].register_high;
+            }
+            return keys;
+        }();
+
+    /** \brief The page table, selecting a byte table for each page. */
+    static constexpr std::array<uint16_t, VIRTUAL_DEVICE_PAGE_COUNT>
+        dispatch_pages =
+            []() {
+                std::array<uint16_t, VIRTUAL_DEVICE_PAGE_COUNT> pages = {};
+                std::size_t table_count = 1;
+                for (std::size_t i = 0; i < device_entries; ++i)
+                {
+                    for (std::size_t page =
+                            devices[i].register_low
+                                >> VIRTUAL_DEVICE_PAGE_SHIFT;
+                         page <= (devices[i].register_high
+                                    >> VIRTUAL_DEVICE_PAGE_SHIFT);
+                         ++page)
+                    {
+                        if (0 == pages[page])
+                        {
+                            pages[page] = (uint16_t)table_count;
+                            table_count += 1;
+                        }
+                    }
+                }
+                return pages;
+            }();
+
+    /** \brief The byte tables, holding the entry index plus one. */
+    static constexpr std::array<
+        uint16_t, dispatch_tables * VIRTUAL_DEVICE_PAGE_SIZE>
+        dispatch_bytes =
+            []() {
+                std::array<
+                    uint16_t, dispatch_tables * VIRTUAL_DEVICE_PAGE_SIZE>
+                        bytes = {};
+                for (std::size_t i = 0; i < device_entries; ++i)
+                {
+                    for (uint32_t reg = devices[i].register_low;
+                         reg <= devices[i].register_high; ++reg)
+                    {
+                        std::size_t page = reg >> VIRTUAL_DEVICE_PAGE_SHIFT;
+                        std::size_t offset =
+                            reg & (VIRTUAL_DEVICE_PAGE_SIZE - 1);
+
+                        bytes[dispatch_pages[page] * VIRTUAL_DEVICE_PAGE_SIZE
+                                + offset] = (uint16_t)(i + 1);
+                    }
+                }
+                return bytes;
+            }();
+
+    /** \brief The address presence bitmap. */
+    static constexpr std::array<uint32_t, VIRTUAL_DEVICE_PRESENCE_WORDS>
+        presence =
+            []() {
+                std::array<uint32_t, VIRTUAL_DEVICE_PRESENCE_WORDS> bits = {};
+                for (std::size_t i = 0; i < device_entries; ++i)
+                {
+                    for (uint32_t addr = devices[i].register_low;
+                         addr <= devices[i].register_high; ++addr)
+                    {
+                        bits[addr >> 5] |= UINT32_C(1) << (addr & 31);
+                    }
+                }
+                return bits;
+            }();
+
+    /** \brief The finalized device map, for
+     * \ref virtual_device_manager_create_from_map. */
+    static constexpr virtual_device_map map = {
+        devices.data(), register_lows.data(), register_highs.data(),
+        device_entries, dispatch_pages.data(), dispatch_bytes.data(),
+        dispatch_tables, presence.data() };
+};
+
+} /* namespace virtual_devices */
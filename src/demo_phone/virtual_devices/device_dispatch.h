@@ -0,0 +1,238 @@
+/**
+ * \file demo_phone/virtual_devices/device_dispatch.h
+ *
+ * \brief Compile-time device dispatch for hot devices.
+ *
+ * The C device manager reaches every device through a read or write function
+ * pointer and a void* context, so no handler can be inlined.  Here, the board's
+ * hot devices are a template parameter pack of \ref device_binding types, each
+ * naming its register range and its register handlers as template arguments.
+ * Address decode becomes a chain of constant range compares, and each handler
+ * is called directly, so the compiler can inline it.  Addresses outside every
+ * binding fall back to a C device manager, through the existing callback ABI.
+ *
+ * \code
+ * using board_dispatch =
+ *     virtual_devices::device_dispatch<virtual_devices::via_binding<>>;
+ *
+ * board_dispatch dispatch(via, virt);
+ * cpu_read = &board_dispatch::emu_read_callback;
+ * cpu_context = &dispatch;
+ * \endcode
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#pragma once
+
+#ifndef __cplusplus
+# error "device_dispatch.h requires C++20."
+#endif /*__cplusplus*/
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+#include "board_manifest.h"
+#include "status.h"
+#include "via.h"
+#include "virtual_device.h"
+
+namespace virtual_devices {
+
+/**
+ * \brief Bind a device type to a register range and its register handlers.
+ *
+ * \tparam Device           The device instance type.
+ * \tparam Low              The lowest register serviced by the device.
+ * \tparam High             The highest register serviced by the device.
+ * \tparam Read             The read handler for the device.
+ * \tparam Write            The write handler for the device.
+ */
+template <
+    typename Device, uint16_t Low, uint16_t High,
+    JEMU_SYM(status) (*Read)(Device*, uint16_t, uint8_t*),
+    JEMU_SYM(status) (*Write)(Device*, uint16_t, uint8_t)>
+struct device_binding
+{
+    static_assert(Low <= High, "the register range is inverted");
+
+    using device = Device;
+    static constexpr uint16_t register_low = Low;
+    static constexpr uint16_t register_high = High;
+
+    static constexpr bool services(uint16_t addr)
+    {
+        return addr >= Low && addr <= High;
+    }
+
+    static JEMU_SYM(status) read(Device* dev, uint16_t addr, uint8_t* byte)
+    {
+        return Read(dev, addr, byte);
+    }
+
+    static JEMU_SYM(status) write(Device* dev, uint16_t addr, uint8_t byte)
+    {
+        return Write(dev, addr, byte);
+    }
+};
+
+/**
+ * \brief Bind the VIA, using its inline register handlers.
+ *
+ * \tparam Low              The first VIA register.
+ */
+template <uint16_t Low = VIA_REGISTER_IORB>
+using via_binding =
+    device_binding<
+        virtual_device_via, Low,
+        (uint16_t)(Low + VIA_REGISTER_IORA2 - VIA_REGISTER_IORB),
+        &virtual_device_via_read, &virtual_device_via_write>;
+
+/**
+ * \brief Dispatch reads and writes to a fixed set of devices, resolved at
+ * compile time.
+ *
+ * \tparam Bindings         The \ref device_binding for each hot device.
+ */
+template <typename... Bindings>
+class device_dispatch
+{
+    static_assert(
+        manifest_valid(
+            std::array<virtual_device_entry, sizeof...(Bindings)>{
+                manifest_device(
+                    Bindings::register_low, Bindings::register_high,
+                    nullptr, nullptr, nullptr)... }),
+        "the device bindings have overlapping register ranges");
+
+public:
+    /**
+     * \brief Create a dispatcher over the given device instances.
+     *
+     * \param devices       One instance for each binding, in order.
+     * \param fallback      The device manager servicing every other address,
+     *                      or nullptr.
+     */
+    explicit device_dispatch(
+        typename Bindings::device*... devices,
+        virtual_device_manager* fallback = nullptr)
+        : devices_(devices...)
+        , fallback_(fallback)
+    {
+    }
+
+    /**
+     * \brief Read a byte from the device servicing the given address.
+     *
+     * \param addr          The address for the read operation.
+     * \param byte          Pointer to receive the byte read.
+     *
+     * \returns a status code indicating success or failure.
+     *      - STATUS_SUCCESS on success.
+     *      - VIRTUAL_DEVICE_ERROR_UNMAPPED if no device services the address.
+     *      - a non-zero error code on failure.
+     */
+    JEMU_SYM(status) read(uint16_t addr, uint8_t* byte)
+    {
+        JEMU_SYM(status) retval;
+
+        if (read_bound(
+                addr, byte, retval,
+                std::index_sequence_for<Bindings...>{}))
+        {
+            return retval;
+        }
+
+        if (nullptr != fallback_)
+        {
+            return virtual_device_manager_emu_read_callback(
+                fallback_, addr, byte);
+        }
+
+        return VIRTUAL_DEVICE_ERROR_UNMAPPED;
+    }
+
+    /**
+     * \brief Write a byte to the device servicing the given address.
+     *
+     * \param addr          The address for the write operation.
+     * \param byte          The byte to write.
+     *
+     * \returns a status code indicating success or failure.
+     *      - STATUS_SUCCESS on success.
+     *      - VIRTUAL_DEVICE_ERROR_UNMAPPED if no device services the address.
+     *      - a non-zero error code on failure.
+     */
+    JEMU_SYM(status) write(uint16_t addr, uint8_t byte)
+    {
+        JEMU_SYM(status) retval;
+
+        if (write_bound(
+                addr, byte, retval,
+                std::index_sequence_for<Bindings...>{}))
+        {
+            return retval;
+        }
+
+        if (nullptr != fallback_)
+        {
+            return virtual_device_manager_emu_write_callback(
+                fallback_, addr, byte);
+        }
+
+        return VIRTUAL_DEVICE_ERROR_UNMAPPED;
+    }
+
+    /**
+     * \brief JEMU65C02 read callback, with a dispatcher as its context.
+     */
+    static JEMU_SYM(status) emu_read_callback(
+        void* dispatch, uint16_t addr, uint8_t* byte)
+    {
+        return static_cast<device_dispatch*>(dispatch)->read(addr, byte);
+    }
+
+    /**
+     * \brief JEMU65C02 write callback, with a dispatcher as its context.
+     */
+    static JEMU_SYM(status) emu_write_callback(
+        void* dispatch, uint16_t addr, uint8_t byte)
+    {
+        return static_cast<device_dispatch*>(dispatch)->write(addr, byte);
+    }
+
+private:
+    template <std::size_t... I>
+    bool read_bound(
+        uint16_t addr, uint8_t* byte, JEMU_SYM(status)& retval,
+        std::index_sequence<I...>)
+    {
+        return (
+            (Bindings::services(addr)
+                && (retval =
+                        Bindings::read(std::get<I>(devices_), addr, byte),
+                    true))
+         || ...);
+    }
+
+    template <std::size_t... I>
+    bool write_bound(
+        uint16_t addr, uint8_t byte, JEMU_SYM(status)& retval,
+        std::index_sequence<I...>)
+    {
+        return (
+            (Bindings::services(addr)
+                && (retval =
+                        Bindings::write(std::get<I>(devices_), addr, byte),
+                    true))
+         || ...);
+    }
+
+    std::tuple<typename Bindings::device*...> devices_;
+    virtual_device_manager* fallback_;
+};
+
+} /* namespace virtual_devices */
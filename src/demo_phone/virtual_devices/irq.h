@@ -0,0 +1,124 @@
+/**
+ * \file demo_phone/virtual_devices/irq.h
+ *
+ * \brief The IRQ aggregator, which ORs device interrupt sources into the
+ * 65C02's single, level-sensitive IRQ input.
+ *
+ * Each device that can interrupt takes a source number from the aggregator,
+ * and sets or clears its source whenever its own interrupt output changes.
+ * The aggregator keeps the sources as a bitmask, and only calls the host's
+ * line callback when the first source asserts or the last one releases, so
+ * devices can report their level as often as they like.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#pragma once
+
+#include <jemu65c02/jemu65c02.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "status.h"
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+extern "C" {
+# endif /*__cplusplus*/
+
+/**
+ * \brief The maximum number of interrupt sources in an aggregator.
+ */
+#define VIRTUAL_DEVICE_IRQ_SOURCES                                          32
+
+/**
+ * \brief Drive the CPU's IRQ input.
+ *
+ * \param context           The user context for the line.
+ * \param asserted          true when IRQ is pulled low.
+ */
+typedef void (*virtual_device_irq_line_fn)(void* context, bool asserted);
+
+/**
+ * \brief An IRQ aggregator.
+ *
+ * Each bit of sources is the level of one interrupt source, and asserted is
+ * the level last driven onto the line.
+ */
+typedef struct virtual_device_irq virtual_device_irq;
+
+struct virtual_device_irq
+{
+    virtual_device_irq_line_fn line;
+    void* context;
+    uint32_t sources;
+    size_t source_count;
+    bool asserted;
+};
+
+/**
+ * \brief Connect an IRQ aggregator to the CPU's IRQ input.
+ *
+ * The line is driven with the current level at once.
+ *
+ * \param irq               The aggregator.
+ * \param line              The callback driving the CPU's IRQ input, or NULL
+ *                          to disconnect it.
+ * \param context           The user context for the line.
+ */
+void virtual_device_irq_connect(
+    virtual_device_irq* irq, virtual_device_irq_line_fn line, void* context);
+
+/**
+ * \brief Add an interrupt source to an IRQ aggregator.
+ *
+ * \param irq               The aggregator.
+ * \param source            Pointer to receive the source number.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_IRQ_SOURCES if the aggregator has no room for
+ *        another source.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_irq_source_add(virtual_device_irq* irq, uint8_t* source);
+
+/**
+ * \brief Set the level of an interrupt source, driving the line if the
+ * aggregate level changes.
+ *
+ * \param irq               The aggregator.
+ * \param source            The source number.
+ * \param asserted          true if the source is requesting an interrupt.
+ */
+inline void virtual_device_irq_set(
+    virtual_device_irq* irq, uint8_t source, bool asserted)
+{
+    uint32_t mask = UINT32_C(1) << source;
+
+    if (asserted)
+    {
+        irq->sources |= mask;
+    }
+    else
+    {
+        irq->sources &= ~mask;
+    }
+
+    /* only the first source to assert or the last to release moves the line. */
+    if ((0 != irq->sources) != irq->asserted)
+    {
+        irq->asserted = (0 != irq->sources);
+        if (NULL != irq->line)
+        {
+            irq->line(irq->context, irq->asserted);
+        }
+    }
+}
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+}
+# endif /*__cplusplus*/
@@ -0,0 +1,217 @@
+/**
+ * \file demo_phone/virtual_devices/journal.h
+ *
+ * \brief Deterministic record and replay of virtual device inputs.
+ *
+ * When built with VIRTUAL_DEVICE_JOURNAL, every input that the outside world
+ * delivers to a device (keypad levels on a VIA port, bytes from the modem,
+ * host timer expirations) can be routed through an input journal.  Each device
+ * input is registered as a channel.  While recording, an input is applied to
+ * its device at once and written to the journal with the emulator's cycle
+ * count.  While replaying, live inputs are refused, and each journaled input
+ * is applied when the emulator reaches its cycle, so the same firmware image
+ * sees the same inputs at the same instructions.
+ *
+ * Nothing in a replay waits on host time.  The emulator runs flat out, and can
+ * ask for the cycle of the next input to know how far it may run.
+ *
+ * Cycles are counted from emulator reset, so a replay must start from the
+ * same reset as its recording.  The journal format starts with a header of
+ * "VDJR" and a version byte.  Each record is the varint cycle delta from the
+ * previous record, or from cycle zero, followed by the channel byte and the
+ * value byte.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "virtual_device.h"
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+extern "C" {
+# endif /*__cplusplus*/
+
+#if defined(VIRTUAL_DEVICE_JOURNAL)
+
+/**
+ * \brief The journal format version.
+ */
+#define VIRTUAL_DEVICE_JOURNAL_VERSION                                    0x01
+
+/**
+ * \brief The maximum number of input channels in a journal.
+ */
+#define VIRTUAL_DEVICE_JOURNAL_CHANNELS                                     16
+
+/**
+ * \brief The cycle returned when no journaled input is pending.
+ */
+#define VIRTUAL_DEVICE_JOURNAL_NEVER                                UINT64_MAX
+
+/**
+ * \brief An input channel, delivering inputs to one device input.
+ */
+typedef struct virtual_device_journal_channel virtual_device_journal_channel;
+
+struct virtual_device_journal_channel
+{
+    virtual_device_input_fn input;
+    void* context;
+};
+
+/**
+ * \brief An input journal, recording or replaying device inputs.
+ *
+ * While replaying, the next record is read ahead into cycle, channel, and
+ * value, and pending is set until the journal runs out.  While recording,
+ * cycle is the cycle of the last record written.
+ */
+typedef struct virtual_device_journal virtual_device_journal;
+
+struct virtual_device_journal
+{
+    FILE* stream;
+    const uint64_t* cycle_source;
+    bool replaying;
+    bool pending;
+    uint64_t cycle;
+    uint8_t channel;
+    uint8_t value;
+    size_t channel_count;
+    virtual_device_journal_channel channels[VIRTUAL_DEVICE_JOURNAL_CHANNELS];
+};
+
+/**
+ * \brief Create an input journal, recording to or replaying from the given
+ * stream.
+ *
+ * \param journal           Pointer to receive the journal.
+ * \param stream            The stream to record to or replay from, which the
+ *                          caller closes after releasing the journal.
+ * \param replay            true to replay the stream, false to record to it.
+ * \param cycle_source      The emulator's cycle counter.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_IO if the header could not be written.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_FORMAT if the stream to replay does not
+ *        start with a supported journal header.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_journal_create(
+    virtual_device_journal** journal, FILE* stream, bool replay,
+    const uint64_t* cycle_source);
+
+/**
+ * \brief Flush and release an input journal.
+ *
+ * \param journal           The journal to release.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_IO if the journal could not be written.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_journal_release(virtual_device_journal* journal);
+
+/**
+ * \brief Add an input channel to a journal.
+ *
+ * Channels are numbered in the order they are added, and a replay must add
+ * the same channels in the same order as its recording.
+ *
+ * \param journal           The journal.
+ * \param input             The device input to deliver to.
+ * \param context           The user context for the device.
+ * \param channel           Pointer to receive the channel number.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_CHANNEL if the journal has no room for
+ *        another channel.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_journal_channel_add(
+    virtual_device_journal* journal, virtual_device_input_fn input,
+    void* context, uint8_t* channel);
+
+/**
+ * \brief Deliver a live input through a journal, recording it at the current
+ * cycle.
+ *
+ * This must only be called from the emulator thread, between instructions.
+ *
+ * \param journal           The journal.
+ * \param channel           The channel to deliver to.
+ * \param value             The input value.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_REPLAYING if the journal is replaying;
+ *        the input is not delivered.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_CHANNEL if the channel is unknown.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_IO if the input could not be recorded.
+ *      - a non-zero error code from the device input on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_journal_input(
+    virtual_device_journal* journal, uint8_t channel, uint8_t value);
+
+/**
+ * \brief Deliver every journaled input that is due at the current cycle.
+ *
+ * When replaying, this must be called between instructions, at least at each
+ * cycle returned by \ref virtual_device_journal_next_cycle.  When recording,
+ * this does nothing.
+ *
+ * \param journal           The journal.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success, including at the end of the journal.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_FORMAT if the journal is truncated,
+ *        corrupt, or names a channel that was not added.
+ *      - a non-zero error code from a device input on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_journal_poll(virtual_device_journal* journal);
+
+/**
+ * \brief Return the cycle at which the next journaled input is due.
+ *
+ * \param journal           The journal.
+ *
+ * \returns the cycle of the next input, or VIRTUAL_DEVICE_JOURNAL_NEVER when
+ * recording or at the end of the journal.
+ */
+uint64_t virtual_device_journal_next_cycle(
+    const virtual_device_journal* journal);
+
+/**
+ * \brief Read the next record of a replayed journal ahead into the journal.
+ *
+ * This is used by \ref virtual_device_journal_create and
+ * \ref virtual_device_journal_poll.
+ *
+ * \param journal           The journal, which is replaying.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success, including at the end of the journal.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_FORMAT if the record is truncated.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_journal_load(virtual_device_journal* journal);
+
+#endif /*defined(VIRTUAL_DEVICE_JOURNAL)*/
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+}
+# endif /*__cplusplus*/
@@ -0,0 +1,121 @@
+/**
+ * \file demo_phone/virtual_devices/range_match.c
+ *
+ * \brief Vectorized register range match over packed register keys.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#if defined(__AVX2__) || defined(__SSE2__)
+# include <immintrin.h>
+#elif defined(__ARM_NEON)
+# include <arm_neon.h>
+#endif
+
+#include "range_match.h"
+
+/**
+ * \brief Find the first range containing the given register.
+ *
+ * The ranges are given as packed arrays of inclusive low and high registers.
+ * The ranges do not need to be sorted.  On x86, eight (SSE2) or sixteen (AVX2)
+ * ranges are tested per instruction, and on ARM with NEON, eight ranges are
+ * tested per instruction.  Other targets use a scalar loop.
+ *
+ * \param lows              The low register of each range.
+ * \param highs             The high register of each range.
+ * \param count             The number of ranges.
+ * \param reg               The register to match.
+ *
+ * \returns the index of the first range containing this register, or count if
+ * no range contains it.
+ */
+size_t range_match(
+    const uint16_t* lows, const uint16_t* highs, size_t count, uint16_t reg)
+{
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    /* SSE / AVX only compare signed words, so bias everything by 0x8000. */
+    const __m256i bias = _mm256_set1_epi16((short)0x8000);
+    const __m256i key =
+        _mm256_xor_si256(_mm256_set1_epi16((short)reg), bias);
+
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256i lo =
+            _mm256_xor_si256(
+                _mm256_loadu_si256((const __m256i*)(lows + i)), bias);
+        __m256i hi =
+            _mm256_xor_si256(
+                _mm256_loadu_si256((const __m256i*)(highs + i)), bias);
+
+        /* a lane misses if low > reg or reg > high. */
+        __m256i miss =
+            _mm256_or_si256(
+                _mm256_cmpgt_epi16(lo, key), _mm256_cmpgt_epi16(key, hi));
+        uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(miss);
+        if (mask)
+        {
+            /* each lane contributes two mask bits. */
+            return i + (size_t)(__builtin_ctz(mask) / 2);
+        }
+    }
+#endif
+
+#if defined(__SSE2__)
+    /* SSE only compares signed words, so bias everything by 0x8000. */
+    const __m128i bias128 = _mm_set1_epi16((short)0x8000);
+    const __m128i key128 = _mm_xor_si128(_mm_set1_epi16((short)reg), bias128);
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i lo =
+            _mm_xor_si128(_mm_loadu_si128((const __m128i*)(lows + i)), bias128);
+        __m128i hi =
+            _mm_xor_si128(
+                _mm_loadu_si128((const __m128i*)(highs + i)), bias128);
+
+        /* a lane misses if low > reg or reg > high. */
+        __m128i miss =
+            _mm_or_si128(
+                _mm_cmpgt_epi16(lo, key128), _mm_cmpgt_epi16(key128, hi));
+        uint32_t mask = ~(uint32_t)_mm_movemask_epi8(miss) & 0xFFFF;
+        if (mask)
+        {
+            /* each lane contributes two mask bits. */
+            return i + (size_t)(__builtin_ctz(mask) / 2);
+        }
+    }
+#elif defined(__ARM_NEON)
+    const uint16x8_t key = vdupq_n_u16(reg);
+
+    for (; i + 8 <= count; i += 8)
+    {
+        uint16x8_t hit =
+            vandq_u16(
+                vcleq_u16(vld1q_u16(lows + i), key),
+                vcgeq_u16(vld1q_u16(highs + i), key));
+
+        /* narrow each lane to a byte so the hits fit in a 64-bit word. */
+        uint64_t mask =
+            vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(hit, 4)), 0);
+        if (mask)
+        {
+            return i + (size_t)(__builtin_ctzll(mask) / 8);
+        }
+    }
+#endif
+
+    /* scalar fallback, and the tail of the vector loops. */
+    for (; i < count; ++i)
+    {
+        if (lows[i] <= reg && reg <= highs[i])
+        {
+            return i;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,48 @@
+/**
+ * \file demo_phone/virtual_devices/range_match.h
+ *
+ * \brief Vectorized register range match over packed register keys.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+extern "C" {
+# endif /*__cplusplus*/
+
+/**
+ * \brief The number of entries below which a search stops bisecting the
+ * register keys and hands the remainder to \ref range_match.
+ */
+#define RANGE_MATCH_WINDOW                                                  16
+
+/**
+ * \brief Find the first range containing the given register.
+ *
+ * The ranges are given as packed arrays of inclusive low and high registers.
+ * The ranges do not need to be sorted.  On x86, eight (SSE2) or sixteen (AVX2)
+ * ranges are tested per instruction, and on ARM with NEON, eight ranges are
+ * tested per instruction.  Other targets use a scalar loop.
+ *
+ * \param lows              The low register of each range.
+ * \param highs             The high register of each range.
+ * \param count             The number of ranges.
+ * \param reg               The register to match.
+ *
+ * \returns the index of the first range containing this register, or count if
+ * no range contains it.
+ */
+size_t range_match(
+    const uint16_t* lows, const uint16_t* highs, size_t count, uint16_t reg);
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+}
+# endif /*__cplusplus*/
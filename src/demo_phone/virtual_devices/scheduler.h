@@ -0,0 +1,243 @@
+/**
+ * \file demo_phone/virtual_devices/scheduler.h
+ *
+ * \brief A cycle-timestamped event scheduler for virtual devices.
+ *
+ * Devices with a notion of time (timers, serial lines, the ringer) post the
+ * CPU cycle of their next deadline to the board's scheduler, instead of being
+ * ticked every cycle.  The scheduler keeps the pending events in a binary
+ * min-heap keyed by deadline, and caches the earliest deadline, so the
+ * emulation loop pays one compare per step no matter how many devices are
+ * attached, and only calls into the scheduler when a deadline has passed.
+ *
+ * Each event is owned by its device, usually embedded in the device's
+ * instance, so posting and cancelling never allocate.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "arena.h"
+#include "status.h"
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+extern "C" {
+# endif /*__cplusplus*/
+
+/**
+ * \brief The deadline of a scheduler with no pending events.
+ */
+#define VIRTUAL_DEVICE_SCHEDULER_NEVER                              UINT64_MAX
+
+/**
+ * \brief The heap index of an event that is not pending.
+ */
+#define VIRTUAL_DEVICE_EVENT_IDLE                                   SIZE_MAX
+
+/**
+ * \brief Handle an event whose deadline has passed.
+ *
+ * The event is no longer pending when this is called, and may be posted again
+ * from here, for instance to make it periodic.
+ *
+ * \param context           The user context for the event.
+ * \param deadline          The cycle the event was due, which may be earlier
+ *                          than the current cycle.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+typedef JEMU_SYM(status) (*virtual_device_event_fn)(
+    void* context, uint64_t deadline);
+
+/**
+ * \brief A device event.
+ *
+ * The index is the event's position in the scheduler's heap, or
+ * \ref VIRTUAL_DEVICE_EVENT_IDLE when the event is not pending.
+ */
+typedef struct virtual_device_event virtual_device_event;
+
+struct virtual_device_event
+{
+    uint64_t deadline;
+    virtual_device_event_fn callback;
+    void* context;
+    size_t index;
+};
+
+/**
+ * \brief The event scheduler for a board.
+ *
+ * The heap array of capacity event pointers follows this structure in the same
+ * allocation.  The next_deadline is the deadline at the top of the heap, or
+ * \ref VIRTUAL_DEVICE_SCHEDULER_NEVER.
+ */
+typedef struct virtual_device_scheduler virtual_device_scheduler;
+
+struct virtual_device_scheduler
+{
+    virtual_device_arena* arena;
+    const uint64_t* cycle_source;
+    uint64_t next_deadline;
+    size_t count;
+    size_t capacity;
+    virtual_device_event** heap;
+};
+
+/**
+ * \brief Create an event scheduler.
+ *
+ * \param scheduler         Pointer to receive the scheduler.
+ * \param arena             The arena to allocate from, or NULL to use the
+ *                          default allocator.
+ * \param capacity          The most events that can be pending at once.
+ * \param cycle_source      The emulator's cycle counter.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_scheduler_create(
+    virtual_device_scheduler** scheduler, virtual_device_arena* arena,
+    size_t capacity, const uint64_t* cycle_source);
+
+/**
+ * \brief Release an event scheduler.
+ *
+ * Pending events are cancelled.
+ *
+ * \param scheduler         The scheduler to release.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_scheduler_release(virtual_device_scheduler* scheduler);
+
+/**
+ * \brief Initialize a device event, which is not pending.
+ *
+ * \param event             The event to initialize.
+ * \param callback          The handler to call when the event is due.
+ * \param context           The user context for the handler.
+ */
+void virtual_device_event_init(
+    virtual_device_event* event, virtual_device_event_fn callback,
+    void* context);
+
+/**
+ * \brief Post an event for the given cycle, moving it if it is already
+ * pending.
+ *
+ * \param scheduler         The scheduler.
+ * \param event             The event to post.
+ * \param deadline          The cycle the event is due.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_SCHEDULER_FULL if the scheduler already has
+ *        capacity events pending.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_scheduler_post(
+    virtual_device_scheduler* scheduler, virtual_device_event* event,
+    uint64_t deadline);
+
+/**
+ * \brief Cancel an event, if it is pending.
+ *
+ * \param scheduler         The scheduler.
+ * \param event             The event to cancel.
+ */
+void virtual_device_scheduler_cancel(
+    virtual_device_scheduler* scheduler, virtual_device_event* event);
+
+/**
+ * \brief Call the handler of every event due at the current cycle, in
+ * deadline order.
+ *
+ * Events posted by a handler for a cycle that has already passed are handled
+ * in the same call.
+ *
+ * \param scheduler         The scheduler.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code from a handler, which stops the run.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_scheduler_run(virtual_device_scheduler* scheduler);
+
+/**
+ * \brief Restore the heap order around an event whose deadline went down.
+ *
+ * This is used by \ref virtual_device_scheduler_post.
+ *
+ * \param scheduler         The scheduler.
+ * \param index             The heap index of the event.
+ */
+void virtual_device_scheduler_sift_up(
+    virtual_device_scheduler* scheduler, size_t index);
+
+/**
+ * \brief Restore the heap order around an event whose deadline went up.
+ *
+ * This is used by \ref virtual_device_scheduler_post,
+ * \ref virtual_device_scheduler_cancel, and
+ * \ref virtual_device_scheduler_run.
+ *
+ * \param scheduler         The scheduler.
+ * \param index             The heap index of the event.
+ */
+void virtual_device_scheduler_sift_down(
+    virtual_device_scheduler* scheduler, size_t index);
+
+/**
+ * \brief Return the current cycle.
+ *
+ * \param scheduler         The scheduler.
+ *
+ * \returns the emulator's cycle count.
+ */
+inline uint64_t virtual_device_scheduler_now(
+    const virtual_device_scheduler* scheduler)
+{
+    return *scheduler->cycle_source;
+}
+
+/**
+ * \brief Handle any events that are due, from the emulation loop.
+ *
+ * Unless a deadline has passed, this is a single compare.
+ *
+ * \param scheduler         The scheduler.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code from a handler.
+ */
+inline JEMU_SYM(status) virtual_device_scheduler_advance(
+    virtual_device_scheduler* scheduler)
+{
+    if (*scheduler->cycle_source < scheduler->next_deadline)
+    {
+        return STATUS_SUCCESS;
+    }
+
+    return virtual_device_scheduler_run(scheduler);
+}
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+}
+# endif /*__cplusplus*/
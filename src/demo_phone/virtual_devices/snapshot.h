@@ -0,0 +1,272 @@
+/**
+ * \file demo_phone/virtual_devices/snapshot.h
+ *
+ * \brief Save-state snapshots of the virtual devices and memory of a board.
+ *
+ * When built with VIRTUAL_DEVICE_SNAPSHOT, a snapshot captures every writable
+ * memory region, the state block of every device entry that declares one, and
+ * the shape of the device map, so that the board can be put back exactly as
+ * it was.  A device whose state reaches outside its state block, such as a
+ * pending scheduler event or an asserted IRQ, sets a restore handler on its
+ * entry, which the manager calls after restoring.  Read-only and
+ * write-protected regions never change, and are not saved.  The emulator's own
+ * CPU state is saved by the emulator.
+ *
+ * Writes to tracked memory regions mark their pages dirty.  Restoring the
+ * snapshot that the manager was last saved to or restored from only copies the
+ * pages written since, so a scenario that touches a little RAM restores in a
+ * few page copies.  Restoring any other snapshot copies everything.
+ *
+ * A snapshot is serialized with a header of "VDSS", a version byte, and the
+ * byte order marker, then the entry count, a description of each entry, and
+ * each entry's memory and state bytes.  The header, count, and descriptions
+ * are little endian.  State blocks are copied from the devices as they are laid
+ * out in memory, so they are only meaningful to a build with the same layout
+ * on a host with the same byte order: reading refuses a snapshot written with
+ * the other byte order, and restoring refuses a state block whose size or
+ * state version differs from the entry's.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "virtual_device.h"
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+extern "C" {
+# endif /*__cplusplus*/
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+
+/**
+ * \brief The snapshot format version.
+ */
+#define VIRTUAL_DEVICE_SNAPSHOT_VERSION                                   0x02
+
+/**
+ * \brief The byte order marker, written in the host's byte order after the
+ * version.
+ */
+#define VIRTUAL_DEVICE_SNAPSHOT_BYTE_ORDER                              0x0102
+
+/**
+ * \brief The number of dirty map pages covering a region's memory.
+ */
+#define VIRTUAL_DEVICE_SNAPSHOT_PAGES(memory_size) \
+    (((memory_size) + VIRTUAL_DEVICE_PAGE_SIZE - 1) \
+        >> VIRTUAL_DEVICE_PAGE_SHIFT)
+
+/**
+ * \brief The saved state of a device entry.
+ *
+ * The register range, decoding, and region flags identify the entry when the
+ * snapshot is restored, and the state size and version identify the layout of
+ * its state.  The memory_size is the number of memory bytes saved, which is
+ * zero unless the entry is a writable memory region.
+ */
+typedef struct virtual_device_snapshot_entry virtual_device_snapshot_entry;
+
+struct virtual_device_snapshot_entry
+{
+    uint16_t register_low;
+    uint16_t register_high;
+    uint16_t decode_mask;
+    uint32_t region_flags;
+    size_t memory_size;
+    size_t state_size;
+    uint32_t state_version;
+    uint8_t* memory;
+    uint8_t* state;
+};
+
+/**
+ * \brief A snapshot of a board.
+ *
+ * The entries follow this structure in the same allocation; their memory and
+ * state bytes live in the data block.  The owner and serial identify the point
+ * that the owner's dirty maps are tracking from, if this snapshot is it.
+ */
+typedef struct virtual_device_snapshot virtual_device_snapshot;
+
+struct virtual_device_snapshot
+{
+    const virtual_device_manager* owner;
+    uint64_t serial;
+    size_t device_entries;
+    virtual_device_snapshot_entry* entries;
+    uint8_t* data;
+};
+
+/**
+ * \brief Return the number of memory bytes a snapshot saves for a device
+ * entry.
+ *
+ * \param entry             The device entry.
+ *
+ * \returns the size of the entry's memory if it is a writable memory region,
+ * or zero.
+ */
+inline size_t virtual_device_snapshot_saved_size(
+    const virtual_device_entry* entry)
+{
+    if (NULL == entry->memory
+     || (entry->region_flags
+            & (VIRTUAL_DEVICE_REGION_READ_ONLY
+                | VIRTUAL_DEVICE_REGION_WRITE_PROTECTED)))
+    {
+        return 0;
+    }
+
+    return entry->memory_size;
+}
+
+/**
+ * \brief Create an empty snapshot with room for the given number of entries.
+ *
+ * This is used by \ref virtual_device_manager_snapshot_save and
+ * \ref virtual_device_snapshot_read.
+ *
+ * \param snapshot          Pointer to receive the snapshot.
+ * \param device_entries    The number of entries.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_snapshot_create(
+    virtual_device_snapshot** snapshot, size_t device_entries);
+
+/**
+ * \brief Allocate the data block of a snapshot, and point each entry at its
+ * memory and state bytes.
+ *
+ * This is used by \ref virtual_device_manager_snapshot_save and
+ * \ref virtual_device_snapshot_read, once the entry sizes are known.
+ *
+ * \param snapshot          The snapshot.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_snapshot_layout(virtual_device_snapshot* snapshot);
+
+/**
+ * \brief Release a snapshot.
+ *
+ * \param snapshot          The snapshot to release.
+ */
+void virtual_device_snapshot_release(virtual_device_snapshot* snapshot);
+
+/**
+ * \brief Serialize a snapshot to a stream.
+ *
+ * \param snapshot          The snapshot.
+ * \param out               The stream to write to.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_SNAPSHOT_IO if the stream could not be written.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_snapshot_write(
+    const virtual_device_snapshot* snapshot, FILE* out);
+
+/**
+ * \brief Read a serialized snapshot from a stream.
+ *
+ * \param snapshot          Pointer to receive the snapshot.
+ * \param in                The stream to read from.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_SNAPSHOT_FORMAT if the stream is not a complete
+ *        snapshot of a supported version, written with this host's byte
+ *        order.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_snapshot_read(virtual_device_snapshot** snapshot, FILE* in);
+
+/**
+ * \brief Start tracking writes to every writable memory region in the manager.
+ *
+ * Regions that are already tracked keep their dirty maps.  The dirty maps are
+ * owned by the manager, and released with their entries.
+ *
+ * \param virt              The virtual device manager instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_snapshot_track(virtual_device_manager* virt);
+
+/**
+ * \brief Save a snapshot of the manager's memory regions and device states.
+ *
+ * Dirty tracking restarts from this snapshot.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param snapshot          Pointer to receive the snapshot.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_snapshot_save(
+    virtual_device_manager* virt, virtual_device_snapshot** snapshot);
+
+/**
+ * \brief Restore the manager's memory regions and device states from a
+ * snapshot.
+ *
+ * If the manager was last saved to or restored from this snapshot, only the
+ * pages written since are copied.  Dirty tracking restarts from this snapshot.
+ * Once every entry is restored, each entry's restore handler is called, so
+ * that devices post their scheduler events and drive their outputs again.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param snapshot          The snapshot to restore.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - VIRTUAL_DEVICE_ERROR_SNAPSHOT_MISMATCH if the snapshot does not match
+ *        the manager's device entries or the layouts of their states; nothing
+ *        is restored.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_snapshot_restore(
+    virtual_device_manager* virt, virtual_device_snapshot* snapshot);
+
+/**
+ * \brief Count the memory pages written since the last snapshot was saved or
+ * restored.
+ *
+ * \param virt              The virtual device manager instance.
+ *
+ * \returns the number of dirty pages in the manager's tracked regions.
+ */
+size_t virtual_device_manager_snapshot_dirty(
+    const virtual_device_manager* virt);
+
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+}
+# endif /*__cplusplus*/
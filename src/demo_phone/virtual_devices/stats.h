@@ -0,0 +1,222 @@
+/**
+ * \file demo_phone/virtual_devices/stats.h
+ *
+ * \brief Access counters and latency histograms for virtual devices.
+ *
+ * When built with VIRTUAL_DEVICE_STATS, each device entry can carry a stats
+ * block counting its reads and writes, in total and per register, and sampling
+ * the host time spent servicing them into log2 scaled histograms.  Without
+ * VIRTUAL_DEVICE_STATS, none of this is compiled, and dispatch is unchanged.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "virtual_device.h"
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+extern "C" {
+# endif /*__cplusplus*/
+
+#if defined(VIRTUAL_DEVICE_STATS)
+
+/**
+ * \brief The number of buckets in a latency histogram.
+ *
+ * Bucket n counts samples taking [2^n, 2^(n+1)) nanoseconds; bucket 0 also
+ * counts samples under one nanosecond, and the last bucket counts every
+ * sample beyond it.
+ */
+#define VIRTUAL_DEVICE_STATS_BUCKETS                                        32
+
+/**
+ * \brief Time one access out of this many on each device entry.
+ *
+ * Every access is counted, but reading the host clock costs more than most
+ * device callbacks, so latency is only sampled.
+ */
+#ifndef VIRTUAL_DEVICE_STATS_SAMPLE_PERIOD
+# define VIRTUAL_DEVICE_STATS_SAMPLE_PERIOD                                 16
+#endif
+
+/**
+ * \brief The access statistics for a device entry.
+ *
+ * The per-register counters are indexed by register offset, after address
+ * decoding, and follow this structure in the same allocation.
+ */
+struct virtual_device_stats
+{
+    uint64_t reads;
+    uint64_t writes;
+    uint32_t sample_countdown;
+    uint64_t read_latency[VIRTUAL_DEVICE_STATS_BUCKETS];
+    uint64_t write_latency[VIRTUAL_DEVICE_STATS_BUCKETS];
+    size_t registers;
+    uint64_t* register_reads;
+    uint64_t* register_writes;
+};
+
+/**
+ * \brief Create a stats block sized for a device entry.
+ *
+ * \param stats             Pointer to receive the stats block.
+ * \param arena             The arena to allocate from, or NULL for the heap.
+ * \param entry             The device entry to be counted.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_stats_create(
+    virtual_device_stats** stats, virtual_device_arena* arena,
+    const virtual_device_entry* entry);
+
+/**
+ * \brief Release a stats block.
+ *
+ * \param arena             The arena the stats block was allocated from.
+ * \param stats             The stats block to release.
+ */
+void virtual_device_stats_release(
+    virtual_device_arena* arena, virtual_device_stats* stats);
+
+/**
+ * \brief Clear every counter and histogram in a stats block.
+ *
+ * \param stats             The stats block to reset.
+ */
+void virtual_device_stats_reset(virtual_device_stats* stats);
+
+/**
+ * \brief Count a run of accesses to a device entry.
+ *
+ * \param entry             The device entry, which has a stats block.
+ * \param addr              The first address accessed.
+ * \param size              The number of consecutive addresses accessed.
+ * \param write             true for writes, false for reads.
+ */
+void virtual_device_stats_count(
+    const virtual_device_entry* entry, uint16_t addr, size_t size,
+    bool write);
+
+/**
+ * \brief Read the host's monotonic clock.
+ *
+ * \returns the current time in nanoseconds.
+ */
+uint64_t virtual_device_stats_clock(void);
+
+/**
+ * \brief Return the latency histogram bucket for a duration.
+ *
+ * \param nanoseconds       The duration of the access.
+ *
+ * \returns the bucket index, floor(log2(nanoseconds)), clamped to the
+ * histogram.
+ */
+inline size_t virtual_device_stats_bucket(uint64_t nanoseconds)
+{
+    size_t bucket = 0;
+
+    while (nanoseconds > 1 && bucket < VIRTUAL_DEVICE_STATS_BUCKETS - 1)
+    {
+        nanoseconds >>= 1;
+        bucket += 1;
+    }
+
+    return bucket;
+}
+
+/**
+ * \brief Read a byte from a device entry, counting the read and sampling its
+ * latency.
+ *
+ * \param entry             The device entry, which has a stats block.
+ * \param addr              The address for the read operation.
+ * \param byte              Pointer to receive the byte read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_stats_read(
+    const virtual_device_entry* entry, uint16_t addr, uint8_t* byte);
+
+/**
+ * \brief Write a byte to a device entry, counting the write and sampling its
+ * latency.
+ *
+ * \param entry             The device entry, which has a stats block.
+ * \param addr              The address for the write operation.
+ * \param byte              The byte to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_stats_write(
+    const virtual_device_entry* entry, uint16_t addr, uint8_t byte);
+
+/**
+ * \brief Start collecting access statistics for every device entry in the
+ * manager, including entries registered or attached later.
+ *
+ * Enabling statistics again is a no-op.  The stats blocks are owned by the
+ * manager, and released with their entries.
+ *
+ * \param virt              The virtual device manager instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_stats_enable(virtual_device_manager* virt);
+
+/**
+ * \brief Find the access statistics for the device servicing an address.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param addr              An address serviced by the device.
+ *
+ * \returns the device's stats block, or NULL if the address is unmapped or the
+ * device is not being counted.
+ */
+const virtual_device_stats* virtual_device_manager_stats_find(
+    virtual_device_manager* virt, uint16_t addr);
+
+/**
+ * \brief Clear the access statistics of every device entry in the manager.
+ *
+ * \param virt              The virtual device manager instance.
+ */
+void virtual_device_manager_stats_reset(virtual_device_manager* virt);
+
+/**
+ * \brief Write a report of the access statistics of every counted device
+ * entry to a stream.
+ *
+ * Each device is listed with its totals, its latency histograms, and each
+ * register that was accessed.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param out               The stream to write to.
+ */
+void virtual_device_manager_stats_dump(
+    const virtual_device_manager* virt, FILE* out);
+
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+}
+# endif /*__cplusplus*/
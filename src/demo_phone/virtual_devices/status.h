@@ -21,6 +21,123 @@ extern "C" {
  */
 #define VIRTUAL_DEVICE_ERROR_OVERLAP                                0x80001000
 
+/**
+ * \brief There are too many device entries to index in the dispatch table.
+ */
+#define VIRTUAL_DEVICE_ERROR_TOO_MANY_ENTRIES                       0x80001001
+
+/**
+ * \brief No device entry services the given address.
+ */
+#define VIRTUAL_DEVICE_ERROR_UNMAPPED                               0x80001002
+
+/**
+ * \brief The operation requires a sorted virtual device manager.
+ */
+#define VIRTUAL_DEVICE_ERROR_NOT_SORTED                             0x80001003
+
+/**
+ * \brief No device entry matches the given register range.
+ */
+#define VIRTUAL_DEVICE_ERROR_NOT_FOUND                              0x80001004
+
+/**
+ * \brief The virtual device manager was created from a read-only device map.
+ */
+#define VIRTUAL_DEVICE_ERROR_READ_ONLY                              0x80001005
+
+/**
+ * \brief The device map is missing a required table.
+ */
+#define VIRTUAL_DEVICE_ERROR_INVALID_MAP                            0x80001006
+
+/**
+ * \brief The memory region is too small for its register range.
+ */
+#define VIRTUAL_DEVICE_ERROR_INVALID_REGION                         0x80001007
+
+/**
+ * \brief The memory region is read-only.
+ */
+#define VIRTUAL_DEVICE_ERROR_REGION_READ_ONLY                       0x80001008
+
+/**
+ * \brief The address decoding for this device is invalid.
+ */
+#define VIRTUAL_DEVICE_ERROR_INVALID_DECODE                         0x80001009
+
+/**
+ * \brief The trace ring capacity is not a power of two.
+ */
+#define VIRTUAL_DEVICE_ERROR_INVALID_TRACE                          0x8000100A
+
+/**
+ * \brief The trace stream could not be written, or its drain thread could not
+ * be started.
+ */
+#define VIRTUAL_DEVICE_ERROR_TRACE_IO                               0x8000100B
+
+/**
+ * \brief The trace stream is truncated, corrupt, or an unsupported version.
+ */
+#define VIRTUAL_DEVICE_ERROR_TRACE_FORMAT                           0x8000100C
+
+/**
+ * \brief The end of the trace stream was reached.
+ */
+#define VIRTUAL_DEVICE_ERROR_TRACE_END                              0x8000100D
+
+/**
+ * \brief The input journal could not be read or written.
+ */
+#define VIRTUAL_DEVICE_ERROR_JOURNAL_IO                             0x8000100E
+
+/**
+ * \brief The input journal is corrupt, an unsupported version, or was recorded
+ * with different channels.
+ */
+#define VIRTUAL_DEVICE_ERROR_JOURNAL_FORMAT                         0x8000100F
+
+/**
+ * \brief The input channel is unknown, or there are too many channels.
+ */
+#define VIRTUAL_DEVICE_ERROR_JOURNAL_CHANNEL                        0x80001010
+
+/**
+ * \brief Live inputs are refused while the journal is replaying.
+ */
+#define VIRTUAL_DEVICE_ERROR_JOURNAL_REPLAYING                      0x80001011
+
+/**
+ * \brief The snapshot was taken of a different device map.
+ */
+#define VIRTUAL_DEVICE_ERROR_SNAPSHOT_MISMATCH                      0x80001012
+
+/**
+ * \brief The snapshot stream is truncated, corrupt, or an unsupported version.
+ */
+#define VIRTUAL_DEVICE_ERROR_SNAPSHOT_FORMAT                        0x80001013
+
+/**
+ * \brief The snapshot stream could not be written.
+ */
+#define VIRTUAL_DEVICE_ERROR_SNAPSHOT_IO                            0x80001014
+
+/**
+ * \brief The scheduler already has as many pending events as it can hold.
+ */
+#define VIRTUAL_DEVICE_ERROR_SCHEDULER_FULL                         0x80001015
+
+/**
+ * \brief The IRQ aggregator has no room for another interrupt source.
+ */
+#define VIRTUAL_DEVICE_ERROR_IRQ_SOURCES                            0x80001016
+
+/**
+ * \brief The UART's line has no room for the characters sent to it.
+ */
+#define VIRTUAL_DEVICE_ERROR_UART_LINE_FULL                         0x80001017
+
 /* C++ compatibility. */
 # ifdef   __cplusplus
 }
@@ -2,3 +2,8 @@
 #include "merge_sort.h"
 #include "via.h"
 #include "virtual_device.h"
+
+/* external definitions of the inline helpers, for callers not inlining them. */
+extern inline size_t midpoint(size_t lower, size_t upper);
+extern inline int register_range_compare(
+    uint16_t x_low, uint16_t x_high, uint16_t y_low, uint16_t y_high);
@@ -0,0 +1,223 @@
+/**
+ * \file demo_phone/virtual_devices/trace.h
+ *
+ * \brief Bus trace recording for the virtual device manager.
+ *
+ * When built with VIRTUAL_DEVICE_TRACE, a trace can be attached to a device
+ * manager.  Every access serviced by the manager is pushed onto a lock-free,
+ * single producer ring buffer, and a background thread drains the ring to a
+ * stream in a compact, delta encoded format.  Recording never blocks the
+ * emulator; if the ring is full, the event is dropped and counted, and the
+ * count is written to the trace.
+ *
+ * The trace format starts with a header of "VDTR" and a version byte.  Each
+ * record starts with a tag byte:
+ *
+ *      - 0x80 marks dropped events, followed by a varint count.
+ *      - otherwise, the tag holds the event flags below, and is followed by:
+ *          - a varint repeat count, if VIRTUAL_DEVICE_TRACE_TAG_RUN is set,
+ *          - the varint cycle delta from the previous event,
+ *          - the zigzag varint address delta, unless SAME_ADDRESS,
+ *          - the varint device id, unless SAME_DEVICE,
+ *          - the value byte, unless SAME_VALUE.
+ *
+ * A run repeats its event the given number of extra times, each with the same
+ * cycle delta, so a firmware busy-poll loop costs a few bytes in total.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "virtual_device.h"
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+extern "C" {
+# endif /*__cplusplus*/
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+/**
+ * \brief The trace format version.
+ */
+#define VIRTUAL_DEVICE_TRACE_VERSION                                      0x01
+
+/**
+ * \brief The event is a write.
+ */
+#define VIRTUAL_DEVICE_TRACE_TAG_WRITE                                    0x01
+
+/**
+ * \brief The event has the address of the previous event.
+ */
+#define VIRTUAL_DEVICE_TRACE_TAG_SAME_ADDRESS                             0x02
+
+/**
+ * \brief The event has the device id of the previous event.
+ */
+#define VIRTUAL_DEVICE_TRACE_TAG_SAME_DEVICE                              0x04
+
+/**
+ * \brief The event has the value of the previous event.
+ */
+#define VIRTUAL_DEVICE_TRACE_TAG_SAME_VALUE                               0x08
+
+/**
+ * \brief The event repeats, with the same cycle delta.
+ */
+#define VIRTUAL_DEVICE_TRACE_TAG_RUN                                      0x10
+
+/**
+ * \brief The record counts dropped events.
+ */
+#define VIRTUAL_DEVICE_TRACE_TAG_DROPPED                                  0x80
+
+/**
+ * \brief A bus event.
+ *
+ * The device id is the low register of the device entry that serviced the
+ * access.
+ */
+typedef struct virtual_device_trace_event virtual_device_trace_event;
+
+struct virtual_device_trace_event
+{
+    uint64_t cycle;
+    uint16_t address;
+    uint16_t device;
+    uint8_t value;
+    bool write;
+};
+
+/**
+ * \brief A trace reader, decoding a trace stream one event at a time.
+ */
+typedef struct virtual_device_trace_reader virtual_device_trace_reader;
+
+struct virtual_device_trace_reader
+{
+    FILE* in;
+    virtual_device_trace_event event;
+    uint64_t run_remaining;
+    uint64_t run_delta;
+    uint64_t dropped;
+};
+
+/**
+ * \brief Create a trace recorder writing to the given stream, and start its
+ * drain thread.
+ *
+ * \param trace             Pointer to receive the trace recorder.
+ * \param out               The stream to write the trace to, which the caller
+ *                          closes after releasing the recorder.
+ * \param capacity          The number of events the ring holds, which must be
+ *                          a power of two.
+ * \param cycle_source      The emulator's cycle counter, read for each event,
+ *                          or NULL to number events instead.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_INVALID_TRACE if the capacity is not a power of
+ *        two.
+ *      - VIRTUAL_DEVICE_ERROR_TRACE_IO if the header could not be written or
+ *        the drain thread could not be started.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_trace_create(
+    virtual_device_trace** trace, FILE* out, size_t capacity,
+    const uint64_t* cycle_source);
+
+/**
+ * \brief Stop the drain thread, write every remaining event, and release the
+ * trace recorder.
+ *
+ * The recorder must be detached from its device manager first.
+ *
+ * \param trace             The trace recorder to release.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_TRACE_IO if the trace could not be written.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_trace_release(virtual_device_trace* trace);
+
+/**
+ * \brief Record a bus event.
+ *
+ * This must only be called from the emulator thread.
+ *
+ * \param trace             The trace recorder.
+ * \param address           The address accessed.
+ * \param value             The value read or written.
+ * \param write             true for a write, false for a read.
+ * \param device            The id of the device servicing the access.
+ */
+void virtual_device_trace_record(
+    virtual_device_trace* trace, uint16_t address, uint8_t value, bool write,
+    uint16_t device);
+
+/**
+ * \brief Return the number of events dropped because the ring was full.
+ *
+ * \param trace             The trace recorder.
+ *
+ * \returns the number of events dropped so far.
+ */
+uint64_t virtual_device_trace_dropped(virtual_device_trace* trace);
+
+/**
+ * \brief Record every access serviced by a device manager in a trace.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param trace             The trace recorder, or NULL to stop tracing.
+ */
+void virtual_device_manager_trace_attach(
+    virtual_device_manager* virt, virtual_device_trace* trace);
+
+/**
+ * \brief Start reading a trace from a stream.
+ *
+ * \param reader            The reader to initialize.
+ * \param in                The stream to read, positioned at the header.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_TRACE_FORMAT if the header is not a supported
+ *        trace header.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_trace_reader_init(
+    virtual_device_trace_reader* reader, FILE* in);
+
+/**
+ * \brief Read the next event from a trace.
+ *
+ * Dropped event records are added to the reader's dropped count.
+ *
+ * \param reader            The trace reader.
+ * \param event             Pointer to receive the event.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_TRACE_END at the end of the trace.
+ *      - VIRTUAL_DEVICE_ERROR_TRACE_FORMAT if the trace is truncated or
+ *        corrupt.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_trace_reader_next(
+    virtual_device_trace_reader* reader, virtual_device_trace_event* event);
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+}
+# endif /*__cplusplus*/
@@ -0,0 +1,191 @@
+/**
+ * \file demo_phone/virtual_devices/trace_ring.h
+ *
+ * \brief The trace recorder's ring buffer and encoder state.
+ *
+ * This header is private to the C recording code, since it uses C11 atomics.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+# error "trace_ring.h is private to the C recording code; use trace.h."
+#endif /*__cplusplus*/
+
+#include "trace.h"
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+/**
+ * \brief The size of a cache line, separating the producer's and consumer's
+ * ring positions.
+ */
+#define VIRTUAL_DEVICE_TRACE_CACHE_LINE                                     64
+
+/**
+ * \brief The size of the encoder's output buffer.
+ */
+#define VIRTUAL_DEVICE_TRACE_BUFFER_SIZE                                  4096
+
+/**
+ * \brief The trace recorder.
+ *
+ * The emulator thread owns head, tail_cache, and sequence; the drain thread
+ * owns tail and the encoder state.  Each side only reads the other's position
+ * through the atomics.
+ */
+struct virtual_device_trace
+{
+    /* shared, read-only after creation. */
+    virtual_device_trace_event* ring;
+    size_t mask;
+    const uint64_t* cycle_source;
+    FILE* out;
+    pthread_t thread;
+    atomic_bool running;
+
+    /* producer. */
+    _Alignas(VIRTUAL_DEVICE_TRACE_CACHE_LINE) atomic_size_t head;
+    size_t tail_cache;
+    uint64_t sequence;
+    atomic_uint_least64_t dropped;
+
+    /* consumer. */
+    _Alignas(VIRTUAL_DEVICE_TRACE_CACHE_LINE) atomic_size_t tail;
+    uint64_t dropped_written;
+    uint64_t last_cycle;
+    virtual_device_trace_event written;
+    virtual_device_trace_event pending;
+    uint64_t pending_delta;
+    uint64_t pending_count;
+    bool io_error;
+    size_t buffer_size;
+    uint8_t buffer[VIRTUAL_DEVICE_TRACE_BUFFER_SIZE];
+};
+
+/**
+ * \brief Push a bus event onto the ring, or count it as dropped if the ring is
+ * full.
+ *
+ * \param trace             The trace recorder.
+ * \param address           The address accessed.
+ * \param value             The value read or written.
+ * \param write             true for a write, false for a read.
+ * \param device            The id of the device servicing the access.
+ */
+inline void virtual_device_trace_push(
+    virtual_device_trace* trace, uint16_t address, uint8_t value, bool write,
+    uint16_t device)
+{
+    size_t head = atomic_load_explicit(&trace->head, memory_order_relaxed);
+
+    /* only look at the consumer's position when the ring seems full. */
+    if (head - trace->tail_cache > trace->mask)
+    {
+        trace->tail_cache =
+            atomic_load_explicit(&trace->tail, memory_order_acquire);
+        if (head - trace->tail_cache > trace->mask)
+        {
+            atomic_fetch_add_explicit(
+                &trace->dropped, 1, memory_order_relaxed);
+            return;
+        }
+    }
+
+    virtual_device_trace_event* event = trace->ring + (head & trace->mask);
+    event->cycle =
+        NULL != trace->cycle_source ? *trace->cycle_source : trace->sequence;
+    event->address = address;
+    event->device = device;
+    event->value = value;
+    event->write = write;
+    trace->sequence += 1;
+
+    /* publish the event to the drain thread. */
+    atomic_store_explicit(&trace->head, head + 1, memory_order_release);
+}
+
+/**
+ * \brief Write the encoder's output buffer to the trace stream.
+ *
+ * \param trace             The trace recorder.
+ */
+void virtual_device_trace_write(virtual_device_trace* trace);
+
+/**
+ * \brief Append a byte to the encoder's output buffer.
+ *
+ * \param trace             The trace recorder.
+ * \param byte              The byte to append.
+ */
+inline void virtual_device_trace_put(virtual_device_trace* trace, uint8_t byte)
+{
+    if (VIRTUAL_DEVICE_TRACE_BUFFER_SIZE == trace->buffer_size)
+    {
+        virtual_device_trace_write(trace);
+    }
+
+    trace->buffer[trace->buffer_size++] = byte;
+}
+
+/**
+ * \brief Append an unsigned LEB128 varint to the encoder's output buffer.
+ *
+ * \param trace             The trace recorder.
+ * \param value             The value to append.
+ */
+inline void virtual_device_trace_put_varint(
+    virtual_device_trace* trace, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        virtual_device_trace_put(trace, (uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+
+    virtual_device_trace_put(trace, (uint8_t)value);
+}
+
+/**
+ * \brief Add an event to the pending run, or emit the pending run and start a
+ * new one.
+ *
+ * \param trace             The trace recorder.
+ * \param event             The event to encode.
+ */
+void virtual_device_trace_encode(
+    virtual_device_trace* trace, const virtual_device_trace_event* event);
+
+/**
+ * \brief Emit the pending run into the encoder's output buffer.
+ *
+ * \param trace             The trace recorder.
+ */
+void virtual_device_trace_emit(virtual_device_trace* trace);
+
+/**
+ * \brief Encode every event published so far, and every dropped count, into
+ * the trace stream.
+ *
+ * This must only be called from the drain thread, or once it has stopped.
+ *
+ * \param trace             The trace recorder.
+ *
+ * \returns the number of events drained.
+ */
+size_t virtual_device_trace_drain(virtual_device_trace* trace);
+
+/**
+ * \brief Write the pending run and the output buffer to the trace stream.
+ *
+ * \param trace             The trace recorder.
+ */
+void virtual_device_trace_flush(virtual_device_trace* trace);
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
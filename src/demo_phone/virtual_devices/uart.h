@@ -0,0 +1,621 @@
+/**
+ * \file demo_phone/virtual_devices/uart.h
+ *
+ * \brief Virtual 6551 UART device for the demo phone's modem link.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "scheduler.h"
+#include "status.h"
+#include "virtual_device.h"
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+extern "C" {
+# endif /*__cplusplus*/
+
+#define UART_REGISTER_DATA          0xF610
+#define UART_REGISTER_STATUS        0xF611
+#define UART_REGISTER_COMMAND       0xF612
+#define UART_REGISTER_CONTROL       0xF613
+
+#define UART_REGISTER_COUNT              4
+
+#define UART_STATUS_PARITY            0x01
+#define UART_STATUS_FRAMING           0x02
+#define UART_STATUS_OVERRUN           0x04
+#define UART_STATUS_RDRF              0x08
+#define UART_STATUS_TDRE              0x10
+#define UART_STATUS_DCD               0x20
+#define UART_STATUS_DSR               0x40
+#define UART_STATUS_IRQ               0x80
+
+#define UART_COMMAND_DTR              0x01
+#define UART_COMMAND_RX_IRQ_OFF       0x02
+#define UART_COMMAND_TIC              0x0C
+#define UART_COMMAND_TX_IRQ           0x04
+#define UART_COMMAND_ECHO             0x10
+#define UART_COMMAND_PARITY           0x20
+
+/**
+ * \brief The command bits cleared by a programmed reset.
+ */
+#define UART_COMMAND_RESET            0x1F
+
+#define UART_CONTROL_BAUD             0x0F
+#define UART_CONTROL_BAUD_9600        0x0E
+#define UART_CONTROL_RCS              0x10
+#define UART_CONTROL_WORD             0x60
+#define UART_CONTROL_STOP             0x80
+
+/**
+ * \brief The clock rate that delivers characters without baud-rate timing.
+ */
+#define UART_INSTANT                     0
+
+/**
+ * \brief The number of received characters that can be on the line at once,
+ * sent by the peripheral but not yet arrived in the receive FIFO.
+ */
+#ifndef UART_LINE_DEPTH
+# define UART_LINE_DEPTH               256
+#endif
+
+/**
+ * \brief The shadow byte of a UART register.
+ */
+#define UART_SHADOW(uart, reg) ((uart)->shadow[(reg) - UART_REGISTER_DATA])
+
+/**
+ * \brief Take a character transmitted by the UART.
+ *
+ * \param context       The user context for the peripheral.
+ * \param byte          The character.
+ */
+typedef void (*virtual_device_uart_tx_fn)(void* context, uint8_t byte);
+
+/**
+ * \brief The UART virtual device.
+ *
+ * The receive and transmit FIFOs are rings of rx_depth and tx_depth bytes,
+ * and the line a ring of \ref UART_LINE_DEPTH bytes, allocated with the UART
+ * and following it in memory.  COMMAND and CONTROL live in the shadow array,
+ * so that the device manager can serve them without calling the UART.
+ *
+ * Everything from the shadow array to the end of the line is plain device
+ * state, which snapshots save and restore as one block; it must not hold
+ * pointers.
+ *
+ * The UART runs in one of two timing modes.  With a scheduler and a clock rate
+ * attached, characters take the time the programmed baud rate, word length,
+ * parity, and stop bits give them: a received character waits on the line,
+ * counted by line_count, until its last bit arrives, and only then takes a
+ * place in the receive FIFO, or is lost with an overrun if the FIFO is full.
+ * A transmitted character stays in the transmit FIFO until its last bit is
+ * sent.  The rx_event and tx_event are posted for rx_next and tx_next, the
+ * cycles the characters on the line finish.  Otherwise, characters are
+ * delivered instantly, so that regression runs can push modem traffic far
+ * faster than the line would carry it.
+ *
+ * The UART pulls its IRQ output low while the receiver holds a character with
+ * receive interrupts enabled, or the transmit FIFO has room with transmit
+ * interrupts enabled, and DTR is on.  Unlike the 6551, which latches IRQ until
+ * STATUS is read, the output follows those conditions.
+ */
+typedef struct virtual_device_uart virtual_device_uart;
+
+struct virtual_device_uart
+{
+    virtual_device_arena* arena;
+    virtual_device_scheduler* scheduler;
+    virtual_device_event rx_event;
+    virtual_device_event tx_event;
+    virtual_device_uart_tx_fn transmit;
+    void* transmit_context;
+    virtual_device_irq* irq;
+    uint8_t irq_source;
+    uint32_t clock_hz;
+    uint8_t* rx_fifo;
+    uint8_t* tx_fifo;
+    uint8_t* line;
+    uint8_t shadow[UART_REGISTER_COUNT];
+    uint8_t errors;
+    uint8_t rx_data;
+    uint16_t rx_depth;
+    uint16_t rx_head;
+    uint16_t rx_count;
+    uint16_t tx_depth;
+    uint16_t tx_head;
+    uint16_t tx_count;
+    uint16_t line_head;
+    uint16_t line_count;
+    uint64_t rx_next;
+    uint64_t tx_next;
+};
+
+/**
+ * \brief The shadow flags for each UART register, by register offset.
+ */
+extern const uint8_t virtual_device_uart_shadow_flags[UART_REGISTER_COUNT];
+
+/**
+ * \brief The layout version of the UART's snapshot state, everything from the
+ * shadow array to the end of the line.
+ *
+ * Bump this whenever those fields change.
+ */
+#define VIRTUAL_DEVICE_UART_STATE_VERSION                                    2
+
+/**
+ * \brief The rate of each CONTROL baud rate selection, in hundredths of a
+ * baud.
+ */
+extern const uint32_t virtual_device_uart_baud_rates[UART_CONTROL_BAUD + 1];
+
+/**
+ * \brief Create a virtual UART device for the demo phone.
+ *
+ * \param uart          Pointer to the virtual UART device instance pointer to
+ *                      be set to the created instance on success.
+ * \param rx_depth      The depth of the receive FIFO; zero is taken as one.
+ * \param tx_depth      The depth of the transmit FIFO; zero is taken as one.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_uart_create(
+    virtual_device_uart** uart, uint16_t rx_depth, uint16_t tx_depth);
+
+/**
+ * \brief Create a virtual UART device for the demo phone in the given arena.
+ *
+ * The UART comes out of reset with DTR off and receive interrupts disabled,
+ * and delivers characters instantly until a clock is attached.
+ *
+ * \param uart          Pointer to the virtual UART device instance pointer to
+ *                      be set to the created instance on success.
+ * \param arena         The arena to allocate from, or NULL to use the
+ *                      default allocator.
+ * \param rx_depth      The depth of the receive FIFO; zero is taken as one.
+ * \param tx_depth      The depth of the transmit FIFO; zero is taken as one.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_uart_create_in_arena(
+    virtual_device_uart** uart, virtual_device_arena* arena,
+    uint16_t rx_depth, uint16_t tx_depth);
+
+/**
+ * \brief Release a virtual UART device instance.
+ *
+ * \note After this call, the instance pointer is no longer valid.
+ *
+ * \param uart          The instance to release.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_uart_release(virtual_device_uart* uart);
+
+/**
+ * \brief Describe a UART as a device entry, with its shadow registers.
+ *
+ * In a VIRTUAL_DEVICE_SNAPSHOT build, the entry also declares the UART's state
+ * block, so that snapshots save and restore its registers and FIFOs, and a
+ * restore handler that resumes its character timing.
+ *
+ * \param uart          The UART instance.
+ * \param entry         The entry to initialize.
+ * \param register_low  The first UART register, which must be aligned to
+ *                      \ref UART_REGISTER_COUNT.
+ */
+void virtual_device_uart_entry_init(
+    virtual_device_uart* uart, virtual_device_entry* entry,
+    uint16_t register_low);
+
+/**
+ * \brief Read callback for the UART device.
+ *
+ * \param uart          An opaque reference to the UART instance.
+ * \param addr          The address for the read operation.
+ * \param byte          Pointer to receive the byte read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_uart_read_callback(
+    void* uart, uint16_t addr, uint8_t* byte);
+
+/**
+ * \brief Write callback for the UART device.
+ *
+ * \param uart          An opaque reference to the UART instance.
+ * \param addr          The address for the write operation.
+ * \param byte          The byte to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_uart_write_callback(
+    void* uart, uint16_t addr, uint8_t byte);
+
+/**
+ * \brief Restore callback for the UART device.
+ *
+ * Posts the UART's character events again and drives its IRQ output, to match
+ * its restored state.
+ *
+ * \param uart          An opaque reference to the UART instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_uart_restore_callback(void* uart);
+
+/**
+ * \brief Input callback for a character sent by the peripheral to the UART.
+ *
+ * This is \ref virtual_device_uart_receive for one character, in the shape of
+ * a device input, so that a journal can record and replay modem traffic.
+ *
+ * \param uart          An opaque reference to the UART instance.
+ * \param byte          The character.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_UART_LINE_FULL if the line has no room for the
+ *        character.
+ *      - a non-zero error code if a character deadline could not be posted.
+ */
+JEMU_SYM(status) virtual_device_uart_rx_input(void* uart, uint8_t byte);
+
+/**
+ * \brief Time the UART's characters from the given scheduler's cycle counter.
+ *
+ * Characters already on the line restart from the current cycle.  Attaching
+ * no scheduler, or a clock rate of \ref UART_INSTANT, switches to instant
+ * delivery, and delivers the characters on the line at once.
+ *
+ * \param uart          The UART instance.
+ * \param scheduler     The scheduler to post character deadlines to, or NULL.
+ * \param clock_hz      The rate of the scheduler's cycle counter, in Hz.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_uart_clock_attach(
+    virtual_device_uart* uart, virtual_device_scheduler* scheduler,
+    uint32_t clock_hz);
+
+/**
+ * \brief Drive the UART's interrupt output into the given IRQ aggregator.
+ *
+ * To route the UART through a VIA handshake line, as the modem driver does,
+ * attach it to an aggregator whose line drives the VIA's CA1 input.
+ *
+ * \param uart          The UART instance.
+ * \param irq           The aggregator.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_IRQ_SOURCES if the aggregator has no room for
+ *        another source.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_uart_irq_attach(
+    virtual_device_uart* uart, virtual_device_irq* irq);
+
+/**
+ * \brief Connect the peripheral that takes the UART's transmitted characters.
+ *
+ * \param uart          The UART instance.
+ * \param transmit      The callback for each character, or NULL to drop them.
+ * \param context       The user context for the callback.
+ */
+void virtual_device_uart_connect(
+    virtual_device_uart* uart, virtual_device_uart_tx_fn transmit,
+    void* context);
+
+/**
+ * \brief Send characters from the peripheral to the UART.
+ *
+ * Characters that arrive to find the receive FIFO full are lost, and set the
+ * overrun flag.  In timed mode, the characters go onto the line, and arrive
+ * one character time apart.  While DTR is off, the receiver is disabled, and
+ * characters are lost without an overrun.
+ *
+ * \param uart          The UART instance.
+ * \param data          The characters.
+ * \param size          The number of characters.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_UART_LINE_FULL if the characters do not fit on
+ *        the line; none of them are sent.
+ *      - a non-zero error code if a character deadline could not be posted.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_uart_receive(
+    virtual_device_uart* uart, const uint8_t* data, size_t size);
+
+/**
+ * \brief Queue a character written by the CPU for transmission.
+ *
+ * A character written while the transmit FIFO is full is lost.
+ *
+ * \param uart          The UART instance.
+ * \param byte          The character.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code if a character deadline could not be posted.
+ */
+JEMU_SYM(status) virtual_device_uart_transmit(
+    virtual_device_uart* uart, uint8_t byte);
+
+/**
+ * \brief Move the oldest character on the line into the receive FIFO.
+ *
+ * The character is lost, and sets the overrun flag, if the receive FIFO is
+ * full.  The line must not be empty.
+ *
+ * \param uart          The UART instance.
+ */
+void virtual_device_uart_rx_arrive(virtual_device_uart* uart);
+
+/**
+ * \brief Send the oldest character in the transmit FIFO to the peripheral.
+ *
+ * The transmit FIFO must not be empty.
+ *
+ * \param uart          The UART instance.
+ */
+void virtual_device_uart_tx_send(virtual_device_uart* uart);
+
+/**
+ * \brief Handle the arrival of a received character.
+ *
+ * \param uart          An opaque reference to the UART instance.
+ * \param deadline      The cycle the event was due.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_uart_rx_event(void* uart, uint64_t deadline);
+
+/**
+ * \brief Handle the end of a transmitted character.
+ *
+ * \param uart          An opaque reference to the UART instance.
+ * \param deadline      The cycle the event was due.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_uart_tx_event(void* uart, uint64_t deadline);
+
+/**
+ * \brief Post the UART's character events for rx_next and tx_next, or, in
+ * instant mode, deliver the characters on the line.
+ *
+ * \ref virtual_device_uart_restore_callback calls this after a snapshot
+ * restores the UART's state.
+ *
+ * \param uart          The UART instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_uart_sync(virtual_device_uart* uart);
+
+/**
+ * \brief Return true if the UART times its characters.
+ *
+ * \param uart          The UART instance.
+ *
+ * \returns true with a scheduler and a clock rate attached.
+ */
+inline bool virtual_device_uart_timed(const virtual_device_uart* uart)
+{
+    return NULL != uart->scheduler && UART_INSTANT != uart->clock_hz;
+}
+
+/**
+ * \brief Return the number of cycles a character takes on the line.
+ *
+ * A character is a start bit, the word, the parity bit if enabled, and the
+ * stop bits, at the baud rate CONTROL selects.
+ *
+ * \param uart          The UART instance.
+ *
+ * \returns the cycles per character.
+ */
+inline uint64_t virtual_device_uart_char_cycles(
+    const virtual_device_uart* uart)
+{
+    uint8_t control = UART_SHADOW(uart, UART_REGISTER_CONTROL);
+    uint64_t bits =
+        1
+      + (8 - ((control & UART_CONTROL_WORD) >> 5))
+      + (UART_SHADOW(uart, UART_REGISTER_COMMAND) & UART_COMMAND_PARITY
+            ? 1 : 0)
+      + (control & UART_CONTROL_STOP ? 2 : 1);
+
+    return
+        (uint64_t)uart->clock_hz * bits * 100
+      / virtual_device_uart_baud_rates[control & UART_CONTROL_BAUD];
+}
+
+/**
+ * \brief Return the room left in the receive FIFO, less the characters still
+ * on the line.
+ *
+ * A peripheral that honors flow control sends no more than this.
+ *
+ * \param uart          The UART instance.
+ *
+ * \returns the number of characters the receive FIFO can still take.
+ */
+inline size_t virtual_device_uart_rx_space(const virtual_device_uart* uart)
+{
+    size_t used = (size_t)uart->rx_count + uart->line_count;
+
+    return used < uart->rx_depth ? uart->rx_depth - used : 0;
+}
+
+/**
+ * \brief Compute the UART's interrupt output.
+ *
+ * \param uart          The UART instance.
+ *
+ * \returns true if the UART is requesting an interrupt.
+ */
+inline bool virtual_device_uart_irq_level(const virtual_device_uart* uart)
+{
+    uint8_t command = UART_SHADOW(uart, UART_REGISTER_COMMAND);
+
+    if (!(command & UART_COMMAND_DTR))
+    {
+        return false;
+    }
+
+    return
+        (uart->rx_count > 0 && !(command & UART_COMMAND_RX_IRQ_OFF))
+     || (uart->tx_count < uart->tx_depth
+         && UART_COMMAND_TX_IRQ == (command & UART_COMMAND_TIC));
+}
+
+/**
+ * \brief Report the UART's interrupt output to its IRQ aggregator.
+ *
+ * \param uart          The UART instance.
+ */
+inline void virtual_device_uart_irq_update(virtual_device_uart* uart)
+{
+    if (NULL != uart->irq)
+    {
+        virtual_device_irq_set(
+            uart->irq, uart->irq_source, virtual_device_uart_irq_level(uart));
+    }
+}
+
+/**
+ * \brief Read a UART register.
+ *
+ * Reading DATA takes the oldest received character, and clears the overrun
+ * flag.  With the receive FIFO empty, it returns the last character again.
+ *
+ * \param uart          The UART instance.
+ * \param addr          The address for the read operation.
+ * \param byte          Pointer to receive the byte read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ */
+inline JEMU_SYM(status) virtual_device_uart_read(
+    virtual_device_uart* uart, uint16_t addr, uint8_t* byte)
+{
+    /* the UART decodes the low two address bits. */
+    uint16_t reg = (uint16_t)(UART_REGISTER_DATA | (addr & 0x03));
+
+    switch (reg)
+    {
+        case UART_REGISTER_DATA:
+            if (uart->rx_count > 0)
+            {
+                uart->rx_data = uart->rx_fifo[uart->rx_head];
+                uart->rx_head =
+                    (uint16_t)((uart->rx_head + 1) % uart->rx_depth);
+                uart->rx_count -= 1;
+                uart->errors &= (uint8_t)~UART_STATUS_OVERRUN;
+                virtual_device_uart_irq_update(uart);
+            }
+            *byte = uart->rx_data;
+            break;
+
+        /* DCD and DSR are active low, and the modem always asserts them. */
+        case UART_REGISTER_STATUS:
+            *byte =
+                (uint8_t)(
+                    uart->errors
+                  | (uart->rx_count > 0 ? UART_STATUS_RDRF : 0)
+                  | (uart->tx_count < uart->tx_depth ? UART_STATUS_TDRE : 0)
+                  | (virtual_device_uart_irq_level(uart)
+                        ? UART_STATUS_IRQ : 0));
+            break;
+
+        default:
+            *byte = UART_SHADOW(uart, reg);
+            break;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief Write a UART register.
+ *
+ * Writing STATUS is a programmed reset, which clears the low command bits and
+ * the overrun flag, but leaves the FIFOs alone.
+ *
+ * \param uart          The UART instance.
+ * \param addr          The address for the write operation.
+ * \param byte          The byte to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code if a character deadline could not be posted.
+ */
+inline JEMU_SYM(status) virtual_device_uart_write(
+    virtual_device_uart* uart, uint16_t addr, uint8_t byte)
+{
+    /* the UART decodes the low two address bits. */
+    uint16_t reg = (uint16_t)(UART_REGISTER_DATA | (addr & 0x03));
+
+    switch (reg)
+    {
+        case UART_REGISTER_DATA:
+            return virtual_device_uart_transmit(uart, byte);
+
+        case UART_REGISTER_STATUS:
+            UART_SHADOW(uart, UART_REGISTER_COMMAND) &=
+                (uint8_t)~UART_COMMAND_RESET;
+            uart->errors &= (uint8_t)~UART_STATUS_OVERRUN;
+            break;
+
+        default:
+            UART_SHADOW(uart, reg) = byte;
+            break;
+    }
+
+    virtual_device_uart_irq_update(uart);
+
+    return STATUS_SUCCESS;
+}
+
+/* C++ compatibility. */
+# ifdef   __cplusplus
+}
+# endif /*__cplusplus*/
@@ -9,6 +9,10 @@
 
 #pragma once
 
+#include <stdbool.h>
+
+#include "scheduler.h"
+#include "status.h"
 #include "virtual_device.h"
 
 /* C++ compatibility. */
@@ -33,20 +37,258 @@ extern "C" {
 #define VIA_REGISTER_IER            0xF60E
 #define VIA_REGISTER_IORA2          0xF60F
 
+#define VIA_REGISTER_COUNT            16
+
 #define VIA_DDR_PIN_DIR_INPUT            0
 #define VIA_DDR_PIN_DIR_OUTPUT           1
 
+#define VIA_IFR_CA2                   0x01
+#define VIA_IFR_CA1                   0x02
+#define VIA_IFR_SR                    0x04
+#define VIA_IFR_CB2                   0x08
+#define VIA_IFR_CB1                   0x10
+#define VIA_IFR_T2                    0x20
+#define VIA_IFR_T1                    0x40
+#define VIA_IFR_IRQ                   0x80
+#define VIA_IFR_FLAGS                 0x7F
+
+#define VIA_IER_SET                   0x80
+
+#define VIA_ACR_PA_LATCH              0x01
+#define VIA_ACR_PB_LATCH              0x02
+#define VIA_ACR_SR_MODE               0x1C
+#define VIA_ACR_T2_PULSE_COUNT        0x20
+#define VIA_ACR_T1_FREE_RUN           0x40
+#define VIA_ACR_TIMER_MODE \
+    (VIA_ACR_T2_PULSE_COUNT | VIA_ACR_T1_FREE_RUN)
+
+#define VIA_PB6                       0x40
+
+/**
+ * \brief The shift register modes, as ACR bits.
+ */
+#define VIA_SR_DISABLED               0x00
+#define VIA_SR_IN_T2                  0x04
+#define VIA_SR_IN_PHI2                0x08
+#define VIA_SR_IN_CB1                 0x0C
+#define VIA_SR_OUT_FREE               0x10
+#define VIA_SR_OUT_T2                 0x14
+#define VIA_SR_OUT_PHI2               0x18
+#define VIA_SR_OUT_CB1                0x1C
+
+/**
+ * \brief True if the shift register mode shifts out on CB2.
+ */
+#define VIA_SR_SHIFTS_OUT(mode)       (0 != ((mode) & 0x10))
+
+/**
+ * \brief True if the shift register mode is clocked by the VIA on CB1.
+ */
+#define VIA_SR_CLOCKS_CB1(mode) \
+    (VIA_SR_DISABLED != (mode) && 0x0C != ((mode) & 0x0C))
+
+#define VIA_PORT_B                       0
+#define VIA_PORT_A                       1
+#define VIA_PORT_CONTROL                 2
+#define VIA_PORT_COUNT                   3
+
+/**
+ * \brief The handshake lines, as the pins of \ref VIA_PORT_CONTROL.
+ */
+#define VIA_CONTROL_CA1               0x01
+#define VIA_CONTROL_CA2               0x02
+#define VIA_CONTROL_CB1               0x04
+#define VIA_CONTROL_CB2               0x08
+
+/**
+ * \brief The PCR bits for a port's C1 and C2 lines, shifted down to the port A
+ * nibble.
+ */
+#define VIA_PCR_SIDE(pcr, port) \
+    ((uint8_t)((VIA_PORT_A == (port) ? (pcr) : (pcr) >> 4) & 0x0F))
+
+#define VIA_PCR_C1_POSITIVE           0x01
+#define VIA_PCR_C2_MODE               0x0E
+#define VIA_PCR_C2_POSITIVE           0x04
+#define VIA_PCR_C2_OUTPUT             0x08
+
+#define VIA_PCR_C2_INPUT_NEGATIVE     0x00
+#define VIA_PCR_C2_IND_NEGATIVE       0x02
+#define VIA_PCR_C2_INPUT_POSITIVE     0x04
+#define VIA_PCR_C2_IND_POSITIVE       0x06
+#define VIA_PCR_C2_HANDSHAKE          0x08
+#define VIA_PCR_C2_PULSE              0x0A
+#define VIA_PCR_C2_LOW                0x0C
+#define VIA_PCR_C2_HIGH               0x0E
+
+/**
+ * \brief True if accessing the port strobes its C2 line.
+ */
+#define VIA_PCR_STROBES(pcr, port) \
+    ((VIA_PCR_SIDE(pcr, port) & 0x0C) == VIA_PCR_C2_HANDSHAKE)
+
+/**
+ * \brief The IFR and control line bits of a port's C1 and C2 lines.
+ */
+#define VIA_IFR_C1(port) \
+    (VIA_PORT_A == (port) ? VIA_IFR_CA1 : VIA_IFR_CB1)
+#define VIA_IFR_C2(port) \
+    (VIA_PORT_A == (port) ? VIA_IFR_CA2 : VIA_IFR_CB2)
+#define VIA_CONTROL_C1(port) \
+    (VIA_PORT_A == (port) ? VIA_CONTROL_CA1 : VIA_CONTROL_CB1)
+#define VIA_CONTROL_C2(port) \
+    (VIA_PORT_A == (port) ? VIA_CONTROL_CA2 : VIA_CONTROL_CB2)
+
+/**
+ * \brief The shadow byte of a VIA register.
+ */
+#define VIA_SHADOW(via, reg) ((via)->shadow[(reg) - VIA_REGISTER_IORB])
+
+/**
+ * \brief Handle a change in the levels of a VIA port's pins.
+ *
+ * \param context       The user context for the subscription.
+ * \param port          \ref VIA_PORT_A, \ref VIA_PORT_B, or
+ *                      \ref VIA_PORT_CONTROL.
+ * \param levels        The levels of all of the port's pins.
+ * \param changed       The subscribed pins whose levels changed.
+ */
+typedef void (*virtual_device_via_pin_fn)(
+    void* context, uint8_t port, uint8_t levels, uint8_t changed);
+
+/**
+ * \brief Transfer a whole byte through the VIA's shift register.
+ *
+ * \param context       The user context for the peripheral.
+ * \param shift_out     true if the VIA is shifting the byte out, false if it
+ *                      is shifting a byte in.
+ * \param byte          The byte shifted out, or 0xFF when shifting in.
+ *
+ * \returns the byte shifted in, which is ignored when shifting out.
+ */
+typedef uint8_t (*virtual_device_via_sr_fn)(
+    void* context, bool shift_out, uint8_t byte);
+
+/**
+ * \brief A subscription to pin-level changes on a VIA port.
+ *
+ * Subscriptions are owned by their peripheral models, usually embedded in the
+ * model's instance, and are linked into the VIA's list for their port.
+ */
+typedef struct virtual_device_via_subscription
+    virtual_device_via_subscription;
+
+struct virtual_device_via_subscription
+{
+    virtual_device_via_pin_fn notify;
+    void* context;
+    uint8_t port;
+    uint8_t mask;
+    virtual_device_via_subscription* next;
+};
+
 /**
  * \brief The VIA virtual device.
+ *
+ * The output registers, data direction registers, and the levels driven onto
+ * the input pins by the host are kept separately; reading a port combines the
+ * output register for output pins with the input level for input pins.
+ *
+ * Registers that are plain storage (the data direction registers, the timer 1
+ * latches, ACR, and PCR) live in the shadow array, indexed by register offset,
+ * so that the device manager can serve their reads without calling the VIA.
+ * Their writes are written through to the VIA, which acts on them.
+ *
+ * Everything from the shadow array on is plain device state, which snapshots
+ * save and restore as one block; it must not hold pointers.
+ *
+ * The timers are not ticked.  Each timer remembers the cycle it was loaded at
+ * (its base) and the count it was loaded with (its start), and its counter is
+ * computed from the cycle delta when it is read.  A timer that will interrupt
+ * is armed, and the VIA posts a single scheduler event for the earliest armed
+ * underflow.  In pulse counting mode, timer 2 holds its count in t2_start and
+ * is decremented by falling edges on PB6.  The timer_mode is the ACR timer
+ * bits that the timers are running under, and t1_latch the latch that timer 1
+ * reloads from.  The device manager stores a latch write in the shadow array
+ * before passing it on, so the VIA keeps its own copy, to settle periods that
+ * ran out under the old latch.
+ *
+ * The VIA pulls its IRQ output low while any flag in IFR is enabled in IER,
+ * and reports that level to the IRQ aggregator it is attached to.
+ *
+ * The pins array holds the levels of each port's pins as last published to
+ * the port's subscribers.  The levels are worked out again after anything that
+ * can move them, and subscribers are only called when a pin they subscribe to
+ * has changed, so rewriting a port with the same value costs one compare.
+ *
+ * The CA1, CA2, CB1, and CB2 handshake lines are published as the pins of
+ * \ref VIA_PORT_CONTROL.  The control_in byte holds the levels driven onto
+ * them from outside, and control_out the levels the VIA drives onto CA2 and
+ * CB2 when PCR makes them outputs.  The input latches hold the port inputs as
+ * they were at the last active C1 edge, for ACR input latching.
+ *
+ * The shift register counts the bits of the current byte in sr_bits while
+ * sr_running, and sr_mode is the ACR shift register bits it is running under.
+ * Shifting bit by bit, the VIA drives CB1 as the shift clock and CB2 as the
+ * data line, posting sr_event for each clock edge.  With a byte transfer
+ * attached in sr_transfer, the whole byte is exchanged with the peripheral by
+ * a single sr_event, at the cycle its last bit would finish.
+ * The sr_next field is the cycle sr_event is posted for.
  */
 typedef struct virtual_device_via virtual_device_via;
 
 struct virtual_device_via
 {
-    uint16_t ddrb;
-    uint16_t ddra;
+    virtual_device_arena* arena;
+    virtual_device_scheduler* scheduler;
+    virtual_device_event timer_event;
+    virtual_device_event sr_event;
+    virtual_device_via_sr_fn sr_transfer;
+    void* sr_context;
+    virtual_device_irq* irq;
+    uint8_t irq_source;
+    virtual_device_via_subscription* subscribers[VIA_PORT_COUNT];
+    uint8_t pins[VIA_PORT_COUNT];
+    uint8_t shadow[VIA_REGISTER_COUNT];
+    uint8_t orb;
+    uint8_t ora;
+    uint8_t irb;
+    uint8_t ira;
+    uint8_t t2_latch_low;
+    uint8_t sr;
+    uint8_t ifr;
+    uint8_t ier;
+    uint8_t timer_mode;
+    bool t1_armed;
+    bool t2_armed;
+    uint16_t t1_latch;
+    uint16_t t1_start;
+    uint16_t t2_start;
+    uint64_t t1_base;
+    uint64_t t2_base;
+    uint8_t control_in;
+    uint8_t control_out;
+    uint8_t ira_latch;
+    uint8_t irb_latch;
+    uint8_t sr_mode;
+    uint8_t sr_bits;
+    bool sr_running;
+    uint64_t sr_next;
 };
 
+/**
+ * \brief The shadow flags for each VIA register, by register offset.
+ */
+extern const uint8_t virtual_device_via_shadow_flags[VIA_REGISTER_COUNT];
+
+/**
+ * \brief The layout version of the VIA's snapshot state, everything from the
+ * shadow array to the end of \ref virtual_device_via.
+ *
+ * Bump this whenever those fields change.
+ */
+#define VIRTUAL_DEVICE_VIA_STATE_VERSION                                     1
+
 /**
  * \brief Create a virtual VIA device for the demo phone.
  *
@@ -61,6 +303,22 @@ JEMU_SYM(status) FN_DECL_MUST_CHECK
 virtual_device_via_create(
     virtual_device_via** via);
 
+/**
+ * \brief Create a virtual VIA device for the demo phone in the given arena.
+ *
+ * \param via           Pointer to the virtual VIA device instance pointer to
+ *                      be set to the created instance on success.
+ * \param arena         The arena to allocate from, or NULL to use the
+ *                      default allocator.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_via_create_in_arena(
+    virtual_device_via** via, virtual_device_arena* arena);
+
 /**
  * \brief Release a virtual VIA device instance.
  *
@@ -75,6 +333,26 @@ virtual_device_via_create(
 JEMU_SYM(status) FN_DECL_MUST_CHECK
 virtual_device_via_release(virtual_device_via* via);
 
+/**
+ * \brief Describe a VIA as a device entry, with its shadow registers.
+ *
+ * In a VIRTUAL_DEVICE_SNAPSHOT build, the entry also declares the VIA's state
+ * block, so that snapshots save and restore its registers, and a restore
+ * handler that resumes its timers and shift register and republishes its pins.
+ *
+ * The entry can then be registered with
+ * \ref virtual_device_manager_entry_register or attached with
+ * \ref virtual_device_manager_entry_attach.
+ *
+ * \param via           The VIA instance.
+ * \param entry         The entry to initialize.
+ * \param register_low  The first VIA register, which must be aligned to
+ *                      \ref VIA_REGISTER_COUNT.
+ */
+void virtual_device_via_entry_init(
+    virtual_device_via* via, virtual_device_entry* entry,
+    uint16_t register_low);
+
 /**
  * \brief Read callback for the VIA device.
  *
@@ -103,6 +381,773 @@ JEMU_SYM(status) virtual_device_via_read_callback(
 JEMU_SYM(status) virtual_device_via_write_callback(
     void* via, uint16_t addr, uint8_t byte);
 
+/**
+ * \brief Restore callback for the VIA device.
+ *
+ * Posts the VIA's timer and shift register events again, republishes its pin
+ * levels, and drives its IRQ output, to match its restored state.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_via_restore_callback(void* via);
+
+/**
+ * \brief Input callback for the levels driven onto the VIA's port A pins.
+ *
+ * Only the pins configured as inputs are seen by the firmware.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ * \param value         The pin levels.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ */
+JEMU_SYM(status) virtual_device_via_port_a_input(void* via, uint8_t value);
+
+/**
+ * \brief Input callback for the levels driven onto the VIA's port B pins.
+ *
+ * Only the pins configured as inputs are seen by the firmware.  In pulse
+ * counting mode, each falling edge on PB6 counts timer 2 down.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ * \param value         The pin levels.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ */
+JEMU_SYM(status) virtual_device_via_port_b_input(void* via, uint8_t value);
+
+/**
+ * \brief Input callback for the level driven onto the VIA's CA1 line.
+ *
+ * An active transition, as selected by PCR, sets the CA1 flag, latches port A
+ * if ACR enables it, and ends a CA2 handshake.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ * \param value         The line level; any non-zero value is high.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ */
+JEMU_SYM(status) virtual_device_via_ca1_input(void* via, uint8_t value);
+
+/**
+ * \brief Input callback for the level driven onto the VIA's CA2 line.
+ *
+ * While CA2 is an input, an active transition, as selected by PCR, sets the
+ * CA2 flag.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ * \param value         The line level; any non-zero value is high.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ */
+JEMU_SYM(status) virtual_device_via_ca2_input(void* via, uint8_t value);
+
+/**
+ * \brief Input callback for the level driven onto the VIA's CB1 line.
+ *
+ * An active transition, as selected by PCR, sets the CB1 flag, latches port B
+ * if ACR enables it, and ends a CB2 handshake.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ * \param value         The line level; any non-zero value is high.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ */
+JEMU_SYM(status) virtual_device_via_cb1_input(void* via, uint8_t value);
+
+/**
+ * \brief Input callback for the level driven onto the VIA's CB2 line.
+ *
+ * While CB2 is an input, an active transition, as selected by PCR, sets the
+ * CB2 flag.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ * \param value         The line level; any non-zero value is high.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ */
+JEMU_SYM(status) virtual_device_via_cb2_input(void* via, uint8_t value);
+
+/**
+ * \brief Drive one of the VIA's handshake lines from outside.
+ *
+ * This is used by the CA1, CA2, CB1, and CB2 input callbacks.
+ *
+ * \param via           The VIA instance.
+ * \param line          The \ref VIA_CONTROL_CA1 style bit of the line.
+ * \param high          true if the line is driven high.
+ */
+void virtual_device_via_control_input(
+    virtual_device_via* via, uint8_t line, bool high);
+
+/**
+ * \brief Carry out the handshake for a CPU access to port A or port B.
+ *
+ * The access clears the port's C1 flag, and its C2 flag unless C2 is an
+ * independent interrupt input.  In handshake mode, C2 goes low until the next
+ * active C1 edge; in pulse mode, it goes low and straight back high.  Port B
+ * only strobes CB2 on writes.
+ *
+ * \param via           The VIA instance.
+ * \param port          \ref VIA_PORT_A or \ref VIA_PORT_B.
+ * \param write         true for a write, false for a read.
+ */
+void virtual_device_via_handshake(
+    virtual_device_via* via, uint8_t port, bool write);
+
+/**
+ * \brief Write the peripheral control register, driving CA2 and CB2 when they
+ * become outputs.
+ *
+ * \param via           The VIA instance.
+ * \param byte          The new PCR value.
+ */
+void virtual_device_via_pcr_write(virtual_device_via* via, uint8_t byte);
+
+/**
+ * \brief Exchange whole bytes with a peripheral through the shift register.
+ *
+ * With a transfer attached, a byte shifted under T2 or phi2 completes with a
+ * single scheduler event instead of an event per clock edge, and CB1 and CB2
+ * are not toggled.  Bytes clocked by the peripheral on CB1 are always shifted
+ * bit by bit.
+ *
+ * \param via           The VIA instance.
+ * \param transfer      The byte transfer, or NULL to shift bit by bit.
+ * \param context       The user context for the transfer.
+ */
+void virtual_device_via_sr_attach(
+    virtual_device_via* via, virtual_device_via_sr_fn transfer,
+    void* context);
+
+/**
+ * \brief Start shifting a byte, on a CPU access to SR.
+ *
+ * The access clears the SR flag.
+ *
+ * \param via           The VIA instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_via_sr_start(virtual_device_via* via);
+
+/**
+ * \brief Stop the shift register, after ACR changes its mode.
+ *
+ * CB1 and CB2 return high, and any pending shift event is cancelled.
+ *
+ * \param via           The VIA instance.
+ */
+void virtual_device_via_sr_stop(virtual_device_via* via);
+
+/**
+ * \brief Shift one bit on an edge of the shift clock.
+ *
+ * Bits are shifted out on CB2 at the falling edge, most significant first,
+ * and shifted in from CB2 at the rising edge.  The byte completes at the
+ * eighth rising edge.
+ *
+ * \param via           The VIA instance.
+ * \param rising        true for a rising edge of CB1.
+ */
+void virtual_device_via_sr_edge(virtual_device_via* via, bool rising);
+
+/**
+ * \brief Finish shifting a byte, raising the SR flag.
+ *
+ * Shifting out under T2 in free-running mode never finishes; the byte is
+ * shifted out again, and the flag is not raised.
+ *
+ * \param via           The VIA instance.
+ */
+void virtual_device_via_sr_complete(virtual_device_via* via);
+
+/**
+ * \brief Handle the VIA's shift register event.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ * \param deadline      The cycle the event was due.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_via_sr_event(void* via, uint64_t deadline);
+
+/**
+ * \brief Post the VIA's shift register event for sr_next, or cancel it if the
+ * shift register is idle or clocked from outside.
+ *
+ * \param via           The VIA instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_via_sr_sync(virtual_device_via* via);
+
+/**
+ * \brief Return the number of cycles between edges of the shift clock.
+ *
+ * Under T2, CB1 toggles each time the low byte of T2 counts out, every T2
+ * low latch + 2 cycles; under phi2, it toggles every cycle.
+ *
+ * \param via           The VIA instance.
+ *
+ * \returns the half period of the shift clock.
+ */
+inline uint64_t virtual_device_via_sr_half_period(
+    const virtual_device_via* via)
+{
+    switch (VIA_SHADOW(via, VIA_REGISTER_ACR) & VIA_ACR_SR_MODE)
+    {
+        case VIA_SR_IN_PHI2:
+        case VIA_SR_OUT_PHI2:
+            return 1;
+
+        default:
+            return (uint64_t)via->t2_latch_low + 2;
+    }
+}
+
+/**
+ * \brief Run the VIA's timers from the given scheduler's cycle counter.
+ *
+ * Until a scheduler is attached, the VIA's clock stands at cycle zero and its
+ * timers do not count.  Timers already loaded restart from the current cycle.
+ *
+ * \param via           The VIA instance.
+ * \param scheduler     The scheduler to post timer deadlines to.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_via_timer_attach(
+    virtual_device_via* via, virtual_device_scheduler* scheduler);
+
+/**
+ * \brief Handle the VIA's timer event, when a timer underflows.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ * \param deadline      The cycle the event was due.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_via_timer_event(void* via, uint64_t deadline);
+
+/**
+ * \brief Bring the timers up to the current cycle, raising the interrupt flag
+ * of each timer that has underflowed and reloading timer 1 in free-run mode.
+ *
+ * \param via           The VIA instance.
+ */
+void virtual_device_via_timer_update(virtual_device_via* via);
+
+/**
+ * \brief Post the VIA's timer event for its earliest armed underflow, or cancel
+ * it if no timer is armed, and drive the VIA's IRQ output.
+ *
+ * \ref virtual_device_via_restore_callback calls this after a snapshot
+ * restores the VIA's state.
+ *
+ * \param via           The VIA instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_via_timer_sync(virtual_device_via* via);
+
+/**
+ * \brief Return the current value of the timer 1 counter.
+ *
+ * \param via           The VIA instance.
+ *
+ * \returns the counter.
+ */
+uint16_t virtual_device_via_t1_counter(virtual_device_via* via);
+
+/**
+ * \brief Return the current value of the timer 2 counter.
+ *
+ * \param via           The VIA instance.
+ *
+ * \returns the counter.
+ */
+uint16_t virtual_device_via_t2_counter(virtual_device_via* via);
+
+/**
+ * \brief Load timer 1 from its latches and start it, on a write to T1C-H.
+ *
+ * \param via           The VIA instance.
+ * \param byte          The high latch byte.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_via_t1_load(
+    virtual_device_via* via, uint8_t byte);
+
+/**
+ * \brief Load timer 2 and start it, on a write to T2C-H.
+ *
+ * \param via           The VIA instance.
+ * \param byte          The high counter byte.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_via_t2_load(
+    virtual_device_via* via, uint8_t byte);
+
+/**
+ * \brief Write the auxiliary control register, switching the timer modes.
+ *
+ * A timer whose mode changes carries on from its current count.
+ *
+ * \param via           The VIA instance.
+ * \param byte          The new ACR value.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_via_acr_write(
+    virtual_device_via* via, uint8_t byte);
+
+/**
+ * \brief Drive the VIA's interrupt output into the given IRQ aggregator.
+ *
+ * \param via           The VIA instance.
+ * \param irq           The aggregator, usually the device manager's.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_IRQ_SOURCES if the aggregator has no room for
+ *        another source.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_via_irq_attach(virtual_device_via* via, virtual_device_irq* irq);
+
+/**
+ * \brief Report the VIA's IRQ output to its aggregator, after a change to IFR
+ * or IER.
+ *
+ * \param via           The VIA instance.
+ */
+inline void virtual_device_via_irq_update(virtual_device_via* via)
+{
+    if (NULL != via->irq)
+    {
+        virtual_device_irq_set(
+            via->irq, via->irq_source,
+            0 != (via->ifr & via->ier & VIA_IFR_FLAGS));
+    }
+}
+
+/**
+ * \brief Subscribe to changes in the levels of some of a port's pins.
+ *
+ * \param via           The VIA instance.
+ * \param subscription  The subscription to link, which must stay valid until
+ *                      it is unsubscribed or the VIA is released.
+ * \param port          \ref VIA_PORT_A or \ref VIA_PORT_B.
+ * \param mask          The pins to be notified about.
+ * \param notify        The callback for changes to those pins.
+ * \param context       The user context for the callback.
+ */
+void virtual_device_via_subscribe(
+    virtual_device_via* via, virtual_device_via_subscription* subscription,
+    uint8_t port, uint8_t mask, virtual_device_via_pin_fn notify,
+    void* context);
+
+/**
+ * \brief Remove a subscription from its VIA port.
+ *
+ * \param via           The VIA instance.
+ * \param subscription  The subscription to unlink.
+ */
+void virtual_device_via_unsubscribe(
+    virtual_device_via* via, virtual_device_via_subscription* subscription);
+
+/**
+ * \brief Publish a port's new pin levels to the subscribers whose pins
+ * changed.
+ *
+ * This is used by \ref virtual_device_via_pins_update.
+ *
+ * \param via           The VIA instance.
+ * \param port          \ref VIA_PORT_A or \ref VIA_PORT_B.
+ * \param levels        The new levels, which differ from the published ones.
+ */
+void virtual_device_via_pins_publish(
+    virtual_device_via* via, uint8_t port, uint8_t levels);
+
+/**
+ * \brief Return the levels of a port's pins.
+ *
+ * Output pins carry the output register, and input pins the levels driven
+ * onto them from outside.
+ *
+ * \param via           The VIA instance.
+ * \param port          \ref VIA_PORT_A, \ref VIA_PORT_B, or
+ *                      \ref VIA_PORT_CONTROL.
+ *
+ * \returns the pin levels.
+ */
+inline uint8_t virtual_device_via_port_levels(
+    const virtual_device_via* via, uint8_t port)
+{
+    uint8_t ddr, out, in;
+
+    if (VIA_PORT_CONTROL == port)
+    {
+        uint8_t pcr = VIA_SHADOW(via, VIA_REGISTER_PCR);
+        uint8_t sr = VIA_SHADOW(via, VIA_REGISTER_ACR) & VIA_ACR_SR_MODE;
+
+        /* CA2 and CB2 are driven by the VIA in the PCR output modes, and the
+         * shift register takes over CB1 and CB2 when it drives them. */
+        ddr =
+            (uint8_t)(
+                (pcr & VIA_PCR_C2_OUTPUT ? VIA_CONTROL_CA2 : 0)
+              | (pcr & (VIA_PCR_C2_OUTPUT << 4) ? VIA_CONTROL_CB2 : 0)
+              | (VIA_SR_CLOCKS_CB1(sr) ? VIA_CONTROL_CB1 : 0)
+              | (VIA_SR_SHIFTS_OUT(sr) ? VIA_CONTROL_CB2 : 0));
+        out = via->control_out;
+        in = via->control_in;
+    }
+    else if (VIA_PORT_A == port)
+    {
+        ddr = VIA_SHADOW(via, VIA_REGISTER_DDRA);
+        out = via->ora;
+        in = via->ira;
+    }
+    else
+    {
+        ddr = VIA_SHADOW(via, VIA_REGISTER_DDRB);
+        out = via->orb;
+        in = via->irb;
+    }
+
+    return (uint8_t)((out & ddr) | (in & ~ddr));
+}
+
+/**
+ * \brief Return the value the CPU reads from port A or port B.
+ *
+ * With input latching enabled in ACR, input pins read as they were latched at
+ * the last active C1 edge.
+ *
+ * \param via           The VIA instance.
+ * \param port          \ref VIA_PORT_A or \ref VIA_PORT_B.
+ *
+ * \returns the value read.
+ */
+inline uint8_t virtual_device_via_port_read(
+    const virtual_device_via* via, uint8_t port)
+{
+    uint8_t latch =
+        VIA_PORT_A == port ? VIA_ACR_PA_LATCH : VIA_ACR_PB_LATCH;
+
+    if (!(VIA_SHADOW(via, VIA_REGISTER_ACR) & latch))
+    {
+        return virtual_device_via_port_levels(via, port);
+    }
+
+    if (VIA_PORT_A == port)
+    {
+        return
+            (uint8_t)(
+                (via->ora & VIA_SHADOW(via, VIA_REGISTER_DDRA))
+              | (via->ira_latch & ~VIA_SHADOW(via, VIA_REGISTER_DDRA)));
+    }
+
+    return
+        (uint8_t)(
+            (via->orb & VIA_SHADOW(via, VIA_REGISTER_DDRB))
+          | (via->irb_latch & ~VIA_SHADOW(via, VIA_REGISTER_DDRB)));
+}
+
+/**
+ * \brief Work out a port's pin levels again, and publish them if they moved.
+ *
+ * \param via           The VIA instance.
+ * \param port          \ref VIA_PORT_A, \ref VIA_PORT_B, or
+ *                      \ref VIA_PORT_CONTROL.
+ */
+inline void virtual_device_via_pins_update(
+    virtual_device_via* via, uint8_t port)
+{
+    uint8_t levels = virtual_device_via_port_levels(via, port);
+
+    if (levels != via->pins[port])
+    {
+        virtual_device_via_pins_publish(via, port, levels);
+    }
+}
+
+/**
+ * \brief Return the VIA's current cycle.
+ *
+ * \param via           The VIA instance.
+ *
+ * \returns the scheduler's cycle, or zero if no scheduler is attached.
+ */
+inline uint64_t virtual_device_via_now(const virtual_device_via* via)
+{
+    if (NULL == via->scheduler)
+    {
+        return 0;
+    }
+
+    return virtual_device_scheduler_now(via->scheduler);
+}
+
+/**
+ * \brief Read a VIA register.
+ *
+ * This is the register handler behind \ref virtual_device_via_read_callback,
+ * exposed inline so that a caller that knows it is addressing the VIA can
+ * have the handler inlined.  Only the low four address bits are decoded.
+ *
+ * \param via           The VIA instance.
+ * \param addr          The address for the read operation.
+ * \param byte          Pointer to receive the byte read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code if a shift deadline could not be posted.
+ */
+inline JEMU_SYM(status) virtual_device_via_read(
+    virtual_device_via* via, uint16_t addr, uint8_t* byte)
+{
+    /* the VIA decodes the low four address bits. */
+    uint16_t reg = (uint16_t)(VIA_REGISTER_IORB | (addr & 0x0F));
+
+    switch (reg)
+    {
+        /* port B clears its flags on a read, but only strobes on a write. */
+        case VIA_REGISTER_IORB:
+            *byte = virtual_device_via_port_read(via, VIA_PORT_B);
+            if (via->ifr & (VIA_IFR_CB1 | VIA_IFR_CB2))
+            {
+                virtual_device_via_handshake(via, VIA_PORT_B, false);
+            }
+            break;
+
+        case VIA_REGISTER_IORA:
+            *byte = virtual_device_via_port_read(via, VIA_PORT_A);
+            if ((via->ifr & (VIA_IFR_CA1 | VIA_IFR_CA2))
+             || VIA_PCR_STROBES(VIA_SHADOW(via, VIA_REGISTER_PCR), VIA_PORT_A))
+            {
+                virtual_device_via_handshake(via, VIA_PORT_A, false);
+            }
+            break;
+
+        /* IORA2 reads port A without a handshake. */
+        case VIA_REGISTER_IORA2:
+            *byte = virtual_device_via_port_read(via, VIA_PORT_A);
+            break;
+
+        /* reading the low counter byte clears the timer's flag. */
+        case VIA_REGISTER_T1C1L:
+            *byte = (uint8_t)virtual_device_via_t1_counter(via);
+            via->ifr &= (uint8_t)~VIA_IFR_T1;
+            virtual_device_via_irq_update(via);
+            break;
+
+        case VIA_REGISTER_T1C1H:
+            *byte = (uint8_t)(virtual_device_via_t1_counter(via) >> 8);
+            break;
+
+        case VIA_REGISTER_T2CL:
+            *byte = (uint8_t)virtual_device_via_t2_counter(via);
+            via->ifr &= (uint8_t)~VIA_IFR_T2;
+            virtual_device_via_irq_update(via);
+            break;
+
+        case VIA_REGISTER_T2CH:
+            *byte = (uint8_t)(virtual_device_via_t2_counter(via) >> 8);
+            break;
+
+        /* reading SR starts shifting the next byte. */
+        case VIA_REGISTER_SR:
+            *byte = via->sr;
+            return virtual_device_via_sr_start(via);
+
+        /* bit 7 of IFR is set while any enabled flag is set. */
+        case VIA_REGISTER_IFR:
+            virtual_device_via_timer_update(via);
+            *byte = via->ifr;
+            if (via->ifr & via->ier & VIA_IFR_FLAGS)
+            {
+                *byte |= VIA_IFR_IRQ;
+            }
+            break;
+
+        /* bit 7 of IER always reads as set. */
+        case VIA_REGISTER_IER:
+            *byte = (uint8_t)(via->ier | VIA_IER_SET);
+            break;
+
+        /* the remaining registers are plain storage. */
+        default:
+            *byte = VIA_SHADOW(via, reg);
+            break;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief Write a VIA register.
+ *
+ * This is the register handler behind \ref virtual_device_via_write_callback,
+ * exposed inline so that a caller that knows it is addressing the VIA can
+ * have the handler inlined.  Only the low four address bits are decoded.
+ *
+ * \param via           The VIA instance.
+ * \param addr          The address for the write operation.
+ * \param byte          The byte to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code if a timer or shift deadline could not be
+ *        posted.
+ */
+inline JEMU_SYM(status) virtual_device_via_write(
+    virtual_device_via* via, uint16_t addr, uint8_t byte)
+{
+    /* the VIA decodes the low four address bits. */
+    uint16_t reg = (uint16_t)(VIA_REGISTER_IORB | (addr & 0x0F));
+
+    switch (reg)
+    {
+        case VIA_REGISTER_IORB:
+            via->orb = byte;
+            virtual_device_via_pins_update(via, VIA_PORT_B);
+            if ((via->ifr & (VIA_IFR_CB1 | VIA_IFR_CB2))
+             || VIA_PCR_STROBES(VIA_SHADOW(via, VIA_REGISTER_PCR), VIA_PORT_B))
+            {
+                virtual_device_via_handshake(via, VIA_PORT_B, true);
+            }
+            break;
+
+        case VIA_REGISTER_IORA:
+            via->ora = byte;
+            virtual_device_via_pins_update(via, VIA_PORT_A);
+            if ((via->ifr & (VIA_IFR_CA1 | VIA_IFR_CA2))
+             || VIA_PCR_STROBES(VIA_SHADOW(via, VIA_REGISTER_PCR), VIA_PORT_A))
+            {
+                virtual_device_via_handshake(via, VIA_PORT_A, true);
+            }
+            break;
+
+        /* IORA2 writes port A without a handshake. */
+        case VIA_REGISTER_IORA2:
+            via->ora = byte;
+            virtual_device_via_pins_update(via, VIA_PORT_A);
+            break;
+
+        case VIA_REGISTER_PCR:
+            virtual_device_via_pcr_write(via, byte);
+            break;
+
+        case VIA_REGISTER_DDRB:
+            VIA_SHADOW(via, VIA_REGISTER_DDRB) = byte;
+            virtual_device_via_pins_update(via, VIA_PORT_B);
+            break;
+
+        case VIA_REGISTER_DDRA:
+            VIA_SHADOW(via, VIA_REGISTER_DDRA) = byte;
+            virtual_device_via_pins_update(via, VIA_PORT_A);
+            break;
+
+        /* writing the low counter byte only sets the low latch. */
+        case VIA_REGISTER_T1C1L:
+        case VIA_REGISTER_T1LL:
+            virtual_device_via_timer_update(via);
+            VIA_SHADOW(via, VIA_REGISTER_T1LL) = byte;
+            via->t1_latch = (uint16_t)((via->t1_latch & 0xFF00) | byte);
+            break;
+
+        /* writing the high counter byte loads the counter from the latch. */
+        case VIA_REGISTER_T1C1H:
+            return virtual_device_via_t1_load(via, byte);
+
+        /* writing the high latch byte clears the timer 1 flag. */
+        case VIA_REGISTER_T1LH:
+            virtual_device_via_timer_update(via);
+            VIA_SHADOW(via, VIA_REGISTER_T1LH) = byte;
+            via->t1_latch = (uint16_t)((via->t1_latch & 0x00FF) | (byte << 8));
+            via->ifr &= (uint8_t)~VIA_IFR_T1;
+            virtual_device_via_irq_update(via);
+            break;
+
+        case VIA_REGISTER_T2CL:
+            via->t2_latch_low = byte;
+            break;
+
+        case VIA_REGISTER_T2CH:
+            return virtual_device_via_t2_load(via, byte);
+
+        case VIA_REGISTER_ACR:
+            return virtual_device_via_acr_write(via, byte);
+
+        /* writing SR starts shifting it. */
+        case VIA_REGISTER_SR:
+            via->sr = byte;
+            return virtual_device_via_sr_start(via);
+
+        /* writing a one to a flag clears it. */
+        case VIA_REGISTER_IFR:
+            virtual_device_via_timer_update(via);
+            via->ifr &= (uint8_t)~(byte & VIA_IFR_FLAGS);
+            virtual_device_via_irq_update(via);
+            break;
+
+        /* bit 7 selects whether the other bits set or clear enables. */
+        case VIA_REGISTER_IER:
+            if (byte & VIA_IER_SET)
+            {
+                via->ier |= (uint8_t)(byte & VIA_IFR_FLAGS);
+            }
+            else
+            {
+                via->ier &= (uint8_t)~byte;
+            }
+            virtual_device_via_irq_update(via);
+            break;
+
+        /* the remaining registers are plain storage. */
+        default:
+            VIA_SHADOW(via, reg) = byte;
+            break;
+    }
+
+    return STATUS_SUCCESS;
+}
+
 /* C++ compatibility. */
 # ifdef   __cplusplus
 }
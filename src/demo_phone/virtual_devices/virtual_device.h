@@ -12,40 +12,520 @@
 #include <jemu65c02/jemu65c02.h>
 #include <stddef.h>
 
+#include "arena.h"
+#include "irq.h"
+#include "status.h"
+
 /* C++ compatibility. */
 # ifdef   __cplusplus
 extern "C" {
 # endif /*__cplusplus*/
 
+/**
+ * \brief The number of address bits used to select a byte within a page of the
+ * finalized dispatch table.
+ */
+#define VIRTUAL_DEVICE_PAGE_SHIFT                                            8
+
+/**
+ * \brief The number of bytes in a page of the finalized dispatch table.
+ */
+#define VIRTUAL_DEVICE_PAGE_SIZE             (1 << VIRTUAL_DEVICE_PAGE_SHIFT)
+
+/**
+ * \brief The number of pages in the 65C02 address space.
+ */
+#define VIRTUAL_DEVICE_PAGE_COUNT  (65536 >> VIRTUAL_DEVICE_PAGE_SHIFT)
+
+/**
+ * \brief The number of 32-bit words in the address presence bitmap.
+ */
+#define VIRTUAL_DEVICE_PRESENCE_WORDS                          (65536 / 32)
+
+/**
+ * \brief Read a contiguous block of registers from a device in one call.
+ *
+ * \param context           The user context for the device.
+ * \param addr              The first address of the block.
+ * \param buffer            The buffer to receive the bytes read.
+ * \param size              The number of bytes to read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+typedef JEMU_SYM(status) (*virtual_device_block_read_fn)(
+    void* context, uint16_t addr, uint8_t* buffer, size_t size);
+
+/**
+ * \brief Write a contiguous block of registers to a device in one call.
+ *
+ * \param context           The user context for the device.
+ * \param addr              The first address of the block.
+ * \param buffer            The bytes to write.
+ * \param size              The number of bytes to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+typedef JEMU_SYM(status) (*virtual_device_block_write_fn)(
+    void* context, uint16_t addr, const uint8_t* buffer, size_t size);
+
+/**
+ * \brief Bring a device back in step with its state block, after a snapshot
+ * has restored it.
+ *
+ * Scheduler events, interrupt outputs, and published pin levels live outside
+ * the state block, and are worked out again from it.
+ *
+ * \param context           The user context for the device.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+typedef JEMU_SYM(status) (*virtual_device_restore_fn)(void* context);
+
+/**
+ * \brief Deliver an input from the outside world to a device, such as the
+ * levels on a port's pins or a byte arriving on a serial line.
+ *
+ * Inputs are delivered on the emulator thread, between instructions, so that
+ * they can be journaled and replayed at the same cycle; see journal.h.
+ *
+ * \param context           The user context for the device.
+ * \param value             The input value.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+typedef JEMU_SYM(status) (*virtual_device_input_fn)(
+    void* context, uint8_t value);
+
+/**
+ * \brief Writes to a memory region fail with
+ * VIRTUAL_DEVICE_ERROR_REGION_READ_ONLY.
+ */
+#define VIRTUAL_DEVICE_REGION_READ_ONLY                                  0x01
+
+/**
+ * \brief Writes to a memory region are silently ignored, as with a ROM on the
+ * bus.
+ */
+#define VIRTUAL_DEVICE_REGION_WRITE_PROTECTED                            0x02
+
+/**
+ * \brief A memory region smaller than its register range repeats across the
+ * range.
+ */
+#define VIRTUAL_DEVICE_REGION_MIRRORED                                   0x04
+
+/**
+ * \brief Reads of this register are served from the shadow byte, without
+ * calling the device.
+ */
+#define VIRTUAL_DEVICE_SHADOW_READ                                       0x01
+
+/**
+ * \brief Writes to this register are stored in the shadow byte, without calling
+ * the device.
+ */
+#define VIRTUAL_DEVICE_SHADOW_WRITE                                      0x02
+
+/**
+ * \brief Writes to this register are stored in the shadow byte, and the device
+ * is still called to act on them.
+ */
+#define VIRTUAL_DEVICE_SHADOW_WRITE_THROUGH                              0x04
+
 /**
  * \brief A virtual device entry.
+ *
+ * The block_read and block_write handlers are optional.  When NULL, block
+ * transfers fall back to the byte handlers.  The byte handlers are optional
+ * too: a device without a read or write handler answers those accesses with
+ * VIRTUAL_DEVICE_ERROR_UNMAPPED, like an address no device decodes.
+ *
+ * An entry with a memory pointer is a memory region.  Its accesses are serviced
+ * directly from memory, with memory_size bytes and the region_flags above, and
+ * its read and write handlers are not used.
+ *
+ * An entry with shadow_flags declares, for each register in its range, whether
+ * the register is served from the matching byte of the device's shadow array
+ * or needs a callback.  Both arrays are owned by the device.
+ *
+ * An entry with a non-zero decode_mask is partially decoded: only the address
+ * bits in the mask select a register, so the device's registers repeat across
+ * its range.  The handlers, shadow, and memory see only the first copy.
+ *
+ * In a VIRTUAL_DEVICE_STATS build, an entry with a stats block has its accesses
+ * counted by the manager's dispatch; see stats.h.
+ *
+ * In a VIRTUAL_DEVICE_SNAPSHOT build, an entry can declare a block of plain
+ * device state, owned by the device, that snapshots save and restore as is.
+ * The state_version names the layout of that block; a device bumps it when the
+ * layout changes, so that older snapshots are refused rather than misread.
+ * Its optional restore handler is called once every entry has been restored.
+ * Writable memory regions get a dirty map from the manager, with a byte per
+ * \ref VIRTUAL_DEVICE_PAGE_SIZE page of memory, set when the page is written;
+ * see snapshot.h.
  */
 typedef struct virtual_device_entry virtual_device_entry;
 
+#if defined(VIRTUAL_DEVICE_STATS)
+typedef struct virtual_device_stats virtual_device_stats;
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+/**
+ * \brief The trace recorder, opaque outside of the recording code; see
+ * trace.h.
+ */
+typedef struct virtual_device_trace virtual_device_trace;
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
+
 struct virtual_device_entry
 {
     uint16_t register_low;
     uint16_t register_high;
+    uint16_t decode_mask;
     void* context;
     JEMU_SYM(j65c02_read_fn) read;
     JEMU_SYM(j65c02_write_fn) write;
+    virtual_device_block_read_fn block_read;
+    virtual_device_block_write_fn block_write;
+    uint8_t* memory;
+    size_t memory_size;
+    uint32_t region_flags;
+    uint8_t* shadow;
+    const uint8_t* shadow_flags;
+#if defined(VIRTUAL_DEVICE_STATS)
+    virtual_device_stats* stats;
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+    void* state;
+    size_t state_size;
+    uint32_t state_version;
+    virtual_device_restore_fn restore;
+    uint8_t* dirty;
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
 };
 
+/**
+ * \brief Return the register offset of an address within a device entry,
+ * after address decoding.
+ *
+ * \param entry             The device entry.
+ * \param addr              An address serviced by the entry.
+ *
+ * \returns the offset of the register selected by this address.
+ */
+inline size_t virtual_device_entry_offset(
+    const virtual_device_entry* entry, uint16_t addr)
+{
+    size_t offset = (size_t)(addr - entry->register_low);
+
+    /* a zero mask means the entry is fully decoded. */
+    if (0 != entry->decode_mask)
+    {
+        offset &= entry->decode_mask;
+    }
+
+    return offset;
+}
+
+/**
+ * \brief Return the address that a device entry's handlers see for an address,
+ * after address decoding.
+ *
+ * \param entry             The device entry.
+ * \param addr              An address serviced by the entry.
+ *
+ * \returns the address of the register in the first copy of the device.
+ */
+inline uint16_t virtual_device_entry_decode(
+    const virtual_device_entry* entry, uint16_t addr)
+{
+    return
+        (uint16_t)(
+            entry->register_low + virtual_device_entry_offset(entry, addr));
+}
+
+/**
+ * \brief Return the offset into a memory region's memory for an address.
+ *
+ * \param entry             The memory region entry.
+ * \param addr              An address serviced by the entry.
+ *
+ * \returns the offset of this address in the region's memory.
+ */
+inline size_t virtual_device_region_offset(
+    const virtual_device_entry* entry, uint16_t addr)
+{
+    size_t offset = virtual_device_entry_offset(entry, addr);
+
+    if (entry->region_flags & VIRTUAL_DEVICE_REGION_MIRRORED)
+    {
+        offset %= entry->memory_size;
+    }
+
+    return offset;
+}
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+/**
+ * \brief Mark the pages of a memory region touched by a write as dirty.
+ *
+ * \param entry             The memory region entry.
+ * \param offset            The offset of the first byte written in the
+ *                          region's memory.
+ * \param size              The number of bytes written, which is not zero.
+ */
+inline void virtual_device_region_touch(
+    const virtual_device_entry* entry, size_t offset, size_t size)
+{
+    if (NULL != entry->dirty)
+    {
+        size_t last = (offset + size - 1) >> VIRTUAL_DEVICE_PAGE_SHIFT;
+
+        for (size_t page = offset >> VIRTUAL_DEVICE_PAGE_SHIFT; page <= last;
+             ++page)
+        {
+            entry->dirty[page] = 1;
+        }
+    }
+}
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
+
+/**
+ * \brief Read a byte from a device entry, from its memory, its shadow, or its
+ * read handler.
+ *
+ * \param entry             The device entry servicing this address.
+ * \param addr              The address for the read operation.
+ * \param byte              Pointer to receive the byte read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_UNMAPPED if the read would need a read handler,
+ *        and the entry has none.
+ *      - a non-zero error code on failure.
+ */
+inline JEMU_SYM(status) virtual_device_entry_read(
+    const virtual_device_entry* entry, uint16_t addr, uint8_t* byte)
+{
+    /* memory regions are read directly. */
+    if (NULL != entry->memory)
+    {
+        *byte = entry->memory[virtual_device_region_offset(entry, addr)];
+        return STATUS_SUCCESS;
+    }
+
+    /* shadowed registers are read without calling the device. */
+    if (NULL != entry->shadow_flags)
+    {
+        size_t offset = virtual_device_entry_offset(entry, addr);
+
+        if (entry->shadow_flags[offset] & VIRTUAL_DEVICE_SHADOW_READ)
+        {
+            *byte = entry->shadow[offset];
+            return STATUS_SUCCESS;
+        }
+    }
+
+    /* a device without a read handler does not answer reads. */
+    if (NULL == entry->read)
+    {
+        return VIRTUAL_DEVICE_ERROR_UNMAPPED;
+    }
+
+    return
+        entry->read(
+            entry->context, virtual_device_entry_decode(entry, addr), byte);
+}
+
+/**
+ * \brief Write a byte to a device entry, to its memory, its shadow, or its
+ * write handler.
+ *
+ * \param entry             The device entry servicing this address.
+ * \param addr              The address for the write operation.
+ * \param byte              The byte to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_REGION_READ_ONLY if the entry is a read-only
+ *        memory region.
+ *      - VIRTUAL_DEVICE_ERROR_UNMAPPED if the write would need a write
+ *        handler, and the entry has none.
+ *      - a non-zero error code on failure.
+ */
+inline JEMU_SYM(status) virtual_device_entry_write(
+    const virtual_device_entry* entry, uint16_t addr, uint8_t byte)
+{
+    /* memory regions are written directly, unless protected. */
+    if (NULL != entry->memory)
+    {
+        if (entry->region_flags & VIRTUAL_DEVICE_REGION_READ_ONLY)
+        {
+            return VIRTUAL_DEVICE_ERROR_REGION_READ_ONLY;
+        }
+
+        if (!(entry->region_flags & VIRTUAL_DEVICE_REGION_WRITE_PROTECTED))
+        {
+            size_t offset = virtual_device_region_offset(entry, addr);
+
+            entry->memory[offset] = byte;
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+            virtual_device_region_touch(entry, offset, 1);
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
+        }
+
+        return STATUS_SUCCESS;
+    }
+
+    /* shadowed registers are stored, and only written through on request. */
+    if (NULL != entry->shadow_flags)
+    {
+        size_t offset = virtual_device_entry_offset(entry, addr);
+        uint8_t flags = entry->shadow_flags[offset];
+
+        if (flags & VIRTUAL_DEVICE_SHADOW_WRITE)
+        {
+            entry->shadow[offset] = byte;
+            return STATUS_SUCCESS;
+        }
+
+        if (flags & VIRTUAL_DEVICE_SHADOW_WRITE_THROUGH)
+        {
+            entry->shadow[offset] = byte;
+        }
+    }
+
+    /* a device without a write handler does not answer writes. */
+    if (NULL == entry->write)
+    {
+        return VIRTUAL_DEVICE_ERROR_UNMAPPED;
+    }
+
+    return
+        entry->write(
+            entry->context, virtual_device_entry_decode(entry, addr), byte);
+}
+
 /**
  * \brief The virtual device manager instance.
+ *
+ * The low and high registers of each device entry are mirrored in the packed
+ * register_lows and register_highs arrays, in the same order as the device
+ * array, so that searches only touch the keys.  The sort_keys array holds two
+ * keys per device entry, and is the fixed working buffer for sorting.
+ *
+ * A manager created from a \ref virtual_device_map borrows the map's tables,
+ * which may live in flash, and is marked read_only so that nothing writes to
+ * them.
+ *
+ * The irq aggregator collects the interrupt outputs of the board's devices
+ * into the CPU's IRQ input; see irq.h.
  */
 typedef struct virtual_device_manager virtual_device_manager;
 
 struct virtual_device_manager
 {
+    virtual_device_arena* arena;
     virtual_device_entry* devices;
+    uint16_t* register_lows;
+    uint16_t* register_highs;
+    uint32_t* sort_keys;
     size_t device_entries;
     size_t max_device_entries;
+    bool sorted;
+    bool finalized;
+    bool read_only;
+    uint16_t* dispatch_pages;
+    uint16_t* dispatch_bytes;
+    size_t dispatch_tables;
+    size_t dispatch_capacity;
+    virtual_device_entry* last_hit;
+    uint32_t* presence;
+#if defined(VIRTUAL_DEVICE_STATS)
+    bool stats_enabled;
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
+#if defined(VIRTUAL_DEVICE_TRACE)
+    virtual_device_trace* trace;
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+    uint64_t snapshot_serial;
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
+    virtual_device_irq irq;
+};
+
+/**
+ * \brief A sorted, read-only device map, suitable for placing in flash as a
+ * const table.
+ *
+ * The register keys and the presence bitmap are required.  The dispatch tables
+ * are optional; when dispatch_pages is NULL, lookups search the register keys.
+ * When set, dispatch_pages holds \ref VIRTUAL_DEVICE_PAGE_COUNT entries and
+ * dispatch_bytes holds dispatch_tables byte tables, laid out as built by
+ * \ref virtual_device_manager_finalize.
+ */
+typedef struct virtual_device_map virtual_device_map;
+
+struct virtual_device_map
+{
+    const virtual_device_entry* devices;
+    const uint16_t* register_lows;
+    const uint16_t* register_highs;
+    size_t device_entries;
+    const uint16_t* dispatch_pages;
+    const uint16_t* dispatch_bytes;
+    size_t dispatch_tables;
+    const uint32_t* presence;
 };
 
+/**
+ * \brief The number of arena bytes needed to create and finalize a virtual
+ * device manager with the given capacities.
+ *
+ * This is a constant expression, so that static storage can be sized from it.
+ */
+#define VIRTUAL_DEVICE_MANAGER_ARENA_SIZE(capacity, pages) \
+    (VIRTUAL_DEVICE_ARENA_ALIGN(sizeof(virtual_device_manager)) \
+   + VIRTUAL_DEVICE_ARENA_ALIGN( \
+        ((capacity) < 2 ? 2 : (capacity)) * sizeof(virtual_device_entry)) \
+   + 2 * VIRTUAL_DEVICE_ARENA_ALIGN( \
+        ((capacity) < 2 ? 2 : (capacity)) * sizeof(uint16_t)) \
+   + VIRTUAL_DEVICE_ARENA_ALIGN( \
+        2 * ((capacity) < 2 ? 2 : (capacity)) * sizeof(uint32_t)) \
+   + VIRTUAL_DEVICE_ARENA_ALIGN( \
+        VIRTUAL_DEVICE_PRESENCE_WORDS * sizeof(uint32_t)) \
+   + VIRTUAL_DEVICE_ARENA_ALIGN( \
+        ((pages) + 1 + 1) * VIRTUAL_DEVICE_PAGE_SIZE * sizeof(uint16_t)))
+
+/**
+ * \brief The number of device entries that \ref virtual_device_manager_create
+ * makes room for.
+ *
+ * In a static build, this is the number of entries budgeted for in the static
+ * pool, so that the manager fits in the pool without growing.
+ */
+#if defined(VIRTUAL_DEVICE_STATIC)
+# define VIRTUAL_DEVICE_MANAGER_DEFAULT_CAPACITY \
+    VIRTUAL_DEVICE_STATIC_MAX_DEVICES
+#else
+# define VIRTUAL_DEVICE_MANAGER_DEFAULT_CAPACITY                           10
+#endif /*defined(VIRTUAL_DEVICE_STATIC)*/
+
 /**
  * \brief Create a virtual device manager instance.
  *
+ * The manager starts with room for
+ * \ref VIRTUAL_DEVICE_MANAGER_DEFAULT_CAPACITY device entries, in the default
+ * arena.
+ *
  * \note On success, the caller is given ownership of the virtual device
  * instance and must release it by calling \ref virtual_device_release when it
  * is no longer needed.
@@ -61,6 +541,73 @@ JEMU_SYM(status) FN_DECL_MUST_CHECK
 virtual_device_manager_create(
     virtual_device_manager** virt);
 
+/**
+ * \brief Create a virtual device manager instance, carving its memory from the
+ * given arena.
+ *
+ * \note On success, the caller is given ownership of the virtual device
+ * instance and must release it by calling \ref virtual_device_manager_release
+ * when it is no longer needed.  If an arena is given, the arena must outlive
+ * the instance.
+ *
+ * \param virt              Pointer to the virtual device manager instance
+ *                          pointer to set to the created instance on success.
+ * \param arena             The arena to allocate from, or NULL to use the
+ *                          default allocator.
+ * \param capacity          The number of device entries to reserve.  With an
+ *                          arena, reserving every device up front avoids
+ *                          leaving abandoned arrays in the arena on growth.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_create_in_arena(
+    virtual_device_manager** virt, virtual_device_arena* arena,
+    size_t capacity);
+
+/**
+ * \brief Create a virtual device manager instance over a read-only device map.
+ *
+ * Only the instance itself is allocated; the device entries, register keys,
+ * presence bitmap, and dispatch tables are borrowed from the map, so a map
+ * declared const is read directly from flash.  The resulting manager can be
+ * searched and used for emulation, but registering, attaching, detaching,
+ * sorting, or finalizing fails with VIRTUAL_DEVICE_ERROR_READ_ONLY.
+ *
+ * \note On success, the caller is given ownership of the virtual device
+ * instance and must release it by calling \ref virtual_device_manager_release
+ * when it is no longer needed.  The map must outlive the instance.
+ *
+ * \param virt              Pointer to the virtual device manager instance
+ *                          pointer to set to the created instance on success.
+ * \param arena             The arena to allocate from, or NULL to use the
+ *                          default allocator.
+ * \param map               The sorted device map to use.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_INVALID_MAP if a required table is missing.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_create_from_map(
+    virtual_device_manager** virt, virtual_device_arena* arena,
+    const virtual_device_map* map);
+
+/**
+ * \brief Compute the arena size needed for a virtual device manager instance.
+ *
+ * \param capacity          The number of device entries to reserve.
+ * \param pages             The number of 256 byte pages the devices will touch,
+ *                          for the finalized dispatch table.
+ *
+ * \returns the number of arena bytes needed to create and finalize a manager
+ * with these capacities.
+ */
+size_t virtual_device_manager_arena_size(size_t capacity, size_t pages);
+
 /**
  * \brief Release a virtual device manager instance.
  *
@@ -90,6 +637,7 @@ virtual_device_manager_release(virtual_device_manager* virt);
  *
  * \returns a status code indicating success or failure.
  *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
  *      - a non-zero error code on failure.
  */
 JEMU_SYM(status) FN_DECL_MUST_CHECK
@@ -98,9 +646,174 @@ virtual_device_manager_device_register(
     JEMU_SYM(j65c02_write_fn) write, uint16_t register_low,
     uint16_t register_high, void* context);
 
+/**
+ * \brief Register a device entry in the virtual device manager.
+ *
+ * The entry is copied, including its optional fields, such as the block
+ * transfer handlers.  If statistics are enabled, the copy is given its own
+ * stats block.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param entry             The device entry to register.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_entry_register(
+    virtual_device_manager* virt, const virtual_device_entry* entry);
+
+/**
+ * \brief Register a memory region in the virtual device manager.
+ *
+ * Reads and writes to the region are serviced directly from memory, without a
+ * device callback, and \ref virtual_device_manager_direct_access hands out
+ * pointers into it.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param register_low      The lowest address of the region.
+ * \param register_high     The highest address of the region.
+ * \param memory            The host memory backing the region, which must
+ *                          outlive the manager.  A read-only region may point
+ *                          at const memory cast to non-const; it is never
+ *                          written.
+ * \param memory_size       The size of the host memory.  This must cover the
+ *                          register range, unless the region is mirrored.
+ * \param region_flags      Any of VIRTUAL_DEVICE_REGION_READ_ONLY,
+ *                          VIRTUAL_DEVICE_REGION_WRITE_PROTECTED, and
+ *                          VIRTUAL_DEVICE_REGION_MIRRORED.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_INVALID_REGION if the memory is too small.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_region_register(
+    virtual_device_manager* virt, uint16_t register_low,
+    uint16_t register_high, uint8_t* memory, size_t memory_size,
+    uint32_t region_flags);
+
+/**
+ * \brief Register a partially decoded device in the virtual device manager,
+ * mirrored across a larger window.
+ *
+ * The entry describes one copy of the device, whose register_low is the base of
+ * the window, and whose range holds decode_mask + 1 registers.  The device is
+ * registered once, covering mirror_count copies, so lookups stay O(1) and
+ * the search does not grow.  Each access is decoded to the first copy before
+ * it reaches the device's handlers, shadow, or memory.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param entry             The device entry for the first copy.
+ * \param decode_mask       The address bits decoded by the device, which must
+ *                          be contiguous low bits.
+ * \param mirror_count      The number of copies of the device in the window.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_INVALID_DECODE if the mask is not contiguous low
+ *        bits, the entry's range does not match the mask, or the window runs
+ *        past the address space.
+ *      - VIRTUAL_DEVICE_ERROR_INVALID_REGION if a memory region's memory is too
+ *        small for one copy.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_decoded_register(
+    virtual_device_manager* virt, const virtual_device_entry* entry,
+    uint16_t decode_mask, size_t mirror_count);
+
+/**
+ * \brief Attach a device to a sorted virtual device manager, keeping the device
+ * array sorted.
+ *
+ * Unlike \ref virtual_device_manager_device_register, the new entry is placed
+ * in sorted position and only checked against its neighbors for overlap, so
+ * devices can be attached while emulation is running.  The presence bitmap is
+ * updated in place, and if the manager was finalized, the dispatch table is
+ * rebuilt.  Room for the rebuilt table is made first, so on failure the
+ * manager is left unchanged, and still finalized.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param read              The read function for the virtual device.
+ * \param write             The write function for the virtual device.
+ * \param register_low      The lowest register number in the contiguous memory
+ *                          mapped register space for this device.
+ * \param register_high     The highest register number in the contiguous memory
+ *                          mapped register space for this device.
+ * \param context           The user context for the virtual device read/write
+ *                          callbacks.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - VIRTUAL_DEVICE_ERROR_NOT_SORTED if the manager has unsorted entries.
+ *      - VIRTUAL_DEVICE_ERROR_OVERLAP if the device overlaps another device.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_device_attach(
+    virtual_device_manager* virt, JEMU_SYM(j65c02_read_fn) read,
+    JEMU_SYM(j65c02_write_fn) write, uint16_t register_low,
+    uint16_t register_high, void* context);
+
+/**
+ * \brief Attach a device entry to a sorted virtual device manager, keeping the
+ * device array sorted.
+ *
+ * This is \ref virtual_device_manager_device_attach for a whole entry, so that
+ * optional fields, such as the block transfer handlers, are attached too.  On
+ * failure, the manager is left unchanged.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param entry             The device entry to attach.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - VIRTUAL_DEVICE_ERROR_NOT_SORTED if the manager has unsorted entries.
+ *      - VIRTUAL_DEVICE_ERROR_OVERLAP if the device overlaps another device.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_entry_attach(
+    virtual_device_manager* virt, const virtual_device_entry* entry);
+
+/**
+ * \brief Detach a device from a sorted virtual device manager.
+ *
+ * The remaining entries stay sorted.  The presence bitmap is updated in place,
+ * and if the manager was finalized, the dispatch table is rebuilt.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param register_low      The lowest register number of the device to detach.
+ * \param register_high     The highest register number of the device to
+ *                          detach.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - VIRTUAL_DEVICE_ERROR_NOT_SORTED if the manager has unsorted entries.
+ *      - VIRTUAL_DEVICE_ERROR_NOT_FOUND if no device has exactly this range.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_device_detach(
+    virtual_device_manager* virt, uint16_t register_low,
+    uint16_t register_high);
+
 /**
  * \brief Return true if the given address is covered by the virtual device map.
  *
+ * This is a single bit test against the presence bitmap, which is rebuilt by
+ * \ref virtual_device_manager_sort and kept current by attach and detach.
+ * Devices registered since the last sort are not reflected in the bitmap.
+ *
  * \param virt              The virtual device manager instance.
  * \param address           The memory address.
  *
@@ -108,18 +821,24 @@ virtual_device_manager_device_register(
  * map.
  */
 bool virtual_device_manager_address_mapped(
-    const virtual_device_manager* virt);
+    const virtual_device_manager* virt, uint16_t address);
 
 /**
  * \brief Given an opaque reference to a device manager, perform the JEMU65C02
  * read function for the device manager.
  *
+ * The manager remembers the last device entry matched by either callback, so
+ * that repeated accesses to the same device only cost a range compare.  Memory
+ * regions and shadowed registers are accessed without a device callback.
+ *
  * \param virt              An opaque reference to the device manager instance.
  * \param addr              The address for the read operation.
  * \param byte              Pointer to receive the byte read.
  *
  * \returns a status code indicating success or failure.
  *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_UNMAPPED if no device entry services the
+ *        address, or its device has no read handler.
  *      - a non-zero error code on failure.
  */
 JEMU_SYM(status) virtual_device_manager_emu_read_callback(
@@ -129,21 +848,117 @@ JEMU_SYM(status) virtual_device_manager_emu_read_callback(
  * \brief Given an opaque reference to a device manager, perform the JEMU65C02
  * write function for the device manager.
  *
+ * The manager remembers the last device entry matched by either callback, so
+ * that repeated accesses to the same device only cost a range compare.  Memory
+ * regions and shadowed registers are accessed without a device callback.
+ *
  * \param virt              An opaque reference to the device manager instance.
  * \param addr              The address for the write operation.
  * \param byte              The byte to write.
  *
  * \returns a status code indicating success or failure.
  *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_UNMAPPED if no device entry services the
+ *        address, or its device has no write handler.
+ *      - VIRTUAL_DEVICE_ERROR_REGION_READ_ONLY if the address is in a
+ *        read-only memory region.
  *      - a non-zero error code on failure.
  */
 JEMU_SYM(status) virtual_device_manager_emu_write_callback(
     void* virt, uint16_t addr, uint8_t byte);
 
+/**
+ * \brief Read a contiguous burst of addresses from the virtual device map.
+ *
+ * The burst is split at device boundaries, and each piece is routed to its
+ * device in one call to the device's block_read handler, or byte by byte
+ * otherwise, honoring shadowed registers.  Memory regions are copied
+ * directly.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param addr              The first address of the burst.
+ * \param buffer            The buffer to receive the bytes read.
+ * \param size              The number of bytes to read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_UNMAPPED if any address in the burst is not
+ *        serviced by a device, or the burst runs past the address space.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_block_read(
+    virtual_device_manager* virt, uint16_t addr, uint8_t* buffer,
+    size_t size);
+
+/**
+ * \brief Write a contiguous burst of addresses to the virtual device map.
+ *
+ * The burst is split at device boundaries, and each piece is routed to its
+ * device in one call to the device's block_write handler, or byte by byte
+ * otherwise, honoring shadowed registers.  Memory regions are copied
+ * directly.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param addr              The first address of the burst.
+ * \param buffer            The bytes to write.
+ * \param size              The number of bytes to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_UNMAPPED if any address in the burst is not
+ *        serviced by a device, or the burst runs past the address space.
+ *      - VIRTUAL_DEVICE_ERROR_REGION_READ_ONLY if the burst writes to a
+ *        read-only memory region.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_block_write(
+    virtual_device_manager* virt, uint16_t addr, const uint8_t* buffer,
+    size_t size);
+
+/**
+ * \brief Get a host pointer for direct access to the memory region servicing
+ * an address.
+ *
+ * The emulator can read or write up to the returned number of contiguous bytes
+ * through the pointer without going through the manager.  A write pointer into
+ * a region tracked for snapshots marks its page dirty, and only reaches to the
+ * end of that page.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param addr              The address to access.
+ * \param write             true if the pointer will be written through.
+ * \param contiguous        Set to the number of bytes that can be accessed
+ *                          through the pointer, up to the end of the region,
+ *                          of its current copy, or of its memory.
+ *
+ * \returns a pointer to the memory for this address, or NULL if the address is
+ * not in a memory region, or a write was requested and the region is read-only
+ * or write-protected.
+ */
+uint8_t* virtual_device_manager_direct_access(
+    virtual_device_manager* virt, uint16_t addr, bool write,
+    size_t* contiguous);
+
+/**
+ * \brief Callback reporting a pair of overlapping device entries.
+ *
+ * \param context           The user context for this callback.
+ * \param lhs               The entry with the lower low register.
+ * \param rhs               The entry overlapping it.
+ */
+typedef void (*virtual_device_overlap_fn)(
+    void* context, const virtual_device_entry* lhs,
+    const virtual_device_entry* rhs);
+
 /**
  * \brief The sort command must be called before emulation starts, as registered
  * devices are appended to the device array in an unsorted manner.
  *
+ * This is equivalent to \ref virtual_device_manager_sort_with_overlaps with no
+ * overlap callback.
+ *
  * \param virt              The virtual machine manager instance to sort.
  *
  * \returns a status code indicating success or failure.
@@ -153,6 +968,81 @@ JEMU_SYM(status) virtual_device_manager_emu_write_callback(
 JEMU_SYM(status) virtual_device_manager_sort(
     virtual_device_manager* virt);
 
+/**
+ * \brief Sort the device entries, reporting every overlapping pair of entries.
+ *
+ * The sort does not allocate memory.  It performs a non-recursive, bottom-up
+ * merge sort of packed (low register, entry index) keys in the manager's
+ * sort_keys buffer, then permutes the device array into place, moving each
+ * entry at most once.  Each sorted entry is then checked against the entries
+ * after it that start before it ends, so every overlapping pair is reported,
+ * at a cost of one compare per entry plus one per overlap.  On failure, the
+ * entries are still left ordered by low register.
+ *
+ * \param virt              The virtual machine manager instance to sort.
+ * \param overlap           Optional callback to receive each overlap, or NULL.
+ * \param context           The user context for the overlap callback.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_OVERLAP if any entries overlap.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_manager_sort_with_overlaps(
+    virtual_device_manager* virt, virtual_device_overlap_fn overlap,
+    void* context);
+
+/**
+ * \brief Sort the device entries and build the finalized dispatch table.
+ *
+ * Once finalized, \ref virtual_device_manager_device_find resolves a register
+ * with two table loads instead of searching the device array.  The dispatch
+ * table consists of a page table with one entry per 256 byte page, which
+ * selects a byte table for that page.  Each byte table holds the device entry
+ * index plus one for each address in that page, or zero if the address is not
+ * mapped.  All unmapped pages share the first byte table, which is empty.  The
+ * page table and byte tables are a single allocation.
+ *
+ * Finalizing again rebuilds the dispatch table in place while the byte tables
+ * it needs still fit, so re-finalizing, attaching, and detaching cost no memory
+ * within the page count the table was first built for.  A table that must grow
+ * is grown in place when it is the arena's most recent allocation; otherwise a
+ * larger table is allocated, and a bump arena cannot reclaim the old one.
+ *
+ * \note Registering a device after finalization clears the finalized flag, and
+ * this function must be called again before emulation resumes.  Attaching or
+ * detaching a device keeps the manager finalized.
+ *
+ * \param virt              The virtual device manager instance to finalize.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_finalize(
+    virtual_device_manager* virt);
+
+/**
+ * \brief Make room in the dispatch table for the given number of byte tables.
+ *
+ * The current dispatch table is kept, and stays valid, whether or not this
+ * succeeds.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param table_count       The number of byte tables needed, including the
+ *                          shared empty table.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - JEMU_ERROR_OUT_OF_MEMORY if the table could not be grown.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_dispatch_reserve(
+    virtual_device_manager* virt, size_t table_count);
+
 /**
  * \brief Given a sorted virtual device manager and a register location, find a
  * device entry or NULL if no device entry was found.
@@ -0,0 +1,40 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_alloc.c
+ *
+ * \brief Allocate memory from an arena or the default allocator.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#if !defined(VIRTUAL_DEVICE_STATIC)
+# include <stdlib.h>
+#endif /*!defined(VIRTUAL_DEVICE_STATIC)*/
+
+#include "arena.h"
+
+/**
+ * \brief Allocate memory from the given arena, or from the default allocator
+ * if the arena is NULL.
+ *
+ * The default allocator is the heap, except in a static build, where it is
+ * \ref virtual_device_static_arena and the heap is never used.
+ *
+ * \param arena             The arena to allocate from, or NULL.
+ * \param size              The size of the allocation in bytes.
+ *
+ * \returns the allocation, or NULL on failure.
+ */
+void* virtual_device_alloc(virtual_device_arena* arena, size_t size)
+{
+    if (NULL == arena)
+    {
+#if defined(VIRTUAL_DEVICE_STATIC)
+        arena = &virtual_device_static_arena;
+#else
+        return malloc(size);
+#endif /*defined(VIRTUAL_DEVICE_STATIC)*/
+    }
+
+    return virtual_device_arena_alloc(arena, size);
+}
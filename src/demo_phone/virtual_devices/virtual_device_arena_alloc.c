@@ -0,0 +1,35 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_arena_alloc.c
+ *
+ * \brief Allocate memory from an arena.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "arena.h"
+
+/**
+ * \brief Allocate memory from an arena.
+ *
+ * \param arena             The arena to allocate from.
+ * \param size              The size of the allocation in bytes.
+ *
+ * \returns the aligned allocation, or NULL if the arena is exhausted.
+ */
+void* virtual_device_arena_alloc(virtual_device_arena* arena, size_t size)
+{
+    size_t aligned = VIRTUAL_DEVICE_ARENA_ALIGN(size);
+
+    /* is there enough room left in the block? */
+    if (aligned < size || aligned > arena->size - arena->offset)
+    {
+        return NULL;
+    }
+
+    /* bump the offset, remembering this allocation as the most recent. */
+    arena->last = arena->offset;
+    arena->offset += aligned;
+
+    return arena->base + arena->last;
+}
@@ -0,0 +1,65 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_arena_create.c
+ *
+ * \brief Create an arena.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "arena.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Create an arena with the given capacity.
+ *
+ * The arena is carved from the default allocator: the heap, or in a static
+ * build, \ref virtual_device_static_arena.
+ *
+ * \note On success, the caller is given ownership of the arena and must release
+ * it by calling \ref virtual_device_arena_release when it is no longer needed.
+ * Every instance created in the arena must be released first.
+ *
+ * \param arena             Pointer to the arena pointer to set to the created
+ *                          arena on success.
+ * \param size              The capacity of the arena in bytes.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_arena_create(virtual_device_arena** arena, size_t size)
+{
+    status retval;
+    virtual_device_arena* tmp = NULL;
+    size_t header = VIRTUAL_DEVICE_ARENA_ALIGN(sizeof(*tmp));
+
+    /* allocate the arena header and block together. */
+    tmp =
+        (virtual_device_arena*)virtual_device_alloc(
+            NULL, header + VIRTUAL_DEVICE_ARENA_ALIGN(size));
+    if (NULL == tmp)
+    {
+        retval = JEMU_ERROR_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    /* clear instance memory. */
+    memset(tmp, 0, sizeof(*tmp));
+
+    /* the block follows the header. */
+    tmp->base = (uint8_t*)tmp + header;
+    tmp->size = VIRTUAL_DEVICE_ARENA_ALIGN(size);
+
+    /* success. */
+    *arena = tmp;
+    retval = STATUS_SUCCESS;
+    goto done;
+
+done:
+    return retval;
+}
@@ -0,0 +1,34 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_arena_init.c
+ *
+ * \brief Initialize an arena over caller-provided storage.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "arena.h"
+
+/**
+ * \brief Initialize an arena over caller-provided storage, such as a static
+ * array.
+ *
+ * The arena does not own the storage, and must not be passed to
+ * \ref virtual_device_arena_release.
+ *
+ * \param arena             The arena to initialize.
+ * \param block             The storage to allocate from, which must be aligned
+ *                          to \ref VIRTUAL_DEVICE_ARENA_ALIGNMENT.
+ * \param size              The size of the storage in bytes.
+ */
+void virtual_device_arena_init(
+    virtual_device_arena* arena, void* block, size_t size)
+{
+    memset(arena, 0, sizeof(*arena));
+
+    /* only whole aligned allocations fit in the block. */
+    arena->base = (uint8_t*)block;
+    arena->size = size & ~((size_t)VIRTUAL_DEVICE_ARENA_ALIGNMENT - 1);
+}
@@ -0,0 +1,37 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_arena_release.c
+ *
+ * \brief Release an arena.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "arena.h"
+
+/**
+ * \brief Release an arena and every allocation made from it.
+ *
+ * \note After this call, the arena pointer and every allocation made from it
+ * are no longer valid.
+ *
+ * \param arena             The arena to release.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_arena_release(virtual_device_arena* arena)
+{
+    /* clear the used part of the block. */
+    memset(arena->base, 0, arena->offset);
+
+    /* clear and free the arena and its block. */
+    memset(arena, 0, sizeof(*arena));
+    virtual_device_free(NULL, arena);
+
+    return STATUS_SUCCESS;
+}
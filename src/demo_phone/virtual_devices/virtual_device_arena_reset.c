@@ -0,0 +1,27 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_arena_reset.c
+ *
+ * \brief Discard every allocation made from an arena.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "arena.h"
+
+/**
+ * \brief Discard every allocation made from an arena, so that it can be reused
+ * for the next board.
+ *
+ * \param arena             The arena to reset.
+ */
+void virtual_device_arena_reset(virtual_device_arena* arena)
+{
+    /* clear the used part of the block. */
+    memset(arena->base, 0, arena->offset);
+
+    arena->offset = 0;
+    arena->last = 0;
+}
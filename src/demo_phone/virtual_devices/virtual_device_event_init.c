@@ -0,0 +1,27 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_event_init.c
+ *
+ * \brief Initialize a device event.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "scheduler.h"
+
+/**
+ * \brief Initialize a device event, which is not pending.
+ *
+ * \param event             The event to initialize.
+ * \param callback          The handler to call when the event is due.
+ * \param context           The user context for the handler.
+ */
+void virtual_device_event_init(
+    virtual_device_event* event, virtual_device_event_fn callback,
+    void* context)
+{
+    event->deadline = VIRTUAL_DEVICE_SCHEDULER_NEVER;
+    event->callback = callback;
+    event->context = context;
+    event->index = VIRTUAL_DEVICE_EVENT_IDLE;
+}
@@ -0,0 +1,39 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_free.c
+ *
+ * \brief Free memory allocated from an arena or the default allocator.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#if !defined(VIRTUAL_DEVICE_STATIC)
+# include <stdlib.h>
+#endif /*!defined(VIRTUAL_DEVICE_STATIC)*/
+
+#include "arena.h"
+
+/**
+ * \brief Free memory allocated by \ref virtual_device_alloc.
+ *
+ * \param arena             The arena the memory came from, or NULL.
+ * \param ptr               The allocation to free.
+ */
+void virtual_device_free(virtual_device_arena* arena, void* ptr)
+{
+    if (NULL == arena)
+    {
+#if defined(VIRTUAL_DEVICE_STATIC)
+        arena = &virtual_device_static_arena;
+#else
+        free(ptr);
+        return;
+#endif /*defined(VIRTUAL_DEVICE_STATIC)*/
+    }
+
+    /* only the most recent allocation can be returned to the arena. */
+    if (NULL != ptr && (uint8_t*)ptr == arena->base + arena->last)
+    {
+        arena->offset = arena->last;
+    }
+}
@@ -0,0 +1,36 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_irq_connect.c
+ *
+ * \brief Connect an IRQ aggregator to the CPU's IRQ input.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "irq.h"
+
+/* emit the external definition of the inline source setter. */
+extern inline void virtual_device_irq_set(
+    virtual_device_irq* irq, uint8_t source, bool asserted);
+
+/**
+ * \brief Connect an IRQ aggregator to the CPU's IRQ input.
+ *
+ * The line is driven with the current level at once.
+ *
+ * \param irq               The aggregator.
+ * \param line              The callback driving the CPU's IRQ input, or NULL
+ *                          to disconnect it.
+ * \param context           The user context for the line.
+ */
+void virtual_device_irq_connect(
+    virtual_device_irq* irq, virtual_device_irq_line_fn line, void* context)
+{
+    irq->line = line;
+    irq->context = context;
+
+    if (NULL != line)
+    {
+        line(context, irq->asserted);
+    }
+}
@@ -0,0 +1,37 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_irq_source_add.c
+ *
+ * \brief Add an interrupt source to an IRQ aggregator.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "irq.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Add an interrupt source to an IRQ aggregator.
+ *
+ * \param irq               The aggregator.
+ * \param source            Pointer to receive the source number.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_IRQ_SOURCES if the aggregator has no room for
+ *        another source.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_irq_source_add(virtual_device_irq* irq, uint8_t* source)
+{
+    if (irq->source_count >= VIRTUAL_DEVICE_IRQ_SOURCES)
+    {
+        return VIRTUAL_DEVICE_ERROR_IRQ_SOURCES;
+    }
+
+    *source = (uint8_t)irq->source_count;
+    irq->source_count += 1;
+
+    return STATUS_SUCCESS;
+}
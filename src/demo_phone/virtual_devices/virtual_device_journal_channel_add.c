@@ -0,0 +1,56 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_journal_channel_add.c
+ *
+ * \brief Add an input channel to a journal.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "journal.h"
+#include "status.h"
+
+#if defined(VIRTUAL_DEVICE_JOURNAL)
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Add an input channel to a journal.
+ *
+ * Channels are numbered in the order they are added, and a replay must add
+ * the same channels in the same order as its recording.
+ *
+ * \param journal           The journal.
+ * \param input             The device input to deliver to.
+ * \param context           The user context for the device.
+ * \param channel           Pointer to receive the channel number.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_CHANNEL if the journal has no room for
+ *        another channel.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_journal_channel_add(
+    virtual_device_journal* journal, virtual_device_input_fn input,
+    void* context, uint8_t* channel)
+{
+    if (VIRTUAL_DEVICE_JOURNAL_CHANNELS == journal->channel_count)
+    {
+        return VIRTUAL_DEVICE_ERROR_JOURNAL_CHANNEL;
+    }
+
+    journal->channels[journal->channel_count].input = input;
+    journal->channels[journal->channel_count].context = context;
+    *channel = (uint8_t)journal->channel_count;
+    journal->channel_count += 1;
+
+    return STATUS_SUCCESS;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_journal_channel_add_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_JOURNAL)*/
@@ -0,0 +1,107 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_journal_create.c
+ *
+ * \brief Create an input journal.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "journal.h"
+#include "status.h"
+
+#if defined(VIRTUAL_DEVICE_JOURNAL)
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Create an input journal, recording to or replaying from the given
+ * stream.
+ *
+ * \param journal           Pointer to receive the journal.
+ * \param stream            The stream to record to or replay from, which the
+ *                          caller closes after releasing the journal.
+ * \param replay            true to replay the stream, false to record to it.
+ * \param cycle_source      The emulator's cycle counter.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_IO if the header could not be written.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_FORMAT if the stream to replay does not
+ *        start with a supported journal header.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_journal_create(
+    virtual_device_journal** journal, FILE* stream, bool replay,
+    const uint64_t* cycle_source)
+{
+    status retval;
+    virtual_device_journal* tmp = NULL;
+    static const uint8_t header[] = {
+        'V', 'D', 'J', 'R', VIRTUAL_DEVICE_JOURNAL_VERSION };
+    uint8_t found[sizeof(header)];
+
+    /* allocate memory for the journal. */
+    tmp = (virtual_device_journal*)malloc(sizeof(*tmp));
+    if (NULL == tmp)
+    {
+        retval = JEMU_ERROR_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    /* clear memory. */
+    memset(tmp, 0, sizeof(*tmp));
+
+    /* initialize the journal. */
+    tmp->stream = stream;
+    tmp->cycle_source = cycle_source;
+    tmp->replaying = replay;
+
+    if (replay)
+    {
+        /* check the header, and read the first record ahead. */
+        if (sizeof(found) != fread(found, 1, sizeof(found), stream)
+         || 0 != memcmp(header, found, sizeof(header)))
+        {
+            retval = VIRTUAL_DEVICE_ERROR_JOURNAL_FORMAT;
+            goto cleanup_journal;
+        }
+
+        retval = virtual_device_journal_load(tmp);
+        if (STATUS_SUCCESS != retval)
+        {
+            goto cleanup_journal;
+        }
+    }
+    else
+    {
+        /* write the header. */
+        if (sizeof(header) != fwrite(header, 1, sizeof(header), stream))
+        {
+            retval = VIRTUAL_DEVICE_ERROR_JOURNAL_IO;
+            goto cleanup_journal;
+        }
+    }
+
+    /* success. */
+    *journal = tmp;
+    retval = STATUS_SUCCESS;
+    goto done;
+
+cleanup_journal:
+    free(tmp);
+
+done:
+    return retval;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_journal_create_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_JOURNAL)*/
@@ -0,0 +1,103 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_journal_input.c
+ *
+ * \brief Deliver and record a live input.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "journal.h"
+#include "status.h"
+
+#if defined(VIRTUAL_DEVICE_JOURNAL)
+
+JEMU_IMPORT_jemu65c02;
+
+/* forward decls. */
+static bool write_varint(FILE* out, uint64_t value);
+
+/**
+ * \brief Deliver a live input through a journal, recording it at the current
+ * cycle.
+ *
+ * This must only be called from the emulator thread, between instructions.
+ *
+ * \param journal           The journal.
+ * \param channel           The channel to deliver to.
+ * \param value             The input value.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_REPLAYING if the journal is replaying;
+ *        the input is not delivered.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_CHANNEL if the channel is unknown.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_IO if the input could not be recorded.
+ *      - a non-zero error code from the device input on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_journal_input(
+    virtual_device_journal* journal, uint8_t channel, uint8_t value)
+{
+    /* a replay only sees the inputs that were recorded. */
+    if (journal->replaying)
+    {
+        return VIRTUAL_DEVICE_ERROR_JOURNAL_REPLAYING;
+    }
+
+    if (channel >= journal->channel_count)
+    {
+        return VIRTUAL_DEVICE_ERROR_JOURNAL_CHANNEL;
+    }
+
+    /* a rewound cycle counter cannot be recorded as a delta. */
+    uint64_t cycle = *journal->cycle_source;
+    if (cycle < journal->cycle)
+    {
+        return VIRTUAL_DEVICE_ERROR_JOURNAL_IO;
+    }
+
+    /* record the input before the device can act on it. */
+    if (!write_varint(journal->stream, cycle - journal->cycle)
+     || EOF == fputc(channel, journal->stream)
+     || EOF == fputc(value, journal->stream))
+    {
+        return VIRTUAL_DEVICE_ERROR_JOURNAL_IO;
+    }
+
+    journal->cycle = cycle;
+
+    return
+        journal->channels[channel].input(
+            journal->channels[channel].context, value);
+}
+
+/**
+ * \brief Write an unsigned LEB128 varint.
+ *
+ * \param out               The stream to write.
+ * \param value             The value to write.
+ *
+ * \returns true if the varint was written.
+ */
+static bool write_varint(FILE* out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        if (EOF == fputc((int)((value & 0x7F) | 0x80), out))
+        {
+            return false;
+        }
+
+        value >>= 7;
+    }
+
+    return EOF != fputc((int)value, out);
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_journal_input_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_JOURNAL)*/
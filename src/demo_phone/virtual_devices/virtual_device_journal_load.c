@@ -0,0 +1,86 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_journal_load.c
+ *
+ * \brief Read the next record of a replayed journal ahead.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "journal.h"
+#include "status.h"
+
+#if defined(VIRTUAL_DEVICE_JOURNAL)
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Read the next record of a replayed journal ahead into the journal.
+ *
+ * This is used by \ref virtual_device_journal_create and
+ * \ref virtual_device_journal_poll.
+ *
+ * \param journal           The journal, which is replaying.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success, including at the end of the journal.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_FORMAT if the record is truncated.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_journal_load(virtual_device_journal* journal)
+{
+    uint64_t delta = 0;
+    int byte;
+
+    journal->pending = false;
+
+    /* a clean end of stream ends the journal. */
+    byte = fgetc(journal->stream);
+    if (EOF == byte)
+    {
+        return STATUS_SUCCESS;
+    }
+
+    /* read the rest of the cycle delta. */
+    for (unsigned shift = 0; ; shift += 7)
+    {
+        if (shift >= 64)
+        {
+            return VIRTUAL_DEVICE_ERROR_JOURNAL_FORMAT;
+        }
+
+        delta |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            break;
+        }
+
+        byte = fgetc(journal->stream);
+        if (EOF == byte)
+        {
+            return VIRTUAL_DEVICE_ERROR_JOURNAL_FORMAT;
+        }
+    }
+
+    /* read the channel and value. */
+    int channel = fgetc(journal->stream);
+    int value = fgetc(journal->stream);
+    if (EOF == channel || EOF == value)
+    {
+        return VIRTUAL_DEVICE_ERROR_JOURNAL_FORMAT;
+    }
+
+    journal->cycle += delta;
+    journal->channel = (uint8_t)channel;
+    journal->value = (uint8_t)value;
+    journal->pending = true;
+
+    return STATUS_SUCCESS;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_journal_load_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_JOURNAL)*/
@@ -0,0 +1,38 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_journal_next_cycle.c
+ *
+ * \brief Return the cycle at which the next journaled input is due.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "journal.h"
+
+#if defined(VIRTUAL_DEVICE_JOURNAL)
+
+/**
+ * \brief Return the cycle at which the next journaled input is due.
+ *
+ * \param journal           The journal.
+ *
+ * \returns the cycle of the next input, or VIRTUAL_DEVICE_JOURNAL_NEVER when
+ * recording or at the end of the journal.
+ */
+uint64_t virtual_device_journal_next_cycle(
+    const virtual_device_journal* journal)
+{
+    if (!journal->pending)
+    {
+        return VIRTUAL_DEVICE_JOURNAL_NEVER;
+    }
+
+    return journal->cycle;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_journal_next_cycle_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_JOURNAL)*/
@@ -0,0 +1,70 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_journal_poll.c
+ *
+ * \brief Deliver the journaled inputs that are due.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "journal.h"
+#include "status.h"
+
+#if defined(VIRTUAL_DEVICE_JOURNAL)
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Deliver every journaled input that is due at the current cycle.
+ *
+ * When replaying, this must be called between instructions, at least at each
+ * cycle returned by \ref virtual_device_journal_next_cycle.  When recording,
+ * this does nothing.
+ *
+ * \param journal           The journal.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success, including at the end of the journal.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_FORMAT if the journal is truncated,
+ *        corrupt, or names a channel that was not added.
+ *      - a non-zero error code from a device input on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_journal_poll(virtual_device_journal* journal)
+{
+    status retval;
+    uint64_t cycle = *journal->cycle_source;
+
+    while (journal->pending && journal->cycle <= cycle)
+    {
+        /* the recording must have used the same channels. */
+        if (journal->channel >= journal->channel_count)
+        {
+            return VIRTUAL_DEVICE_ERROR_JOURNAL_FORMAT;
+        }
+
+        virtual_device_journal_channel* channel =
+            journal->channels + journal->channel;
+
+        retval = channel->input(channel->context, journal->value);
+        if (STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        retval = virtual_device_journal_load(journal);
+        if (STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+    }
+
+    return STATUS_SUCCESS;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_journal_poll_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_JOURNAL)*/
@@ -0,0 +1,52 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_journal_release.c
+ *
+ * \brief Flush and release an input journal.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "journal.h"
+#include "status.h"
+
+#if defined(VIRTUAL_DEVICE_JOURNAL)
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Flush and release an input journal.
+ *
+ * \param journal           The journal to release.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_JOURNAL_IO if the journal could not be written.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_journal_release(virtual_device_journal* journal)
+{
+    status retval = STATUS_SUCCESS;
+
+    /* make sure the recording reaches the stream. */
+    if (!journal->replaying && 0 != fflush(journal->stream))
+    {
+        retval = VIRTUAL_DEVICE_ERROR_JOURNAL_IO;
+    }
+
+    memset(journal, 0, sizeof(*journal));
+    free(journal);
+
+    return retval;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_journal_release_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_JOURNAL)*/
@@ -0,0 +1,29 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_address_mapped.c
+ *
+ * \brief Check whether an address is covered by the virtual device map.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "virtual_device.h"
+
+/**
+ * \brief Return true if the given address is covered by the virtual device map.
+ *
+ * This is a single bit test against the presence bitmap, which is rebuilt by
+ * \ref virtual_device_manager_sort and kept current by attach and detach.
+ * Devices registered since the last sort are not reflected in the bitmap.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param address           The memory address.
+ *
+ * \returns true if the given memory address is covered by the virtual device
+ * map.
+ */
+bool virtual_device_manager_address_mapped(
+    const virtual_device_manager* virt, uint16_t address)
+{
+    return (virt->presence[address >> 5] >> (address & 31)) & 1;
+}
@@ -0,0 +1,25 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_arena_size.c
+ *
+ * \brief Compute the arena size needed for a virtual device manager.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "virtual_device.h"
+
+/**
+ * \brief Compute the arena size needed for a virtual device manager instance.
+ *
+ * \param capacity          The number of device entries to reserve.
+ * \param pages             The number of 256 byte pages the devices will touch,
+ *                          for the finalized dispatch table.
+ *
+ * \returns the number of arena bytes needed to create and finalize a manager
+ * with these capacities.
+ */
+size_t virtual_device_manager_arena_size(size_t capacity, size_t pages)
+{
+    return VIRTUAL_DEVICE_MANAGER_ARENA_SIZE(capacity, pages);
+}
@@ -0,0 +1,160 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_block_write.c
+ *
+ * \brief Write a contiguous burst of addresses to the virtual device map.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "stats.h"
+#include "status.h"
+#include "trace_ring.h"
+#include "virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Write a contiguous burst of addresses to the virtual device map.
+ *
+ * The burst is split at device boundaries, and each piece is routed to its
+ * device in one call to the device's block_write handler, or byte by byte
+ * otherwise, honoring shadowed registers.  Memory regions are copied
+ * directly.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param addr              The first address of the burst.
+ * \param buffer            The bytes to write.
+ * \param size              The number of bytes to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_UNMAPPED if any address in the burst is not
+ *        serviced by a device, or the burst runs past the address space.
+ *      - VIRTUAL_DEVICE_ERROR_REGION_READ_ONLY if the burst writes to a
+ *        read-only memory region.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_block_write(
+    virtual_device_manager* virt, uint16_t addr, const uint8_t* buffer,
+    size_t size)
+{
+    status retval;
+    uint32_t cursor = addr;
+
+    /* the burst must fit in the address space. */
+    if (size > 0x10000 - (uint32_t)addr)
+    {
+        return VIRTUAL_DEVICE_ERROR_UNMAPPED;
+    }
+
+    while (size > 0)
+    {
+        /* find the device servicing the next address. */
+        virtual_device_entry* entry =
+            virtual_device_manager_device_find(virt, (uint16_t)cursor);
+        if (NULL == entry)
+        {
+            return VIRTUAL_DEVICE_ERROR_UNMAPPED;
+        }
+
+        /* this piece ends at the burst or the device, whichever is first. */
+        size_t piece = entry->register_high - cursor + 1;
+        if (piece > size)
+        {
+            piece = size;
+        }
+
+        /* a partially decoded device is split at the end of each copy. */
+        if (0 != entry->decode_mask)
+        {
+            size_t copy_left =
+                (size_t)entry->decode_mask + 1
+                    - virtual_device_entry_offset(entry, (uint16_t)cursor);
+            if (piece > copy_left)
+            {
+                piece = copy_left;
+            }
+        }
+
+        /* copy memory regions directly, up to the end of their memory. */
+        if (NULL != entry->memory)
+        {
+            size_t offset =
+                virtual_device_region_offset(entry, (uint16_t)cursor);
+            if (piece > entry->memory_size - offset)
+            {
+                piece = entry->memory_size - offset;
+            }
+
+            if (entry->region_flags & VIRTUAL_DEVICE_REGION_READ_ONLY)
+            {
+                return VIRTUAL_DEVICE_ERROR_REGION_READ_ONLY;
+            }
+
+            if (!(entry->region_flags & VIRTUAL_DEVICE_REGION_WRITE_PROTECTED))
+            {
+                memcpy(entry->memory + offset, buffer, piece);
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+                virtual_device_region_touch(entry, offset, piece);
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
+            }
+        }
+        /* route the piece in one call, or byte by byte. */
+        else if (NULL != entry->block_write)
+        {
+            retval =
+                entry->block_write(
+                    entry->context,
+                    virtual_device_entry_decode(entry, (uint16_t)cursor),
+                    buffer, piece);
+            if (STATUS_SUCCESS != retval)
+            {
+                return retval;
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < piece; ++i)
+            {
+                retval =
+                    virtual_device_entry_write(
+                        entry, (uint16_t)(cursor + i), buffer[i]);
+                if (STATUS_SUCCESS != retval)
+                {
+                    return retval;
+                }
+            }
+        }
+
+#if defined(VIRTUAL_DEVICE_STATS)
+        if (NULL != entry->stats)
+        {
+            virtual_device_stats_count(
+                entry, (uint16_t)cursor, piece, true);
+        }
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+        /* record each byte of the piece on the bus trace. */
+        if (NULL != virt->trace)
+        {
+            for (size_t i = 0; i < piece; ++i)
+            {
+                virtual_device_trace_push(
+                    virt->trace, (uint16_t)(cursor + i), buffer[i], true,
+                    entry->register_low);
+            }
+        }
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
+
+        cursor += piece;
+        buffer += piece;
+        size -= piece;
+    }
+
+    return STATUS_SUCCESS;
+}
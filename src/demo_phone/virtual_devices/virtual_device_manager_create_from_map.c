@@ -0,0 +1,102 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_create_from_map.c
+ *
+ * \brief Create a virtual device manager instance over a read-only device map.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "status.h"
+#include "virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Create a virtual device manager instance over a read-only device map.
+ *
+ * Only the instance itself is allocated; the device entries, register keys,
+ * presence bitmap, and dispatch tables are borrowed from the map, so a map
+ * declared const is read directly from flash.  The resulting manager can be
+ * searched and used for emulation, but registering, attaching, detaching,
+ * sorting, or finalizing fails with VIRTUAL_DEVICE_ERROR_READ_ONLY.
+ *
+ * \note On success, the caller is given ownership of the virtual device
+ * instance and must release it by calling \ref virtual_device_manager_release
+ * when it is no longer needed.  The map must outlive the instance.
+ *
+ * \param virt              Pointer to the virtual device manager instance
+ *                          pointer to set to the created instance on success.
+ * \param arena             The arena to allocate from, or NULL to use the
+ *                          default allocator.
+ * \param map               The sorted device map to use.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_INVALID_MAP if a required table is missing.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_create_from_map(
+    virtual_device_manager** virt, virtual_device_arena* arena,
+    const virtual_device_map* map)
+{
+    status retval;
+    virtual_device_manager* tmp = NULL;
+
+    /* the register keys and presence bitmap are required. */
+    if (NULL == map->presence
+     || (map->device_entries > 0
+            && (NULL == map->devices
+             || NULL == map->register_lows
+             || NULL == map->register_highs)))
+    {
+        retval = VIRTUAL_DEVICE_ERROR_INVALID_MAP;
+        goto done;
+    }
+
+    /* the byte tables must accompany the page table. */
+    if (NULL != map->dispatch_pages
+     && (NULL == map->dispatch_bytes || 0 == map->dispatch_tables))
+    {
+        retval = VIRTUAL_DEVICE_ERROR_INVALID_MAP;
+        goto done;
+    }
+
+    /* allocate memory for the instance. */
+    tmp = (virtual_device_manager*)virtual_device_alloc(arena, sizeof(*tmp));
+    if (NULL == tmp)
+    {
+        retval = JEMU_ERROR_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    /* clear instance memory. */
+    memset(tmp, 0, sizeof(*tmp));
+
+    /* borrow the map's tables.  The read_only flag guards every write, so the
+     * const qualifiers can be dropped here. */
+    tmp->arena = arena;
+    tmp->devices = (virtual_device_entry*)map->devices;
+    tmp->register_lows = (uint16_t*)map->register_lows;
+    tmp->register_highs = (uint16_t*)map->register_highs;
+    tmp->device_entries = map->device_entries;
+    tmp->max_device_entries = map->device_entries;
+    tmp->dispatch_pages = (uint16_t*)map->dispatch_pages;
+    tmp->dispatch_bytes = (uint16_t*)map->dispatch_bytes;
+    tmp->dispatch_tables = map->dispatch_tables;
+    tmp->presence = (uint32_t*)map->presence;
+    tmp->read_only = true;
+    tmp->sorted = true;
+    tmp->finalized = (NULL != map->dispatch_pages);
+
+    /* success. */
+    retval = STATUS_SUCCESS;
+    *virt = tmp;
+    goto done;
+
+done:
+    return retval;
+}
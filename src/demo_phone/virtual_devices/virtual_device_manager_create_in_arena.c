@@ -0,0 +1,146 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_create_in_arena.c
+ *
+ * \brief Create a virtual device manager instance in an arena.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Create a virtual device manager instance, carving its memory from the
+ * given arena.
+ *
+ * \note On success, the caller is given ownership of the virtual device
+ * instance and must release it by calling \ref virtual_device_manager_release
+ * when it is no longer needed.  If an arena is given, the arena must outlive
+ * the instance.
+ *
+ * \param virt              Pointer to the virtual device manager instance
+ *                          pointer to set to the created instance on success.
+ * \param arena             The arena to allocate from, or NULL to use the
+ *                          default allocator.
+ * \param capacity          The number of device entries to reserve.  With an
+ *                          arena, reserving every device up front avoids
+ *                          leaving abandoned arrays in the arena on growth.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_create_in_arena(
+    virtual_device_manager** virt, virtual_device_arena* arena,
+    size_t capacity)
+{
+    status retval;
+    virtual_device_manager* tmp = NULL;
+
+    /* the device array must be able to grow by half. */
+    if (capacity < 2)
+    {
+        capacity = 2;
+    }
+
+    /* allocate memory for the instance. */
+    tmp = (virtual_device_manager*)virtual_device_alloc(arena, sizeof(*tmp));
+    if (NULL == tmp)
+    {
+        retval = JEMU_ERROR_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    /* clear instance memory. */
+    memset(tmp, 0, sizeof(*tmp));
+
+    /* initialize instance. */
+    tmp->device_entries = 0;
+    tmp->max_device_entries = capacity;
+    tmp->sorted = true;
+    tmp->arena = arena;
+
+    /* allocate memory for the device array. */
+    tmp->devices =
+        (virtual_device_entry*)virtual_device_alloc(
+            arena, sizeof(*(tmp->devices)) * capacity);
+    if (NULL == tmp->devices)
+    {
+        retval = JEMU_ERROR_OUT_OF_MEMORY;
+        goto cleanup_tmp;
+    }
+
+    /* clear the device array. */
+    memset(tmp->devices, 0, sizeof(*(tmp->devices)) * capacity);
+
+    /* allocate memory for the low register keys. */
+    tmp->register_lows =
+        (uint16_t*)virtual_device_alloc(arena, sizeof(uint16_t) * capacity);
+    if (NULL == tmp->register_lows)
+    {
+        retval = JEMU_ERROR_OUT_OF_MEMORY;
+        goto cleanup_devices;
+    }
+
+    /* allocate memory for the high register keys. */
+    tmp->register_highs =
+        (uint16_t*)virtual_device_alloc(arena, sizeof(uint16_t) * capacity);
+    if (NULL == tmp->register_highs)
+    {
+        retval = JEMU_ERROR_OUT_OF_MEMORY;
+        goto cleanup_register_lows;
+    }
+
+    /* allocate memory for the sort keys. */
+    tmp->sort_keys =
+        (uint32_t*)virtual_device_alloc(
+            arena, sizeof(uint32_t) * 2 * capacity);
+    if (NULL == tmp->sort_keys)
+    {
+        retval = JEMU_ERROR_OUT_OF_MEMORY;
+        goto cleanup_register_highs;
+    }
+
+    /* allocate memory for the presence bitmap. */
+    tmp->presence =
+        (uint32_t*)virtual_device_alloc(
+            arena, sizeof(uint32_t) * VIRTUAL_DEVICE_PRESENCE_WORDS);
+    if (NULL == tmp->presence)
+    {
+        retval = JEMU_ERROR_OUT_OF_MEMORY;
+        goto cleanup_sort_keys;
+    }
+
+    /* no address is mapped yet. */
+    memset(tmp->presence, 0, sizeof(uint32_t) * VIRTUAL_DEVICE_PRESENCE_WORDS);
+
+    /* success. */
+    retval = STATUS_SUCCESS;
+    *virt = tmp;
+    goto done;
+
+cleanup_sort_keys:
+    virtual_device_free(arena, tmp->sort_keys);
+
+cleanup_register_highs:
+    virtual_device_free(arena, tmp->register_highs);
+
+cleanup_register_lows:
+    virtual_device_free(arena, tmp->register_lows);
+
+cleanup_devices:
+    memset(tmp->devices, 0, sizeof(*(tmp->devices)) * capacity);
+    virtual_device_free(arena, tmp->devices);
+
+cleanup_tmp:
+    memset(tmp, 0, sizeof(*tmp));
+    virtual_device_free(arena, tmp);
+
+done:
+    return retval;
+}
@@ -0,0 +1,90 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_decoded_register.c
+ *
+ * \brief Register a partially decoded device in the device manager.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "status.h"
+#include "virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/* emit the external definitions of the inline decode helpers. */
+extern inline size_t virtual_device_entry_offset(
+    const virtual_device_entry* entry, uint16_t addr);
+extern inline uint16_t virtual_device_entry_decode(
+    const virtual_device_entry* entry, uint16_t addr);
+
+/**
+ * \brief Register a partially decoded device in the virtual device manager,
+ * mirrored across a larger window.
+ *
+ * The entry describes one copy of the device, whose register_low is the base of
+ * the window, and whose range holds decode_mask + 1 registers.  The device is
+ * registered once, covering mirror_count copies, so lookups stay O(1) and
+ * the search does not grow.  Each access is decoded to the first copy before
+ * it reaches the device's handlers, shadow, or memory.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param entry             The device entry for the first copy.
+ * \param decode_mask       The address bits decoded by the device, which must
+ *                          be contiguous low bits.
+ * \param mirror_count      The number of copies of the device in the window.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_INVALID_DECODE if the mask is not contiguous low
+ *        bits, the entry's range does not match the mask, or the window runs
+ *        past the address space.
+ *      - VIRTUAL_DEVICE_ERROR_INVALID_REGION if a memory region's memory is too
+ *        small for one copy.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_decoded_register(
+    virtual_device_manager* virt, const virtual_device_entry* entry,
+    uint16_t decode_mask, size_t mirror_count)
+{
+    virtual_device_entry decoded;
+    uint32_t copy_size = (uint32_t)decode_mask + 1;
+
+    /* the mask selects a power of two registers, matching the entry. */
+    if (0 == decode_mask
+     || 0 != (decode_mask & copy_size)
+     || entry->register_high < entry->register_low
+     || (uint32_t)(entry->register_high - entry->register_low) + 1
+            != copy_size)
+    {
+        return VIRTUAL_DEVICE_ERROR_INVALID_DECODE;
+    }
+
+    /* a memory region must cover one copy, or mirror across it. */
+    if (NULL != entry->memory
+     && (0 == entry->memory_size
+      || (!(entry->region_flags & VIRTUAL_DEVICE_REGION_MIRRORED)
+            && entry->memory_size < copy_size)))
+    {
+        return VIRTUAL_DEVICE_ERROR_INVALID_REGION;
+    }
+
+    /* the mirrors must fit in the address space. */
+    if (0 == mirror_count
+     || mirror_count > (0x10000 - (uint32_t)entry->register_low) / copy_size)
+    {
+        return VIRTUAL_DEVICE_ERROR_INVALID_DECODE;
+    }
+
+    /* one entry covers every copy. */
+    memcpy(&decoded, entry, sizeof(decoded));
+    decoded.register_high =
+        (uint16_t)(entry->register_low + mirror_count * copy_size - 1);
+    decoded.decode_mask = decode_mask;
+
+    return virtual_device_manager_entry_register(virt, &decoded);
+}
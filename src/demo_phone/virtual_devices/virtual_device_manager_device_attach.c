@@ -0,0 +1,61 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_device_attach.c
+ *
+ * \brief Attach a virtual device to a sorted device manager.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Attach a device to a sorted virtual device manager, keeping the device
+ * array sorted.
+ *
+ * Unlike \ref virtual_device_manager_device_register, the new entry is placed
+ * in sorted position and only checked against its neighbors for overlap, so
+ * devices can be attached while emulation is running.  The presence bitmap is
+ * updated in place, and if the manager was finalized, the dispatch table is
+ * rebuilt.  Room for the rebuilt table is made first, so on failure the
+ * manager is left unchanged, and still finalized.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param read              The read function for the virtual device.
+ * \param write             The write function for the virtual device.
+ * \param register_low      The lowest register number in the contiguous memory
+ *                          mapped register space for this device.
+ * \param register_high     The highest register number in the contiguous memory
+ *                          mapped register space for this device.
+ * \param context           The user context for the virtual device read/write
+ *                          callbacks.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - VIRTUAL_DEVICE_ERROR_NOT_SORTED if the manager has unsorted entries.
+ *      - VIRTUAL_DEVICE_ERROR_OVERLAP if the device overlaps another device.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_device_attach(
+    virtual_device_manager* virt, JEMU_SYM(j65c02_read_fn) read,
+    JEMU_SYM(j65c02_write_fn) write, uint16_t register_low,
+    uint16_t register_high, void* context)
+{
+    virtual_device_entry entry;
+
+    /* build an entry without any of the optional fields. */
+    memset(&entry, 0, sizeof(entry));
+    entry.register_low = register_low;
+    entry.register_high = register_high;
+    entry.context = context;
+    entry.read = read;
+    entry.write = write;
+
+    return virtual_device_manager_entry_attach(virt, &entry);
+}
@@ -0,0 +1,102 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_device_detach.c
+ *
+ * \brief Detach a virtual device from a sorted device manager.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "stats.h"
+#include "status.h"
+#include "virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Detach a device from a sorted virtual device manager.
+ *
+ * The remaining entries stay sorted.  The presence bitmap is updated in place,
+ * and if the manager was finalized, the dispatch table is rebuilt.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param register_low      The lowest register number of the device to detach.
+ * \param register_high     The highest register number of the device to
+ *                          detach.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - VIRTUAL_DEVICE_ERROR_NOT_SORTED if the manager has unsorted entries.
+ *      - VIRTUAL_DEVICE_ERROR_NOT_FOUND if no device has exactly this range.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_device_detach(
+    virtual_device_manager* virt, uint16_t register_low,
+    uint16_t register_high)
+{
+    /* a borrowed device map cannot be changed. */
+    if (virt->read_only)
+    {
+        return VIRTUAL_DEVICE_ERROR_READ_ONLY;
+    }
+
+    /* lookup requires a sorted array. */
+    if (!virt->sorted)
+    {
+        return VIRTUAL_DEVICE_ERROR_NOT_SORTED;
+    }
+
+    /* find the entry servicing the low register. */
+    virtual_device_entry* entry =
+        virtual_device_manager_device_find(virt, register_low);
+    if (NULL == entry
+     || entry->register_low != register_low
+     || entry->register_high != register_high)
+    {
+        return VIRTUAL_DEVICE_ERROR_NOT_FOUND;
+    }
+
+#if defined(VIRTUAL_DEVICE_STATS)
+    /* the stats block leaves with its entry. */
+    virtual_device_stats_release(virt->arena, entry->stats);
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+    /* the dirty map leaves with its entry. */
+    virtual_device_free(virt->arena, entry->dirty);
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
+
+    /* close the gap left by this entry. */
+    size_t pos = (size_t)(entry - virt->devices);
+    memmove(
+        virt->devices + pos, virt->devices + pos + 1,
+        (virt->device_entries - pos - 1) * sizeof(virtual_device_entry));
+    memmove(
+        virt->register_lows + pos, virt->register_lows + pos + 1,
+        (virt->device_entries - pos - 1) * sizeof(uint16_t));
+    memmove(
+        virt->register_highs + pos, virt->register_highs + pos + 1,
+        (virt->device_entries - pos - 1) * sizeof(uint16_t));
+    virt->device_entries -= 1;
+    memset(virt->devices + virt->device_entries, 0, sizeof(*entry));
+
+    /* entries have moved, and this range is no longer present. */
+    virt->last_hit = NULL;
+    for (uint32_t addr = register_low; addr <= register_high; ++addr)
+    {
+        virt->presence[addr >> 5] &= ~(UINT32_C(1) << (addr & 31));
+    }
+
+    /* rebuild the dispatch table if the manager was finalized; it needs no
+     * more byte tables than the table it replaces, so this cannot fail. */
+    if (virt->finalized)
+    {
+        return virtual_device_manager_finalize(virt);
+    }
+
+    return STATUS_SUCCESS;
+}
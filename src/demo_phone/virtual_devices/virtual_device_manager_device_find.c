@@ -9,13 +9,9 @@
 
 #include <stddef.h>
 
-#include "merge_sort.h"
+#include "range_match.h"
 #include "virtual_device.h"
 
-/* forward decls. */
-static virtual_device_entry* binary_search(
-    virtual_device_entry* array, size_t entries, uint16_t reg);
-
 /**
  * \brief Given a sorted virtual device manager and a register location, find a
  * device entry or NULL if no device entry was found.
@@ -28,65 +24,42 @@ static virtual_device_entry* binary_search(
 virtual_device_entry* virtual_device_manager_device_find(
     virtual_device_manager* virt, uint16_t reg)
 {
-    return binary_search(virt->devices, virt->device_entries, reg);
-}
-
-/**
- * \brief Perform a recursive binary search for the given register value.
- *
- * \param array             The sorted array to search.
- * \param entries           The number of entries in this array.
- * \param reg               The register to search.
- *
- * \returns the virtual device entry that services this register or NULL if not
- * found.
- */
-static virtual_device_entry* binary_search(
-    virtual_device_entry* array, size_t entries, uint16_t reg)
-{
-    /* if there are no entries, there is no result to be found. */
-    if (0 == entries)
-    {
-        return NULL;
-    }
-    /* if there is only one entry, then check that entry. */
-    else if (1 == entries)
+    /* a finalized manager resolves the register through the dispatch table. */
+    if (virt->finalized)
     {
-        if (array[0].register_low <= reg && array[0].register_high >= reg)
-        {
-            return array + 0;
-        }
-        else
-        {
-            return NULL;
-        }
+        size_t table = virt->dispatch_pages[reg >> VIRTUAL_DEVICE_PAGE_SHIFT];
+        size_t offset = reg & (VIRTUAL_DEVICE_PAGE_SIZE - 1);
+        size_t idx =
+            virt->dispatch_bytes[table * VIRTUAL_DEVICE_PAGE_SIZE + offset];
+
+        return idx ? virt->devices + idx - 1 : NULL;
     }
-    /* recursive case. */
-    else
+
+    const uint16_t* lows = virt->register_lows;
+    size_t base = 0;
+    size_t count = virt->device_entries;
+
+    /* bisect the sorted low register keys down to a single match window. */
+    while (count > RANGE_MATCH_WINDOW)
     {
-        /* compute the midpoint of this array. */
-        size_t mid = midpoint(0, entries);
+        size_t half = count / 2;
 
-        /* should we search the lower range? */
-        if (reg < array[mid].register_low && mid > 0)
+        /* ranges are disjoint, so no entry below a lower low key can match. */
+        if (lows[base + half] <= reg)
         {
-            return binary_search(array, mid, reg);
+            base += half;
+            count -= half;
         }
-        /* should we search the upper range? */
-        else if (reg > array[mid].register_high && mid < entries)
-        {
-            return binary_search(array + mid, entries - mid, reg);
-        }
-        /* does this entry match? */
-        else if (
-            array[mid].register_low <= reg && array[mid].register_high >= reg)
-        {
-            return array + mid;
-        }
-        /* there are no more results to find. */
         else
         {
-            return NULL;
+            count = half;
         }
     }
+
+    /* test the remaining window of ranges at once. */
+    size_t idx =
+        range_match(
+            lows + base, virt->register_highs + base, count, reg);
+
+    return idx < count ? virt->devices + base + idx : NULL;
 }
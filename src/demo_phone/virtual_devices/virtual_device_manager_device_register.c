@@ -7,7 +7,7 @@
  * distribution for the license terms under which this software is distributed.
  */
 
-#include <stdlib.h>
+#include <string.h>
 
 #include "virtual_device.h"
 
@@ -28,6 +28,7 @@ JEMU_IMPORT_jemu65c02;
  *
  * \returns a status code indicating success or failure.
  *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
  *      - a non-zero error code on failure.
  */
 JEMU_SYM(status) FN_DECL_MUST_CHECK
@@ -36,45 +37,15 @@ virtual_device_manager_device_register(
     JEMU_SYM(j65c02_write_fn) write, uint16_t register_low,
     uint16_t register_high, void* context)
 {
-    status retval;
+    virtual_device_entry entry;
 
-    /* do we need to grow the device buffer? */
-    if (virt->device_entries == virt->max_device_entries)
-    {
-        /* calculate the new max size. */
-        size_t new_max_entries =
-            virt->max_device_entries + (virt->max_device_entries / 2);
+    /* build an entry without any of the optional fields. */
+    memset(&entry, 0, sizeof(entry));
+    entry.register_low = register_low;
+    entry.register_high = register_high;
+    entry.context = context;
+    entry.read = read;
+    entry.write = write;
 
-        /* attempt to reallocate the memory. */
-        void* tmp =
-            realloc(
-                virt->devices, new_max_entries * sizeof(virtual_device_entry));
-        if (NULL == tmp)
-        {
-            retval = JEMU_ERROR_OUT_OF_MEMORY;
-            goto done;
-        }
-
-        /* update size and pointer. */
-        virt->devices = (virtual_device_entry*)tmp;
-        virt->max_device_entries = new_max_entries;
-    }
-
-    /* get the insert index and increment the number of device entries. */
-    size_t idx = virt->device_entries;
-    virt->device_entries += 1;
-
-    /* set the values for this entry. */
-    virt->devices[idx].register_low = register_low;
-    virt->devices[idx].register_high = register_high;
-    virt->devices[idx].context = context;
-    virt->devices[idx].read = read;
-    virt->devices[idx].write = write;
-
-    /* success. */
-    retval = STATUS_SUCCESS;
-    goto done;
-
-done:
-    return retval;
+    return virtual_device_manager_entry_register(virt, &entry);
 }
@@ -0,0 +1,88 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_direct_access.c
+ *
+ * \brief Get a host pointer into a memory region.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "virtual_device.h"
+
+/* emit the external definition of the inline region offset helper. */
+extern inline size_t virtual_device_region_offset(
+    const virtual_device_entry* entry, uint16_t addr);
+
+/**
+ * \brief Get a host pointer for direct access to the memory region servicing
+ * an address.
+ *
+ * The emulator can read or write up to the returned number of contiguous bytes
+ * through the pointer without going through the manager.  A write pointer into
+ * a region tracked for snapshots marks its page dirty, and only reaches to the
+ * end of that page.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param addr              The address to access.
+ * \param write             true if the pointer will be written through.
+ * \param contiguous        Set to the number of bytes that can be accessed
+ *                          through the pointer, up to the end of the region,
+ *                          of its current copy, or of its memory.
+ *
+ * \returns a pointer to the memory for this address, or NULL if the address is
+ * not in a memory region, or a write was requested and the region is read-only
+ * or write-protected.
+ */
+uint8_t* virtual_device_manager_direct_access(
+    virtual_device_manager* virt, uint16_t addr, bool write,
+    size_t* contiguous)
+{
+    virtual_device_entry* entry =
+        virtual_device_manager_device_find(virt, addr);
+
+    /* only memory regions can be accessed directly. */
+    if (NULL == entry || NULL == entry->memory)
+    {
+        return NULL;
+    }
+
+    /* read-only and write-protected regions hand out read pointers only. */
+    if (write
+     && (entry->region_flags
+            & (VIRTUAL_DEVICE_REGION_READ_ONLY
+                | VIRTUAL_DEVICE_REGION_WRITE_PROTECTED)))
+    {
+        return NULL;
+    }
+
+    /* the run ends at the end of the range or of the memory. */
+    size_t offset = virtual_device_region_offset(entry, addr);
+    size_t range_left = (size_t)(entry->register_high - addr) + 1;
+    if (0 != entry->decode_mask)
+    {
+        size_t copy_left =
+            (size_t)entry->decode_mask + 1
+                - virtual_device_entry_offset(entry, addr);
+        range_left = range_left < copy_left ? range_left : copy_left;
+    }
+    size_t memory_left = entry->memory_size - offset;
+    *contiguous = range_left < memory_left ? range_left : memory_left;
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+    /* a tracked write pointer only covers the page it marks dirty. */
+    if (write && NULL != entry->dirty)
+    {
+        size_t page_left =
+            VIRTUAL_DEVICE_PAGE_SIZE
+                - (offset & (VIRTUAL_DEVICE_PAGE_SIZE - 1));
+        if (*contiguous > page_left)
+        {
+            *contiguous = page_left;
+        }
+
+        virtual_device_region_touch(entry, offset, 1);
+    }
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
+
+    return entry->memory + offset;
+}
@@ -0,0 +1,89 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_dispatch_reserve.c
+ *
+ * \brief Make room in the dispatch table for more byte tables.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "status.h"
+#include "virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Make room in the dispatch table for the given number of byte tables.
+ *
+ * The current dispatch table is kept, and stays valid, whether or not this
+ * succeeds.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param table_count       The number of byte tables needed, including the
+ *                          shared empty table.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - JEMU_ERROR_OUT_OF_MEMORY if the table could not be grown.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_dispatch_reserve(
+    virtual_device_manager* virt, size_t table_count)
+{
+    uint16_t* tables;
+
+#if defined(VIRTUAL_DEVICE_STATIC)
+    /* the static pool has room for one table covering the whole page budget,
+     * so take all of it at once, and hot-plugging never allocates again. */
+    if (NULL == virt->arena
+     && table_count < VIRTUAL_DEVICE_STATIC_MAX_PAGES + 1)
+    {
+        table_count = VIRTUAL_DEVICE_STATIC_MAX_PAGES + 1;
+    }
+
+    /* going past the page budget would take memory meant for devices. */
+    if (NULL == virt->arena
+     && table_count > VIRTUAL_DEVICE_STATIC_MAX_PAGES + 1)
+    {
+        return JEMU_ERROR_OUT_OF_MEMORY;
+    }
+#endif /*defined(VIRTUAL_DEVICE_STATIC)*/
+
+    /* the table is rebuilt in place while it fits. */
+    if (table_count <= virt->dispatch_capacity)
+    {
+        return STATUS_SUCCESS;
+    }
+
+    size_t new_size =
+        (VIRTUAL_DEVICE_PAGE_COUNT + table_count * VIRTUAL_DEVICE_PAGE_SIZE)
+            * sizeof(*tables);
+
+    if (NULL == virt->dispatch_pages)
+    {
+        tables = (uint16_t*)virtual_device_alloc(virt->arena, new_size);
+    }
+    else
+    {
+        /* the old contents come along, so lookups keep working. */
+        size_t old_size =
+            (VIRTUAL_DEVICE_PAGE_COUNT
+                + virt->dispatch_capacity * VIRTUAL_DEVICE_PAGE_SIZE)
+                    * sizeof(*tables);
+
+        tables =
+            (uint16_t*)virtual_device_realloc(
+                virt->arena, virt->dispatch_pages, old_size, new_size);
+    }
+
+    if (NULL == tables)
+    {
+        return JEMU_ERROR_OUT_OF_MEMORY;
+    }
+
+    virt->dispatch_pages = tables;
+    virt->dispatch_bytes = tables + VIRTUAL_DEVICE_PAGE_COUNT;
+    virt->dispatch_capacity = table_count;
+
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,83 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_emu_write_callback.c
+ *
+ * \brief Dispatch an emulator write to the device servicing the address.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "stats.h"
+#include "status.h"
+#include "trace_ring.h"
+#include "virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/* emit the external definition of the inline entry write helper. */
+extern inline JEMU_SYM(status) virtual_device_entry_write(
+    const virtual_device_entry* entry, uint16_t addr, uint8_t byte);
+
+/**
+ * \brief Given an opaque reference to a device manager, perform the JEMU65C02
+ * write function for the device manager.
+ *
+ * The manager remembers the last device entry matched by either callback, so
+ * that repeated accesses to the same device only cost a range compare.  Memory
+ * regions and shadowed registers are accessed without a device callback.
+ *
+ * \param virt              An opaque reference to the device manager instance.
+ * \param addr              The address for the write operation.
+ * \param byte              The byte to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_UNMAPPED if no device entry services the
+ *        address, or its device has no write handler.
+ *      - VIRTUAL_DEVICE_ERROR_REGION_READ_ONLY if the address is in a
+ *        read-only memory region.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_manager_emu_write_callback(
+    void* virt, uint16_t addr, uint8_t byte)
+{
+    virtual_device_manager* manager = (virtual_device_manager*)virt;
+    virtual_device_entry* entry = manager->last_hit;
+    status retval;
+
+    /* if the last matched entry doesn't service this address, look it up. */
+    if (NULL == entry
+     || addr < entry->register_low || addr > entry->register_high)
+    {
+        entry = virtual_device_manager_device_find(manager, addr);
+        if (NULL == entry)
+        {
+            return VIRTUAL_DEVICE_ERROR_UNMAPPED;
+        }
+
+        manager->last_hit = entry;
+    }
+
+#if defined(VIRTUAL_DEVICE_STATS)
+    /* counted entries take the instrumented path. */
+    if (NULL != entry->stats)
+    {
+        retval = virtual_device_stats_write(entry, addr, byte);
+    }
+    else
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
+    {
+        retval = virtual_device_entry_write(entry, addr, byte);
+    }
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+    /* record the access on the bus trace. */
+    if (NULL != manager->trace && STATUS_SUCCESS == retval)
+    {
+        virtual_device_trace_push(
+            manager->trace, addr, byte, true, entry->register_low);
+    }
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
+
+    return retval;
+}
@@ -0,0 +1,200 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_entry_attach.c
+ *
+ * \brief Attach a virtual device entry to a sorted device manager.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "merge_sort.h"
+#include "status.h"
+#include "virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/* forward decls. */
+static size_t insert_position(
+    const uint16_t* register_lows, size_t entries, uint16_t register_low);
+
+/**
+ * \brief Attach a device entry to a sorted virtual device manager, keeping the
+ * device array sorted.
+ *
+ * This is \ref virtual_device_manager_device_attach for a whole entry, so that
+ * optional fields, such as the block transfer handlers, are attached too.  On
+ * failure, the manager is left unchanged.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param entry             The device entry to attach.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - VIRTUAL_DEVICE_ERROR_NOT_SORTED if the manager has unsorted entries.
+ *      - VIRTUAL_DEVICE_ERROR_OVERLAP if the device overlaps another device.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_entry_attach(
+    virtual_device_manager* virt, const virtual_device_entry* entry)
+{
+    status retval;
+    bool finalized = virt->finalized;
+    uint16_t register_low = entry->register_low;
+    uint16_t register_high = entry->register_high;
+
+    /* a borrowed device map cannot be changed. */
+    if (virt->read_only)
+    {
+        retval = VIRTUAL_DEVICE_ERROR_READ_ONLY;
+        goto done;
+    }
+
+    /* placement by binary search only works on a sorted array. */
+    if (!virt->sorted)
+    {
+        retval = VIRTUAL_DEVICE_ERROR_NOT_SORTED;
+        goto done;
+    }
+
+    /* find where this entry belongs. */
+    size_t pos =
+        insert_position(
+            virt->register_lows, virt->device_entries, register_low);
+
+    /* the previous entry must be strictly less than this entry. */
+    if (pos > 0
+     && COMPARE_RESULT_LESSER
+            != register_range_compare(
+                    virt->register_lows[pos - 1],
+                    virt->register_highs[pos - 1],
+                    register_low, register_high))
+    {
+        retval = VIRTUAL_DEVICE_ERROR_OVERLAP;
+        goto done;
+    }
+
+    /* the next entry must be strictly greater than this entry. */
+    if (pos < virt->device_entries
+     && COMPARE_RESULT_GREATER
+            != register_range_compare(
+                    virt->register_lows[pos], virt->register_highs[pos],
+                    register_low, register_high))
+    {
+        retval = VIRTUAL_DEVICE_ERROR_OVERLAP;
+        goto done;
+    }
+
+    /* a finalized manager needs room for the new table before anything
+     * changes, so that a failure leaves it as it was. */
+    if (finalized)
+    {
+        size_t table_count = virt->dispatch_tables;
+
+        if (virt->device_entries + 1 >= UINT16_MAX)
+        {
+            retval = VIRTUAL_DEVICE_ERROR_TOO_MANY_ENTRIES;
+            goto done;
+        }
+
+        for (size_t page = register_low >> VIRTUAL_DEVICE_PAGE_SHIFT;
+             page <= (size_t)(register_high >> VIRTUAL_DEVICE_PAGE_SHIFT);
+             ++page)
+        {
+            if (0 == virt->dispatch_pages[page])
+            {
+                table_count += 1;
+            }
+        }
+
+        retval = virtual_device_manager_dispatch_reserve(virt, table_count);
+        if (STATUS_SUCCESS != retval)
+        {
+            goto done;
+        }
+    }
+
+    /* append the entry, growing the device array if needed. */
+    retval = virtual_device_manager_entry_register(virt, entry);
+    if (STATUS_SUCCESS != retval)
+    {
+        goto done;
+    }
+
+    /* rotate the appended entry into its sorted position. */
+    size_t last = virt->device_entries - 1;
+    if (pos < last)
+    {
+        virtual_device_entry tmp;
+        memcpy(&tmp, virt->devices + last, sizeof(tmp));
+        memmove(
+            virt->devices + pos + 1, virt->devices + pos,
+            (last - pos) * sizeof(virtual_device_entry));
+        memcpy(virt->devices + pos, &tmp, sizeof(tmp));
+
+        memmove(
+            virt->register_lows + pos + 1, virt->register_lows + pos,
+            (last - pos) * sizeof(uint16_t));
+        memmove(
+            virt->register_highs + pos + 1, virt->register_highs + pos,
+            (last - pos) * sizeof(uint16_t));
+        virt->register_lows[pos] = register_low;
+        virt->register_highs[pos] = register_high;
+    }
+
+    /* the array is still sorted; mark the new range as present. */
+    virt->sorted = true;
+    for (uint32_t addr = register_low; addr <= register_high; ++addr)
+    {
+        virt->presence[addr >> 5] |= UINT32_C(1) << (addr & 31);
+    }
+
+    /* rebuild the dispatch table in the room reserved above. */
+    if (finalized)
+    {
+        retval = virtual_device_manager_finalize(virt);
+        goto done;
+    }
+
+    /* success. */
+    retval = STATUS_SUCCESS;
+    goto done;
+
+done:
+    return retval;
+}
+
+/**
+ * \brief Find the index of the first entry whose low register is greater than
+ * the given register.
+ *
+ * \param register_lows     The sorted low register keys to search.
+ * \param entries           The number of entries in this array.
+ * \param register_low      The low register of the entry to insert.
+ *
+ * \returns the insert position for an entry starting at this register.
+ */
+static size_t insert_position(
+    const uint16_t* register_lows, size_t entries, uint16_t register_low)
+{
+    size_t lower = 0, upper = entries;
+
+    while (lower < upper)
+    {
+        size_t mid = midpoint(lower, upper);
+
+        if (register_lows[mid] <= register_low)
+        {
+            lower = mid + 1;
+        }
+        else
+        {
+            upper = mid;
+        }
+    }
+
+    return lower;
+}
@@ -0,0 +1,165 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_entry_register.c
+ *
+ * \brief Register a virtual device entry in the device manager.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "stats.h"
+#include "status.h"
+#include "virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Register a device entry in the virtual device manager.
+ *
+ * The entry is copied, including its optional fields, such as the block
+ * transfer handlers.  If statistics are enabled, the copy is given its own
+ * stats block.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param entry             The device entry to register.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_entry_register(
+    virtual_device_manager* virt, const virtual_device_entry* entry)
+{
+    status retval;
+
+    /* a borrowed device map cannot be changed. */
+    if (virt->read_only)
+    {
+        retval = VIRTUAL_DEVICE_ERROR_READ_ONLY;
+        goto done;
+    }
+
+    /* do we need to grow the device buffer? */
+    if (virt->device_entries == virt->max_device_entries)
+    {
+#if defined(VIRTUAL_DEVICE_STATIC)
+        /* the static pool has no room budgeted for a larger device array, and
+         * growing one would take memory meant for device instances. */
+        if (NULL == virt->arena
+         && virt->max_device_entries >= VIRTUAL_DEVICE_STATIC_MAX_DEVICES)
+        {
+            retval = JEMU_ERROR_OUT_OF_MEMORY;
+            goto done;
+        }
+#endif /*defined(VIRTUAL_DEVICE_STATIC)*/
+
+        /* calculate the new max size. */
+        size_t new_max_entries =
+            virt->max_device_entries + (virt->max_device_entries / 2);
+
+        /* attempt to reallocate the memory. */
+        void* tmp =
+            virtual_device_realloc(
+                virt->arena, virt->devices,
+                virt->max_device_entries * sizeof(virtual_device_entry),
+                new_max_entries * sizeof(virtual_device_entry));
+        if (NULL == tmp)
+        {
+            retval = JEMU_ERROR_OUT_OF_MEMORY;
+            goto done;
+        }
+
+        /* update pointer. */
+        virt->devices = (virtual_device_entry*)tmp;
+
+        /* attempt to reallocate the low register keys. */
+        tmp =
+            virtual_device_realloc(
+                virt->arena, virt->register_lows,
+                virt->max_device_entries * sizeof(uint16_t),
+                new_max_entries * sizeof(uint16_t));
+        if (NULL == tmp)
+        {
+            retval = JEMU_ERROR_OUT_OF_MEMORY;
+            goto done;
+        }
+
+        /* update pointer. */
+        virt->register_lows = (uint16_t*)tmp;
+
+        /* attempt to reallocate the high register keys. */
+        tmp =
+            virtual_device_realloc(
+                virt->arena, virt->register_highs,
+                virt->max_device_entries * sizeof(uint16_t),
+                new_max_entries * sizeof(uint16_t));
+        if (NULL == tmp)
+        {
+            retval = JEMU_ERROR_OUT_OF_MEMORY;
+            goto done;
+        }
+
+        /* update pointer. */
+        virt->register_highs = (uint16_t*)tmp;
+
+        /* attempt to reallocate the sort keys. */
+        tmp =
+            virtual_device_realloc(
+                virt->arena, virt->sort_keys,
+                2 * virt->max_device_entries * sizeof(uint32_t),
+                2 * new_max_entries * sizeof(uint32_t));
+        if (NULL == tmp)
+        {
+            retval = JEMU_ERROR_OUT_OF_MEMORY;
+            goto done;
+        }
+
+        /* update pointer and size. */
+        virt->sort_keys = (uint32_t*)tmp;
+        virt->max_device_entries = new_max_entries;
+    }
+
+#if defined(VIRTUAL_DEVICE_STATS)
+    /* the manager owns the stats blocks of its entries. */
+    virtual_device_stats* stats = NULL;
+    if (virt->stats_enabled)
+    {
+        retval = virtual_device_stats_create(&stats, virt->arena, entry);
+        if (STATUS_SUCCESS != retval)
+        {
+            goto done;
+        }
+    }
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
+
+    /* get the insert index and increment the number of device entries. */
+    size_t idx = virt->device_entries;
+    virt->device_entries += 1;
+
+    /* copy this entry. */
+    memcpy(virt->devices + idx, entry, sizeof(*entry));
+    virt->register_lows[idx] = entry->register_low;
+    virt->register_highs[idx] = entry->register_high;
+#if defined(VIRTUAL_DEVICE_STATS)
+    virt->devices[idx].stats = stats;
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+    virt->devices[idx].dirty = NULL;
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
+
+    /* the dispatch table and hit cache no longer reflect the device array. */
+    virt->sorted = false;
+    virt->finalized = false;
+    virt->last_hit = NULL;
+
+    /* success. */
+    retval = STATUS_SUCCESS;
+    goto done;
+
+done:
+    return retval;
+}
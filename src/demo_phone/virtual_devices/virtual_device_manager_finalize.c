@@ -0,0 +1,132 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_finalize.c
+ *
+ * \brief Sort the virtual device entries and build the dispatch table.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "status.h"
+#include "virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Sort the device entries and build the finalized dispatch table.
+ *
+ * Once finalized, \ref virtual_device_manager_device_find resolves a register
+ * with two table loads instead of searching the device array.  The dispatch
+ * table consists of a page table with one entry per 256 byte page, which
+ * selects a byte table for that page.  Each byte table holds the device entry
+ * index plus one for each address in that page, or zero if the address is not
+ * mapped.  All unmapped pages share the first byte table, which is empty.  The
+ * page table and byte tables are a single allocation.
+ *
+ * Finalizing again rebuilds the dispatch table in place while the byte tables
+ * it needs still fit, so re-finalizing, attaching, and detaching cost no memory
+ * within the page count the table was first built for.  A table that must grow
+ * is grown in place when it is the arena's most recent allocation; otherwise a
+ * larger table is allocated, and a bump arena cannot reclaim the old one.
+ *
+ * \note Registering a device after finalization clears the finalized flag, and
+ * this function must be called again before emulation resumes.  Attaching or
+ * detaching a device keeps the manager finalized.
+ *
+ * \param virt              The virtual device manager instance to finalize.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_finalize(
+    virtual_device_manager* virt)
+{
+    status retval;
+    size_t table_count = 1;
+    uint16_t pages[VIRTUAL_DEVICE_PAGE_COUNT];
+
+    /* a borrowed device map is already final. */
+    if (virt->read_only)
+    {
+        retval = VIRTUAL_DEVICE_ERROR_READ_ONLY;
+        goto done;
+    }
+
+    /* the entries must be sorted and free of overlaps. */
+    if (!virt->sorted)
+    {
+        retval = virtual_device_manager_sort(virt);
+        if (STATUS_SUCCESS != retval)
+        {
+            goto done;
+        }
+    }
+
+    /* each entry index plus one must fit in a byte table slot. */
+    if (virt->device_entries >= UINT16_MAX)
+    {
+        retval = VIRTUAL_DEVICE_ERROR_TOO_MANY_ENTRIES;
+        goto done;
+    }
+
+    /* assign a byte table to each page touched by a device entry. */
+    memset(pages, 0, sizeof(pages));
+    for (size_t i = 0; i < virt->device_entries; ++i)
+    {
+        size_t first =
+            virt->devices[i].register_low >> VIRTUAL_DEVICE_PAGE_SHIFT;
+        size_t last =
+            virt->devices[i].register_high >> VIRTUAL_DEVICE_PAGE_SHIFT;
+
+        for (size_t page = first; page <= last; ++page)
+        {
+            if (0 == pages[page])
+            {
+                pages[page] = (uint16_t)table_count;
+                table_count += 1;
+            }
+        }
+    }
+
+    /* make room for the byte tables, including the shared empty table. */
+    retval = virtual_device_manager_dispatch_reserve(virt, table_count);
+    if (STATUS_SUCCESS != retval)
+    {
+        goto done;
+    }
+
+    /* the byte tables follow the page table. */
+    uint16_t* bytes = virt->dispatch_bytes;
+    memcpy(virt->dispatch_pages, pages, sizeof(pages));
+    memset(bytes, 0, table_count * VIRTUAL_DEVICE_PAGE_SIZE * sizeof(*bytes));
+
+    /* fill in the entry index for each register covered by a device. */
+    for (size_t i = 0; i < virt->device_entries; ++i)
+    {
+        for (uint32_t reg = virt->devices[i].register_low;
+             reg <= virt->devices[i].register_high; ++reg)
+        {
+            size_t page = reg >> VIRTUAL_DEVICE_PAGE_SHIFT;
+            size_t offset = reg & (VIRTUAL_DEVICE_PAGE_SIZE - 1);
+
+            bytes[pages[page] * VIRTUAL_DEVICE_PAGE_SIZE + offset] =
+                (uint16_t)(i + 1);
+        }
+    }
+
+    /* the rebuilt table is in use. */
+    virt->dispatch_tables = table_count;
+    virt->finalized = true;
+
+    /* success. */
+    retval = STATUS_SUCCESS;
+    goto done;
+
+done:
+    return retval;
+}
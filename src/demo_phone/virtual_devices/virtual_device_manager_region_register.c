@@ -0,0 +1,71 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_region_register.c
+ *
+ * \brief Register a memory region in the device manager.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "status.h"
+#include "virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Register a memory region in the virtual device manager.
+ *
+ * Reads and writes to the region are serviced directly from memory, without a
+ * device callback, and \ref virtual_device_manager_direct_access hands out
+ * pointers into it.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param register_low      The lowest address of the region.
+ * \param register_high     The highest address of the region.
+ * \param memory            The host memory backing the region, which must
+ *                          outlive the manager.  A read-only region may point
+ *                          at const memory cast to non-const; it is never
+ *                          written.
+ * \param memory_size       The size of the host memory.  This must cover the
+ *                          register range, unless the region is mirrored.
+ * \param region_flags      Any of VIRTUAL_DEVICE_REGION_READ_ONLY,
+ *                          VIRTUAL_DEVICE_REGION_WRITE_PROTECTED, and
+ *                          VIRTUAL_DEVICE_REGION_MIRRORED.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_INVALID_REGION if the memory is too small.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_region_register(
+    virtual_device_manager* virt, uint16_t register_low,
+    uint16_t register_high, uint8_t* memory, size_t memory_size,
+    uint32_t region_flags)
+{
+    virtual_device_entry entry;
+    size_t range = (size_t)register_high - register_low + 1;
+
+    /* the memory must cover the range, or at least one mirror of it. */
+    if (NULL == memory
+     || register_high < register_low
+     || 0 == memory_size
+     || (!(region_flags & VIRTUAL_DEVICE_REGION_MIRRORED)
+            && memory_size < range))
+    {
+        return VIRTUAL_DEVICE_ERROR_INVALID_REGION;
+    }
+
+    /* build the region entry. */
+    memset(&entry, 0, sizeof(entry));
+    entry.register_low = register_low;
+    entry.register_high = register_high;
+    entry.memory = memory;
+    entry.memory_size = memory_size;
+    entry.region_flags = region_flags;
+
+    return virtual_device_manager_entry_register(virt, &entry);
+}
@@ -7,9 +7,9 @@
  * distribution for the license terms under which this software is distributed.
  */
 
-#include <stdlib.h>
 #include <string.h>
 
+#include "stats.h"
 #include "virtual_device.h"
 
 /**
@@ -26,18 +26,60 @@
 JEMU_SYM(status) FN_DECL_MUST_CHECK
 virtual_device_manager_release(virtual_device_manager* virt)
 {
+    virtual_device_arena* arena = virt->arena;
+
+    /* the tables of a read-only manager are borrowed from its map. */
+    if (virt->read_only)
+    {
+        goto release_instance;
+    }
+
     /* if devices is set, clear and free it. */
     if (NULL != virt->devices)
     {
+#if defined(VIRTUAL_DEVICE_STATS)
+        /* free the stats blocks owned by the entries. */
+        for (size_t i = 0; i < virt->device_entries; ++i)
+        {
+            virtual_device_stats_release(virt->arena, virt->devices[i].stats);
+        }
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+        /* free the dirty maps owned by the entries. */
+        for (size_t i = 0; i < virt->device_entries; ++i)
+        {
+            virtual_device_free(virt->arena, virt->devices[i].dirty);
+        }
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
+
         memset(
             virt->devices, 0,
             sizeof(*(virt->devices)) * virt->max_device_entries);
-        free(virt->devices);
+        virtual_device_free(virt->arena, virt->devices);
+    }
+
+    /* free the register keys and the presence bitmap. */
+    virtual_device_free(virt->arena, virt->register_lows);
+    virtual_device_free(virt->arena, virt->register_highs);
+    virtual_device_free(virt->arena, virt->sort_keys);
+    virtual_device_free(virt->arena, virt->presence);
+
+    /* if the dispatch table is set, clear and free it. */
+    if (NULL != virt->dispatch_pages)
+    {
+        memset(
+            virt->dispatch_pages, 0,
+            (VIRTUAL_DEVICE_PAGE_COUNT
+                + virt->dispatch_capacity * VIRTUAL_DEVICE_PAGE_SIZE)
+                    * sizeof(*(virt->dispatch_pages)));
+        virtual_device_free(virt->arena, virt->dispatch_pages);
     }
 
+release_instance:
     /* clear and free memory for this instance. */
     memset(virt, 0, sizeof(*virt));
-    free(virt);
+    virtual_device_free(arena, virt);
 
     return STATUS_SUCCESS;
 }
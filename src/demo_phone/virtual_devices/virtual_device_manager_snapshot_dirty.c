@@ -0,0 +1,51 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_snapshot_dirty.c
+ *
+ * \brief Count the memory pages written since the last snapshot.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "snapshot.h"
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+
+/**
+ * \brief Count the memory pages written since the last snapshot was saved or
+ * restored.
+ *
+ * \param virt              The virtual device manager instance.
+ *
+ * \returns the number of dirty pages in the manager's tracked regions.
+ */
+size_t virtual_device_manager_snapshot_dirty(
+    const virtual_device_manager* virt)
+{
+    size_t dirty = 0;
+
+    for (size_t i = 0; i < virt->device_entries; ++i)
+    {
+        const virtual_device_entry* entry = virt->devices + i;
+
+        if (NULL == entry->dirty)
+        {
+            continue;
+        }
+
+        size_t pages = VIRTUAL_DEVICE_SNAPSHOT_PAGES(entry->memory_size);
+        for (size_t page = 0; page < pages; ++page)
+        {
+            dirty += entry->dirty[page];
+        }
+    }
+
+    return dirty;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_manager_snapshot_dirty_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
@@ -0,0 +1,197 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_snapshot_restore.c
+ *
+ * \brief Restore the manager's memory regions and device states.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "snapshot.h"
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+
+JEMU_IMPORT_jemu65c02;
+
+/* forward decls. */
+static bool snapshot_matches(
+    const virtual_device_manager* virt,
+    const virtual_device_snapshot* snapshot);
+static void restore_pages(
+    const virtual_device_entry* entry,
+    const virtual_device_snapshot_entry* saved);
+
+/**
+ * \brief Restore the manager's memory regions and device states from a
+ * snapshot.
+ *
+ * If the manager was last saved to or restored from this snapshot, only the
+ * pages written since are copied.  Dirty tracking restarts from this snapshot.
+ * Once every entry is restored, each entry's restore handler is called, so
+ * that devices post their scheduler events and drive their outputs again.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param snapshot          The snapshot to restore.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - VIRTUAL_DEVICE_ERROR_SNAPSHOT_MISMATCH if the snapshot does not match
+ *        the manager's device entries or the layouts of their states; nothing
+ *        is restored.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_snapshot_restore(
+    virtual_device_manager* virt, virtual_device_snapshot* snapshot)
+{
+    status retval;
+
+    /* the entries of a borrowed device map cannot be tracked. */
+    if (virt->read_only)
+    {
+        return VIRTUAL_DEVICE_ERROR_READ_ONLY;
+    }
+
+    if (!snapshot_matches(virt, snapshot))
+    {
+        return VIRTUAL_DEVICE_ERROR_SNAPSHOT_MISMATCH;
+    }
+
+    /* dirty pages are only meaningful against the snapshot they track. */
+    bool tracking =
+        snapshot->owner == virt && snapshot->serial == virt->snapshot_serial;
+
+    /* a region without a dirty map starts out all dirty. */
+    retval = virtual_device_manager_snapshot_track(virt);
+    if (STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    for (size_t i = 0; i < virt->device_entries; ++i)
+    {
+        const virtual_device_entry* entry = virt->devices + i;
+        const virtual_device_snapshot_entry* saved = snapshot->entries + i;
+
+        if (saved->memory_size > 0)
+        {
+            if (tracking)
+            {
+                restore_pages(entry, saved);
+            }
+            else
+            {
+                memcpy(entry->memory, saved->memory, saved->memory_size);
+            }
+
+            memset(
+                entry->dirty, 0,
+                VIRTUAL_DEVICE_SNAPSHOT_PAGES(saved->memory_size));
+        }
+
+        if (saved->state_size > 0)
+        {
+            memcpy(entry->state, saved->state, saved->state_size);
+        }
+    }
+
+    /* track from this snapshot. */
+    snapshot->owner = virt;
+    virt->snapshot_serial += 1;
+    snapshot->serial = virt->snapshot_serial;
+
+    /* devices rebuild what lives outside their state blocks. */
+    for (size_t i = 0; i < virt->device_entries; ++i)
+    {
+        const virtual_device_entry* entry = virt->devices + i;
+
+        if (NULL != entry->restore)
+        {
+            retval = entry->restore(entry->context);
+            if (STATUS_SUCCESS != retval)
+            {
+                return retval;
+            }
+        }
+    }
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief Check that a snapshot describes the manager's device entries.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param snapshot          The snapshot to check.
+ *
+ * \returns true if every entry matches, in order.
+ */
+static bool snapshot_matches(
+    const virtual_device_manager* virt,
+    const virtual_device_snapshot* snapshot)
+{
+    if (snapshot->device_entries != virt->device_entries)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < virt->device_entries; ++i)
+    {
+        const virtual_device_entry* entry = virt->devices + i;
+        const virtual_device_snapshot_entry* saved = snapshot->entries + i;
+
+        if (saved->register_low != entry->register_low
+         || saved->register_high != entry->register_high
+         || saved->decode_mask != entry->decode_mask
+         || saved->region_flags != entry->region_flags
+         || saved->memory_size != virtual_device_snapshot_saved_size(entry)
+         || saved->state_size != entry->state_size
+         || saved->state_version != entry->state_version)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * \brief Copy the dirty pages of a region back from its saved memory.
+ *
+ * \param entry             The memory region entry, which has a dirty map.
+ * \param saved             The region's saved state.
+ */
+static void restore_pages(
+    const virtual_device_entry* entry,
+    const virtual_device_snapshot_entry* saved)
+{
+    size_t pages = VIRTUAL_DEVICE_SNAPSHOT_PAGES(saved->memory_size);
+
+    for (size_t page = 0; page < pages; ++page)
+    {
+        if (!entry->dirty[page])
+        {
+            continue;
+        }
+
+        /* the last page may be short. */
+        size_t offset = page << VIRTUAL_DEVICE_PAGE_SHIFT;
+        size_t size = saved->memory_size - offset;
+        if (size > VIRTUAL_DEVICE_PAGE_SIZE)
+        {
+            size = VIRTUAL_DEVICE_PAGE_SIZE;
+        }
+
+        memcpy(entry->memory + offset, saved->memory + offset, size);
+    }
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_manager_snapshot_restore_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
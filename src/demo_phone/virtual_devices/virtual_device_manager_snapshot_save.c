@@ -0,0 +1,119 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_snapshot_save.c
+ *
+ * \brief Save a snapshot of the manager's memory regions and device states.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "snapshot.h"
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+
+JEMU_IMPORT_jemu65c02;
+
+/* emit the external definitions of the inline snapshot helpers. */
+extern inline size_t virtual_device_snapshot_saved_size(
+    const virtual_device_entry* entry);
+extern inline void virtual_device_region_touch(
+    const virtual_device_entry* entry, size_t offset, size_t size);
+
+/**
+ * \brief Save a snapshot of the manager's memory regions and device states.
+ *
+ * Dirty tracking restarts from this snapshot.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param snapshot          Pointer to receive the snapshot.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_snapshot_save(
+    virtual_device_manager* virt, virtual_device_snapshot** snapshot)
+{
+    status retval;
+    virtual_device_snapshot* tmp = NULL;
+
+    /* track every writable region from here on. */
+    retval = virtual_device_manager_snapshot_track(virt);
+    if (STATUS_SUCCESS != retval)
+    {
+        goto done;
+    }
+
+    retval = virtual_device_snapshot_create(&tmp, virt->device_entries);
+    if (STATUS_SUCCESS != retval)
+    {
+        goto done;
+    }
+
+    /* describe each entry. */
+    for (size_t i = 0; i < virt->device_entries; ++i)
+    {
+        const virtual_device_entry* entry = virt->devices + i;
+        virtual_device_snapshot_entry* saved = tmp->entries + i;
+
+        saved->register_low = entry->register_low;
+        saved->register_high = entry->register_high;
+        saved->decode_mask = entry->decode_mask;
+        saved->region_flags = entry->region_flags;
+        saved->memory_size = virtual_device_snapshot_saved_size(entry);
+        saved->state_size = entry->state_size;
+        saved->state_version = entry->state_version;
+    }
+
+    retval = virtual_device_snapshot_layout(tmp);
+    if (STATUS_SUCCESS != retval)
+    {
+        goto cleanup_snapshot;
+    }
+
+    /* copy the memory and state, and start tracking from this copy. */
+    for (size_t i = 0; i < virt->device_entries; ++i)
+    {
+        const virtual_device_entry* entry = virt->devices + i;
+        virtual_device_snapshot_entry* saved = tmp->entries + i;
+
+        if (saved->memory_size > 0)
+        {
+            memcpy(saved->memory, entry->memory, saved->memory_size);
+            memset(
+                entry->dirty, 0,
+                VIRTUAL_DEVICE_SNAPSHOT_PAGES(saved->memory_size));
+        }
+
+        if (saved->state_size > 0)
+        {
+            memcpy(saved->state, entry->state, saved->state_size);
+        }
+    }
+
+    tmp->owner = virt;
+    virt->snapshot_serial += 1;
+    tmp->serial = virt->snapshot_serial;
+
+    /* success. */
+    *snapshot = tmp;
+    retval = STATUS_SUCCESS;
+    goto done;
+
+cleanup_snapshot:
+    virtual_device_snapshot_release(tmp);
+
+done:
+    return retval;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_manager_snapshot_save_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
@@ -0,0 +1,69 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_snapshot_track.c
+ *
+ * \brief Start tracking writes to the manager's memory regions.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "snapshot.h"
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Start tracking writes to every writable memory region in the manager.
+ *
+ * Regions that are already tracked keep their dirty maps.  The dirty maps are
+ * owned by the manager, and released with their entries.
+ *
+ * \param virt              The virtual device manager instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_snapshot_track(virtual_device_manager* virt)
+{
+    /* the entries of a borrowed device map cannot be changed. */
+    if (virt->read_only)
+    {
+        return VIRTUAL_DEVICE_ERROR_READ_ONLY;
+    }
+
+    for (size_t i = 0; i < virt->device_entries; ++i)
+    {
+        virtual_device_entry* entry = virt->devices + i;
+        size_t saved = virtual_device_snapshot_saved_size(entry);
+
+        if (0 == saved || NULL != entry->dirty)
+        {
+            continue;
+        }
+
+        /* a new map starts out with every page dirty. */
+        size_t pages = VIRTUAL_DEVICE_SNAPSHOT_PAGES(saved);
+        entry->dirty = (uint8_t*)virtual_device_alloc(virt->arena, pages);
+        if (NULL == entry->dirty)
+        {
+            return JEMU_ERROR_OUT_OF_MEMORY;
+        }
+
+        memset(entry->dirty, 1, pages);
+    }
+
+    return STATUS_SUCCESS;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_manager_snapshot_track_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
@@ -0,0 +1,236 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_sort_with_overlaps.c
+ *
+ * \brief Sort the virtual device entries without allocating memory, reporting
+ * every overlap.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "status.h"
+#include "virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/* the entry index is packed into the low half of each sort key. */
+#define SORT_KEY_INDEX_MASK                                             0xFFFF
+
+/* forward decls. */
+static uint32_t* merge_sort(uint32_t* keys, uint32_t* scratch, size_t entries);
+static void permute(virtual_device_manager* virt, uint32_t* keys);
+static void presence_rebuild(virtual_device_manager* virt);
+
+/**
+ * \brief Sort the device entries, reporting every overlapping pair of entries.
+ *
+ * The sort does not allocate memory.  It performs a non-recursive, bottom-up
+ * merge sort of packed (low register, entry index) keys in the manager's
+ * sort_keys buffer, then permutes the device array into place, moving each
+ * entry at most once.  Each sorted entry is then checked against the entries
+ * after it that start before it ends, so every overlapping pair is reported,
+ * at a cost of one compare per entry plus one per overlap.  On failure, the
+ * entries are still left ordered by low register.
+ *
+ * \param virt              The virtual machine manager instance to sort.
+ * \param overlap           Optional callback to receive each overlap, or NULL.
+ * \param context           The user context for the overlap callback.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_OVERLAP if any entries overlap.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_manager_sort_with_overlaps(
+    virtual_device_manager* virt, virtual_device_overlap_fn overlap,
+    void* context)
+{
+    size_t entries = virt->device_entries;
+    size_t overlaps = 0;
+
+    /* a borrowed device map cannot be reordered. */
+    if (virt->read_only)
+    {
+        return VIRTUAL_DEVICE_ERROR_READ_ONLY;
+    }
+
+    /* sorting moves entries out from under the hit cache. */
+    virt->last_hit = NULL;
+    virt->sorted = false;
+
+    /* the presence bitmap is only valid for a successfully sorted map. */
+    memset(
+        virt->presence, 0, sizeof(uint32_t) * VIRTUAL_DEVICE_PRESENCE_WORDS);
+
+    /* each entry index must fit in the low half of a sort key. */
+    if (entries > SORT_KEY_INDEX_MASK + 1)
+    {
+        return VIRTUAL_DEVICE_ERROR_TOO_MANY_ENTRIES;
+    }
+
+    /* build the sort keys. */
+    for (size_t i = 0; i < entries; ++i)
+    {
+        virt->sort_keys[i] =
+            ((uint32_t)virt->devices[i].register_low << 16) | (uint32_t)i;
+    }
+
+    /* sort the keys, and move each entry to its sorted position. */
+    permute(
+        virt, merge_sort(virt->sort_keys, virt->sort_keys + entries, entries));
+
+    /* the register keys follow the entries, even after a failed sort. */
+    for (size_t i = 0; i < entries; ++i)
+    {
+        virt->register_lows[i] = virt->devices[i].register_low;
+        virt->register_highs[i] = virt->devices[i].register_high;
+    }
+
+    /* report each pair of entries where the later one starts before the
+     * earlier one ends.  The low registers are sorted, so the scan for each
+     * entry stops at the first later entry that starts past its end. */
+    for (size_t i = 0; i < entries; ++i)
+    {
+        for (size_t j = i + 1;
+             j < entries && virt->register_lows[j] <= virt->register_highs[i];
+             ++j)
+        {
+            overlaps += 1;
+            if (NULL != overlap)
+            {
+                overlap(context, virt->devices + i, virt->devices + j);
+            }
+        }
+    }
+
+    /* any overlap fails the sort. */
+    if (overlaps > 0)
+    {
+        return VIRTUAL_DEVICE_ERROR_OVERLAP;
+    }
+
+    /* rebuild the presence bitmap. */
+    presence_rebuild(virt);
+    virt->sorted = true;
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief Perform a bottom-up merge sort of the given keys.
+ *
+ * \param keys          The keys to be sorted.
+ * \param scratch       A scratch buffer of the same size as the keys.
+ * \param entries       The number of keys.
+ *
+ * Each pass merges runs of keys from one buffer into the other, doubling the
+ * run width, so the sorted keys end up in either buffer.
+ *
+ * \returns the buffer holding the sorted keys.
+ */
+static uint32_t* merge_sort(uint32_t* keys, uint32_t* scratch, size_t entries)
+{
+    uint32_t* src = keys;
+    uint32_t* dst = scratch;
+
+    for (size_t width = 1; width < entries; width *= 2)
+    {
+        for (size_t lhs = 0; lhs < entries; lhs += 2 * width)
+        {
+            size_t rhs = lhs + width < entries ? lhs + width : entries;
+            size_t end = rhs + width < entries ? rhs + width : entries;
+            size_t lhs_idx = lhs, rhs_idx = rhs, out_idx = lhs;
+
+            /* merge the two runs. */
+            while (lhs_idx < rhs && rhs_idx < end)
+            {
+                if (src[lhs_idx] <= src[rhs_idx])
+                {
+                    dst[out_idx++] = src[lhs_idx++];
+                }
+                else
+                {
+                    dst[out_idx++] = src[rhs_idx++];
+                }
+            }
+
+            /* copy any remaining keys from either run. */
+            while (lhs_idx < rhs)
+            {
+                dst[out_idx++] = src[lhs_idx++];
+            }
+            while (rhs_idx < end)
+            {
+                dst[out_idx++] = src[rhs_idx++];
+            }
+        }
+
+        /* the next pass reads what this pass wrote. */
+        uint32_t* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    return src;
+}
+
+/**
+ * \brief Move each device entry to the position given by the sorted keys.
+ *
+ * \param virt          The virtual device manager instance.
+ * \param keys          The sorted keys.  Each key is rewritten to point at its
+ *                      own position as its entry is moved.
+ *
+ * This follows each cycle of the permutation, so each entry is copied once,
+ * with one temporary entry per cycle.
+ */
+static void permute(virtual_device_manager* virt, uint32_t* keys)
+{
+    virtual_device_entry tmp;
+
+    for (size_t start = 0; start < virt->device_entries; ++start)
+    {
+        size_t src = keys[start] & SORT_KEY_INDEX_MASK;
+
+        /* skip entries that are already in place. */
+        if (src == start)
+        {
+            continue;
+        }
+
+        /* walk this cycle, pulling each entry into the hole before it. */
+        size_t pos = start;
+        memcpy(&tmp, virt->devices + start, sizeof(tmp));
+        while (src != start)
+        {
+            memcpy(virt->devices + pos, virt->devices + src, sizeof(tmp));
+            keys[pos] = (keys[pos] & ~SORT_KEY_INDEX_MASK) | (uint32_t)pos;
+            pos = src;
+            src = keys[pos] & SORT_KEY_INDEX_MASK;
+        }
+
+        /* the start entry closes the cycle. */
+        memcpy(virt->devices + pos, &tmp, sizeof(tmp));
+        keys[pos] = (keys[pos] & ~SORT_KEY_INDEX_MASK) | (uint32_t)pos;
+    }
+}
+
+/**
+ * \brief Set the presence bit for every address covered by a device entry.
+ *
+ * \param virt          The virtual device manager instance.
+ */
+static void presence_rebuild(virtual_device_manager* virt)
+{
+    for (size_t i = 0; i < virt->device_entries; ++i)
+    {
+        for (uint32_t addr = virt->register_lows[i];
+             addr <= virt->register_highs[i]; ++addr)
+        {
+            virt->presence[addr >> 5] |= UINT32_C(1) << (addr & 31);
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_stats_dump.c
+ *
+ * \brief Write a report of the access statistics in the device manager.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <inttypes.h>
+
+#include "stats.h"
+
+#if defined(VIRTUAL_DEVICE_STATS)
+
+/* forward decls. */
+static void dump_histogram(
+    FILE* out, const char* name, const uint64_t* buckets);
+
+/**
+ * \brief Write a report of the access statistics of every counted device
+ * entry to a stream.
+ *
+ * Each device is listed with its totals, its latency histograms, and each
+ * register that was accessed.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param out               The stream to write to.
+ */
+void virtual_device_manager_stats_dump(
+    const virtual_device_manager* virt, FILE* out)
+{
+    for (size_t i = 0; i < virt->device_entries; ++i)
+    {
+        const virtual_device_entry* entry = virt->devices + i;
+        const virtual_device_stats* stats = entry->stats;
+
+        if (NULL == stats)
+        {
+            continue;
+        }
+
+        /* the device totals. */
+        fprintf(
+            out, "device %04X-%04X: %" PRIu64 " reads, %" PRIu64 " writes\n",
+            entry->register_low, entry->register_high, stats->reads,
+            stats->writes);
+
+        /* the sampled latencies. */
+        dump_histogram(out, "read ns", stats->read_latency);
+        dump_histogram(out, "write ns", stats->write_latency);
+
+        /* each register accessed, at its address in the first copy. */
+        for (size_t reg = 0; reg < stats->registers; ++reg)
+        {
+            if (0 != stats->register_reads[reg]
+             || 0 != stats->register_writes[reg])
+            {
+                fprintf(
+                    out, "  %04X: %" PRIu64 " reads, %" PRIu64 " writes\n",
+                    (unsigned)(entry->register_low + reg),
+                    stats->register_reads[reg], stats->register_writes[reg]);
+            }
+        }
+    }
+}
+
+/**
+ * \brief Write the non-empty buckets of a latency histogram.
+ *
+ * \param out               The stream to write to.
+ * \param name              The name of the histogram.
+ * \param buckets           The histogram buckets.
+ */
+static void dump_histogram(
+    FILE* out, const char* name, const uint64_t* buckets)
+{
+    bool empty = true;
+
+    for (size_t i = 0; i < VIRTUAL_DEVICE_STATS_BUCKETS; ++i)
+    {
+        if (0 == buckets[i])
+        {
+            continue;
+        }
+
+        if (empty)
+        {
+            fprintf(out, "  %s:", name);
+            empty = false;
+        }
+
+        fprintf(
+            out, " [%" PRIu64 "] %" PRIu64, UINT64_C(1) << i, buckets[i]);
+    }
+
+    if (!empty)
+    {
+        fprintf(out, "\n");
+    }
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_manager_stats_dump_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
@@ -0,0 +1,67 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_stats_enable.c
+ *
+ * \brief Start collecting access statistics in the device manager.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "stats.h"
+
+#if defined(VIRTUAL_DEVICE_STATS)
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Start collecting access statistics for every device entry in the
+ * manager, including entries registered or attached later.
+ *
+ * Enabling statistics again is a no-op.  The stats blocks are owned by the
+ * manager, and released with their entries.
+ *
+ * \param virt              The virtual device manager instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_READ_ONLY if the manager uses a read-only map.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_manager_stats_enable(virtual_device_manager* virt)
+{
+    status retval;
+
+    /* the entries of a borrowed device map cannot be changed. */
+    if (virt->read_only)
+    {
+        return VIRTUAL_DEVICE_ERROR_READ_ONLY;
+    }
+
+    /* new entries are counted from now on. */
+    virt->stats_enabled = true;
+
+    /* count the existing entries. */
+    for (size_t i = 0; i < virt->device_entries; ++i)
+    {
+        if (NULL == virt->devices[i].stats)
+        {
+            retval =
+                virtual_device_stats_create(
+                    &virt->devices[i].stats, virt->arena, virt->devices + i);
+            if (STATUS_SUCCESS != retval)
+            {
+                return retval;
+            }
+        }
+    }
+
+    return STATUS_SUCCESS;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_manager_stats_enable_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
@@ -0,0 +1,37 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_stats_find.c
+ *
+ * \brief Find the access statistics for the device servicing an address.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "stats.h"
+
+#if defined(VIRTUAL_DEVICE_STATS)
+
+/**
+ * \brief Find the access statistics for the device servicing an address.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param addr              An address serviced by the device.
+ *
+ * \returns the device's stats block, or NULL if the address is unmapped or the
+ * device is not being counted.
+ */
+const virtual_device_stats* virtual_device_manager_stats_find(
+    virtual_device_manager* virt, uint16_t addr)
+{
+    virtual_device_entry* entry =
+        virtual_device_manager_device_find(virt, addr);
+
+    return NULL != entry ? entry->stats : NULL;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_manager_stats_find_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
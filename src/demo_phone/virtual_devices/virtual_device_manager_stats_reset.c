@@ -0,0 +1,35 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_stats_reset.c
+ *
+ * \brief Clear the access statistics in the device manager.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "stats.h"
+
+#if defined(VIRTUAL_DEVICE_STATS)
+
+/**
+ * \brief Clear the access statistics of every device entry in the manager.
+ *
+ * \param virt              The virtual device manager instance.
+ */
+void virtual_device_manager_stats_reset(virtual_device_manager* virt)
+{
+    for (size_t i = 0; i < virt->device_entries; ++i)
+    {
+        if (NULL != virt->devices[i].stats)
+        {
+            virtual_device_stats_reset(virt->devices[i].stats);
+        }
+    }
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_manager_stats_reset_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
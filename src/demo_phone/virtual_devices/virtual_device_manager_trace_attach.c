@@ -0,0 +1,31 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_manager_trace_attach.c
+ *
+ * \brief Attach a trace recorder to the device manager.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "trace.h"
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+/**
+ * \brief Record every access serviced by a device manager in a trace.
+ *
+ * \param virt              The virtual device manager instance.
+ * \param trace             The trace recorder, or NULL to stop tracing.
+ */
+void virtual_device_manager_trace_attach(
+    virtual_device_manager* virt, virtual_device_trace* trace)
+{
+    virt->trace = trace;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_manager_trace_attach_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
@@ -0,0 +1,65 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_realloc.c
+ *
+ * \brief Resize memory allocated from an arena or the default allocator.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#if !defined(VIRTUAL_DEVICE_STATIC)
+# include <stdlib.h>
+#endif /*!defined(VIRTUAL_DEVICE_STATIC)*/
+#include <string.h>
+
+#include "arena.h"
+
+/**
+ * \brief Resize memory allocated by \ref virtual_device_alloc.
+ *
+ * \param arena             The arena the memory came from, or NULL.
+ * \param ptr               The allocation to resize.
+ * \param old_size          The current size of the allocation.
+ * \param new_size          The new size of the allocation.
+ *
+ * \returns the resized allocation, or NULL on failure, in which case the
+ * original allocation is untouched.
+ */
+void* virtual_device_realloc(
+    virtual_device_arena* arena, void* ptr, size_t old_size, size_t new_size)
+{
+    if (NULL == arena)
+    {
+#if defined(VIRTUAL_DEVICE_STATIC)
+        arena = &virtual_device_static_arena;
+#else
+        return realloc(ptr, new_size);
+#endif /*defined(VIRTUAL_DEVICE_STATIC)*/
+    }
+
+    /* the most recent allocation can grow in place. */
+    if ((uint8_t*)ptr == arena->base + arena->last)
+    {
+        size_t aligned = VIRTUAL_DEVICE_ARENA_ALIGN(new_size);
+
+        if (aligned < new_size || aligned > arena->size - arena->last)
+        {
+            return NULL;
+        }
+
+        arena->offset = arena->last + aligned;
+
+        return ptr;
+    }
+
+    /* otherwise, copy to a new allocation. */
+    void* tmp = virtual_device_arena_alloc(arena, new_size);
+    if (NULL == tmp)
+    {
+        return NULL;
+    }
+
+    memcpy(tmp, ptr, old_size < new_size ? old_size : new_size);
+
+    return tmp;
+}
@@ -0,0 +1,52 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_scheduler_cancel.c
+ *
+ * \brief Cancel a pending event.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "scheduler.h"
+
+/**
+ * \brief Cancel an event, if it is pending.
+ *
+ * \param scheduler         The scheduler.
+ * \param event             The event to cancel.
+ */
+void virtual_device_scheduler_cancel(
+    virtual_device_scheduler* scheduler, virtual_device_event* event)
+{
+    size_t index = event->index;
+
+    if (VIRTUAL_DEVICE_EVENT_IDLE == index)
+    {
+        return;
+    }
+
+    event->index = VIRTUAL_DEVICE_EVENT_IDLE;
+    scheduler->count -= 1;
+
+    /* fill the hole with the last event, and move it to its slot. */
+    if (index < scheduler->count)
+    {
+        virtual_device_event* last = scheduler->heap[scheduler->count];
+
+        scheduler->heap[index] = last;
+        if (index > 0
+         && last->deadline < scheduler->heap[(index - 1) / 2]->deadline)
+        {
+            virtual_device_scheduler_sift_up(scheduler, index);
+        }
+        else
+        {
+            virtual_device_scheduler_sift_down(scheduler, index);
+        }
+    }
+
+    scheduler->next_deadline =
+        scheduler->count > 0
+            ? scheduler->heap[0]->deadline
+            : VIRTUAL_DEVICE_SCHEDULER_NEVER;
+}
@@ -0,0 +1,59 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_scheduler_create.c
+ *
+ * \brief Create an event scheduler.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "scheduler.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Create an event scheduler.
+ *
+ * \param scheduler         Pointer to receive the scheduler.
+ * \param arena             The arena to allocate from, or NULL to use the
+ *                          default allocator.
+ * \param capacity          The most events that can be pending at once.
+ * \param cycle_source      The emulator's cycle counter.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_scheduler_create(
+    virtual_device_scheduler** scheduler, virtual_device_arena* arena,
+    size_t capacity, const uint64_t* cycle_source)
+{
+    size_t size =
+        sizeof(virtual_device_scheduler)
+      + capacity * sizeof(virtual_device_event*);
+
+    /* allocate the scheduler and its heap together. */
+    virtual_device_scheduler* tmp =
+        (virtual_device_scheduler*)virtual_device_alloc(arena, size);
+    if (NULL == tmp)
+    {
+        return JEMU_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* clear memory. */
+    memset(tmp, 0, size);
+
+    /* the heap follows the scheduler, and starts out empty. */
+    tmp->arena = arena;
+    tmp->cycle_source = cycle_source;
+    tmp->next_deadline = VIRTUAL_DEVICE_SCHEDULER_NEVER;
+    tmp->capacity = capacity;
+    tmp->heap = (virtual_device_event**)(tmp + 1);
+
+    *scheduler = tmp;
+
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,64 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_scheduler_post.c
+ *
+ * \brief Post an event for a cycle.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "scheduler.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Post an event for the given cycle, moving it if it is already
+ * pending.
+ *
+ * \param scheduler         The scheduler.
+ * \param event             The event to post.
+ * \param deadline          The cycle the event is due.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_SCHEDULER_FULL if the scheduler already has
+ *        capacity events pending.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_scheduler_post(
+    virtual_device_scheduler* scheduler, virtual_device_event* event,
+    uint64_t deadline)
+{
+    if (VIRTUAL_DEVICE_EVENT_IDLE == event->index)
+    {
+        if (scheduler->count == scheduler->capacity)
+        {
+            return VIRTUAL_DEVICE_ERROR_SCHEDULER_FULL;
+        }
+
+        /* append the event, and move it up to its slot. */
+        event->deadline = deadline;
+        scheduler->heap[scheduler->count] = event;
+        scheduler->count += 1;
+        virtual_device_scheduler_sift_up(scheduler, scheduler->count - 1);
+    }
+    else
+    {
+        /* move a pending event whichever way its deadline went. */
+        uint64_t previous = event->deadline;
+        event->deadline = deadline;
+
+        if (deadline < previous)
+        {
+            virtual_device_scheduler_sift_up(scheduler, event->index);
+        }
+        else
+        {
+            virtual_device_scheduler_sift_down(scheduler, event->index);
+        }
+    }
+
+    scheduler->next_deadline = scheduler->heap[0]->deadline;
+
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,45 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_scheduler_release.c
+ *
+ * \brief Release an event scheduler.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "scheduler.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Release an event scheduler.
+ *
+ * Pending events are cancelled.
+ *
+ * \param scheduler         The scheduler to release.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_scheduler_release(virtual_device_scheduler* scheduler)
+{
+    virtual_device_arena* arena = scheduler->arena;
+    size_t size =
+        sizeof(virtual_device_scheduler)
+      + scheduler->capacity * sizeof(virtual_device_event*);
+
+    /* the events outlive the scheduler. */
+    for (size_t i = 0; i < scheduler->count; ++i)
+    {
+        scheduler->heap[i]->index = VIRTUAL_DEVICE_EVENT_IDLE;
+    }
+
+    memset(scheduler, 0, size);
+    virtual_device_free(arena, scheduler);
+
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,54 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_scheduler_run.c
+ *
+ * \brief Handle the events that are due.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "scheduler.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/* emit the external definitions of the inline scheduler helpers. */
+extern inline uint64_t virtual_device_scheduler_now(
+    const virtual_device_scheduler* scheduler);
+extern inline JEMU_SYM(status) virtual_device_scheduler_advance(
+    virtual_device_scheduler* scheduler);
+
+/**
+ * \brief Call the handler of every event due at the current cycle, in
+ * deadline order.
+ *
+ * Events posted by a handler for a cycle that has already passed are handled
+ * in the same call.
+ *
+ * \param scheduler         The scheduler.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code from a handler, which stops the run.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_scheduler_run(virtual_device_scheduler* scheduler)
+{
+    status retval;
+    uint64_t now = *scheduler->cycle_source;
+
+    while (scheduler->count > 0 && scheduler->heap[0]->deadline <= now)
+    {
+        /* pop the earliest event. */
+        virtual_device_event* event = scheduler->heap[0];
+        virtual_device_scheduler_cancel(scheduler, event);
+
+        /* the handler may post it again. */
+        retval = event->callback(event->context, event->deadline);
+        if (STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+    }
+
+    return STATUS_SUCCESS;
+}
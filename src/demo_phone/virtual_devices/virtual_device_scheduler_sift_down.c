@@ -0,0 +1,56 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_scheduler_sift_down.c
+ *
+ * \brief Restore the heap order around an event whose deadline went up.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "scheduler.h"
+
+/**
+ * \brief Restore the heap order around an event whose deadline went up.
+ *
+ * This is used by \ref virtual_device_scheduler_post,
+ * \ref virtual_device_scheduler_cancel, and
+ * \ref virtual_device_scheduler_run.
+ *
+ * \param scheduler         The scheduler.
+ * \param index             The heap index of the event.
+ */
+void virtual_device_scheduler_sift_down(
+    virtual_device_scheduler* scheduler, size_t index)
+{
+    virtual_device_event** heap = scheduler->heap;
+    virtual_device_event* event = heap[index];
+    size_t count = scheduler->count;
+
+    /* move the earlier child up until the event's slot is found. */
+    for (;;)
+    {
+        size_t child = 2 * index + 1;
+        if (child >= count)
+        {
+            break;
+        }
+
+        if (child + 1 < count
+         && heap[child + 1]->deadline < heap[child]->deadline)
+        {
+            child += 1;
+        }
+
+        if (event->deadline <= heap[child]->deadline)
+        {
+            break;
+        }
+
+        heap[index] = heap[child];
+        heap[index]->index = index;
+        index = child;
+    }
+
+    heap[index] = event;
+    event->index = index;
+}
@@ -0,0 +1,42 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_scheduler_sift_up.c
+ *
+ * \brief Restore the heap order around an event whose deadline went down.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "scheduler.h"
+
+/**
+ * \brief Restore the heap order around an event whose deadline went down.
+ *
+ * This is used by \ref virtual_device_scheduler_post.
+ *
+ * \param scheduler         The scheduler.
+ * \param index             The heap index of the event.
+ */
+void virtual_device_scheduler_sift_up(
+    virtual_device_scheduler* scheduler, size_t index)
+{
+    virtual_device_event** heap = scheduler->heap;
+    virtual_device_event* event = heap[index];
+
+    /* move parents down until the event's slot is found. */
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / 2;
+        if (heap[parent]->deadline <= event->deadline)
+        {
+            break;
+        }
+
+        heap[index] = heap[parent];
+        heap[index]->index = index;
+        index = parent;
+    }
+
+    heap[index] = event;
+    event->index = index;
+}
@@ -0,0 +1,64 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_snapshot_create.c
+ *
+ * \brief Create an empty snapshot.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "snapshot.h"
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Create an empty snapshot with room for the given number of entries.
+ *
+ * This is used by \ref virtual_device_manager_snapshot_save and
+ * \ref virtual_device_snapshot_read.
+ *
+ * \param snapshot          Pointer to receive the snapshot.
+ * \param device_entries    The number of entries.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_snapshot_create(
+    virtual_device_snapshot** snapshot, size_t device_entries)
+{
+    size_t size =
+        sizeof(virtual_device_snapshot)
+      + device_entries * sizeof(virtual_device_snapshot_entry);
+
+    /* allocate the snapshot and its entries together. */
+    virtual_device_snapshot* tmp = (virtual_device_snapshot*)malloc(size);
+    if (NULL == tmp)
+    {
+        return JEMU_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* clear memory. */
+    memset(tmp, 0, size);
+
+    /* the entries follow the snapshot. */
+    tmp->device_entries = device_entries;
+    tmp->entries = (virtual_device_snapshot_entry*)(tmp + 1);
+
+    *snapshot = tmp;
+
+    return STATUS_SUCCESS;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_snapshot_create_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
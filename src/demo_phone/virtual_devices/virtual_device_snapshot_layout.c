@@ -0,0 +1,69 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_snapshot_layout.c
+ *
+ * \brief Allocate the data block of a snapshot.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <stdlib.h>
+
+#include "snapshot.h"
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Allocate the data block of a snapshot, and point each entry at its
+ * memory and state bytes.
+ *
+ * This is used by \ref virtual_device_manager_snapshot_save and
+ * \ref virtual_device_snapshot_read, once the entry sizes are known.
+ *
+ * \param snapshot          The snapshot.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_snapshot_layout(virtual_device_snapshot* snapshot)
+{
+    size_t size = 0;
+
+    for (size_t i = 0; i < snapshot->device_entries; ++i)
+    {
+        size +=
+            snapshot->entries[i].memory_size + snapshot->entries[i].state_size;
+    }
+
+    /* an empty data block is still a distinct allocation. */
+    snapshot->data = (uint8_t*)malloc(size > 0 ? size : 1);
+    if (NULL == snapshot->data)
+    {
+        return JEMU_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* each entry's memory is followed by its state. */
+    uint8_t* cursor = snapshot->data;
+    for (size_t i = 0; i < snapshot->device_entries; ++i)
+    {
+        virtual_device_snapshot_entry* entry = snapshot->entries + i;
+
+        entry->memory = cursor;
+        cursor += entry->memory_size;
+        entry->state = cursor;
+        cursor += entry->state_size;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_snapshot_layout_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
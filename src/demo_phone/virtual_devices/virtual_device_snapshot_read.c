@@ -0,0 +1,162 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_snapshot_read.c
+ *
+ * \brief Read a serialized snapshot from a stream.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "snapshot.h"
+#include "status.h"
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief The most device entries a serialized snapshot may describe.
+ */
+#define SNAPSHOT_MAX_ENTRIES                                             65536
+
+/* forward decls. */
+static bool read_le(FILE* in, uint32_t* value, size_t size);
+
+/**
+ * \brief Read a serialized snapshot from a stream.
+ *
+ * \param snapshot          Pointer to receive the snapshot.
+ * \param in                The stream to read from.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_SNAPSHOT_FORMAT if the stream is not a complete
+ *        snapshot of a supported version, written with this host's byte
+ *        order.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_snapshot_read(virtual_device_snapshot** snapshot, FILE* in)
+{
+    status retval;
+    virtual_device_snapshot* tmp = NULL;
+    static const uint8_t header[] = {
+        'V', 'D', 'S', 'S', VIRTUAL_DEVICE_SNAPSHOT_VERSION };
+    static const uint16_t byte_order = VIRTUAL_DEVICE_SNAPSHOT_BYTE_ORDER;
+    uint8_t found[sizeof(header)];
+    uint16_t found_order;
+    uint32_t entries, low, high, mask, flags, memory_size, state_size;
+    uint32_t state_version;
+
+    /* check the header; state blocks are only readable in host order. */
+    if (sizeof(found) != fread(found, 1, sizeof(found), in)
+     || 0 != memcmp(header, found, sizeof(header))
+     || sizeof(found_order) != fread(&found_order, 1, sizeof(found_order), in)
+     || byte_order != found_order
+     || !read_le(in, &entries, 4)
+     || entries > SNAPSHOT_MAX_ENTRIES)
+    {
+        retval = VIRTUAL_DEVICE_ERROR_SNAPSHOT_FORMAT;
+        goto done;
+    }
+
+    retval = virtual_device_snapshot_create(&tmp, entries);
+    if (STATUS_SUCCESS != retval)
+    {
+        goto done;
+    }
+
+    /* read each entry's description. */
+    for (size_t i = 0; i < entries; ++i)
+    {
+        virtual_device_snapshot_entry* entry = tmp->entries + i;
+
+        /* no entry saves more than the address space, or a huge state. */
+        if (!read_le(in, &low, 2) || !read_le(in, &high, 2)
+         || !read_le(in, &mask, 2) || !read_le(in, &flags, 4)
+         || !read_le(in, &memory_size, 4) || !read_le(in, &state_size, 4)
+         || !read_le(in, &state_version, 4)
+         || memory_size > 65536 || state_size > 65536)
+        {
+            retval = VIRTUAL_DEVICE_ERROR_SNAPSHOT_FORMAT;
+            goto cleanup_snapshot;
+        }
+
+        entry->register_low = (uint16_t)low;
+        entry->register_high = (uint16_t)high;
+        entry->decode_mask = (uint16_t)mask;
+        entry->region_flags = flags;
+        entry->memory_size = memory_size;
+        entry->state_size = state_size;
+        entry->state_version = state_version;
+    }
+
+    retval = virtual_device_snapshot_layout(tmp);
+    if (STATUS_SUCCESS != retval)
+    {
+        goto cleanup_snapshot;
+    }
+
+    /* read their memory and state. */
+    for (size_t i = 0; i < entries; ++i)
+    {
+        virtual_device_snapshot_entry* entry = tmp->entries + i;
+
+        if (entry->memory_size
+                != fread(entry->memory, 1, entry->memory_size, in)
+         || entry->state_size != fread(entry->state, 1, entry->state_size, in))
+        {
+            retval = VIRTUAL_DEVICE_ERROR_SNAPSHOT_FORMAT;
+            goto cleanup_snapshot;
+        }
+    }
+
+    /* success. */
+    *snapshot = tmp;
+    retval = STATUS_SUCCESS;
+    goto done;
+
+cleanup_snapshot:
+    virtual_device_snapshot_release(tmp);
+
+done:
+    return retval;
+}
+
+/**
+ * \brief Read a little endian integer.
+ *
+ * \param in                The stream to read.
+ * \param value             Pointer to receive the value.
+ * \param size              The number of bytes to read.
+ *
+ * \returns true if the integer was read.
+ */
+static bool read_le(FILE* in, uint32_t* value, size_t size)
+{
+    uint32_t result = 0;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        int byte = fgetc(in);
+        if (EOF == byte)
+        {
+            return false;
+        }
+
+        result |= (uint32_t)byte << (8 * i);
+    }
+
+    *value = result;
+
+    return true;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_snapshot_read_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
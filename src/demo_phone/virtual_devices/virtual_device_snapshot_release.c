@@ -0,0 +1,34 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_snapshot_release.c
+ *
+ * \brief Release a snapshot.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "snapshot.h"
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+
+/**
+ * \brief Release a snapshot.
+ *
+ * \param snapshot          The snapshot to release.
+ */
+void virtual_device_snapshot_release(virtual_device_snapshot* snapshot)
+{
+    free(snapshot->data);
+    memset(snapshot, 0, sizeof(*snapshot));
+    free(snapshot);
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_snapshot_release_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
@@ -0,0 +1,107 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_snapshot_write.c
+ *
+ * \brief Serialize a snapshot to a stream.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "snapshot.h"
+#include "status.h"
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+
+JEMU_IMPORT_jemu65c02;
+
+/* forward decls. */
+static bool write_le(FILE* out, uint32_t value, size_t size);
+
+/**
+ * \brief Serialize a snapshot to a stream.
+ *
+ * \param snapshot          The snapshot.
+ * \param out               The stream to write to.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_SNAPSHOT_IO if the stream could not be written.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_snapshot_write(
+    const virtual_device_snapshot* snapshot, FILE* out)
+{
+    static const uint8_t header[] = {
+        'V', 'D', 'S', 'S', VIRTUAL_DEVICE_SNAPSHOT_VERSION };
+    static const uint16_t byte_order = VIRTUAL_DEVICE_SNAPSHOT_BYTE_ORDER;
+
+    /* the marker goes out in host order, for the state blocks. */
+    if (sizeof(header) != fwrite(header, 1, sizeof(header), out)
+     || sizeof(byte_order) != fwrite(&byte_order, 1, sizeof(byte_order), out)
+     || !write_le(out, (uint32_t)snapshot->device_entries, 4))
+    {
+        return VIRTUAL_DEVICE_ERROR_SNAPSHOT_IO;
+    }
+
+    /* describe each entry. */
+    for (size_t i = 0; i < snapshot->device_entries; ++i)
+    {
+        const virtual_device_snapshot_entry* entry = snapshot->entries + i;
+
+        if (!write_le(out, entry->register_low, 2)
+         || !write_le(out, entry->register_high, 2)
+         || !write_le(out, entry->decode_mask, 2)
+         || !write_le(out, entry->region_flags, 4)
+         || !write_le(out, (uint32_t)entry->memory_size, 4)
+         || !write_le(out, (uint32_t)entry->state_size, 4)
+         || !write_le(out, entry->state_version, 4))
+        {
+            return VIRTUAL_DEVICE_ERROR_SNAPSHOT_IO;
+        }
+    }
+
+    /* then write their memory and state. */
+    for (size_t i = 0; i < snapshot->device_entries; ++i)
+    {
+        const virtual_device_snapshot_entry* entry = snapshot->entries + i;
+
+        if (entry->memory_size
+                != fwrite(entry->memory, 1, entry->memory_size, out)
+         || entry->state_size
+                != fwrite(entry->state, 1, entry->state_size, out))
+        {
+            return VIRTUAL_DEVICE_ERROR_SNAPSHOT_IO;
+        }
+    }
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief Write a little endian integer.
+ *
+ * \param out               The stream to write.
+ * \param value             The value to write.
+ * \param size              The number of bytes to write.
+ *
+ * \returns true if the integer was written.
+ */
+static bool write_le(FILE* out, uint32_t value, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (EOF == fputc((int)((value >> (8 * i)) & 0xFF), out))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_snapshot_write_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
@@ -0,0 +1,43 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_static_arena.c
+ *
+ * \brief The default arena for a static, malloc-free build.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "virtual_device.h"
+
+#if defined(VIRTUAL_DEVICE_STATIC)
+
+/**
+ * \brief The size of the static pool backing the default arena.
+ */
+# ifndef VIRTUAL_DEVICE_STATIC_POOL_SIZE
+#  define VIRTUAL_DEVICE_STATIC_POOL_SIZE \
+    (VIRTUAL_DEVICE_MANAGER_ARENA_SIZE( \
+        VIRTUAL_DEVICE_STATIC_MAX_DEVICES, VIRTUAL_DEVICE_STATIC_MAX_PAGES) \
+   + VIRTUAL_DEVICE_ARENA_ALIGN(VIRTUAL_DEVICE_STATIC_DEVICE_POOL_SIZE))
+# endif
+
+/* the pool is zero-initialized in .bss. */
+static _Alignas(VIRTUAL_DEVICE_ARENA_ALIGNMENT)
+    uint8_t static_pool[VIRTUAL_DEVICE_STATIC_POOL_SIZE];
+
+/**
+ * \brief In a static build, the default arena used in place of the heap.
+ */
+virtual_device_arena virtual_device_static_arena = {
+    .base = static_pool,
+    .size = sizeof(static_pool),
+    .offset = 0,
+    .last = 0,
+};
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_static_arena_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_STATIC)*/
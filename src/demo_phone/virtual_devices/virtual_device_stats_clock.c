@@ -0,0 +1,38 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_stats_clock.c
+ *
+ * \brief Read the host's monotonic clock.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <time.h>
+
+#include "stats.h"
+
+#if defined(VIRTUAL_DEVICE_STATS)
+
+/* emit the external definition of the inline histogram bucket helper. */
+extern inline size_t virtual_device_stats_bucket(uint64_t nanoseconds);
+
+/**
+ * \brief Read the host's monotonic clock.
+ *
+ * \returns the current time in nanoseconds.
+ */
+uint64_t virtual_device_stats_clock(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * UINT64_C(1000000000) + (uint64_t)now.tv_nsec;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_stats_clock_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
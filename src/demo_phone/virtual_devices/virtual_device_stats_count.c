@@ -0,0 +1,51 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_stats_count.c
+ *
+ * \brief Count a run of accesses to a device entry.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "stats.h"
+
+#if defined(VIRTUAL_DEVICE_STATS)
+
+/**
+ * \brief Count a run of accesses to a device entry.
+ *
+ * \param entry             The device entry, which has a stats block.
+ * \param addr              The first address accessed.
+ * \param size              The number of consecutive addresses accessed.
+ * \param write             true for writes, false for reads.
+ */
+void virtual_device_stats_count(
+    const virtual_device_entry* entry, uint16_t addr, size_t size,
+    bool write)
+{
+    virtual_device_stats* stats = entry->stats;
+    uint64_t* registers =
+        write ? stats->register_writes : stats->register_reads;
+
+    if (write)
+    {
+        stats->writes += size;
+    }
+    else
+    {
+        stats->reads += size;
+    }
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        registers[
+            virtual_device_entry_offset(entry, (uint16_t)(addr + i))] += 1;
+    }
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_stats_count_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
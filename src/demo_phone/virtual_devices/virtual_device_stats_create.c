@@ -0,0 +1,70 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_stats_create.c
+ *
+ * \brief Create a stats block for a device entry.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <jemu65c02/status.h>
+#include <string.h>
+
+#include "stats.h"
+
+#if defined(VIRTUAL_DEVICE_STATS)
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Create a stats block sized for a device entry.
+ *
+ * \param stats             Pointer to receive the stats block.
+ * \param arena             The arena to allocate from, or NULL for the heap.
+ * \param entry             The device entry to be counted.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_stats_create(
+    virtual_device_stats** stats, virtual_device_arena* arena,
+    const virtual_device_entry* entry)
+{
+    /* a partially decoded entry counts the registers of one copy. */
+    size_t registers =
+        0 != entry->decode_mask
+            ? (size_t)entry->decode_mask + 1
+            : (size_t)(entry->register_high - entry->register_low) + 1;
+    size_t size =
+        sizeof(virtual_device_stats) + 2 * registers * sizeof(uint64_t);
+
+    /* allocate the stats block and its register counters together. */
+    virtual_device_stats* tmp =
+        (virtual_device_stats*)virtual_device_alloc(arena, size);
+    if (NULL == tmp)
+    {
+        return JEMU_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* clear memory. */
+    memset(tmp, 0, size);
+
+    /* the register counters follow the stats block. */
+    tmp->registers = registers;
+    tmp->register_reads = (uint64_t*)(tmp + 1);
+    tmp->register_writes = tmp->register_reads + registers;
+    tmp->sample_countdown = VIRTUAL_DEVICE_STATS_SAMPLE_PERIOD;
+
+    *stats = tmp;
+
+    return STATUS_SUCCESS;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_stats_create_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
@@ -0,0 +1,42 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_stats_release.c
+ *
+ * \brief Release a stats block.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "stats.h"
+
+#if defined(VIRTUAL_DEVICE_STATS)
+
+/**
+ * \brief Release a stats block.
+ *
+ * \param arena             The arena the stats block was allocated from.
+ * \param stats             The stats block to release.
+ */
+void virtual_device_stats_release(
+    virtual_device_arena* arena, virtual_device_stats* stats)
+{
+    if (NULL == stats)
+    {
+        return;
+    }
+
+    /* clear and free the stats block and its register counters. */
+    memset(
+        stats, 0,
+        sizeof(*stats) + 2 * stats->registers * sizeof(uint64_t));
+    virtual_device_free(arena, stats);
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_stats_release_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
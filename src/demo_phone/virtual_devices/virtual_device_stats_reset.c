@@ -0,0 +1,39 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_stats_reset.c
+ *
+ * \brief Clear the counters and histograms in a stats block.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "stats.h"
+
+#if defined(VIRTUAL_DEVICE_STATS)
+
+/**
+ * \brief Clear every counter and histogram in a stats block.
+ *
+ * \param stats             The stats block to reset.
+ */
+void virtual_device_stats_reset(virtual_device_stats* stats)
+{
+    stats->reads = 0;
+    stats->writes = 0;
+    stats->sample_countdown = VIRTUAL_DEVICE_STATS_SAMPLE_PERIOD;
+    memset(stats->read_latency, 0, sizeof(stats->read_latency));
+    memset(stats->write_latency, 0, sizeof(stats->write_latency));
+    memset(
+        stats->register_reads, 0, stats->registers * sizeof(uint64_t));
+    memset(
+        stats->register_writes, 0, stats->registers * sizeof(uint64_t));
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_stats_reset_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
@@ -0,0 +1,58 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_stats_write.c
+ *
+ * \brief Write a byte to a device entry, counting the write and sampling its
+ * latency.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "stats.h"
+
+#if defined(VIRTUAL_DEVICE_STATS)
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Write a byte to a device entry, counting the write and sampling its
+ * latency.
+ *
+ * \param entry             The device entry, which has a stats block.
+ * \param addr              The address for the write operation.
+ * \param byte              The byte to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_stats_write(
+    const virtual_device_entry* entry, uint16_t addr, uint8_t byte)
+{
+    virtual_device_stats* stats = entry->stats;
+
+    virtual_device_stats_count(entry, addr, 1, true);
+
+    /* most accesses are only counted. */
+    if (stats->sample_countdown > 1)
+    {
+        stats->sample_countdown -= 1;
+        return virtual_device_entry_write(entry, addr, byte);
+    }
+
+    /* time this one. */
+    stats->sample_countdown = VIRTUAL_DEVICE_STATS_SAMPLE_PERIOD;
+    uint64_t start = virtual_device_stats_clock();
+    status retval = virtual_device_entry_write(entry, addr, byte);
+    uint64_t elapsed = virtual_device_stats_clock() - start;
+    stats->write_latency[virtual_device_stats_bucket(elapsed)] += 1;
+
+    return retval;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_stats_write_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
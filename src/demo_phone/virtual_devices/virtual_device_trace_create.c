@@ -0,0 +1,160 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_trace_create.c
+ *
+ * \brief Create a trace recorder and start its drain thread.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "status.h"
+#include "trace_ring.h"
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief How long the drain thread sleeps when the ring is empty, in
+ * nanoseconds.
+ */
+#define DRAIN_IDLE_NANOSECONDS                                         1000000
+
+/* forward decls. */
+static void* drain_thread(void* context);
+
+/**
+ * \brief Create a trace recorder writing to the given stream, and start its
+ * drain thread.
+ *
+ * \param trace             Pointer to receive the trace recorder.
+ * \param out               The stream to write the trace to, which the caller
+ *                          closes after releasing the recorder.
+ * \param capacity          The number of events the ring holds, which must be
+ *                          a power of two.
+ * \param cycle_source      The emulator's cycle counter, read for each event,
+ *                          or NULL to number events instead.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_INVALID_TRACE if the capacity is not a power of
+ *        two.
+ *      - VIRTUAL_DEVICE_ERROR_TRACE_IO if the header could not be written or
+ *        the drain thread could not be started.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_trace_create(
+    virtual_device_trace** trace, FILE* out, size_t capacity,
+    const uint64_t* cycle_source)
+{
+    status retval;
+    virtual_device_trace* tmp = NULL;
+    static const uint8_t header[] = {
+        'V', 'D', 'T', 'R', VIRTUAL_DEVICE_TRACE_VERSION };
+
+    /* the ring is indexed by masking. */
+    if (capacity < 2 || 0 != (capacity & (capacity - 1)))
+    {
+        retval = VIRTUAL_DEVICE_ERROR_INVALID_TRACE;
+        goto done;
+    }
+
+    /* the producer and consumer positions sit on their own cache lines. */
+    size_t size =
+        (sizeof(*tmp) + VIRTUAL_DEVICE_TRACE_CACHE_LINE - 1)
+            & ~((size_t)VIRTUAL_DEVICE_TRACE_CACHE_LINE - 1);
+    tmp =
+        (virtual_device_trace*)aligned_alloc(
+            VIRTUAL_DEVICE_TRACE_CACHE_LINE, size);
+    if (NULL == tmp)
+    {
+        retval = JEMU_ERROR_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    /* clear memory. */
+    memset(tmp, 0, sizeof(*tmp));
+
+    /* allocate the ring. */
+    tmp->ring =
+        (virtual_device_trace_event*)malloc(capacity * sizeof(*tmp->ring));
+    if (NULL == tmp->ring)
+    {
+        retval = JEMU_ERROR_OUT_OF_MEMORY;
+        goto cleanup_trace;
+    }
+
+    /* initialize the recorder. */
+    tmp->mask = capacity - 1;
+    tmp->cycle_source = cycle_source;
+    tmp->out = out;
+    atomic_init(&tmp->head, 0);
+    atomic_init(&tmp->tail, 0);
+    atomic_init(&tmp->dropped, 0);
+    atomic_init(&tmp->running, true);
+
+    /* write the header. */
+    if (sizeof(header) != fwrite(header, 1, sizeof(header), out))
+    {
+        retval = VIRTUAL_DEVICE_ERROR_TRACE_IO;
+        goto cleanup_ring;
+    }
+
+    /* start draining. */
+    if (0 != pthread_create(&tmp->thread, NULL, &drain_thread, tmp))
+    {
+        retval = VIRTUAL_DEVICE_ERROR_TRACE_IO;
+        goto cleanup_ring;
+    }
+
+    /* success. */
+    *trace = tmp;
+    retval = STATUS_SUCCESS;
+    goto done;
+
+cleanup_ring:
+    free(tmp->ring);
+
+cleanup_trace:
+    free(tmp);
+
+done:
+    return retval;
+}
+
+/**
+ * \brief Drain the ring until the recorder is released.
+ *
+ * \param context           The trace recorder.
+ *
+ * \returns NULL.
+ */
+static void* drain_thread(void* context)
+{
+    virtual_device_trace* trace = (virtual_device_trace*)context;
+    const struct timespec idle = { 0, DRAIN_IDLE_NANOSECONDS };
+
+    while (atomic_load_explicit(&trace->running, memory_order_acquire))
+    {
+        /* when the ring runs dry, hand what we have to the stream and wait. */
+        if (0 == virtual_device_trace_drain(trace))
+        {
+            virtual_device_trace_write(trace);
+            nanosleep(&idle, NULL);
+        }
+    }
+
+    return NULL;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_trace_create_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
@@ -0,0 +1,57 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_trace_drain.c
+ *
+ * \brief Drain a trace recorder's ring into its stream.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "trace_ring.h"
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+/**
+ * \brief Encode every event published so far, and every dropped count, into
+ * the trace stream.
+ *
+ * This must only be called from the drain thread, or once it has stopped.
+ *
+ * \param trace             The trace recorder.
+ *
+ * \returns the number of events drained.
+ */
+size_t virtual_device_trace_drain(virtual_device_trace* trace)
+{
+    size_t tail = atomic_load_explicit(&trace->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&trace->head, memory_order_acquire);
+    size_t drained = head - tail;
+
+    /* encode the published events, then hand their slots back. */
+    for (; tail != head; ++tail)
+    {
+        virtual_device_trace_encode(trace, trace->ring + (tail & trace->mask));
+    }
+    atomic_store_explicit(&trace->tail, tail, memory_order_release);
+
+    /* note any events dropped since the last drain. */
+    uint64_t dropped =
+        atomic_load_explicit(&trace->dropped, memory_order_relaxed);
+    if (dropped != trace->dropped_written)
+    {
+        virtual_device_trace_emit(trace);
+        virtual_device_trace_put(trace, VIRTUAL_DEVICE_TRACE_TAG_DROPPED);
+        virtual_device_trace_put_varint(
+            trace, dropped - trace->dropped_written);
+        trace->dropped_written = dropped;
+    }
+
+    return drained;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_trace_drain_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
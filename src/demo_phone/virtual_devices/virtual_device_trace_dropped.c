@@ -0,0 +1,31 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_trace_dropped.c
+ *
+ * \brief Return the number of events dropped by a trace recorder.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "trace_ring.h"
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+/**
+ * \brief Return the number of events dropped because the ring was full.
+ *
+ * \param trace             The trace recorder.
+ *
+ * \returns the number of events dropped so far.
+ */
+uint64_t virtual_device_trace_dropped(virtual_device_trace* trace)
+{
+    return atomic_load_explicit(&trace->dropped, memory_order_relaxed);
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_trace_dropped_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
@@ -0,0 +1,88 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_trace_emit.c
+ *
+ * \brief Emit the trace encoder's pending run.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "trace_ring.h"
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+/**
+ * \brief Emit the pending run into the encoder's output buffer.
+ *
+ * \param trace             The trace recorder.
+ */
+void virtual_device_trace_emit(virtual_device_trace* trace)
+{
+    const virtual_device_trace_event* event = &trace->pending;
+    const virtual_device_trace_event* prev = &trace->written;
+    uint8_t tag = 0;
+
+    if (0 == trace->pending_count)
+    {
+        return;
+    }
+
+    /* leave out whatever matches the previous record. */
+    if (event->write)
+    {
+        tag |= VIRTUAL_DEVICE_TRACE_TAG_WRITE;
+    }
+    if (event->address == prev->address)
+    {
+        tag |= VIRTUAL_DEVICE_TRACE_TAG_SAME_ADDRESS;
+    }
+    if (event->device == prev->device)
+    {
+        tag |= VIRTUAL_DEVICE_TRACE_TAG_SAME_DEVICE;
+    }
+    if (event->value == prev->value)
+    {
+        tag |= VIRTUAL_DEVICE_TRACE_TAG_SAME_VALUE;
+    }
+    if (trace->pending_count > 1)
+    {
+        tag |= VIRTUAL_DEVICE_TRACE_TAG_RUN;
+    }
+
+    virtual_device_trace_put(trace, tag);
+
+    if (tag & VIRTUAL_DEVICE_TRACE_TAG_RUN)
+    {
+        virtual_device_trace_put_varint(trace, trace->pending_count - 1);
+    }
+
+    virtual_device_trace_put_varint(trace, trace->pending_delta);
+
+    /* nearby addresses zigzag encode to short varints. */
+    if (!(tag & VIRTUAL_DEVICE_TRACE_TAG_SAME_ADDRESS))
+    {
+        int32_t delta = (int16_t)(event->address - prev->address);
+        virtual_device_trace_put_varint(
+            trace, ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+    }
+
+    if (!(tag & VIRTUAL_DEVICE_TRACE_TAG_SAME_DEVICE))
+    {
+        virtual_device_trace_put_varint(trace, event->device);
+    }
+
+    if (!(tag & VIRTUAL_DEVICE_TRACE_TAG_SAME_VALUE))
+    {
+        virtual_device_trace_put(trace, event->value);
+    }
+
+    trace->written = *event;
+    trace->pending_count = 0;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_trace_emit_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
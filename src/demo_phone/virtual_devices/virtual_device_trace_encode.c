@@ -0,0 +1,53 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_trace_encode.c
+ *
+ * \brief Add an event to the trace encoder.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "trace_ring.h"
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+/**
+ * \brief Add an event to the pending run, or emit the pending run and start a
+ * new one.
+ *
+ * \param trace             The trace recorder.
+ * \param event             The event to encode.
+ */
+void virtual_device_trace_encode(
+    virtual_device_trace* trace, const virtual_device_trace_event* event)
+{
+    uint64_t delta = event->cycle - trace->last_cycle;
+    const virtual_device_trace_event* pending = &trace->pending;
+
+    trace->last_cycle = event->cycle;
+
+    /* a repeat of the pending event, at the same pace, extends the run. */
+    if (0 != trace->pending_count
+     && delta == trace->pending_delta
+     && event->address == pending->address
+     && event->device == pending->device
+     && event->value == pending->value
+     && event->write == pending->write)
+    {
+        trace->pending_count += 1;
+        return;
+    }
+
+    /* otherwise, this event starts a new run. */
+    virtual_device_trace_emit(trace);
+    trace->pending = *event;
+    trace->pending_delta = delta;
+    trace->pending_count = 1;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_trace_encode_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
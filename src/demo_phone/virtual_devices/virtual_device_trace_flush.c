@@ -0,0 +1,35 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_trace_flush.c
+ *
+ * \brief Flush a trace recorder's encoder to its stream.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "trace_ring.h"
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+/**
+ * \brief Write the pending run and the output buffer to the trace stream.
+ *
+ * \param trace             The trace recorder.
+ */
+void virtual_device_trace_flush(virtual_device_trace* trace)
+{
+    virtual_device_trace_emit(trace);
+    virtual_device_trace_write(trace);
+
+    if (0 != fflush(trace->out))
+    {
+        trace->io_error = true;
+    }
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_trace_flush_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
@@ -0,0 +1,56 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_trace_reader_init.c
+ *
+ * \brief Start reading a trace from a stream.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "status.h"
+#include "trace.h"
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Start reading a trace from a stream.
+ *
+ * \param reader            The reader to initialize.
+ * \param in                The stream to read, positioned at the header.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_TRACE_FORMAT if the header is not a supported
+ *        trace header.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_trace_reader_init(
+    virtual_device_trace_reader* reader, FILE* in)
+{
+    static const uint8_t expected[] = {
+        'V', 'D', 'T', 'R', VIRTUAL_DEVICE_TRACE_VERSION };
+    uint8_t header[sizeof(expected)];
+
+    if (sizeof(header) != fread(header, 1, sizeof(header), in)
+     || 0 != memcmp(header, expected, sizeof(header)))
+    {
+        return VIRTUAL_DEVICE_ERROR_TRACE_FORMAT;
+    }
+
+    /* decoding starts from an all-zero previous event. */
+    memset(reader, 0, sizeof(*reader));
+    reader->in = in;
+
+    return STATUS_SUCCESS;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_trace_reader_init_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
@@ -0,0 +1,163 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_trace_reader_next.c
+ *
+ * \brief Read the next event from a trace.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "status.h"
+#include "trace.h"
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+JEMU_IMPORT_jemu65c02;
+
+/* forward decls. */
+static bool read_varint(FILE* in, uint64_t* value);
+
+/**
+ * \brief Read the next event from a trace.
+ *
+ * Dropped event records are added to the reader's dropped count.
+ *
+ * \param reader            The trace reader.
+ * \param event             Pointer to receive the event.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_TRACE_END at the end of the trace.
+ *      - VIRTUAL_DEVICE_ERROR_TRACE_FORMAT if the trace is truncated or
+ *        corrupt.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_trace_reader_next(
+    virtual_device_trace_reader* reader, virtual_device_trace_event* event)
+{
+    virtual_device_trace_event* prev = &reader->event;
+    uint64_t value;
+    int tag;
+
+    /* repeat the current run. */
+    if (reader->run_remaining > 0)
+    {
+        reader->run_remaining -= 1;
+        prev->cycle += reader->run_delta;
+        *event = *prev;
+
+        return STATUS_SUCCESS;
+    }
+
+    /* skip over dropped event records. */
+    while (VIRTUAL_DEVICE_TRACE_TAG_DROPPED == (tag = fgetc(reader->in)))
+    {
+        if (!read_varint(reader->in, &value))
+        {
+            return VIRTUAL_DEVICE_ERROR_TRACE_FORMAT;
+        }
+
+        reader->dropped += value;
+    }
+
+    if (EOF == tag)
+    {
+        return VIRTUAL_DEVICE_ERROR_TRACE_END;
+    }
+
+    /* no other tag has the high bits set. */
+    if (tag & 0xE0)
+    {
+        return VIRTUAL_DEVICE_ERROR_TRACE_FORMAT;
+    }
+
+    if (tag & VIRTUAL_DEVICE_TRACE_TAG_RUN)
+    {
+        if (!read_varint(reader->in, &reader->run_remaining))
+        {
+            return VIRTUAL_DEVICE_ERROR_TRACE_FORMAT;
+        }
+    }
+
+    if (!read_varint(reader->in, &reader->run_delta))
+    {
+        return VIRTUAL_DEVICE_ERROR_TRACE_FORMAT;
+    }
+    prev->cycle += reader->run_delta;
+    prev->write = 0 != (tag & VIRTUAL_DEVICE_TRACE_TAG_WRITE);
+
+    /* undo the zigzag address delta. */
+    if (!(tag & VIRTUAL_DEVICE_TRACE_TAG_SAME_ADDRESS))
+    {
+        if (!read_varint(reader->in, &value))
+        {
+            return VIRTUAL_DEVICE_ERROR_TRACE_FORMAT;
+        }
+
+        uint16_t delta = (uint16_t)((value >> 1) ^ (~(value & 1) + 1));
+        prev->address = (uint16_t)(prev->address + delta);
+    }
+
+    if (!(tag & VIRTUAL_DEVICE_TRACE_TAG_SAME_DEVICE))
+    {
+        if (!read_varint(reader->in, &value))
+        {
+            return VIRTUAL_DEVICE_ERROR_TRACE_FORMAT;
+        }
+
+        prev->device = (uint16_t)value;
+    }
+
+    if (!(tag & VIRTUAL_DEVICE_TRACE_TAG_SAME_VALUE))
+    {
+        int byte = fgetc(reader->in);
+        if (EOF == byte)
+        {
+            return VIRTUAL_DEVICE_ERROR_TRACE_FORMAT;
+        }
+
+        prev->value = (uint8_t)byte;
+    }
+
+    *event = *prev;
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief Read an unsigned LEB128 varint.
+ *
+ * \param in                The stream to read.
+ * \param value             Pointer to receive the value.
+ *
+ * \returns true if a complete varint was read.
+ */
+static bool read_varint(FILE* in, uint64_t* value)
+{
+    uint64_t result = 0;
+
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        int byte = fgetc(in);
+        if (EOF == byte)
+        {
+            return false;
+        }
+
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            *value = result;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_trace_reader_next_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
@@ -0,0 +1,42 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_trace_record.c
+ *
+ * \brief Record a bus event.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "trace_ring.h"
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+/* emit the external definition of the inline ring push. */
+extern inline void virtual_device_trace_push(
+    virtual_device_trace* trace, uint16_t address, uint8_t value, bool write,
+    uint16_t device);
+
+/**
+ * \brief Record a bus event.
+ *
+ * This must only be called from the emulator thread.
+ *
+ * \param trace             The trace recorder.
+ * \param address           The address accessed.
+ * \param value             The value read or written.
+ * \param write             true for a write, false for a read.
+ * \param device            The id of the device servicing the access.
+ */
+void virtual_device_trace_record(
+    virtual_device_trace* trace, uint16_t address, uint8_t value, bool write,
+    uint16_t device)
+{
+    virtual_device_trace_push(trace, address, value, write, device);
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_trace_record_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
@@ -0,0 +1,63 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_trace_release.c
+ *
+ * \brief Stop and release a trace recorder.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "status.h"
+#include "trace_ring.h"
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Stop the drain thread, write every remaining event, and release the
+ * trace recorder.
+ *
+ * The recorder must be detached from its device manager first.
+ *
+ * \param trace             The trace recorder to release.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_TRACE_IO if the trace could not be written.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_trace_release(virtual_device_trace* trace)
+{
+    status retval = STATUS_SUCCESS;
+
+    /* stop the drain thread. */
+    atomic_store_explicit(&trace->running, false, memory_order_release);
+    pthread_join(trace->thread, NULL);
+
+    /* drain what is left, and write it out. */
+    virtual_device_trace_drain(trace);
+    virtual_device_trace_flush(trace);
+    if (trace->io_error)
+    {
+        retval = VIRTUAL_DEVICE_ERROR_TRACE_IO;
+    }
+
+    /* free the ring and the recorder. */
+    free(trace->ring);
+    memset(trace, 0, sizeof(*trace));
+    free(trace);
+
+    return retval;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_trace_release_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
@@ -0,0 +1,46 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_trace_write.c
+ *
+ * \brief Write the trace encoder's output buffer to its stream.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "trace_ring.h"
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+/* emit the external definitions of the inline output helpers. */
+extern inline void virtual_device_trace_put(
+    virtual_device_trace* trace, uint8_t byte);
+extern inline void virtual_device_trace_put_varint(
+    virtual_device_trace* trace, uint64_t value);
+
+/**
+ * \brief Write the encoder's output buffer to the trace stream.
+ *
+ * \param trace             The trace recorder.
+ */
+void virtual_device_trace_write(virtual_device_trace* trace)
+{
+    if (0 == trace->buffer_size)
+    {
+        return;
+    }
+
+    if (trace->buffer_size
+            != fwrite(trace->buffer, 1, trace->buffer_size, trace->out))
+    {
+        trace->io_error = true;
+    }
+
+    trace->buffer_size = 0;
+}
+
+#else
+
+/* ISO C requires a translation unit to contain a declaration. */
+typedef int virtual_device_trace_write_unused;
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
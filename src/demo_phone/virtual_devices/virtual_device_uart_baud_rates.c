@@ -0,0 +1,24 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_baud_rates.c
+ *
+ * \brief The 6551 baud rate selections.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+/**
+ * \brief The rate of each CONTROL baud rate selection, in hundredths of a
+ * baud.
+ *
+ * Selection zero runs from an external 16x clock, which is taken to be that of
+ * a 115200 baud line.
+ */
+const uint32_t virtual_device_uart_baud_rates[UART_CONTROL_BAUD + 1] = {
+    11520000,     5000,     7500,    10992,
+       13458,    15000,    30000,    60000,
+      120000,   180000,   240000,   360000,
+      480000,   720000,   960000,  1920000,
+};
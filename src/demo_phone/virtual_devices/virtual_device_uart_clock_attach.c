@@ -0,0 +1,59 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_clock_attach.c
+ *
+ * \brief Time the UART's characters from a scheduler.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/* emit the external definitions of the inline character timing. */
+extern inline bool virtual_device_uart_timed(const virtual_device_uart* uart);
+extern inline uint64_t virtual_device_uart_char_cycles(
+    const virtual_device_uart* uart);
+
+/**
+ * \brief Time the UART's characters from the given scheduler's cycle counter.
+ *
+ * Characters already on the line restart from the current cycle.  Attaching
+ * no scheduler, or a clock rate of \ref UART_INSTANT, switches to instant
+ * delivery, and delivers the characters on the line at once.
+ *
+ * \param uart          The UART instance.
+ * \param scheduler     The scheduler to post character deadlines to, or NULL.
+ * \param clock_hz      The rate of the scheduler's cycle counter, in Hz.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_uart_clock_attach(
+    virtual_device_uart* uart, virtual_device_scheduler* scheduler,
+    uint32_t clock_hz)
+{
+    if (NULL != uart->scheduler)
+    {
+        virtual_device_scheduler_cancel(uart->scheduler, &uart->rx_event);
+        virtual_device_scheduler_cancel(uart->scheduler, &uart->tx_event);
+    }
+
+    uart->scheduler = scheduler;
+    uart->clock_hz = clock_hz;
+
+    if (virtual_device_uart_timed(uart))
+    {
+        uint64_t next =
+            virtual_device_scheduler_now(scheduler)
+          + virtual_device_uart_char_cycles(uart);
+
+        uart->rx_next = next;
+        uart->tx_next = next;
+    }
+
+    return virtual_device_uart_sync(uart);
+}
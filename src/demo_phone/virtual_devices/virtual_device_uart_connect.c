@@ -0,0 +1,25 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_connect.c
+ *
+ * \brief Connect the peripheral on the UART's transmit line.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+/**
+ * \brief Connect the peripheral that takes the UART's transmitted characters.
+ *
+ * \param uart          The UART instance.
+ * \param transmit      The callback for each character, or NULL to drop them.
+ * \param context       The user context for the callback.
+ */
+void virtual_device_uart_connect(
+    virtual_device_uart* uart, virtual_device_uart_tx_fn transmit,
+    void* context)
+{
+    uart->transmit = transmit;
+    uart->transmit_context = context;
+}
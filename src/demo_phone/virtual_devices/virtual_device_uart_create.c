@@ -0,0 +1,29 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_create.c
+ *
+ * \brief Create the UART virtual device.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+/**
+ * \brief Create a virtual UART device for the demo phone.
+ *
+ * \param uart          Pointer to the virtual UART device instance pointer to
+ *                      be set to the created instance on success.
+ * \param rx_depth      The depth of the receive FIFO; zero is taken as one.
+ * \param tx_depth      The depth of the transmit FIFO; zero is taken as one.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_uart_create(
+    virtual_device_uart** uart, uint16_t rx_depth, uint16_t tx_depth)
+{
+    return virtual_device_uart_create_in_arena(uart, NULL, rx_depth, tx_depth);
+}
@@ -0,0 +1,80 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_create_in_arena.c
+ *
+ * \brief Create the UART virtual device in an arena.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <jemu65c02/status.h>
+#include <string.h>
+
+#include "uart.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Create a virtual UART device for the demo phone in the given arena.
+ *
+ * The UART comes out of reset with DTR off and receive interrupts disabled,
+ * and delivers characters instantly until a clock is attached.
+ *
+ * \param uart          Pointer to the virtual UART device instance pointer to
+ *                      be set to the created instance on success.
+ * \param arena         The arena to allocate from, or NULL to use the
+ *                      default allocator.
+ * \param rx_depth      The depth of the receive FIFO; zero is taken as one.
+ * \param tx_depth      The depth of the transmit FIFO; zero is taken as one.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_uart_create_in_arena(
+    virtual_device_uart** uart, virtual_device_arena* arena,
+    uint16_t rx_depth, uint16_t tx_depth)
+{
+    virtual_device_uart* tmp = NULL;
+    size_t size;
+
+    if (0 == rx_depth)
+    {
+        rx_depth = 1;
+    }
+
+    if (0 == tx_depth)
+    {
+        tx_depth = 1;
+    }
+
+    /* allocate the UART, its FIFOs, and its line together. */
+    size = sizeof(*tmp) + rx_depth + tx_depth + UART_LINE_DEPTH;
+    tmp = (virtual_device_uart*)virtual_device_alloc(arena, size);
+    if (NULL == tmp)
+    {
+        return JEMU_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* clear memory. */
+    memset(tmp, 0, size);
+
+    /* the FIFOs and line follow the UART, so its state block runs through
+     * them. */
+    tmp->arena = arena;
+    tmp->rx_fifo = (uint8_t*)(tmp + 1);
+    tmp->tx_fifo = tmp->rx_fifo + rx_depth;
+    tmp->line = tmp->tx_fifo + tx_depth;
+    tmp->rx_depth = rx_depth;
+    tmp->tx_depth = tx_depth;
+    UART_SHADOW(tmp, UART_REGISTER_COMMAND) = UART_COMMAND_RX_IRQ_OFF;
+    virtual_device_event_init(
+        &tmp->rx_event, &virtual_device_uart_rx_event, tmp);
+    virtual_device_event_init(
+        &tmp->tx_event, &virtual_device_uart_tx_event, tmp);
+
+    *uart = tmp;
+
+    return STATUS_SUCCESS;
+}
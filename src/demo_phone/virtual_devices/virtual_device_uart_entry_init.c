@@ -0,0 +1,49 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_entry_init.c
+ *
+ * \brief Describe a UART as a device entry, with its shadow registers.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "uart.h"
+
+/**
+ * \brief Describe a UART as a device entry, with its shadow registers.
+ *
+ * In a VIRTUAL_DEVICE_SNAPSHOT build, the entry also declares the UART's state
+ * block, so that snapshots save and restore its registers and FIFOs, and a
+ * restore handler that resumes its character timing.
+ *
+ * \param uart          The UART instance.
+ * \param entry         The entry to initialize.
+ * \param register_low  The first UART register, which must be aligned to
+ *                      \ref UART_REGISTER_COUNT.
+ */
+void virtual_device_uart_entry_init(
+    virtual_device_uart* uart, virtual_device_entry* entry,
+    uint16_t register_low)
+{
+    memset(entry, 0, sizeof(*entry));
+
+    entry->register_low = register_low;
+    entry->register_high =
+        (uint16_t)(register_low + UART_REGISTER_COUNT - 1);
+    entry->context = uart;
+    entry->read = &virtual_device_uart_read_callback;
+    entry->write = &virtual_device_uart_write_callback;
+    entry->shadow = uart->shadow;
+    entry->shadow_flags = virtual_device_uart_shadow_flags;
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+    entry->state = uart->shadow;
+    entry->state_size =
+        sizeof(*uart) - offsetof(virtual_device_uart, shadow)
+      + uart->rx_depth + uart->tx_depth + UART_LINE_DEPTH;
+    entry->state_version = VIRTUAL_DEVICE_UART_STATE_VERSION;
+    entry->restore = &virtual_device_uart_restore_callback;
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
+}
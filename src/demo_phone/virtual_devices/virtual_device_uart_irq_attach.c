@@ -0,0 +1,47 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_irq_attach.c
+ *
+ * \brief Drive the UART's interrupt output into an IRQ aggregator.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/* emit the external definition of the inline IRQ update. */
+extern inline void virtual_device_uart_irq_update(virtual_device_uart* uart);
+
+/**
+ * \brief Drive the UART's interrupt output into the given IRQ aggregator.
+ *
+ * To route the UART through a VIA handshake line, as the modem driver does,
+ * attach it to an aggregator whose line drives the VIA's CA1 input.
+ *
+ * \param uart          The UART instance.
+ * \param irq           The aggregator.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_IRQ_SOURCES if the aggregator has no room for
+ *        another source.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_uart_irq_attach(
+    virtual_device_uart* uart, virtual_device_irq* irq)
+{
+    status retval;
+
+    retval = virtual_device_irq_source_add(irq, &uart->irq_source);
+    if (STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    uart->irq = irq;
+    virtual_device_uart_irq_update(uart);
+
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,35 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_read_callback.c
+ *
+ * \brief Read callback for the UART device.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/* emit the external definitions of the inline register handler. */
+extern inline bool virtual_device_uart_irq_level(
+    const virtual_device_uart* uart);
+extern inline JEMU_SYM(status) virtual_device_uart_read(
+    virtual_device_uart* uart, uint16_t addr, uint8_t* byte);
+
+/**
+ * \brief Read callback for the UART device.
+ *
+ * \param uart          An opaque reference to the UART instance.
+ * \param addr          The address for the read operation.
+ * \param byte          Pointer to receive the byte read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_uart_read_callback(
+    void* uart, uint16_t addr, uint8_t* byte)
+{
+    return virtual_device_uart_read((virtual_device_uart*)uart, addr, byte);
+}
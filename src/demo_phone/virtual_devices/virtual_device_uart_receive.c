@@ -0,0 +1,84 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_receive.c
+ *
+ * \brief Send characters from the peripheral to the UART.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/* emit the external definition of the inline FIFO space. */
+extern inline size_t virtual_device_uart_rx_space(
+    const virtual_device_uart* uart);
+
+/**
+ * \brief Send characters from the peripheral to the UART.
+ *
+ * Characters that arrive to find the receive FIFO full are lost, and set the
+ * overrun flag.  In timed mode, the characters go onto the line, and arrive
+ * one character time apart.  While DTR is off, the receiver is disabled, and
+ * characters are lost without an overrun.
+ *
+ * \param uart          The UART instance.
+ * \param data          The characters.
+ * \param size          The number of characters.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_UART_LINE_FULL if the characters do not fit on
+ *        the line; none of them are sent.
+ *      - a non-zero error code if a character deadline could not be posted.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_uart_receive(
+    virtual_device_uart* uart, const uint8_t* data, size_t size)
+{
+    bool timed = virtual_device_uart_timed(uart);
+
+    if (!(UART_SHADOW(uart, UART_REGISTER_COMMAND) & UART_COMMAND_DTR))
+    {
+        return STATUS_SUCCESS;
+    }
+
+    /* a timed burst goes onto the line whole, or not at all. */
+    if (timed && size > (size_t)UART_LINE_DEPTH - uart->line_count)
+    {
+        return VIRTUAL_DEVICE_ERROR_UART_LINE_FULL;
+    }
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        size_t tail = ((size_t)uart->line_head + uart->line_count)
+                    % UART_LINE_DEPTH;
+
+        /* an idle line starts on the character at once. */
+        if (timed && 0 == uart->line_count)
+        {
+            uart->rx_next =
+                virtual_device_scheduler_now(uart->scheduler)
+              + virtual_device_uart_char_cycles(uart);
+        }
+
+        uart->line[tail] = data[i];
+        uart->line_count += 1;
+
+        /* without timing, the character arrives as it is sent. */
+        if (!timed)
+        {
+            virtual_device_uart_rx_arrive(uart);
+        }
+    }
+
+    virtual_device_uart_irq_update(uart);
+
+    if (!timed)
+    {
+        return STATUS_SUCCESS;
+    }
+
+    return virtual_device_uart_sync(uart);
+}
@@ -0,0 +1,51 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_release.c
+ *
+ * \brief Release the UART virtual device.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <string.h>
+
+#include "uart.h"
+
+/**
+ * \brief Release a virtual UART device instance.
+ *
+ * \note After this call, the instance pointer is no longer valid.
+ *
+ * \param uart          The instance to release.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_uart_release(virtual_device_uart* uart)
+{
+    virtual_device_arena* arena = uart->arena;
+
+    /* the character events must not outlive the UART. */
+    if (NULL != uart->scheduler)
+    {
+        virtual_device_scheduler_cancel(uart->scheduler, &uart->rx_event);
+        virtual_device_scheduler_cancel(uart->scheduler, &uart->tx_event);
+    }
+
+    /* nor may its interrupt request. */
+    if (NULL != uart->irq)
+    {
+        virtual_device_irq_set(uart->irq, uart->irq_source, false);
+    }
+
+    /* clear memory. */
+    memset(uart, 0, sizeof(*uart));
+
+    /* release memory. */
+    virtual_device_free(arena, uart);
+
+    /* success. */
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,33 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_restore_callback.c
+ *
+ * \brief Restore callback for the UART device.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Restore callback for the UART device.
+ *
+ * Posts the UART's character events again and drives its IRQ output, to match
+ * its restored state.
+ *
+ * \param uart          An opaque reference to the UART instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_uart_restore_callback(void* uart)
+{
+    virtual_device_uart* u = (virtual_device_uart*)uart;
+
+    virtual_device_uart_irq_update(u);
+
+    return virtual_device_uart_sync(u);
+}
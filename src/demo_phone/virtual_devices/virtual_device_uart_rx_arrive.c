@@ -0,0 +1,35 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_rx_arrive.c
+ *
+ * \brief Move a character from the line into the receive FIFO.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+/**
+ * \brief Move the oldest character on the line into the receive FIFO.
+ *
+ * The character is lost, and sets the overrun flag, if the receive FIFO is
+ * full.  The line must not be empty.
+ *
+ * \param uart          The UART instance.
+ */
+void virtual_device_uart_rx_arrive(virtual_device_uart* uart)
+{
+    uint8_t byte = uart->line[uart->line_head];
+
+    uart->line_head = (uint16_t)((uart->line_head + 1) % UART_LINE_DEPTH);
+    uart->line_count -= 1;
+
+    if (uart->rx_count >= uart->rx_depth)
+    {
+        uart->errors |= UART_STATUS_OVERRUN;
+        return;
+    }
+
+    uart->rx_fifo[(uart->rx_head + uart->rx_count) % uart->rx_depth] = byte;
+    uart->rx_count += 1;
+}
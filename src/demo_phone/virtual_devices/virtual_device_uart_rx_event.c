@@ -0,0 +1,40 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_rx_event.c
+ *
+ * \brief Handle the arrival of a received character.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Handle the arrival of a received character.
+ *
+ * \param uart          An opaque reference to the UART instance.
+ * \param deadline      The cycle the event was due.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_uart_rx_event(void* uart, uint64_t deadline)
+{
+    virtual_device_uart* u = (virtual_device_uart*)uart;
+
+    /* the character only needs room in the FIFO once it has arrived. */
+    virtual_device_uart_rx_arrive(u);
+
+    /* the next character follows on the line. */
+    if (u->line_count > 0)
+    {
+        u->rx_next = deadline + virtual_device_uart_char_cycles(u);
+    }
+
+    virtual_device_uart_irq_update(u);
+
+    return virtual_device_uart_sync(u);
+}
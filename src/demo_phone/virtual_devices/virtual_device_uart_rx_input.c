@@ -0,0 +1,32 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_rx_input.c
+ *
+ * \brief Input callback for characters sent to the UART.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Input callback for a character sent by the peripheral to the UART.
+ *
+ * This is \ref virtual_device_uart_receive for one character, in the shape of
+ * a device input, so that a journal can record and replay modem traffic.
+ *
+ * \param uart          An opaque reference to the UART instance.
+ * \param byte          The character.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_UART_LINE_FULL if the line has no room for the
+ *        character.
+ *      - a non-zero error code if a character deadline could not be posted.
+ */
+JEMU_SYM(status) virtual_device_uart_rx_input(void* uart, uint8_t byte)
+{
+    return virtual_device_uart_receive((virtual_device_uart*)uart, &byte, 1);
+}
@@ -0,0 +1,29 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_shadow_flags.c
+ *
+ * \brief The shadow flags for the UART registers.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+#define UART_SHADOW_FLAGS(reg) [(reg) - UART_REGISTER_DATA]
+#define UART_SHADOW_RW \
+    (VIRTUAL_DEVICE_SHADOW_READ | VIRTUAL_DEVICE_SHADOW_WRITE)
+#define UART_SHADOW_RT \
+    (VIRTUAL_DEVICE_SHADOW_READ | VIRTUAL_DEVICE_SHADOW_WRITE_THROUGH)
+
+/**
+ * \brief The shadow flags for each UART register, by register offset.
+ *
+ * CONTROL only takes effect at the next character, so reads and writes are
+ * served from the shadow array.  COMMAND is read from the shadow array, but
+ * writing it enables and disables interrupts, so those writes are written
+ * through to the UART.  DATA and STATUS go through the UART callbacks.
+ */
+const uint8_t virtual_device_uart_shadow_flags[UART_REGISTER_COUNT] = {
+    UART_SHADOW_FLAGS(UART_REGISTER_COMMAND) = UART_SHADOW_RT,
+    UART_SHADOW_FLAGS(UART_REGISTER_CONTROL) = UART_SHADOW_RW,
+};
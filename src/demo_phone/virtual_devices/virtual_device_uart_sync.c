@@ -0,0 +1,80 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_sync.c
+ *
+ * \brief Post the UART's character events.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Post the UART's character events for rx_next and tx_next, or, in
+ * instant mode, deliver the characters on the line.
+ *
+ * \ref virtual_device_uart_restore_callback calls this after a snapshot
+ * restores the UART's state.
+ *
+ * \param uart          The UART instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_uart_sync(virtual_device_uart* uart)
+{
+    status retval;
+
+    if (!virtual_device_uart_timed(uart))
+    {
+        if (NULL != uart->scheduler)
+        {
+            virtual_device_scheduler_cancel(uart->scheduler, &uart->rx_event);
+            virtual_device_scheduler_cancel(uart->scheduler, &uart->tx_event);
+        }
+
+        /* the line takes no time. */
+        while (uart->line_count > 0)
+        {
+            virtual_device_uart_rx_arrive(uart);
+        }
+        while (uart->tx_count > 0)
+        {
+            virtual_device_uart_tx_send(uart);
+        }
+
+        virtual_device_uart_irq_update(uart);
+
+        return STATUS_SUCCESS;
+    }
+
+    if (uart->line_count > 0)
+    {
+        retval =
+            virtual_device_scheduler_post(
+                uart->scheduler, &uart->rx_event, uart->rx_next);
+        if (STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+    }
+    else
+    {
+        virtual_device_scheduler_cancel(uart->scheduler, &uart->rx_event);
+    }
+
+    if (uart->tx_count > 0)
+    {
+        return
+            virtual_device_scheduler_post(
+                uart->scheduler, &uart->tx_event, uart->tx_next);
+    }
+
+    virtual_device_scheduler_cancel(uart->scheduler, &uart->tx_event);
+
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,56 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_transmit.c
+ *
+ * \brief Queue a character for transmission.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Queue a character written by the CPU for transmission.
+ *
+ * A character written while the transmit FIFO is full is lost.
+ *
+ * \param uart          The UART instance.
+ * \param byte          The character.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code if a character deadline could not be posted.
+ */
+JEMU_SYM(status) virtual_device_uart_transmit(
+    virtual_device_uart* uart, uint8_t byte)
+{
+    if (uart->tx_count == uart->tx_depth)
+    {
+        return STATUS_SUCCESS;
+    }
+
+    uart->tx_fifo[(uart->tx_head + uart->tx_count) % uart->tx_depth] = byte;
+    uart->tx_count += 1;
+
+    if (!virtual_device_uart_timed(uart))
+    {
+        virtual_device_uart_tx_send(uart);
+        virtual_device_uart_irq_update(uart);
+
+        return STATUS_SUCCESS;
+    }
+
+    /* an idle transmitter starts on the character at once. */
+    if (1 == uart->tx_count)
+    {
+        uart->tx_next =
+            virtual_device_scheduler_now(uart->scheduler)
+          + virtual_device_uart_char_cycles(uart);
+    }
+
+    virtual_device_uart_irq_update(uart);
+
+    return virtual_device_uart_sync(uart);
+}
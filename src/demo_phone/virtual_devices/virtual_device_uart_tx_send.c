@@ -0,0 +1,30 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_tx_send.c
+ *
+ * \brief Send a character to the peripheral.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+/**
+ * \brief Send the oldest character in the transmit FIFO to the peripheral.
+ *
+ * The transmit FIFO must not be empty.
+ *
+ * \param uart          The UART instance.
+ */
+void virtual_device_uart_tx_send(virtual_device_uart* uart)
+{
+    uint8_t byte = uart->tx_fifo[uart->tx_head];
+
+    uart->tx_head = (uint16_t)((uart->tx_head + 1) % uart->tx_depth);
+    uart->tx_count -= 1;
+
+    if (NULL != uart->transmit)
+    {
+        uart->transmit(uart->transmit_context, byte);
+    }
+}
@@ -0,0 +1,33 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_uart_write_callback.c
+ *
+ * \brief Write callback for the UART device.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "uart.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/* emit the external definition of the inline register handler. */
+extern inline JEMU_SYM(status) virtual_device_uart_write(
+    virtual_device_uart* uart, uint16_t addr, uint8_t byte);
+
+/**
+ * \brief Write callback for the UART device.
+ *
+ * \param uart          An opaque reference to the UART instance.
+ * \param addr          The address for the write operation.
+ * \param byte          The byte to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_uart_write_callback(
+    void* uart, uint16_t addr, uint8_t byte)
+{
+    return virtual_device_uart_write((virtual_device_uart*)uart, addr, byte);
+}
@@ -0,0 +1,61 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_acr_write.c
+ *
+ * \brief Write the VIA's auxiliary control register.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Write the auxiliary control register, switching the timer modes.
+ *
+ * A timer whose mode changes carries on from its current count.  The ACR is
+ * written through its shadow byte, so the timers keep the mode they run under
+ * in timer_mode, and the shift register in sr_mode.  Changing the shift
+ * register mode stops the shift register.
+ *
+ * \param via           The VIA instance.
+ * \param byte          The new ACR value.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_via_acr_write(
+    virtual_device_via* via, uint8_t byte)
+{
+    uint8_t changed = (uint8_t)((via->timer_mode ^ byte) & VIA_ACR_TIMER_MODE);
+    uint8_t shift = (uint8_t)((via->sr_mode ^ byte) & VIA_ACR_SR_MODE);
+    uint64_t now = virtual_device_via_now(via);
+
+    /* take the counts under the old modes. */
+    uint16_t t1 = virtual_device_via_t1_counter(via);
+    uint16_t t2 = virtual_device_via_t2_counter(via);
+
+    VIA_SHADOW(via, VIA_REGISTER_ACR) = byte;
+    via->sr_mode = (uint8_t)(byte & VIA_ACR_SR_MODE);
+    if (shift)
+    {
+        virtual_device_via_sr_stop(via);
+    }
+    via->timer_mode = (uint8_t)(byte & VIA_ACR_TIMER_MODE);
+
+    if (changed & VIA_ACR_T1_FREE_RUN)
+    {
+        via->t1_base = now;
+        via->t1_start = t1;
+    }
+
+    if (changed & VIA_ACR_T2_PULSE_COUNT)
+    {
+        via->t2_base = now;
+        via->t2_start = t2;
+    }
+
+    return virtual_device_via_timer_sync(via);
+}
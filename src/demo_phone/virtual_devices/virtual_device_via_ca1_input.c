@@ -0,0 +1,32 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_ca1_input.c
+ *
+ * \brief Input callback for the VIA's CA1 line.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Input callback for the level driven onto the VIA's CA1 line.
+ *
+ * An active transition, as selected by PCR, sets the CA1 flag, latches port A
+ * if ACR enables it, and ends a CA2 handshake.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ * \param value         The line level; any non-zero value is high.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ */
+JEMU_SYM(status) virtual_device_via_ca1_input(void* via, uint8_t value)
+{
+    virtual_device_via_control_input(
+        (virtual_device_via*)via, VIA_CONTROL_CA1, 0 != value);
+
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,89 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_control_input.c
+ *
+ * \brief Drive one of the VIA's handshake lines from outside.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+/**
+ * \brief Drive one of the VIA's handshake lines from outside.
+ *
+ * This is used by the CA1, CA2, CB1, and CB2 input callbacks.
+ *
+ * \param via           The VIA instance.
+ * \param line          The \ref VIA_CONTROL_CA1 style bit of the line.
+ * \param high          true if the line is driven high.
+ */
+void virtual_device_via_control_input(
+    virtual_device_via* via, uint8_t line, bool high)
+{
+    uint8_t port =
+        (line & (VIA_CONTROL_CA1 | VIA_CONTROL_CA2)) ? VIA_PORT_A : VIA_PORT_B;
+    uint8_t pcr = VIA_PCR_SIDE(VIA_SHADOW(via, VIA_REGISTER_PCR), port);
+    uint8_t previous = via->control_in;
+
+    if (high)
+    {
+        via->control_in |= line;
+    }
+    else
+    {
+        via->control_in &= (uint8_t)~line;
+    }
+
+    /* only transitions matter. */
+    if (previous == via->control_in)
+    {
+        return;
+    }
+
+    if (line == VIA_CONTROL_C1(port))
+    {
+        /* the peripheral may clock the shift register on CB1. */
+        if (VIA_CONTROL_CB1 == line)
+        {
+            uint8_t mode =
+                VIA_SHADOW(via, VIA_REGISTER_ACR) & VIA_ACR_SR_MODE;
+
+            if (VIA_SR_IN_CB1 == mode || VIA_SR_OUT_CB1 == mode)
+            {
+                virtual_device_via_sr_edge(via, high);
+            }
+        }
+
+        if (high == (0 != (pcr & VIA_PCR_C1_POSITIVE)))
+        {
+            via->ifr |= VIA_IFR_C1(port);
+
+            /* latch the inputs, for ACR input latching. */
+            if (VIA_PORT_A == port)
+            {
+                via->ira_latch = via->ira;
+            }
+            else
+            {
+                via->irb_latch = via->irb;
+            }
+
+            /* the peripheral's strobe ends a handshake. */
+            if (VIA_PCR_C2_HANDSHAKE == (pcr & VIA_PCR_C2_MODE))
+            {
+                via->control_out |= VIA_CONTROL_C2(port);
+            }
+        }
+    }
+    else if (!(pcr & VIA_PCR_C2_OUTPUT))
+    {
+        if (high == (0 != (pcr & VIA_PCR_C2_POSITIVE)))
+        {
+            via->ifr |= VIA_IFR_C2(port);
+        }
+    }
+
+    virtual_device_via_pins_update(via, VIA_PORT_CONTROL);
+    virtual_device_via_irq_update(via);
+}
@@ -7,14 +7,8 @@
  * distribution for the license terms under which this software is distributed.
  */
 
-#include <jemu65c02/status.h>
-#include <stdlib.h>
-#include <string.h>
-
 #include "via.h"
 
-JEMU_IMPORT_jemu65c02;
-
 /**
  * \brief Create a virtual VIA device for the demo phone.
  *
@@ -29,28 +23,5 @@ JEMU_SYM(status) FN_DECL_MUST_CHECK
 virtual_device_via_create(
     virtual_device_via** via)
 {
-    status retval;
-    virtual_device_via* tmp = NULL;
-
-    /* allocate memory for this device. */
-    tmp = (virtual_device_via*)malloc(sizeof(*tmp));
-    if (NULL == tmp)
-    {
-        retval = JEMU_ERROR_OUT_OF_MEMORY;
-        goto done;
-    }
-
-    /* clear memory. */
-    memset(tmp, 0, sizeof(*tmp));
-
-    /* initialize device. */
-    /* NOP for now. */
-
-    /* success. */
-    *via = tmp;
-    retval = STATUS_SUCCESS;
-    goto done;
-
-done:
-    return retval;
+    return virtual_device_via_create_in_arena(via, NULL);
 }
@@ -0,0 +1,61 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_create_in_arena.c
+ *
+ * \brief Create the VIA virtual device in an arena.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <jemu65c02/status.h>
+#include <string.h>
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Create a virtual VIA device for the demo phone in the given arena.
+ *
+ * \param via           Pointer to the virtual VIA device instance pointer to
+ *                      be set to the created instance on success.
+ * \param arena         The arena to allocate from, or NULL to use the
+ *                      default allocator.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_via_create_in_arena(
+    virtual_device_via** via, virtual_device_arena* arena)
+{
+    status retval;
+    virtual_device_via* tmp = NULL;
+
+    /* allocate memory for this device. */
+    tmp = (virtual_device_via*)virtual_device_alloc(arena, sizeof(*tmp));
+    if (NULL == tmp)
+    {
+        retval = JEMU_ERROR_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    /* clear memory. */
+    memset(tmp, 0, sizeof(*tmp));
+
+    /* initialize device; its timers wait for a scheduler. */
+    tmp->arena = arena;
+    virtual_device_event_init(
+        &tmp->timer_event, &virtual_device_via_timer_event, tmp);
+    virtual_device_event_init(
+        &tmp->sr_event, &virtual_device_via_sr_event, tmp);
+
+    /* success. */
+    *via = tmp;
+    retval = STATUS_SUCCESS;
+    goto done;
+
+done:
+    return retval;
+}
@@ -0,0 +1,52 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_entry_init.c
+ *
+ * \brief Describe a VIA as a device entry, with its shadow registers.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Describe a VIA as a device entry, with its shadow registers.
+ *
+ * In a VIRTUAL_DEVICE_SNAPSHOT build, the entry also declares the VIA's state
+ * block, so that snapshots save and restore its registers, and a restore
+ * handler that resumes its timers and shift register and republishes its pins.
+ *
+ * The entry can then be registered with
+ * \ref virtual_device_manager_entry_register or attached with
+ * \ref virtual_device_manager_entry_attach.
+ *
+ * \param via           The VIA instance.
+ * \param entry         The entry to initialize.
+ * \param register_low  The first VIA register, which must be aligned to
+ *                      \ref VIA_REGISTER_COUNT.
+ */
+void virtual_device_via_entry_init(
+    virtual_device_via* via, virtual_device_entry* entry,
+    uint16_t register_low)
+{
+    memset(entry, 0, sizeof(*entry));
+
+    entry->register_low = register_low;
+    entry->register_high = (uint16_t)(register_low + VIA_REGISTER_COUNT - 1);
+    entry->context = via;
+    entry->read = &virtual_device_via_read_callback;
+    entry->write = &virtual_device_via_write_callback;
+    entry->shadow = via->shadow;
+    entry->shadow_flags = virtual_device_via_shadow_flags;
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+    entry->state = via->shadow;
+    entry->state_size = sizeof(*via) - offsetof(virtual_device_via, shadow);
+    entry->state_version = VIRTUAL_DEVICE_VIA_STATE_VERSION;
+    entry->restore = &virtual_device_via_restore_callback;
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
+}
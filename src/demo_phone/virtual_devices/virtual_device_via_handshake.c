@@ -0,0 +1,57 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_handshake.c
+ *
+ * \brief Carry out the handshake for a CPU access to a VIA port.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+/**
+ * \brief Carry out the handshake for a CPU access to port A or port B.
+ *
+ * The access clears the port's C1 flag, and its C2 flag unless C2 is an
+ * independent interrupt input.  In handshake mode, C2 goes low until the next
+ * active C1 edge; in pulse mode, it goes low and straight back high.  Port B
+ * only strobes CB2 on writes.
+ *
+ * \param via           The VIA instance.
+ * \param port          \ref VIA_PORT_A or \ref VIA_PORT_B.
+ * \param write         true for a write, false for a read.
+ */
+void virtual_device_via_handshake(
+    virtual_device_via* via, uint8_t port, bool write)
+{
+    uint8_t mode =
+        VIA_PCR_SIDE(VIA_SHADOW(via, VIA_REGISTER_PCR), port)
+      & VIA_PCR_C2_MODE;
+    uint8_t clear = VIA_IFR_C1(port);
+
+    if (VIA_PCR_C2_INPUT_NEGATIVE == mode || VIA_PCR_C2_INPUT_POSITIVE == mode)
+    {
+        clear |= VIA_IFR_C2(port);
+    }
+
+    via->ifr &= (uint8_t)~clear;
+
+    if (write || VIA_PORT_A == port)
+    {
+        if (VIA_PCR_C2_HANDSHAKE == mode)
+        {
+            /* data ready, until the peripheral strobes C1. */
+            via->control_out &= (uint8_t)~VIA_CONTROL_C2(port);
+        }
+        else if (VIA_PCR_C2_PULSE == mode)
+        {
+            /* a one cycle strobe, published as a low and a high. */
+            via->control_out &= (uint8_t)~VIA_CONTROL_C2(port);
+            virtual_device_via_pins_update(via, VIA_PORT_CONTROL);
+            via->control_out |= VIA_CONTROL_C2(port);
+        }
+    }
+
+    virtual_device_via_pins_update(via, VIA_PORT_CONTROL);
+    virtual_device_via_irq_update(via);
+}
@@ -0,0 +1,43 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_irq_attach.c
+ *
+ * \brief Drive the VIA's interrupt output into an IRQ aggregator.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/* emit the external definition of the inline IRQ update. */
+extern inline void virtual_device_via_irq_update(virtual_device_via* via);
+
+/**
+ * \brief Drive the VIA's interrupt output into the given IRQ aggregator.
+ *
+ * \param via           The VIA instance.
+ * \param irq           The aggregator, usually the device manager's.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - VIRTUAL_DEVICE_ERROR_IRQ_SOURCES if the aggregator has no room for
+ *        another source.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_via_irq_attach(virtual_device_via* via, virtual_device_irq* irq)
+{
+    status retval;
+
+    retval = virtual_device_irq_source_add(irq, &via->irq_source);
+    if (STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    via->irq = irq;
+    virtual_device_via_irq_update(via);
+
+    return STATUS_SUCCESS;
+}
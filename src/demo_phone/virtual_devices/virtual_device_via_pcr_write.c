@@ -0,0 +1,41 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_pcr_write.c
+ *
+ * \brief Write the VIA's peripheral control register.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+/**
+ * \brief Write the peripheral control register, driving CA2 and CB2 when they
+ * become outputs.
+ *
+ * Manual output modes drive their line at once.  The handshake and pulse modes
+ * start with their line high, ready for the first access.
+ *
+ * \param via           The VIA instance.
+ * \param byte          The new PCR value.
+ */
+void virtual_device_via_pcr_write(virtual_device_via* via, uint8_t byte)
+{
+    VIA_SHADOW(via, VIA_REGISTER_PCR) = byte;
+
+    for (uint8_t port = VIA_PORT_B; port <= VIA_PORT_A; ++port)
+    {
+        uint8_t mode = VIA_PCR_SIDE(byte, port) & VIA_PCR_C2_MODE;
+
+        if (VIA_PCR_C2_LOW == mode)
+        {
+            via->control_out &= (uint8_t)~VIA_CONTROL_C2(port);
+        }
+        else if (mode & VIA_PCR_C2_OUTPUT)
+        {
+            via->control_out |= VIA_CONTROL_C2(port);
+        }
+    }
+
+    virtual_device_via_pins_update(via, VIA_PORT_CONTROL);
+}
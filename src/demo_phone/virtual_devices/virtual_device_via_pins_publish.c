@@ -0,0 +1,50 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_pins_publish.c
+ *
+ * \brief Publish a VIA port's new pin levels to its subscribers.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+/* emit the external definitions of the inline pin helpers. */
+extern inline uint8_t virtual_device_via_port_levels(
+    const virtual_device_via* via, uint8_t port);
+extern inline uint8_t virtual_device_via_port_read(
+    const virtual_device_via* via, uint8_t port);
+extern inline void virtual_device_via_pins_update(
+    virtual_device_via* via, uint8_t port);
+
+/**
+ * \brief Publish a port's new pin levels to the subscribers whose pins
+ * changed.
+ *
+ * A subscriber may unsubscribe itself from its callback.
+ *
+ * \param via           The VIA instance.
+ * \param port          \ref VIA_PORT_A or \ref VIA_PORT_B.
+ * \param levels        The new levels, which differ from the published ones.
+ */
+void virtual_device_via_pins_publish(
+    virtual_device_via* via, uint8_t port, uint8_t levels)
+{
+    uint8_t changed = (uint8_t)(levels ^ via->pins[port]);
+    virtual_device_via_subscription* sub = via->subscribers[port];
+
+    via->pins[port] = levels;
+
+    while (NULL != sub)
+    {
+        virtual_device_via_subscription* next = sub->next;
+
+        if (changed & sub->mask)
+        {
+            sub->notify(
+                sub->context, port, levels, (uint8_t)(changed & sub->mask));
+        }
+
+        sub = next;
+    }
+}
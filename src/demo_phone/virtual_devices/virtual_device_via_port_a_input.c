@@ -0,0 +1,31 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_port_a_input.c
+ *
+ * \brief Input callback for the VIA's port A pins.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Input callback for the levels driven onto the VIA's port A pins.
+ *
+ * Only the pins configured as inputs are seen by the firmware.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ * \param value         The pin levels.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ */
+JEMU_SYM(status) virtual_device_via_port_a_input(void* via, uint8_t value)
+{
+    ((virtual_device_via*)via)->ira = value;
+    virtual_device_via_pins_update((virtual_device_via*)via, VIA_PORT_A);
+
+    return STATUS_SUCCESS;
+}
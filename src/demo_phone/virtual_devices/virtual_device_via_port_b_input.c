@@ -0,0 +1,48 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_port_b_input.c
+ *
+ * \brief Input callback for the VIA's port B pins.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Input callback for the levels driven onto the VIA's port B pins.
+ *
+ * Only the pins configured as inputs are seen by the firmware.  In pulse
+ * counting mode, each falling edge on PB6 counts timer 2 down.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ * \param value         The pin levels.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ */
+JEMU_SYM(status) virtual_device_via_port_b_input(void* via, uint8_t value)
+{
+    virtual_device_via* v = (virtual_device_via*)via;
+    bool falling = (v->irb & VIA_PB6) && !(value & VIA_PB6);
+
+    v->irb = value;
+    virtual_device_via_pins_update(v, VIA_PORT_B);
+
+    if (falling && (v->timer_mode & VIA_ACR_T2_PULSE_COUNT))
+    {
+        v->t2_start = (uint16_t)(v->t2_start - 1);
+
+        /* the flag is raised when the count reaches zero. */
+        if (0 == v->t2_start && v->t2_armed)
+        {
+            v->ifr |= VIA_IFR_T2;
+            v->t2_armed = false;
+            virtual_device_via_irq_update(v);
+        }
+    }
+
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,33 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_read_callback.c
+ *
+ * \brief Read callback for the VIA device.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/* emit the external definition of the inline register handler. */
+extern inline JEMU_SYM(status) virtual_device_via_read(
+    virtual_device_via* via, uint16_t addr, uint8_t* byte);
+
+/**
+ * \brief Read callback for the VIA device.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ * \param addr          The address for the read operation.
+ * \param byte          Pointer to receive the byte read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_via_read_callback(
+    void* via, uint16_t addr, uint8_t* byte)
+{
+    return virtual_device_via_read((virtual_device_via*)via, addr, byte);
+}
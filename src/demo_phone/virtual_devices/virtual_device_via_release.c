@@ -7,7 +7,6 @@
  * distribution for the license terms under which this software is distributed.
  */
 
-#include <stdlib.h>
 #include <string.h>
 
 #include "via.h"
@@ -26,11 +25,26 @@
 JEMU_SYM(status) FN_DECL_MUST_CHECK
 virtual_device_via_release(virtual_device_via* via)
 {
+    virtual_device_arena* arena = via->arena;
+
+    /* the timer and shift events must not outlive the VIA. */
+    if (NULL != via->scheduler)
+    {
+        virtual_device_scheduler_cancel(via->scheduler, &via->timer_event);
+        virtual_device_scheduler_cancel(via->scheduler, &via->sr_event);
+    }
+
+    /* nor may its interrupt request. */
+    if (NULL != via->irq)
+    {
+        virtual_device_irq_set(via->irq, via->irq_source, false);
+    }
+
     /* clear memory. */
     memset(via, 0, sizeof(*via));
 
     /* release memory. */
-    free(via);
+    virtual_device_free(arena, via);
 
     /* success. */
     return STATUS_SUCCESS;
@@ -0,0 +1,50 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_restore_callback.c
+ *
+ * \brief Restore callback for the VIA device.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Restore callback for the VIA device.
+ *
+ * Posts the VIA's timer and shift register events again, republishes its pin
+ * levels, and drives its IRQ output, to match its restored state.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_via_restore_callback(void* via)
+{
+    status retval;
+    virtual_device_via* v = (virtual_device_via*)via;
+
+    /* this also drives the IRQ output. */
+    retval = virtual_device_via_timer_sync(v);
+    if (STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = virtual_device_via_sr_sync(v);
+    if (STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    for (uint8_t port = 0; port < VIA_PORT_COUNT; ++port)
+    {
+        virtual_device_via_pins_update(v, port);
+    }
+
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,32 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_shadow_flags.c
+ *
+ * \brief The shadow flags for the VIA registers.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+#define VIA_SHADOW_FLAGS(reg) [(reg) - VIA_REGISTER_IORB]
+#define VIA_SHADOW_RT \
+    (VIRTUAL_DEVICE_SHADOW_READ | VIRTUAL_DEVICE_SHADOW_WRITE_THROUGH)
+
+/**
+ * \brief The shadow flags for each VIA register, by register offset.
+ *
+ * The data direction registers, the timer 1 latches, ACR, and PCR are read
+ * from the shadow array, but writing them moves port pins, changes the period
+ * of a running timer 1, switches the timer modes, or drives the handshake
+ * lines, so those writes are written through to the VIA.  Every other register
+ * goes through the VIA callbacks.
+ */
+const uint8_t virtual_device_via_shadow_flags[VIA_REGISTER_COUNT] = {
+    VIA_SHADOW_FLAGS(VIA_REGISTER_DDRB) = VIA_SHADOW_RT,
+    VIA_SHADOW_FLAGS(VIA_REGISTER_DDRA) = VIA_SHADOW_RT,
+    VIA_SHADOW_FLAGS(VIA_REGISTER_T1LL) = VIA_SHADOW_RT,
+    VIA_SHADOW_FLAGS(VIA_REGISTER_T1LH) = VIA_SHADOW_RT,
+    VIA_SHADOW_FLAGS(VIA_REGISTER_ACR) = VIA_SHADOW_RT,
+    VIA_SHADOW_FLAGS(VIA_REGISTER_PCR) = VIA_SHADOW_RT,
+};
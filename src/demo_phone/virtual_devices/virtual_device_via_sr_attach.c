@@ -0,0 +1,30 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_sr_attach.c
+ *
+ * \brief Exchange whole bytes with a peripheral through the shift register.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+/**
+ * \brief Exchange whole bytes with a peripheral through the shift register.
+ *
+ * With a transfer attached, a byte shifted under T2 or phi2 completes with a
+ * single scheduler event instead of an event per clock edge, and CB1 and CB2
+ * are not toggled.  Bytes clocked by the peripheral on CB1 are always shifted
+ * bit by bit.
+ *
+ * \param via           The VIA instance.
+ * \param transfer      The byte transfer, or NULL to shift bit by bit.
+ * \param context       The user context for the transfer.
+ */
+void virtual_device_via_sr_attach(
+    virtual_device_via* via, virtual_device_via_sr_fn transfer,
+    void* context)
+{
+    via->sr_transfer = transfer;
+    via->sr_context = context;
+}
@@ -0,0 +1,34 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_sr_complete.c
+ *
+ * \brief Finish shifting a byte.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+/**
+ * \brief Finish shifting a byte, raising the SR flag.
+ *
+ * Shifting out under T2 in free-running mode never finishes; the byte is
+ * shifted out again, and the flag is not raised.
+ *
+ * \param via           The VIA instance.
+ */
+void virtual_device_via_sr_complete(virtual_device_via* via)
+{
+    uint8_t mode = VIA_SHADOW(via, VIA_REGISTER_ACR) & VIA_ACR_SR_MODE;
+
+    via->sr_bits = 0;
+
+    if (VIA_SR_OUT_FREE == mode)
+    {
+        return;
+    }
+
+    via->sr_running = false;
+    via->ifr |= VIA_IFR_SR;
+    virtual_device_via_irq_update(via);
+}
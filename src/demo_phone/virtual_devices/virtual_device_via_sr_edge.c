@@ -0,0 +1,67 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_sr_edge.c
+ *
+ * \brief Shift one bit on an edge of the shift clock.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+/**
+ * \brief Shift one bit on an edge of the shift clock.
+ *
+ * Bits are shifted out on CB2 at the falling edge, most significant first,
+ * and shifted in from CB2 at the rising edge.  The byte completes at the
+ * eighth rising edge.
+ *
+ * \param via           The VIA instance.
+ * \param rising        true for a rising edge of CB1.
+ */
+void virtual_device_via_sr_edge(virtual_device_via* via, bool rising)
+{
+    uint8_t mode = VIA_SHADOW(via, VIA_REGISTER_ACR) & VIA_ACR_SR_MODE;
+
+    if (!via->sr_running)
+    {
+        return;
+    }
+
+    if (!rising)
+    {
+        /* the register rotates, so a byte shifted out is left in place. */
+        if (VIA_SR_SHIFTS_OUT(mode))
+        {
+            uint8_t bit = (uint8_t)(via->sr >> 7);
+
+            via->sr = (uint8_t)((via->sr << 1) | bit);
+            if (bit)
+            {
+                via->control_out |= VIA_CONTROL_CB2;
+            }
+            else
+            {
+                via->control_out &= (uint8_t)~VIA_CONTROL_CB2;
+            }
+
+            virtual_device_via_pins_update(via, VIA_PORT_CONTROL);
+        }
+
+        return;
+    }
+
+    if (!VIA_SR_SHIFTS_OUT(mode))
+    {
+        via->sr =
+            (uint8_t)(
+                (via->sr << 1)
+              | (via->control_in & VIA_CONTROL_CB2 ? 1 : 0));
+    }
+
+    via->sr_bits += 1;
+    if (8 == via->sr_bits)
+    {
+        virtual_device_via_sr_complete(via);
+    }
+}
@@ -0,0 +1,60 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_sr_event.c
+ *
+ * \brief Handle the VIA's shift register event.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Handle the VIA's shift register event.
+ *
+ * With a byte transfer attached, the event moves a whole byte.  Otherwise, it
+ * is one edge of the shift clock on CB1.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ * \param deadline      The cycle the event was due.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_via_sr_event(void* via, uint64_t deadline)
+{
+    virtual_device_via* v = (virtual_device_via*)via;
+    uint8_t mode = VIA_SHADOW(v, VIA_REGISTER_ACR) & VIA_ACR_SR_MODE;
+    uint64_t half = virtual_device_via_sr_half_period(v);
+
+    if (NULL != v->sr_transfer)
+    {
+        /* exchange the byte with the peripheral. */
+        if (VIA_SR_SHIFTS_OUT(mode))
+        {
+            (void)v->sr_transfer(v->sr_context, true, v->sr);
+        }
+        else
+        {
+            v->sr = v->sr_transfer(v->sr_context, false, 0xFF);
+        }
+
+        virtual_device_via_sr_complete(v);
+        v->sr_next = deadline + 16 * half;
+    }
+    else
+    {
+        /* toggle the shift clock, and shift on the new edge. */
+        bool rising = !(v->control_out & VIA_CONTROL_CB1);
+
+        v->control_out ^= VIA_CONTROL_CB1;
+        virtual_device_via_pins_update(v, VIA_PORT_CONTROL);
+        virtual_device_via_sr_edge(v, rising);
+        v->sr_next = deadline + half;
+    }
+
+    return virtual_device_via_sr_sync(v);
+}
@@ -0,0 +1,64 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_sr_start.c
+ *
+ * \brief Start shifting a byte.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/* emit the external definition of the inline shift clock. */
+extern inline uint64_t virtual_device_via_sr_half_period(
+    const virtual_device_via* via);
+
+/**
+ * \brief Start shifting a byte, on a CPU access to SR.
+ *
+ * The access clears the SR flag.
+ *
+ * \param via           The VIA instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_via_sr_start(virtual_device_via* via)
+{
+    uint8_t mode = VIA_SHADOW(via, VIA_REGISTER_ACR) & VIA_ACR_SR_MODE;
+    uint64_t half = virtual_device_via_sr_half_period(via);
+
+    via->ifr &= (uint8_t)~VIA_IFR_SR;
+    virtual_device_via_irq_update(via);
+
+    if (VIA_SR_DISABLED == mode)
+    {
+        return STATUS_SUCCESS;
+    }
+
+    /* a byte in flight starts over. */
+    via->sr_bits = 0;
+    via->sr_running = true;
+
+    /* the shift clock idles high between bytes. */
+    if (VIA_SR_CLOCKS_CB1(mode))
+    {
+        via->control_out |= VIA_CONTROL_CB1;
+        virtual_device_via_pins_update(via, VIA_PORT_CONTROL);
+    }
+
+    /* a byte transfer takes sixteen clock edges, in one event. */
+    if (NULL != via->sr_transfer)
+    {
+        via->sr_next = virtual_device_via_now(via) + 16 * half;
+    }
+    else
+    {
+        via->sr_next = virtual_device_via_now(via) + half;
+    }
+
+    return virtual_device_via_sr_sync(via);
+}
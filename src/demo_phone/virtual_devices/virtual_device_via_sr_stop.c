@@ -0,0 +1,31 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_sr_stop.c
+ *
+ * \brief Stop the VIA's shift register.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+/**
+ * \brief Stop the shift register, after ACR changes its mode.
+ *
+ * CB1 and CB2 return high, and any pending shift event is cancelled.
+ *
+ * \param via           The VIA instance.
+ */
+void virtual_device_via_sr_stop(virtual_device_via* via)
+{
+    via->sr_bits = 0;
+    via->sr_running = false;
+    via->control_out |= VIA_CONTROL_CB1 | VIA_CONTROL_CB2;
+
+    if (NULL != via->scheduler)
+    {
+        virtual_device_scheduler_cancel(via->scheduler, &via->sr_event);
+    }
+
+    virtual_device_via_pins_update(via, VIA_PORT_CONTROL);
+}
@@ -0,0 +1,43 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_sr_sync.c
+ *
+ * \brief Post the VIA's shift register event.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Post the VIA's shift register event for sr_next, or cancel it if the
+ * shift register is idle or clocked from outside.
+ *
+ * \param via           The VIA instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_via_sr_sync(virtual_device_via* via)
+{
+    uint8_t mode = VIA_SHADOW(via, VIA_REGISTER_ACR) & VIA_ACR_SR_MODE;
+
+    if (NULL == via->scheduler)
+    {
+        return STATUS_SUCCESS;
+    }
+
+    if (!via->sr_running || !VIA_SR_CLOCKS_CB1(mode))
+    {
+        virtual_device_scheduler_cancel(via->scheduler, &via->sr_event);
+        return STATUS_SUCCESS;
+    }
+
+    return
+        virtual_device_scheduler_post(
+            via->scheduler, &via->sr_event, via->sr_next);
+}
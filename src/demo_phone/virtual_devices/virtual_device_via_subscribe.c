@@ -0,0 +1,36 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_subscribe.c
+ *
+ * \brief Subscribe to pin-level changes on a VIA port.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+/**
+ * \brief Subscribe to changes in the levels of some of a port's pins.
+ *
+ * \param via           The VIA instance.
+ * \param subscription  The subscription to link, which must stay valid until
+ *                      it is unsubscribed or the VIA is released.
+ * \param port          \ref VIA_PORT_A or \ref VIA_PORT_B.
+ * \param mask          The pins to be notified about.
+ * \param notify        The callback for changes to those pins.
+ * \param context       The user context for the callback.
+ */
+void virtual_device_via_subscribe(
+    virtual_device_via* via, virtual_device_via_subscription* subscription,
+    uint8_t port, uint8_t mask, virtual_device_via_pin_fn notify,
+    void* context)
+{
+    subscription->notify = notify;
+    subscription->context = context;
+    subscription->port = port;
+    subscription->mask = mask;
+
+    /* link it at the head of the port's list. */
+    subscription->next = via->subscribers[port];
+    via->subscribers[port] = subscription;
+}
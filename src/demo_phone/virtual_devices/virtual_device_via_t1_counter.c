@@ -0,0 +1,32 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_t1_counter.c
+ *
+ * \brief Return the current value of the timer 1 counter.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+/**
+ * \brief Return the current value of the timer 1 counter.
+ *
+ * \param via           The VIA instance.
+ *
+ * \returns the counter.
+ */
+uint16_t virtual_device_via_t1_counter(virtual_device_via* via)
+{
+    virtual_device_via_timer_update(via);
+
+    uint64_t now = virtual_device_via_now(via);
+
+    /* a free-running timer reads 0xFFFF on its underflow cycle. */
+    if (now < via->t1_base)
+    {
+        return 0xFFFF;
+    }
+
+    return (uint16_t)(via->t1_start - (now - via->t1_base));
+}
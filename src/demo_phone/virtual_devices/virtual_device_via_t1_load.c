@@ -0,0 +1,38 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_t1_load.c
+ *
+ * \brief Load timer 1 from its latches and start it.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Load timer 1 from its latches and start it, on a write to T1C-H.
+ *
+ * \param via           The VIA instance.
+ * \param byte          The high latch byte.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_via_t1_load(
+    virtual_device_via* via, uint8_t byte)
+{
+    virtual_device_via_timer_update(via);
+
+    VIA_SHADOW(via, VIA_REGISTER_T1LH) = byte;
+    via->t1_latch = (uint16_t)((via->t1_latch & 0x00FF) | (byte << 8));
+    via->t1_start = via->t1_latch;
+    via->t1_base = virtual_device_via_now(via);
+    via->t1_armed = true;
+    via->ifr &= (uint8_t)~VIA_IFR_T1;
+    virtual_device_via_irq_update(via);
+
+    return virtual_device_via_timer_sync(via);
+}
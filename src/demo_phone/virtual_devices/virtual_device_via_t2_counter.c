@@ -0,0 +1,32 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_t2_counter.c
+ *
+ * \brief Return the current value of the timer 2 counter.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+/**
+ * \brief Return the current value of the timer 2 counter.
+ *
+ * \param via           The VIA instance.
+ *
+ * \returns the counter.
+ */
+uint16_t virtual_device_via_t2_counter(virtual_device_via* via)
+{
+    virtual_device_via_timer_update(via);
+
+    /* a pulse counter only moves on PB6 edges. */
+    if (via->timer_mode & VIA_ACR_T2_PULSE_COUNT)
+    {
+        return via->t2_start;
+    }
+
+    return
+        (uint16_t)(
+            via->t2_start - (virtual_device_via_now(via) - via->t2_base));
+}
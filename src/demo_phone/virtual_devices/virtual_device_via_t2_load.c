@@ -0,0 +1,36 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_t2_load.c
+ *
+ * \brief Load timer 2 and start it.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Load timer 2 and start it, on a write to T2C-H.
+ *
+ * \param via           The VIA instance.
+ * \param byte          The high counter byte.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_via_t2_load(
+    virtual_device_via* via, uint8_t byte)
+{
+    virtual_device_via_timer_update(via);
+
+    via->t2_start = (uint16_t)(via->t2_latch_low | (byte << 8));
+    via->t2_base = virtual_device_via_now(via);
+    via->t2_armed = true;
+    via->ifr &= (uint8_t)~VIA_IFR_T2;
+    virtual_device_via_irq_update(via);
+
+    return virtual_device_via_timer_sync(via);
+}
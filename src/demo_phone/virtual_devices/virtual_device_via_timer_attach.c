@@ -0,0 +1,70 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_timer_attach.c
+ *
+ * \brief Run the VIA's timers from a scheduler.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Run the VIA's timers from the given scheduler's cycle counter.
+ *
+ * Until a scheduler is attached, the VIA's clock stands at cycle zero and its
+ * timers do not count.  Timers already loaded restart from the current cycle,
+ * as does the shift clock of a byte being shifted.
+ *
+ * \param via           The VIA instance.
+ * \param scheduler     The scheduler to post timer deadlines to.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_via_timer_attach(
+    virtual_device_via* via, virtual_device_scheduler* scheduler)
+{
+    status retval;
+
+    /* take the counts on the old clock. */
+    uint16_t t1 = virtual_device_via_t1_counter(via);
+    uint16_t t2 = virtual_device_via_t2_counter(via);
+
+    if (NULL != via->scheduler)
+    {
+        virtual_device_scheduler_cancel(via->scheduler, &via->timer_event);
+        virtual_device_scheduler_cancel(via->scheduler, &via->sr_event);
+    }
+
+    /* carry on counting from them on the new clock. */
+    via->scheduler = scheduler;
+    via->t1_base = virtual_device_via_now(via);
+    via->t1_start = t1;
+    if (!(via->timer_mode & VIA_ACR_T2_PULSE_COUNT))
+    {
+        via->t2_base = via->t1_base;
+        via->t2_start = t2;
+    }
+
+    retval = virtual_device_via_timer_sync(via);
+    if (STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (via->sr_running)
+    {
+        uint64_t half = virtual_device_via_sr_half_period(via);
+
+        via->sr_next =
+            virtual_device_via_now(via)
+          + (NULL != via->sr_transfer ? 16 * half : half);
+    }
+
+    return virtual_device_via_sr_sync(via);
+}
@@ -0,0 +1,32 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_timer_event.c
+ *
+ * \brief Handle the VIA's timer event.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Handle the VIA's timer event, when a timer underflows.
+ *
+ * \param via           An opaque reference to the VIA instance.
+ * \param deadline      The cycle the event was due.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) virtual_device_via_timer_event(void* via, uint64_t deadline)
+{
+    (void)deadline;
+
+    /* raise the flags, then post the next underflow. */
+    virtual_device_via_timer_update((virtual_device_via*)via);
+
+    return virtual_device_via_timer_sync((virtual_device_via*)via);
+}
@@ -0,0 +1,63 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_timer_sync.c
+ *
+ * \brief Post the VIA's timer event for its next underflow.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+/**
+ * \brief Post the VIA's timer event for its earliest armed underflow, or cancel
+ * it if no timer is armed, and drive the VIA's IRQ output.
+ *
+ * \ref virtual_device_via_restore_callback calls this after a snapshot
+ * restores the VIA's state.
+ *
+ * \param via           The VIA instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+JEMU_SYM(status) FN_DECL_MUST_CHECK
+virtual_device_via_timer_sync(virtual_device_via* via)
+{
+    uint64_t deadline = VIRTUAL_DEVICE_SCHEDULER_NEVER;
+
+    virtual_device_via_irq_update(via);
+
+    if (NULL == via->scheduler)
+    {
+        return STATUS_SUCCESS;
+    }
+
+    if (via->t1_armed)
+    {
+        deadline = via->t1_base + via->t1_start + 1;
+    }
+
+    if (via->t2_armed && !(via->timer_mode & VIA_ACR_T2_PULSE_COUNT))
+    {
+        uint64_t underflow = via->t2_base + via->t2_start + 1;
+
+        if (underflow < deadline)
+        {
+            deadline = underflow;
+        }
+    }
+
+    if (VIRTUAL_DEVICE_SCHEDULER_NEVER == deadline)
+    {
+        virtual_device_scheduler_cancel(via->scheduler, &via->timer_event);
+        return STATUS_SUCCESS;
+    }
+
+    return
+        virtual_device_scheduler_post(
+            via->scheduler, &via->timer_event, deadline);
+}
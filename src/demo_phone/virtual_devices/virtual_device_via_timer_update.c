@@ -0,0 +1,64 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_timer_update.c
+ *
+ * \brief Bring the VIA's timers up to the current cycle.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+/* emit the external definition of the inline clock. */
+extern inline uint64_t virtual_device_via_now(const virtual_device_via* via);
+
+/**
+ * \brief Bring the timers up to the current cycle, raising the interrupt flag
+ * of each timer that has underflowed and reloading timer 1 in free-run mode.
+ *
+ * A timer loaded with N counts down to zero over N cycles, and underflows on
+ * the cycle after.  In free-run mode, timer 1 reads 0xFFFF on that cycle, and
+ * reloads from its latches on the next, so it interrupts every latch + 2
+ * cycles.  Periods missed since the last update are skipped in one step.
+ *
+ * \param via           The VIA instance.
+ */
+void virtual_device_via_timer_update(virtual_device_via* via)
+{
+    uint64_t now = virtual_device_via_now(via);
+
+    if (via->t1_armed)
+    {
+        uint64_t underflow = via->t1_base + via->t1_start + 1;
+
+        if (now >= underflow)
+        {
+            via->ifr |= VIA_IFR_T1;
+
+            if (via->timer_mode & VIA_ACR_T1_FREE_RUN)
+            {
+                uint64_t period = (uint64_t)via->t1_latch + 2;
+
+                /* restart from the reload of the current period. */
+                via->t1_base =
+                    underflow + 1 + ((now - underflow) / period) * period;
+                via->t1_start = via->t1_latch;
+            }
+            else
+            {
+                via->t1_armed = false;
+            }
+        }
+    }
+
+    if (via->t2_armed && !(via->timer_mode & VIA_ACR_T2_PULSE_COUNT))
+    {
+        if (now >= via->t2_base + via->t2_start + 1)
+        {
+            via->ifr |= VIA_IFR_T2;
+            via->t2_armed = false;
+        }
+    }
+
+    virtual_device_via_irq_update(via);
+}
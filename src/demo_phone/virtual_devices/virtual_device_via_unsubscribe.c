@@ -0,0 +1,35 @@
+/**
+ * \file demo_phone/virtual_devices/virtual_device_via_unsubscribe.c
+ *
+ * \brief Remove a subscription from its VIA port.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include "via.h"
+
+/**
+ * \brief Remove a subscription from its VIA port.
+ *
+ * \param via           The VIA instance.
+ * \param subscription  The subscription to unlink.
+ */
+void virtual_device_via_unsubscribe(
+    virtual_device_via* via, virtual_device_via_subscription* subscription)
+{
+    virtual_device_via_subscription** link =
+        &via->subscribers[subscription->port];
+
+    /* find the link that points at the subscription. */
+    while (NULL != *link && subscription != *link)
+    {
+        link = &(*link)->next;
+    }
+
+    if (NULL != *link)
+    {
+        *link = subscription->next;
+        subscription->next = NULL;
+    }
+}
@@ -0,0 +1,86 @@
+/**
+ * \file tools/vdtrace.c
+ *
+ * \brief Decode a virtual device bus trace.
+ *
+ * Usage: vdtrace [-s] tracefile
+ *
+ * Each event is printed as a line of cycle, address, device id, direction, and
+ * value.  With -s, only the event and dropped event counts are printed.
+ *
+ * \copyright 2023 Justin Handville.  Please see LICENSE.txt in this
+ * distribution for the license terms under which this software is distributed.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../demo_phone/virtual_devices/status.h"
+#include "../demo_phone/virtual_devices/trace.h"
+
+JEMU_IMPORT_jemu65c02;
+
+int main(int argc, char* argv[])
+{
+    virtual_device_trace_reader reader;
+    virtual_device_trace_event event;
+    status retval;
+    bool summary = false;
+    uint64_t events = 0;
+    int arg = 1;
+
+    /* parse the options. */
+    if (arg < argc && 0 == strcmp("-s", argv[arg]))
+    {
+        summary = true;
+        arg += 1;
+    }
+
+    if (arg + 1 != argc)
+    {
+        fprintf(stderr, "usage: %s [-s] tracefile\n", argv[0]);
+        return 2;
+    }
+
+    FILE* in = fopen(argv[arg], "rb");
+    if (NULL == in)
+    {
+        perror(argv[arg]);
+        return 1;
+    }
+
+    retval = virtual_device_trace_reader_init(&reader, in);
+    if (STATUS_SUCCESS != retval)
+    {
+        fprintf(stderr, "%s: not a virtual device trace.\n", argv[arg]);
+        fclose(in);
+        return 1;
+    }
+
+    /* print each event. */
+    while (STATUS_SUCCESS
+                == (retval = virtual_device_trace_reader_next(&reader, &event)))
+    {
+        events += 1;
+        if (!summary)
+        {
+            printf(
+                "%" PRIu64 " %04X %04X %c %02X\n", event.cycle, event.address,
+                event.device, event.write ? 'W' : 'R', event.value);
+        }
+    }
+
+    fclose(in);
+
+    printf(
+        "%" PRIu64 " events, %" PRIu64 " dropped\n", events, reader.dropped);
+
+    if (VIRTUAL_DEVICE_ERROR_TRACE_END != retval)
+    {
+        fprintf(stderr, "%s: the trace is truncated or corrupt.\n", argv[arg]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/board_manifest.h"
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(board_manifest);
+
+/* device contexts with static storage duration. */
+static int test_via_context;
+static int test_rom_context;
+static int test_ram_context;
+
+/* a board manifest, listed out of order. */
+static constexpr std::array test_board_devices = {
+    virtual_devices::manifest_device(
+        0xF800, 0xFFFF, NULL, NULL, &test_rom_context),
+    virtual_devices::manifest_device(
+        VIA_REGISTER_IORB, VIA_REGISTER_IORA2, NULL, NULL, &test_via_context),
+    virtual_devices::manifest_device(
+        0x0000, 0x0000, NULL, NULL, &test_ram_context),
+};
+
+using test_board = virtual_devices::board_manifest<test_board_devices>;
+
+/* overlapping and inverted manifests are rejected at compile time. */
+static_assert(
+    !virtual_devices::manifest_valid(
+        std::array{
+            virtual_devices::manifest_device(0xF600, 0xF60F, NULL, NULL, NULL),
+            virtual_devices::manifest_device(0xF60F, 0xF61F, NULL, NULL, NULL),
+        }));
+static_assert(
+    !virtual_devices::manifest_valid(
+        std::array{
+            virtual_devices::manifest_device(0xF60F, 0xF600, NULL, NULL, NULL),
+        }));
+static_assert(virtual_devices::manifest_valid(test_board_devices));
+
+/* a memory region must cover its range unless it is mirrored. */
+static uint8_t test_ram[0x10];
+static_assert(
+    !virtual_devices::manifest_valid(
+        std::array{
+            virtual_devices::manifest_region(
+                0x0200, 0x0210, test_ram, sizeof(test_ram), 0),
+        }));
+static_assert(
+    virtual_devices::manifest_valid(
+        std::array{
+            virtual_devices::manifest_region(
+                0x0200, 0x02FF, test_ram, sizeof(test_ram),
+                VIRTUAL_DEVICE_REGION_MIRRORED),
+        }));
+
+/* a decode mask must tile its window, and a region need only cover a copy. */
+static_assert(
+    virtual_devices::manifest_valid(
+        std::array{
+            virtual_devices::manifest_decoded(
+                virtual_devices::manifest_region(
+                    0x0200, 0x020F, test_ram, sizeof(test_ram), 0),
+                0x0F, 4),
+        }));
+static_assert(
+    !virtual_devices::manifest_valid(
+        std::array{
+            virtual_devices::manifest_decoded(
+                virtual_devices::manifest_device(
+                    0xF600, 0xF60F, NULL, NULL, NULL),
+                0x0E, 4),
+        }));
+static_assert(
+    0xF6FF
+        == virtual_devices::manifest_decoded(
+                virtual_devices::manifest_device(
+                    0xF600, 0xF60F, NULL, NULL, NULL),
+                0x0F, 16).register_high);
+
+/* the generated map is sorted and indexed at compile time. */
+static_assert(3 == test_board::device_entries);
+static_assert(0x0000 == test_board::register_lows[0]);
+static_assert(VIA_REGISTER_IORB == test_board::register_lows[1]);
+static_assert(0xF800 == test_board::register_lows[2]);
+static_assert(1 + 1 + 1 + 8 == test_board::dispatch_tables);
+
+/**
+ * \brief The generated tables match the tables built at runtime by finalize.
+ */
+TEST(matches_finalize)
+{
+    virtual_device_manager* virt;
+
+    /* build the same board at runtime. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    for (const auto& device : test_board_devices)
+    {
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_manager_device_register(
+                        virt, device.read, device.write, device.register_low,
+                        device.register_high, device.context));
+    }
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    /* the keys and tables are identical. */
+    TEST_ASSERT(test_board::device_entries == virt->device_entries);
+    TEST_ASSERT(test_board::dispatch_tables == virt->dispatch_tables);
+    for (size_t i = 0; i < test_board::device_entries; ++i)
+    {
+        TEST_EXPECT(test_board::register_lows[i] == virt->register_lows[i]);
+        TEST_EXPECT(test_board::register_highs[i] == virt->register_highs[i]);
+        TEST_EXPECT(test_board::devices[i].context == virt->devices[i].context);
+    }
+    TEST_EXPECT(
+        0 == memcmp(
+                test_board::dispatch_pages.data(), virt->dispatch_pages,
+                sizeof(test_board::dispatch_pages)));
+    TEST_EXPECT(
+        0 == memcmp(
+                test_board::dispatch_bytes.data(), virt->dispatch_bytes,
+                sizeof(test_board::dispatch_bytes)));
+    TEST_EXPECT(
+        0 == memcmp(
+                test_board::presence.data(), virt->presence,
+                sizeof(test_board::presence)));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief A manager created from the generated map is finalized with no setup.
+ */
+TEST(create_from_map)
+{
+    virtual_device_manager* virt;
+
+    /* create the manager over the generated map. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_create_from_map(
+                    &virt, NULL, &test_board::map));
+    TEST_EXPECT(virt->finalized);
+
+    /* each device is found through the dispatch table. */
+    virtual_device_entry* entry =
+        virtual_device_manager_device_find(virt, VIA_REGISTER_IFR);
+    TEST_ASSERT(NULL != entry);
+    TEST_EXPECT(&test_via_context == entry->context);
+    entry = virtual_device_manager_device_find(virt, 0xFFFC);
+    TEST_ASSERT(NULL != entry);
+    TEST_EXPECT(&test_rom_context == entry->context);
+    TEST_EXPECT(NULL == virtual_device_manager_device_find(virt, 0xF7FF));
+    TEST_EXPECT(virtual_device_manager_address_mapped(virt, 0x0000));
+    TEST_EXPECT(!virtual_device_manager_address_mapped(virt, 0x0001));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
@@ -0,0 +1,83 @@
+/**
+ * \file test/demo_phone/virtual_devices/test_device_bus.h
+ *
+ * \brief Put a device on a device manager's bus, so that tests reach its
+ * registers the way the emulator does, through the shadow array and the
+ * dispatch table.
+ */
+
+#pragma once
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/uart.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+
+/**
+ * \brief Register a VIA at \ref VIA_REGISTER_IORB and finalize the manager.
+ */
+static inline bool test_bus_attach(
+    virtual_device_manager* bus, virtual_device_via* via)
+{
+    virtual_device_entry entry;
+
+    virtual_device_via_entry_init(via, &entry, VIA_REGISTER_IORB);
+
+    return
+        STATUS_SUCCESS == virtual_device_manager_entry_register(bus, &entry)
+     && STATUS_SUCCESS == virtual_device_manager_finalize(bus);
+}
+
+/**
+ * \brief Register a UART at \ref UART_REGISTER_DATA and finalize the manager.
+ */
+static inline bool test_bus_attach(
+    virtual_device_manager* bus, virtual_device_uart* uart)
+{
+    virtual_device_entry entry;
+
+    virtual_device_uart_entry_init(uart, &entry, UART_REGISTER_DATA);
+
+    return
+        STATUS_SUCCESS == virtual_device_manager_entry_register(bus, &entry)
+     && STATUS_SUCCESS == virtual_device_manager_finalize(bus);
+}
+
+/**
+ * \brief Create a manager with the given device on its bus.
+ */
+template <typename device_type>
+static inline bool test_bus_create(
+    virtual_device_manager** bus, device_type* device)
+{
+    return
+        STATUS_SUCCESS == virtual_device_manager_create(bus)
+     && test_bus_attach(*bus, device);
+}
+
+/**
+ * \brief Read a register through the bus, or return 0xEE on failure.
+ */
+static inline uint8_t test_read(virtual_device_manager* bus, uint16_t reg)
+{
+    uint8_t byte = 0;
+
+    if (STATUS_SUCCESS
+            != virtual_device_manager_emu_read_callback(bus, reg, &byte))
+    {
+        return 0xEE;
+    }
+
+    return byte;
+}
+
+/**
+ * \brief Write a register through the bus.
+ */
+static inline bool test_write(
+    virtual_device_manager* bus, uint16_t reg, uint8_t byte)
+{
+    return
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(bus, reg, byte);
+}
@@ -0,0 +1,115 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/device_dispatch.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(device_dispatch);
+
+/**
+ * \brief A test device that records the last byte written to it.
+ */
+struct test_latch
+{
+    uint8_t value;
+};
+
+static status test_latch_read(test_latch* latch, uint16_t, uint8_t* byte)
+{
+    *byte = latch->value;
+
+    return STATUS_SUCCESS;
+}
+
+static status test_latch_write(test_latch* latch, uint16_t, uint8_t byte)
+{
+    latch->value = byte;
+
+    return STATUS_SUCCESS;
+}
+
+using test_latch_binding =
+    virtual_devices::device_binding<
+        test_latch, 0xF700, 0xF700, &test_latch_read, &test_latch_write>;
+
+using test_dispatch =
+    virtual_devices::device_dispatch<
+        virtual_devices::via_binding<>, test_latch_binding>;
+
+/* a fallback device for addresses outside of every binding. */
+static status test_fallback_read(void*, uint16_t addr, uint8_t* byte)
+{
+    *byte = (uint8_t)(addr >> 8);
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief Bound devices are dispatched directly, and every other address falls
+ * back to the device manager.
+ */
+TEST(dispatch)
+{
+    virtual_device_via* via;
+    virtual_device_manager* virt;
+    test_latch latch = { 0 };
+    uint8_t byte = 0;
+
+    /* create the VIA and a fallback manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, &test_fallback_read, NULL, 0xF800, 0xFFFF, NULL));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    test_dispatch dispatch(via, &latch, virt);
+
+    /* the VIA is written and read through its inline handlers. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == test_dispatch::emu_write_callback(
+                    &dispatch, VIA_REGISTER_DDRB, 0xFF));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == test_dispatch::emu_write_callback(
+                    &dispatch, VIA_REGISTER_IORB, 0x42));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == test_dispatch::emu_read_callback(
+                    &dispatch, VIA_REGISTER_IORB, &byte));
+    TEST_EXPECT(0x42 == byte);
+    TEST_EXPECT(0x42 == via->orb);
+
+    /* the second binding gets its own instance. */
+    TEST_ASSERT(STATUS_SUCCESS == dispatch.write(0xF700, 0x99));
+    TEST_EXPECT(0x99 == latch.value);
+    TEST_ASSERT(STATUS_SUCCESS == dispatch.read(0xF700, &byte));
+    TEST_EXPECT(0x99 == byte);
+
+    /* other addresses go through the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == dispatch.read(0xFFFC, &byte));
+    TEST_EXPECT(0xFF == byte);
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_UNMAPPED == dispatch.read(0xF701, &byte));
+
+    /* release the manager and the VIA. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
+
+/**
+ * \brief Without a fallback, unbound addresses are unmapped.
+ */
+TEST(no_fallback)
+{
+    test_latch latch = { 0x11 };
+    uint8_t byte = 0;
+
+    virtual_devices::device_dispatch<test_latch_binding> dispatch(&latch);
+
+    TEST_ASSERT(STATUS_SUCCESS == dispatch.read(0xF700, &byte));
+    TEST_EXPECT(0x11 == byte);
+    TEST_EXPECT(VIRTUAL_DEVICE_ERROR_UNMAPPED == dispatch.write(0xF600, 0));
+}
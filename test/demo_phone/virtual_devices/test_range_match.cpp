@@ -0,0 +1,91 @@
+#include <minunit/minunit.h>
+#include <stdlib.h>
+
+#include "../../../src/demo_phone/virtual_devices/range_match.h"
+
+TEST_SUITE(range_match);
+
+/**
+ * \brief No range matches when there are no ranges.
+ */
+TEST(empty)
+{
+    const uint16_t lows[] = { 0 };
+    const uint16_t highs[] = { 0 };
+
+    TEST_EXPECT(0 == range_match(lows, highs, 0, 0x0000));
+}
+
+/**
+ * \brief Every lane of a full vector, and the scalar tail, can match.
+ */
+TEST(lanes)
+{
+    uint16_t lows[37], highs[37];
+
+    /* create 37 ranges of four registers each, spanning the sign bit. */
+    for (size_t i = 0; i < 37; ++i)
+    {
+        lows[i] = (uint16_t)(0x7FC0 + i * 4);
+        highs[i] = (uint16_t)(lows[i] + 3);
+    }
+
+    /* each register of each range matches that range. */
+    for (size_t i = 0; i < 37; ++i)
+    {
+        for (uint16_t off = 0; off < 4; ++off)
+        {
+            TEST_EXPECT(i == range_match(lows, highs, 37, lows[i] + off));
+        }
+    }
+
+    /* registers outside of the ranges don't match. */
+    TEST_EXPECT(37 == range_match(lows, highs, 37, 0x7FBF));
+    TEST_EXPECT(37 == range_match(lows, highs, 37, highs[36] + 1));
+    TEST_EXPECT(37 == range_match(lows, highs, 37, 0x0000));
+    TEST_EXPECT(37 == range_match(lows, highs, 37, 0xFFFF));
+}
+
+/**
+ * \brief The vector kernel agrees with a scalar search on random ranges.
+ */
+TEST(random)
+{
+    uint16_t lows[64], highs[64];
+
+    srand(0x6502);
+
+    for (int round = 0; round < 200; ++round)
+    {
+        size_t count = (size_t)(rand() % 64);
+
+        /* create random, possibly overlapping ranges. */
+        for (size_t i = 0; i < count; ++i)
+        {
+            lows[i] = (uint16_t)rand();
+            highs[i] = (uint16_t)(lows[i] + rand() % 512);
+            if (highs[i] < lows[i])
+            {
+                highs[i] = 0xFFFF;
+            }
+        }
+
+        /* compare against a scalar search. */
+        for (int probe = 0; probe < 64; ++probe)
+        {
+            uint16_t reg = (uint16_t)rand();
+            size_t expected = count;
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (lows[i] <= reg && reg <= highs[i])
+                {
+                    expected = i;
+                    break;
+                }
+            }
+
+            TEST_EXPECT(expected == range_match(lows, highs, count, reg));
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/arena.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_arena);
+
+/**
+ * \brief Arena allocations are aligned, contiguous, and bounded by the arena
+ * capacity.
+ */
+TEST(alloc)
+{
+    virtual_device_arena* arena;
+
+    /* create the arena. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_arena_create(&arena, 64));
+    TEST_EXPECT(64 == arena->size);
+
+    /* allocations are aligned and follow each other. */
+    uint8_t* a = (uint8_t*)virtual_device_arena_alloc(arena, 1);
+    uint8_t* b = (uint8_t*)virtual_device_arena_alloc(arena, 17);
+    TEST_ASSERT(NULL != a);
+    TEST_ASSERT(NULL != b);
+    TEST_EXPECT(0 == (uintptr_t)a % VIRTUAL_DEVICE_ARENA_ALIGNMENT);
+    TEST_EXPECT(a + VIRTUAL_DEVICE_ARENA_ALIGNMENT == b);
+    TEST_EXPECT(48 == arena->offset);
+
+    /* an allocation larger than the remaining space fails. */
+    TEST_EXPECT(NULL == virtual_device_arena_alloc(arena, 17));
+    TEST_EXPECT(NULL != virtual_device_arena_alloc(arena, 16));
+    TEST_EXPECT(NULL == virtual_device_arena_alloc(arena, 1));
+
+    /* reset makes the whole arena available again. */
+    virtual_device_arena_reset(arena);
+    TEST_EXPECT(0 == arena->offset);
+    TEST_EXPECT(a == virtual_device_arena_alloc(arena, 64));
+
+    /* release the arena. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_arena_release(arena));
+}
+
+/**
+ * \brief The most recent allocation grows in place and can be freed; older
+ * allocations are copied on growth.
+ */
+TEST(realloc_free)
+{
+    virtual_device_arena* arena;
+
+    /* create the arena. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_arena_create(&arena, 256));
+
+    /* make two allocations. */
+    uint8_t* a = (uint8_t*)virtual_device_alloc(arena, 16);
+    uint8_t* b = (uint8_t*)virtual_device_alloc(arena, 16);
+    TEST_ASSERT(NULL != a && NULL != b);
+    a[0] = 0xA5;
+    b[0] = 0x5A;
+
+    /* growing the most recent allocation stays in place. */
+    TEST_EXPECT(b == virtual_device_realloc(arena, b, 16, 64));
+    TEST_EXPECT(80 == arena->offset);
+
+    /* growing an older allocation copies it. */
+    uint8_t* c = (uint8_t*)virtual_device_realloc(arena, a, 16, 32);
+    TEST_ASSERT(NULL != c);
+    TEST_EXPECT(c != a);
+    TEST_EXPECT(0xA5 == c[0]);
+    TEST_EXPECT(112 == arena->offset);
+
+    /* freeing the most recent allocation returns it to the arena. */
+    virtual_device_free(arena, c);
+    TEST_EXPECT(80 == arena->offset);
+
+    /* freeing an older allocation does nothing. */
+    virtual_device_free(arena, a);
+    TEST_EXPECT(80 == arena->offset);
+
+    /* growing past the end of the arena fails. */
+    uint8_t* d = (uint8_t*)virtual_device_alloc(arena, 16);
+    TEST_ASSERT(NULL != d);
+    TEST_EXPECT(NULL == virtual_device_realloc(arena, d, 16, 256));
+
+    /* release the arena. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_arena_release(arena));
+}
+
+/**
+ * \brief An arena can be initialized over static storage, and a manager can be
+ * created in it without touching the heap.
+ */
+TEST(init_static)
+{
+    alignas(VIRTUAL_DEVICE_ARENA_ALIGNMENT) static uint8_t block[
+        VIRTUAL_DEVICE_MANAGER_ARENA_SIZE(2, 1) + 7];
+    virtual_device_arena arena;
+    virtual_device_manager* virt;
+
+    /* the usable size is rounded down to the alignment. */
+    virtual_device_arena_init(&arena, block, sizeof(block));
+    TEST_EXPECT(block == arena.base);
+    TEST_EXPECT(VIRTUAL_DEVICE_MANAGER_ARENA_SIZE(2, 1) == arena.size);
+    TEST_EXPECT(0 == arena.offset);
+
+    /* a manager and its dispatch table fill the block exactly. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_create_in_arena(&virt, &arena, 2));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+    TEST_EXPECT(arena.offset == arena.size);
+
+    /* release the manager; the storage is not freed. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+    virtual_device_arena_reset(&arena);
+    TEST_EXPECT(0 == arena.offset);
+}
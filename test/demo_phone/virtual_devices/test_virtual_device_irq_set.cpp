@@ -0,0 +1,97 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/irq.h"
+#include "../../../src/demo_phone/virtual_devices/status.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_irq_set);
+
+/**
+ * \brief A CPU IRQ input, counting the times it is driven.
+ */
+struct test_line
+{
+    bool asserted;
+    int changes;
+};
+
+/**
+ * \brief Record the level driven onto the test line.
+ */
+static void test_line_drive(void* context, bool asserted)
+{
+    test_line* line = (test_line*)context;
+
+    line->asserted = asserted;
+    line->changes += 1;
+}
+
+/**
+ * \brief The line is the OR of the sources, and is only driven when it
+ * changes.
+ */
+TEST(aggregate)
+{
+    virtual_device_irq irq;
+    test_line line = { true, 0 };
+    uint8_t a, b;
+
+    memset(&irq, 0, sizeof(irq));
+
+    /* connecting drives the current level. */
+    virtual_device_irq_connect(&irq, &test_line_drive, &line);
+    TEST_EXPECT(!line.asserted);
+    TEST_EXPECT(1 == line.changes);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_irq_source_add(&irq, &a));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_irq_source_add(&irq, &b));
+    TEST_EXPECT(a != b);
+
+    /* a source reporting the same level does not touch the line. */
+    virtual_device_irq_set(&irq, a, false);
+    TEST_EXPECT(1 == line.changes);
+
+    virtual_device_irq_set(&irq, a, true);
+    TEST_EXPECT(line.asserted);
+    TEST_EXPECT(2 == line.changes);
+
+    /* a second source joins without a change. */
+    virtual_device_irq_set(&irq, b, true);
+    virtual_device_irq_set(&irq, a, true);
+    TEST_EXPECT(2 == line.changes);
+
+    /* the line releases with the last source. */
+    virtual_device_irq_set(&irq, a, false);
+    TEST_EXPECT(line.asserted);
+    virtual_device_irq_set(&irq, b, false);
+    TEST_EXPECT(!line.asserted);
+    TEST_EXPECT(3 == line.changes);
+}
+
+/**
+ * \brief An aggregator holds a limited number of sources.
+ */
+TEST(source_limit)
+{
+    virtual_device_irq irq;
+    uint8_t source;
+
+    memset(&irq, 0, sizeof(irq));
+
+    for (int i = 0; i < VIRTUAL_DEVICE_IRQ_SOURCES; ++i)
+    {
+        TEST_ASSERT(
+            STATUS_SUCCESS == virtual_device_irq_source_add(&irq, &source));
+        TEST_EXPECT(i == source);
+    }
+
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_IRQ_SOURCES
+            == virtual_device_irq_source_add(&irq, &source));
+
+    /* the top source works without a line connected. */
+    virtual_device_irq_set(&irq, VIRTUAL_DEVICE_IRQ_SOURCES - 1, true);
+    TEST_EXPECT(irq.asserted);
+}
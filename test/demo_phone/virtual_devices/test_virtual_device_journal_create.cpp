@@ -0,0 +1,121 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/journal.h"
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+
+#if defined(VIRTUAL_DEVICE_JOURNAL)
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_journal_create);
+
+/**
+ * \brief A stream without the journal header cannot be replayed.
+ */
+TEST(fail_header)
+{
+    virtual_device_journal* journal;
+    uint64_t cycle = 0;
+    const uint8_t bytes[] = { 'V', 'D', 'T', 'R', 0x01 };
+
+    FILE* stream = tmpfile();
+    TEST_ASSERT(NULL != stream);
+    fwrite(bytes, 1, sizeof(bytes), stream);
+    rewind(stream);
+
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_JOURNAL_FORMAT
+            == virtual_device_journal_create(&journal, stream, true, &cycle));
+
+    fclose(stream);
+}
+
+/**
+ * \brief A journal has a fixed number of channels, and refuses unknown ones.
+ */
+TEST(fail_channel)
+{
+    virtual_device_journal* journal;
+    virtual_device_via via;
+    uint64_t cycle = 0;
+    uint8_t channel = 0xFF;
+
+    memset(&via, 0, sizeof(via));
+
+    FILE* stream = tmpfile();
+    TEST_ASSERT(NULL != stream);
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_create(&journal, stream, false, &cycle));
+
+    /* an input on a channel that was never added is refused. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_JOURNAL_CHANNEL
+            == virtual_device_journal_input(journal, 0, 0x12));
+
+    /* fill the channel table. */
+    for (size_t i = 0; i < VIRTUAL_DEVICE_JOURNAL_CHANNELS; ++i)
+    {
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_journal_channel_add(
+                        journal, &virtual_device_via_port_a_input, &via,
+                        &channel));
+        TEST_EXPECT(i == channel);
+    }
+
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_JOURNAL_CHANNEL
+            == virtual_device_journal_channel_add(
+                    journal, &virtual_device_via_port_a_input, &via,
+                    &channel));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_journal_release(journal));
+    fclose(stream);
+}
+
+/**
+ * \brief A replaying journal refuses live inputs.
+ */
+TEST(fail_replaying)
+{
+    virtual_device_journal* journal;
+    virtual_device_via via;
+    uint64_t cycle = 0;
+    uint8_t channel;
+    const uint8_t bytes[] = {
+        'V', 'D', 'J', 'R', VIRTUAL_DEVICE_JOURNAL_VERSION };
+
+    memset(&via, 0, sizeof(via));
+
+    FILE* stream = tmpfile();
+    TEST_ASSERT(NULL != stream);
+    fwrite(bytes, 1, sizeof(bytes), stream);
+    rewind(stream);
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_create(&journal, stream, true, &cycle));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_channel_add(
+                    journal, &virtual_device_via_port_b_input, &via,
+                    &channel));
+
+    /* an empty journal has nothing pending. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_JOURNAL_NEVER
+            == virtual_device_journal_next_cycle(journal));
+
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_JOURNAL_REPLAYING
+            == virtual_device_journal_input(journal, channel, 0x55));
+    TEST_EXPECT(0x00 == via.irb);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_journal_release(journal));
+    fclose(stream);
+}
+
+#endif /*defined(VIRTUAL_DEVICE_JOURNAL)*/
@@ -0,0 +1,183 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/journal.h"
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+
+#if defined(VIRTUAL_DEVICE_JOURNAL)
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_journal_poll);
+
+/**
+ * \brief An input recorded at a cycle.
+ */
+struct test_input
+{
+    uint64_t cycle;
+    uint8_t channel;
+    uint8_t value;
+};
+
+/**
+ * \brief Inputs recorded on two VIA ports are replayed at the same cycles,
+ * with the emulator skipping straight from one input to the next.
+ */
+TEST(round_trip)
+{
+    virtual_device_journal* journal;
+    virtual_device_via recorded;
+    virtual_device_via replayed;
+    uint64_t cycle = 100;
+    uint8_t port_a, port_b;
+    const test_input inputs[] = {
+        { 100, 0, 0x01 },
+        { 100, 1, 0x80 },
+        { 250, 0, 0x03 },
+        { 1000000, 1, 0x00 },
+    };
+
+    memset(&recorded, 0, sizeof(recorded));
+    memset(&replayed, 0, sizeof(replayed));
+
+    FILE* stream = tmpfile();
+    TEST_ASSERT(NULL != stream);
+
+    /* record the inputs. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_create(&journal, stream, false, &cycle));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_channel_add(
+                    journal, &virtual_device_via_port_a_input, &recorded,
+                    &port_a));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_channel_add(
+                    journal, &virtual_device_via_port_b_input, &recorded,
+                    &port_b));
+    for (const test_input& input : inputs)
+    {
+        cycle = input.cycle;
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_journal_input(
+                        journal, input.channel, input.value));
+    }
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_journal_release(journal));
+
+    /* the recorded device saw every input. */
+    TEST_EXPECT(0x03 == recorded.ira);
+    TEST_EXPECT(0x00 == recorded.irb);
+
+    /* replay them from cycle zero. */
+    rewind(stream);
+    cycle = 0;
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_create(&journal, stream, true, &cycle));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_channel_add(
+                    journal, &virtual_device_via_port_a_input, &replayed,
+                    &port_a));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_channel_add(
+                    journal, &virtual_device_via_port_b_input, &replayed,
+                    &port_b));
+
+    /* nothing is due before the first recorded cycle. */
+    TEST_EXPECT(100 == virtual_device_journal_next_cycle(journal));
+    cycle = 99;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_journal_poll(journal));
+    TEST_EXPECT(0x00 == replayed.ira);
+
+    /* both inputs at cycle 100 are delivered together. */
+    cycle = virtual_device_journal_next_cycle(journal);
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_journal_poll(journal));
+    TEST_EXPECT(0x01 == replayed.ira);
+    TEST_EXPECT(0x80 == replayed.irb);
+
+    /* an emulator that overshoots still gets the input, late. */
+    TEST_EXPECT(250 == virtual_device_journal_next_cycle(journal));
+    cycle = 260;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_journal_poll(journal));
+    TEST_EXPECT(0x03 == replayed.ira);
+
+    /* skip straight to the last input. */
+    cycle = virtual_device_journal_next_cycle(journal);
+    TEST_EXPECT(1000000 == cycle);
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_journal_poll(journal));
+    TEST_EXPECT(0x00 == replayed.irb);
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_JOURNAL_NEVER
+            == virtual_device_journal_next_cycle(journal));
+
+    /* the replayed device ends up where the recorded device did. */
+    TEST_EXPECT(recorded.ira == replayed.ira);
+    TEST_EXPECT(recorded.irb == replayed.irb);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_journal_release(journal));
+    fclose(stream);
+}
+
+/**
+ * \brief A truncated record, or a record for a channel that was not added,
+ * fails the replay.
+ */
+TEST(fail_format)
+{
+    virtual_device_journal* journal;
+    virtual_device_via via;
+    uint64_t cycle = 0;
+    uint8_t channel;
+    const uint8_t bytes[] = {
+        'V', 'D', 'J', 'R', VIRTUAL_DEVICE_JOURNAL_VERSION,
+        /* an input on channel 1 at cycle 5. */
+        0x05, 0x01, 0x42,
+        /* a record cut off after its cycle delta. */
+        0x85, 0x01,
+    };
+
+    memset(&via, 0, sizeof(via));
+
+    FILE* stream = tmpfile();
+    TEST_ASSERT(NULL != stream);
+    fwrite(bytes, 1, sizeof(bytes), stream);
+    rewind(stream);
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_create(&journal, stream, true, &cycle));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_channel_add(
+                    journal, &virtual_device_via_port_a_input, &via,
+                    &channel));
+
+    /* only channel 0 was added. */
+    cycle = 5;
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_JOURNAL_FORMAT
+            == virtual_device_journal_poll(journal));
+
+    /* with the channel added, the next record is found to be truncated. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_channel_add(
+                    journal, &virtual_device_via_port_b_input, &via,
+                    &channel));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_JOURNAL_FORMAT
+            == virtual_device_journal_poll(journal));
+    TEST_EXPECT(0x42 == via.irb);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_journal_release(journal));
+    fclose(stream);
+}
+
+#endif /*defined(VIRTUAL_DEVICE_JOURNAL)*/
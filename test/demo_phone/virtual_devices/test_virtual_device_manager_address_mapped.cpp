@@ -0,0 +1,107 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_manager_address_mapped);
+
+/**
+ * \brief No address is mapped in an empty manager.
+ */
+TEST(empty)
+{
+    virtual_device_manager* virt;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* no address is mapped. */
+    for (uint32_t addr = 0; addr <= 0xFFFF; ++addr)
+    {
+        TEST_EXPECT(
+            !virtual_device_manager_address_mapped(virt, (uint16_t)addr));
+    }
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Exactly the addresses covered by a device are mapped after sorting.
+ */
+TEST(mapped)
+{
+    virtual_device_manager* virt;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* register three devices. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF800, 0xFFFF, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0x0000, 0x0000, NULL));
+
+    /* the bitmap is not built until the devices are sorted. */
+    TEST_EXPECT(!virtual_device_manager_address_mapped(virt, 0xF600));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_sort(virt));
+
+    /* only the device addresses are mapped. */
+    for (uint32_t addr = 0; addr <= 0xFFFF; ++addr)
+    {
+        bool expected =
+            0x0000 == addr
+         || (addr >= 0xF600 && addr <= 0xF60F)
+         || addr >= 0xF800;
+
+        TEST_EXPECT(
+            expected
+                == virtual_device_manager_address_mapped(
+                        virt, (uint16_t)addr));
+    }
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief A failed sort leaves no address mapped.
+ */
+TEST(fail_overlap)
+{
+    virtual_device_manager* virt;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* register two overlapping devices. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF608, 0xF61F, NULL));
+
+    /* the sort fails. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_OVERLAP == virtual_device_manager_sort(virt));
+
+    /* nothing is mapped. */
+    TEST_EXPECT(!virtual_device_manager_address_mapped(virt, 0xF600));
+    TEST_EXPECT(!virtual_device_manager_address_mapped(virt, 0xF610));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
@@ -0,0 +1,140 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_manager_block_read);
+
+/**
+ * \brief A test device backed by a buffer, counting its calls.
+ */
+struct test_block_device
+{
+    uint16_t base;
+    uint8_t data[0x100];
+    size_t byte_reads;
+    size_t block_reads;
+};
+
+static status test_read(void* context, uint16_t addr, uint8_t* byte)
+{
+    test_block_device* dev = (test_block_device*)context;
+
+    dev->byte_reads += 1;
+    *byte = dev->data[addr - dev->base];
+
+    return STATUS_SUCCESS;
+}
+
+static status test_block_read(
+    void* context, uint16_t addr, uint8_t* buffer, size_t size)
+{
+    test_block_device* dev = (test_block_device*)context;
+
+    dev->block_reads += 1;
+    memcpy(buffer, dev->data + (addr - dev->base), size);
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief A burst spanning two devices is split at the device boundary, using
+ * the block handler where there is one and the byte handler otherwise.
+ */
+TEST(split)
+{
+    virtual_device_manager* virt;
+    static test_block_device block_dev, byte_dev;
+    virtual_device_entry entry;
+    uint8_t buffer[0x180];
+
+    memset(&block_dev, 0, sizeof(block_dev));
+    memset(&byte_dev, 0, sizeof(byte_dev));
+    block_dev.base = 0x1000;
+    byte_dev.base = 0x1100;
+    for (size_t i = 0; i < 0x100; ++i)
+    {
+        block_dev.data[i] = (uint8_t)i;
+        byte_dev.data[i] = (uint8_t)~i;
+    }
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* register a device with a block handler. */
+    memset(&entry, 0, sizeof(entry));
+    entry.register_low = 0x1000;
+    entry.register_high = 0x10FF;
+    entry.context = &block_dev;
+    entry.read = &test_read;
+    entry.block_read = &test_block_read;
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_manager_entry_register(virt, &entry));
+
+    /* register a device without one. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, &test_read, NULL, 0x1100, 0x11FF, &byte_dev));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    /* read a burst across both devices. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_block_read(
+                    virt, 0x1080, buffer, sizeof(buffer)));
+    TEST_EXPECT(1 == block_dev.block_reads);
+    TEST_EXPECT(0 == block_dev.byte_reads);
+    TEST_EXPECT(0x100 == byte_dev.byte_reads);
+    TEST_EXPECT(0x80 == buffer[0]);
+    TEST_EXPECT(0xFF == buffer[0x7F]);
+    TEST_EXPECT(0xFF == buffer[0x80]);
+    TEST_EXPECT(0x00 == buffer[0x17F]);
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief A burst that touches an unmapped address or runs past the end of the
+ * address space fails.
+ */
+TEST(fail_unmapped)
+{
+    virtual_device_manager* virt;
+    static test_block_device dev;
+    uint8_t buffer[0x20];
+
+    memset(&dev, 0, sizeof(dev));
+    dev.base = 0xFFF0;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, &test_read, NULL, 0xFFF0, 0xFFFF, &dev));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    /* the burst starts before the device. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_UNMAPPED
+            == virtual_device_manager_block_read(virt, 0xFFE0, buffer, 0x20));
+
+    /* the burst runs past the end of the address space. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_UNMAPPED
+            == virtual_device_manager_block_read(virt, 0xFFF0, buffer, 0x11));
+    TEST_EXPECT(0 == dev.byte_reads);
+
+    /* an empty burst succeeds. */
+    TEST_EXPECT(
+        STATUS_SUCCESS
+            == virtual_device_manager_block_read(virt, 0x0000, buffer, 0));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
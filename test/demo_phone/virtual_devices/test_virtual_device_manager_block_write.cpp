@@ -0,0 +1,107 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_manager_block_write);
+
+/**
+ * \brief A test device backed by a buffer, counting its calls.
+ */
+struct test_block_device
+{
+    uint16_t base;
+    uint8_t data[0x200];
+    size_t byte_writes;
+    size_t block_writes;
+};
+
+static status test_write(void* context, uint16_t addr, uint8_t byte)
+{
+    test_block_device* dev = (test_block_device*)context;
+
+    dev->byte_writes += 1;
+    dev->data[addr - dev->base] = byte;
+
+    return STATUS_SUCCESS;
+}
+
+static status test_block_write(
+    void* context, uint16_t addr, const uint8_t* buffer, size_t size)
+{
+    test_block_device* dev = (test_block_device*)context;
+
+    dev->block_writes += 1;
+    memcpy(dev->data + (addr - dev->base), buffer, size);
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief A sector sized burst is routed to an attached device in one call, and
+ * falls back to byte writes for a device without a block handler.
+ */
+TEST(sector)
+{
+    virtual_device_manager* virt;
+    static test_block_device block_dev, byte_dev;
+    virtual_device_entry entry;
+    uint8_t sector[0x200];
+
+    memset(&block_dev, 0, sizeof(block_dev));
+    memset(&byte_dev, 0, sizeof(byte_dev));
+    block_dev.base = 0x2000;
+    byte_dev.base = 0x4000;
+    for (size_t i = 0; i < sizeof(sector); ++i)
+    {
+        sector[i] = (uint8_t)(i * 7);
+    }
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* attach a device with a block handler. */
+    memset(&entry, 0, sizeof(entry));
+    entry.register_low = 0x2000;
+    entry.register_high = 0x21FF;
+    entry.context = &block_dev;
+    entry.write = &test_write;
+    entry.block_write = &test_block_write;
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_manager_entry_attach(virt, &entry));
+
+    /* attach a device without one. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_attach(
+                    virt, NULL, &test_write, 0x4000, 0x41FF, &byte_dev));
+
+    /* the block device takes the sector in one call. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_block_write(
+                    virt, 0x2000, sector, sizeof(sector)));
+    TEST_EXPECT(1 == block_dev.block_writes);
+    TEST_EXPECT(0 == block_dev.byte_writes);
+    TEST_EXPECT(0 == memcmp(block_dev.data, sector, sizeof(sector)));
+
+    /* the byte device takes it one byte at a time. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_block_write(
+                    virt, 0x4000, sector, sizeof(sector)));
+    TEST_EXPECT(sizeof(sector) == byte_dev.byte_writes);
+    TEST_EXPECT(0 == memcmp(byte_dev.data, sector, sizeof(sector)));
+
+    /* a burst into the gap between the devices fails. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_UNMAPPED
+            == virtual_device_manager_block_write(
+                    virt, 0x21FF, sector, 2));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
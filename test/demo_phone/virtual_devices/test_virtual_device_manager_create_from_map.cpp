@@ -0,0 +1,181 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/board_manifest.h"
+#include "../../../src/demo_phone/virtual_devices/status.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_manager_create_from_map);
+
+/**
+ * \brief A test device that returns the low byte of the address it is read at.
+ */
+static status test_read(void*, uint16_t addr, uint8_t* byte)
+{
+    *byte = (uint8_t)(addr & 0xFF);
+
+    return STATUS_SUCCESS;
+}
+
+/* a sorted device map without dispatch tables. */
+static const virtual_device_entry test_devices[] = {
+    virtual_devices::manifest_device(
+        0xF600, 0xF60F, &test_read, NULL, (void*)0x1000),
+    virtual_devices::manifest_device(
+        0xF620, 0xF623, &test_read, NULL, (void*)0x2000),
+};
+static const uint16_t test_lows[] = { 0xF600, 0xF620 };
+static const uint16_t test_highs[] = { 0xF60F, 0xF623 };
+
+/**
+ * \brief A map missing its presence bitmap or keys is rejected.
+ */
+TEST(fail_invalid)
+{
+    virtual_device_manager* virt;
+    virtual_device_map map;
+
+    memset(&map, 0, sizeof(map));
+    map.devices = test_devices;
+    map.register_lows = test_lows;
+    map.register_highs = test_highs;
+    map.device_entries = 2;
+
+    /* no presence bitmap. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_INVALID_MAP
+            == virtual_device_manager_create_from_map(&virt, NULL, &map));
+
+    /* no register keys. */
+    static uint32_t presence[VIRTUAL_DEVICE_PRESENCE_WORDS];
+    map.presence = presence;
+    map.register_lows = NULL;
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_INVALID_MAP
+            == virtual_device_manager_create_from_map(&virt, NULL, &map));
+}
+
+/**
+ * \brief A manager over a map without dispatch tables searches the map's keys,
+ * and refuses every change to the map.
+ */
+TEST(search)
+{
+    virtual_device_manager* virt;
+    static uint32_t presence[VIRTUAL_DEVICE_PRESENCE_WORDS];
+    virtual_device_map map;
+    uint8_t byte = 0;
+
+    /* mark the mapped addresses. */
+    for (uint32_t addr = 0xF600; addr <= 0xF623; ++addr)
+    {
+        if (addr <= 0xF60F || addr >= 0xF620)
+        {
+            presence[addr >> 5] |= UINT32_C(1) << (addr & 31);
+        }
+    }
+
+    memset(&map, 0, sizeof(map));
+    map.devices = test_devices;
+    map.register_lows = test_lows;
+    map.register_highs = test_highs;
+    map.device_entries = 2;
+    map.presence = presence;
+
+    /* create the manager over the map. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_create_from_map(&virt, NULL, &map));
+    TEST_EXPECT(virt->read_only);
+    TEST_EXPECT(virt->sorted);
+    TEST_EXPECT(!virt->finalized);
+
+    /* lookups and reads use the map's tables. */
+    TEST_EXPECT(test_devices + 1 == virtual_device_manager_device_find(
+                    virt, 0xF621));
+    TEST_EXPECT(NULL == virtual_device_manager_device_find(virt, 0xF610));
+    TEST_EXPECT(virtual_device_manager_address_mapped(virt, 0xF605));
+    TEST_EXPECT(!virtual_device_manager_address_mapped(virt, 0xF615));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0xF622, &byte));
+    TEST_EXPECT(0x22 == byte);
+
+    /* the map cannot be changed. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_READ_ONLY
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0x0000, 0x0000, NULL));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_READ_ONLY
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0x0000, 0x0000, NULL));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_READ_ONLY
+            == virtual_device_manager_device_detach(virt, 0xF600, 0xF60F));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_READ_ONLY == virtual_device_manager_sort(virt));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_READ_ONLY
+            == virtual_device_manager_finalize(virt));
+    TEST_EXPECT(2 == virt->device_entries);
+
+    /* release the manager; the map is untouched. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+    TEST_EXPECT(0xF600 == test_devices[0].register_low);
+    TEST_EXPECT(0xF620 == test_lows[1]);
+}
+
+/**
+ * \brief A manager over the tables of a finalized manager dispatches through
+ * the borrowed dispatch table.
+ */
+TEST(finalized)
+{
+    virtual_device_manager* source;
+    virtual_device_manager* virt;
+    virtual_device_map map;
+
+    /* build and finalize a source manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&source));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    source, NULL, NULL, 0xF620, 0xF623, (void*)0x2000));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    source, NULL, NULL, 0xF600, 0xF60F, (void*)0x1000));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(source));
+
+    /* export its tables as a map. */
+    map.devices = source->devices;
+    map.register_lows = source->register_lows;
+    map.register_highs = source->register_highs;
+    map.device_entries = source->device_entries;
+    map.dispatch_pages = source->dispatch_pages;
+    map.dispatch_bytes = source->dispatch_bytes;
+    map.dispatch_tables = source->dispatch_tables;
+    map.presence = source->presence;
+
+    /* create the manager over the map. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_create_from_map(&virt, NULL, &map));
+    TEST_EXPECT(virt->finalized);
+
+    /* every address resolves as it does in the source manager. */
+    for (uint32_t reg = 0; reg <= 0xFFFF; ++reg)
+    {
+        virtual_device_entry* entry =
+            virtual_device_manager_device_find(virt, (uint16_t)reg);
+
+        TEST_EXPECT(
+            entry == virtual_device_manager_device_find(source, (uint16_t)reg));
+    }
+
+    /* release the borrowing manager first. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(source));
+}
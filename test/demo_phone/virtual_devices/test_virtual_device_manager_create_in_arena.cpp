@@ -0,0 +1,100 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_manager_create_in_arena);
+
+/**
+ * \brief A whole board, including the finalized dispatch table and the VIA, is
+ * carved from a single arena sized by the capacity hints.
+ */
+TEST(board)
+{
+    virtual_device_arena* arena;
+    virtual_device_manager* virt;
+    virtual_device_via* via;
+    size_t size =
+        virtual_device_manager_arena_size(4, 1)
+      + VIRTUAL_DEVICE_ARENA_ALIGN(sizeof(virtual_device_via));
+
+    /* create the arena. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_arena_create(&arena, size));
+
+    /* create the manager and the VIA in the arena. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_create_in_arena(&virt, arena, 4));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_via_create_in_arena(&via, arena));
+    TEST_EXPECT(arena == virt->arena);
+    TEST_EXPECT(arena == via->arena);
+    TEST_EXPECT(4 == virt->max_device_entries);
+
+    /* everything lives in the arena block. */
+    TEST_EXPECT((uint8_t*)virt >= arena->base);
+    TEST_EXPECT((uint8_t*)via < arena->base + arena->size);
+
+    /* register the VIA and finalize. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, VIA_REGISTER_IORB, VIA_REGISTER_IORA2,
+                    via));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+    TEST_EXPECT(arena->offset == arena->size);
+    TEST_EXPECT(
+        virt->devices
+            == virtual_device_manager_device_find(virt, VIA_REGISTER_IFR));
+
+    /* release the instances, then the arena. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_arena_release(arena));
+}
+
+/**
+ * \brief Creation fails cleanly when the arena is too small, and a manager in
+ * an arena can still grow past its capacity hint while space remains.
+ */
+TEST(capacity)
+{
+    virtual_device_arena* arena;
+    virtual_device_manager* virt;
+
+    /* an arena too small for the manager fails creation. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_arena_create(&arena, 64));
+    TEST_EXPECT(
+        JEMU_ERROR_OUT_OF_MEMORY
+            == virtual_device_manager_create_in_arena(&virt, arena, 2));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_arena_release(arena));
+
+    /* create a roomy arena with a small capacity hint. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_arena_create(
+                    &arena, virtual_device_manager_arena_size(64, 1)));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_create_in_arena(&virt, arena, 2));
+
+    /* registering past the hint grows the arrays inside the arena. */
+    for (uint16_t i = 0; i < 8; ++i)
+    {
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_manager_device_register(
+                        virt, NULL, NULL, 0xF600 + i, 0xF600 + i, NULL));
+    }
+    TEST_EXPECT(8 <= virt->max_device_entries);
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+    TEST_EXPECT(
+        virt->devices + 7 == virtual_device_manager_device_find(virt, 0xF607));
+
+    /* release the manager, then the arena. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_arena_release(arena));
+}
@@ -0,0 +1,252 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_manager_decoded_register);
+
+/* the addresses seen by the test device. */
+static uint16_t test_read_addr;
+static uint16_t test_block_addrs[4];
+static size_t test_block_sizes[4];
+static size_t test_block_calls;
+
+/**
+ * \brief A test device that records the address it is read at.
+ */
+static status test_read(void*, uint16_t addr, uint8_t* byte)
+{
+    test_read_addr = addr;
+    *byte = (uint8_t)(addr & 0xFF);
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief A test block handler that records each call.
+ */
+static status test_block_read(void*, uint16_t addr, uint8_t* buf, size_t size)
+{
+    test_block_addrs[test_block_calls] = addr;
+    test_block_sizes[test_block_calls] = size;
+    test_block_calls += 1;
+    memset(buf, (uint8_t)(addr & 0xFF), size);
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief Masks that are not contiguous low bits, or that do not match the
+ * entry, or windows past the address space, are rejected.
+ */
+TEST(fail_invalid)
+{
+    virtual_device_manager* virt;
+    virtual_device_entry entry;
+    uint8_t memory[0x08];
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    memset(&entry, 0, sizeof(entry));
+    entry.register_low = 0xF600;
+    entry.register_high = 0xF60F;
+    entry.read = &test_read;
+
+    /* the mask must be non-zero and contiguous low bits. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_INVALID_DECODE
+            == virtual_device_manager_decoded_register(virt, &entry, 0, 4));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_INVALID_DECODE
+            == virtual_device_manager_decoded_register(
+                    virt, &entry, 0x0E, 4));
+
+    /* the mask must match the entry's range. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_INVALID_DECODE
+            == virtual_device_manager_decoded_register(
+                    virt, &entry, 0x07, 4));
+
+    /* the mirrors must fit in the address space. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_INVALID_DECODE
+            == virtual_device_manager_decoded_register(
+                    virt, &entry, 0x0F, 0));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_INVALID_DECODE
+            == virtual_device_manager_decoded_register(
+                    virt, &entry, 0x0F, 0xA1));
+
+    /* a memory region must cover one copy. */
+    entry.memory = memory;
+    entry.memory_size = sizeof(memory);
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_INVALID_REGION
+            == virtual_device_manager_decoded_register(
+                    virt, &entry, 0x0F, 4));
+    TEST_EXPECT(0 == virt->device_entries);
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief A VIA decoding four address bits is mirrored across a page with one
+ * entry, and every copy reaches the same registers.
+ */
+TEST(via_mirrors)
+{
+    virtual_device_manager* virt;
+    virtual_device_via* via;
+    virtual_device_entry entry;
+    uint8_t byte = 0;
+
+    /* create the VIA and the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* mirror the VIA sixteen times, across the page. */
+    virtual_device_via_entry_init(via, &entry, VIA_REGISTER_IORB);
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_decoded_register(
+                    virt, &entry, VIA_REGISTER_COUNT - 1, 16));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+    TEST_EXPECT(1 == virt->device_entries);
+    TEST_EXPECT(0xF6FF == virt->devices[0].register_high);
+    TEST_EXPECT(virtual_device_manager_address_mapped(virt, 0xF6FF));
+    TEST_EXPECT(!virtual_device_manager_address_mapped(virt, 0xF700));
+
+    /* a shadowed register written in one copy is read in another. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(virt, 0xF6F2, 0x0F));
+    TEST_EXPECT(0x0F == VIA_SHADOW(via, VIA_REGISTER_DDRB));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0xF612, &byte));
+    TEST_EXPECT(0x0F == byte);
+
+    /* a port written in one copy is read in another. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(virt, 0xF680, 0x05));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0xF650, &byte));
+    TEST_EXPECT(0x05 == byte);
+
+    /* release the manager and the VIA. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
+
+/**
+ * \brief Device handlers see the address in the first copy, and bursts are
+ * split at the end of each copy.
+ */
+TEST(decoded_addresses)
+{
+    virtual_device_manager* virt;
+    virtual_device_entry entry;
+    uint8_t buffer[8];
+    uint8_t byte = 0;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* a four register device, mirrored eight times. */
+    memset(&entry, 0, sizeof(entry));
+    entry.register_low = 0xD000;
+    entry.register_high = 0xD003;
+    entry.read = &test_read;
+    entry.block_read = &test_block_read;
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_decoded_register(
+                    virt, &entry, 0x03, 8));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    /* byte reads are decoded. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0xD01E, &byte));
+    TEST_EXPECT(0xD002 == test_read_addr);
+    TEST_EXPECT(0x02 == byte);
+
+    /* a burst over three copies becomes three decoded block reads. */
+    test_block_calls = 0;
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_block_read(
+                    virt, 0xD006, buffer, sizeof(buffer)));
+    TEST_ASSERT(3 == test_block_calls);
+    TEST_EXPECT(0xD002 == test_block_addrs[0]);
+    TEST_EXPECT(2 == test_block_sizes[0]);
+    TEST_EXPECT(0xD000 == test_block_addrs[1]);
+    TEST_EXPECT(4 == test_block_sizes[1]);
+    TEST_EXPECT(0xD000 == test_block_addrs[2]);
+    TEST_EXPECT(2 == test_block_sizes[2]);
+
+    /* the window ends after the last copy. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_UNMAPPED
+            == virtual_device_manager_emu_read_callback(virt, 0xD020, &byte));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief A decoded memory region repeats its memory in every copy, and direct
+ * access stops at the end of the copy.
+ */
+TEST(region)
+{
+    virtual_device_manager* virt;
+    virtual_device_entry entry;
+    uint8_t memory[0x10];
+    uint8_t byte = 0;
+    size_t contiguous = 0;
+
+    memset(memory, 0, sizeof(memory));
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* sixteen bytes of RAM, mirrored four times. */
+    memset(&entry, 0, sizeof(entry));
+    entry.register_low = 0x0200;
+    entry.register_high = 0x020F;
+    entry.memory = memory;
+    entry.memory_size = sizeof(memory);
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_decoded_register(
+                    virt, &entry, 0x0F, 4));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    /* writes to one copy are read from every copy. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(virt, 0x0231, 0x42));
+    TEST_EXPECT(0x42 == memory[1]);
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0x0211, &byte));
+    TEST_EXPECT(0x42 == byte);
+
+    /* direct access is contiguous to the end of the copy only. */
+    TEST_EXPECT(
+        memory + 0x0E
+            == virtual_device_manager_direct_access(
+                    virt, 0x021E, true, &contiguous));
+    TEST_EXPECT(2 == contiguous);
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
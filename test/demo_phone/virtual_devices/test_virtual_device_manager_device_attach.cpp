@@ -0,0 +1,234 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_manager_device_attach);
+
+/**
+ * \brief Attach fails if the manager holds unsorted registered entries.
+ */
+TEST(fail_not_sorted)
+{
+    virtual_device_manager* virt;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* register a device without sorting. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+
+    /* attach fails. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_NOT_SORTED
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0xF610, 0xF61F, NULL));
+
+    /* after sorting, attach succeeds. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_sort(virt));
+    TEST_EXPECT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0xF610, 0xF61F, NULL));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Attach rejects devices overlapping either neighbor.
+ */
+TEST(fail_overlap)
+{
+    virtual_device_manager* virt;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* attach two devices. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0xF620, 0xF62F, NULL));
+
+    /* an exact duplicate fails. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_OVERLAP
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+
+    /* overlapping the lower neighbor fails. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_OVERLAP
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0xF60F, 0xF61F, NULL));
+
+    /* overlapping the upper neighbor fails. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_OVERLAP
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0xF610, 0xF620, NULL));
+
+    /* enclosing a device fails. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_OVERLAP
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0xF500, 0xF6FF, NULL));
+
+    /* nothing was added. */
+    TEST_EXPECT(2 == virt->device_entries);
+    TEST_EXPECT(virt->sorted);
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Attached devices are kept in sorted order, are marked present, and
+ * are found through the dispatch table of a finalized manager.
+ */
+TEST(sorted_insert)
+{
+    virtual_device_manager* virt;
+    const uint16_t lows[] = {
+        0xF640, 0xF600, 0xF6F0, 0xF620, 0x0000, 0xF800, 0xF610, 0xF630,
+        0xF650, 0xF660, 0xF670, 0xF680 };
+    const size_t count = sizeof(lows) / sizeof(lows[0]);
+
+    /* create and finalize the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    /* attach each device; this grows the device array past its start size. */
+    for (size_t i = 0; i < count; ++i)
+    {
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_manager_device_attach(
+                        virt, NULL, NULL, lows[i], lows[i] + 0x0F,
+                        (void*)(uintptr_t)(i + 1)));
+        TEST_EXPECT(virt->sorted);
+        TEST_EXPECT(virt->finalized);
+    }
+
+    /* the device array is sorted. */
+    TEST_ASSERT(count == virt->device_entries);
+    for (size_t i = 1; i < count; ++i)
+    {
+        TEST_EXPECT(
+            virt->devices[i - 1].register_high < virt->devices[i].register_low);
+    }
+
+    /* every device is present and found. */
+    for (size_t i = 0; i < count; ++i)
+    {
+        virtual_device_entry* entry =
+            virtual_device_manager_device_find(virt, lows[i] + 0x0F);
+
+        TEST_ASSERT(NULL != entry);
+        TEST_EXPECT((void*)(uintptr_t)(i + 1) == entry->context);
+        TEST_EXPECT(virtual_device_manager_address_mapped(virt, lows[i]));
+    }
+
+    /* gaps are not present. */
+    TEST_EXPECT(!virtual_device_manager_address_mapped(virt, 0x0010));
+    TEST_EXPECT(NULL == virtual_device_manager_device_find(virt, 0xF690));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Attaching and detaching on pages that already have a byte table
+ * rebuilds the dispatch table in place.
+ */
+TEST(same_page_in_place)
+{
+    virtual_device_manager* virt;
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    uint16_t* bytes = virt->dispatch_bytes;
+    TEST_EXPECT(2 == virt->dispatch_capacity);
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0xF610, 0xF61F, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_detach(virt, 0xF600, 0xF60F));
+    TEST_EXPECT(bytes == virt->dispatch_bytes);
+    TEST_EXPECT(2 == virt->dispatch_capacity);
+    TEST_EXPECT(
+        virt->devices == virtual_device_manager_device_find(virt, 0xF610));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief When the dispatch table cannot be grown, attaching fails and leaves a
+ * finalized manager unchanged.
+ */
+TEST(fail_out_of_memory)
+{
+    virtual_device_arena* arena;
+    virtual_device_manager* virt;
+
+    /* the manager and a one page dispatch table fill the arena. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_arena_create(
+                    &arena, virtual_device_manager_arena_size(4, 1)));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_create_in_arena(&virt, arena, 4));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+    TEST_EXPECT(arena->offset == arena->size);
+
+    /* a device on a second page needs a byte table there is no room for. */
+    TEST_EXPECT(
+        JEMU_ERROR_OUT_OF_MEMORY
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0x8000, 0x800F, NULL));
+    TEST_EXPECT(1 == virt->device_entries);
+    TEST_EXPECT(virt->finalized);
+    TEST_EXPECT(NULL == virtual_device_manager_device_find(virt, 0x8000));
+    TEST_EXPECT(!virtual_device_manager_address_mapped(virt, 0x8000));
+    TEST_EXPECT(
+        virt->devices == virtual_device_manager_device_find(virt, 0xF600));
+
+    /* a device on the same page still fits, and can be detached again. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0xF610, 0xF61F, NULL));
+    TEST_EXPECT(
+        virt->devices + 1 == virtual_device_manager_device_find(virt, 0xF610));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_detach(virt, 0xF610, 0xF61F));
+    TEST_EXPECT(virt->finalized);
+    TEST_EXPECT(NULL == virtual_device_manager_device_find(virt, 0xF610));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_arena_release(arena));
+}
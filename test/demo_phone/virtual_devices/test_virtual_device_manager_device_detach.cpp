@@ -0,0 +1,121 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_manager_device_detach);
+
+/**
+ * \brief Detach fails if no device has exactly the given range.
+ */
+TEST(fail_not_found)
+{
+    virtual_device_manager* virt;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* attach a device. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+
+    /* detaching an unknown or partial range fails. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_NOT_FOUND
+            == virtual_device_manager_device_detach(virt, 0xF610, 0xF61F));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_NOT_FOUND
+            == virtual_device_manager_device_detach(virt, 0xF600, 0xF607));
+    TEST_EXPECT(1 == virt->device_entries);
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Detach fails if the manager holds unsorted registered entries.
+ */
+TEST(fail_not_sorted)
+{
+    virtual_device_manager* virt;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* register a device without sorting. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+
+    /* detach fails. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_NOT_SORTED
+            == virtual_device_manager_device_detach(virt, 0xF600, 0xF60F));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Detaching a device from a finalized manager removes it from the
+ * presence bitmap and dispatch table and keeps the other devices in order.
+ */
+TEST(detach)
+{
+    virtual_device_manager* virt;
+    void* DEVA_CONTEXT = (void*)0x1000;
+    void* DEVB_CONTEXT = (void*)0x2000;
+    void* DEVC_CONTEXT = (void*)0x3000;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* register three devices and finalize. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF620, 0xF62F, DEVC_CONTEXT));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF600, 0xF60F, DEVA_CONTEXT));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF610, 0xF61F, DEVB_CONTEXT));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    /* detach the middle device. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_detach(virt, 0xF610, 0xF61F));
+    TEST_EXPECT(virt->finalized);
+    TEST_ASSERT(2 == virt->device_entries);
+    TEST_EXPECT(DEVA_CONTEXT == virt->devices[0].context);
+    TEST_EXPECT(DEVC_CONTEXT == virt->devices[1].context);
+
+    /* the detached range is gone. */
+    TEST_EXPECT(!virtual_device_manager_address_mapped(virt, 0xF610));
+    TEST_EXPECT(NULL == virtual_device_manager_device_find(virt, 0xF61F));
+
+    /* the other devices remain. */
+    TEST_EXPECT(virtual_device_manager_address_mapped(virt, 0xF60F));
+    TEST_EXPECT(
+        virt->devices + 1 == virtual_device_manager_device_find(virt, 0xF620));
+
+    /* the range can be attached again. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0xF610, 0xF61F, DEVB_CONTEXT));
+    TEST_EXPECT(
+        virt->devices + 1 == virtual_device_manager_device_find(virt, 0xF615));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
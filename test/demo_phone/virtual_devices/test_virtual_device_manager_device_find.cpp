@@ -1060,3 +1060,54 @@ TEST(success_multi_fifth)
     /* release the manager. */
     TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
 }
+
+/**
+ * \brief Search bisects the register keys when there are more devices than fit
+ * in a single range match window.
+ */
+TEST(success_many)
+{
+    virtual_device_manager* virt;
+    const size_t DEVICES = 40;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* register devices of eight registers each, with eight register gaps. */
+    for (size_t i = DEVICES; i > 0; --i)
+    {
+        uint16_t low = (uint16_t)(0xF600 + (i - 1) * 16);
+
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_manager_device_register(
+                        virt, NULL, NULL, low, low + 7, (void*)(uintptr_t)i));
+    }
+
+    /* Sort the entries. */
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_manager_sort(virt));
+
+    /* every register in a device is found, and every gap is not. */
+    for (size_t i = 0; i < DEVICES; ++i)
+    {
+        uint16_t low = (uint16_t)(0xF600 + i * 16);
+
+        for (uint16_t off = 0; off < 8; ++off)
+        {
+            TEST_EXPECT(
+                virt->devices + i
+                    == virtual_device_manager_device_find(virt, low + off));
+            TEST_EXPECT(
+                NULL
+                    == virtual_device_manager_device_find(virt, low + 8 + off));
+        }
+    }
+
+    /* registers below and above all devices are not found. */
+    TEST_EXPECT(NULL == virtual_device_manager_device_find(virt, 0xF5FF));
+    TEST_EXPECT(NULL == virtual_device_manager_device_find(virt, 0xFFFF));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
@@ -0,0 +1,89 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_manager_direct_access);
+
+static status test_read(void*, uint16_t, uint8_t* byte)
+{
+    *byte = 0;
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief Direct access hands out pointers into memory regions only, and write
+ * pointers only for writable regions.
+ */
+TEST(pointers)
+{
+    virtual_device_manager* virt;
+    uint8_t ram[0x100];
+    uint8_t rom[0x800];
+    uint8_t mirror[0x10];
+    size_t contiguous = 0;
+
+    /* create the manager and register a device and the regions. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, &test_read, NULL, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_region_register(
+                    virt, 0x0200, 0x02FF, ram, sizeof(ram), 0));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_region_register(
+                    virt, 0xF800, 0xFFFF, rom, sizeof(rom),
+                    VIRTUAL_DEVICE_REGION_WRITE_PROTECTED));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_region_register(
+                    virt, 0x1000, 0x1FFF, mirror, sizeof(mirror),
+                    VIRTUAL_DEVICE_REGION_MIRRORED));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    /* RAM can be read and written, up to the end of the region. */
+    TEST_EXPECT(
+        ram + 0x10
+            == virtual_device_manager_direct_access(
+                    virt, 0x0210, true, &contiguous));
+    TEST_EXPECT(0xF0 == contiguous);
+
+    /* ROM can only be read. */
+    TEST_EXPECT(
+        rom + 0x7FC
+            == virtual_device_manager_direct_access(
+                    virt, 0xFFFC, false, &contiguous));
+    TEST_EXPECT(4 == contiguous);
+    TEST_EXPECT(
+        NULL
+            == virtual_device_manager_direct_access(
+                    virt, 0xFFFC, true, &contiguous));
+
+    /* a mirror's run ends at the end of its memory. */
+    TEST_EXPECT(
+        mirror + 0x0C
+            == virtual_device_manager_direct_access(
+                    virt, 0x123C, true, &contiguous));
+    TEST_EXPECT(4 == contiguous);
+
+    /* devices and unmapped addresses have no direct access. */
+    TEST_EXPECT(
+        NULL
+            == virtual_device_manager_direct_access(
+                    virt, 0xF600, false, &contiguous));
+    TEST_EXPECT(
+        NULL
+            == virtual_device_manager_direct_access(
+                    virt, 0x0000, false, &contiguous));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
@@ -0,0 +1,144 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_manager_emu_read_callback);
+
+/**
+ * \brief A test device that returns the low byte of the address it is read at.
+ */
+struct test_read_device
+{
+    size_t reads;
+    uint16_t last_addr;
+};
+
+static status test_read(void* context, uint16_t addr, uint8_t* byte)
+{
+    test_read_device* dev = (test_read_device*)context;
+
+    dev->reads += 1;
+    dev->last_addr = addr;
+    *byte = (uint8_t)(addr & 0xFF);
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief Reading an unmapped address fails.
+ */
+TEST(fail_unmapped)
+{
+    virtual_device_manager* virt;
+    test_read_device dev;
+    uint8_t byte = 0;
+
+    memset(&dev, 0, sizeof(dev));
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* register a device and finalize. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, &test_read, NULL, 0xF600, 0xF60F, &dev));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    /* reading outside of the device fails. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_UNMAPPED
+            == virtual_device_manager_emu_read_callback(virt, 0xF610, &byte));
+    TEST_EXPECT(0 == dev.reads);
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Reading a device without a read handler fails like an unmapped read.
+ */
+TEST(fail_no_handler)
+{
+    virtual_device_manager* virt;
+    uint8_t byte = 0;
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_UNMAPPED
+            == virtual_device_manager_emu_read_callback(virt, 0xF600, &byte));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Reads are dispatched to the matching device, and the last matched
+ * entry is cached.
+ */
+TEST(dispatch)
+{
+    virtual_device_manager* virt;
+    test_read_device deva, devb;
+    uint8_t byte = 0;
+
+    memset(&deva, 0, sizeof(deva));
+    memset(&devb, 0, sizeof(devb));
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* register two devices and finalize. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, &test_read, NULL, 0xF610, 0xF61F, &devb));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, &test_read, NULL, 0xF600, 0xF60F, &deva));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+    TEST_EXPECT(NULL == virt->last_hit);
+
+    /* read from device A. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0xF60D, &byte));
+    TEST_EXPECT(0x0D == byte);
+    TEST_EXPECT(1 == deva.reads);
+    TEST_EXPECT(0xF60D == deva.last_addr);
+    TEST_EXPECT(virt->devices + 0 == virt->last_hit);
+
+    /* read from device B. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0xF611, &byte));
+    TEST_EXPECT(0x11 == byte);
+    TEST_EXPECT(1 == devb.reads);
+    TEST_EXPECT(virt->devices + 1 == virt->last_hit);
+
+    /* a miss leaves the cache alone. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_UNMAPPED
+            == virtual_device_manager_emu_read_callback(virt, 0x0000, &byte));
+    TEST_EXPECT(virt->devices + 1 == virt->last_hit);
+
+    /* registering a device clears the cache. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, &test_read, NULL, 0xF620, 0xF62F, NULL));
+    TEST_EXPECT(NULL == virt->last_hit);
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
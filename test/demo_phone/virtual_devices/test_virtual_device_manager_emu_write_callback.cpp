@@ -0,0 +1,133 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_manager_emu_write_callback);
+
+/**
+ * \brief A test device that records the last write.
+ */
+struct test_write_device
+{
+    size_t writes;
+    uint16_t last_addr;
+    uint8_t last_byte;
+};
+
+static status test_write(void* context, uint16_t addr, uint8_t byte)
+{
+    test_write_device* dev = (test_write_device*)context;
+
+    dev->writes += 1;
+    dev->last_addr = addr;
+    dev->last_byte = byte;
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief Writing an unmapped address fails.
+ */
+TEST(fail_unmapped)
+{
+    virtual_device_manager* virt;
+    test_write_device dev;
+
+    memset(&dev, 0, sizeof(dev));
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* register a device and finalize. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, &test_write, 0xF600, 0xF60F, &dev));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    /* writing outside of the device fails. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_UNMAPPED
+            == virtual_device_manager_emu_write_callback(virt, 0xF5FF, 0x12));
+    TEST_EXPECT(0 == dev.writes);
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Writing a device without a write handler fails like an unmapped
+ * write.
+ */
+TEST(fail_no_handler)
+{
+    virtual_device_manager* virt;
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_UNMAPPED
+            == virtual_device_manager_emu_write_callback(virt, 0xF600, 0x12));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Writes are dispatched to the matching device, and the last matched
+ * entry is cached.
+ */
+TEST(dispatch)
+{
+    virtual_device_manager* virt;
+    test_write_device deva, devb;
+
+    memset(&deva, 0, sizeof(deva));
+    memset(&devb, 0, sizeof(devb));
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* register two devices and finalize. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, &test_write, 0xF600, 0xF60F, &deva));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, &test_write, 0xF610, 0xF61F, &devb));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    /* write to device B twice; the second write hits the cache. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(virt, 0xF61F, 0x34));
+    TEST_EXPECT(virt->devices + 1 == virt->last_hit);
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(virt, 0xF610, 0x56));
+    TEST_EXPECT(2 == devb.writes);
+    TEST_EXPECT(0xF610 == devb.last_addr);
+    TEST_EXPECT(0x56 == devb.last_byte);
+    TEST_EXPECT(0 == deva.writes);
+
+    /* write to device A. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(virt, 0xF600, 0x78));
+    TEST_EXPECT(1 == deva.writes);
+    TEST_EXPECT(0x78 == deva.last_byte);
+    TEST_EXPECT(virt->devices + 0 == virt->last_hit);
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
@@ -0,0 +1,265 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_manager_finalize);
+
+/**
+ * \brief Finalizing an empty manager succeeds, and find fails for every page.
+ */
+TEST(empty)
+{
+    virtual_device_manager* virt;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* finalize the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+    TEST_EXPECT(virt->finalized);
+    TEST_EXPECT(1 == virt->dispatch_tables);
+
+    /* find fails everywhere. */
+    TEST_EXPECT(NULL == virtual_device_manager_device_find(virt, 0x0000));
+    TEST_EXPECT(NULL == virtual_device_manager_device_find(virt, 0xF600));
+    TEST_EXPECT(NULL == virtual_device_manager_device_find(virt, 0xFFFF));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Finalize fails when two devices have intersecting register ranges.
+ */
+TEST(fail_intersect)
+{
+    virtual_device_manager* virt;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* Create two dummy entries that intersect. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF60F, 0xF61F, NULL));
+
+    /* Finalize should fail. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_OVERLAP == virtual_device_manager_finalize(virt));
+    TEST_EXPECT(!virt->finalized);
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Find resolves every address through the dispatch table, including
+ * devices sharing a page and devices spanning several pages.
+ */
+TEST(find)
+{
+    virtual_device_manager* virt;
+
+    /* device entry A spans three pages. */
+    uint16_t DEVA_REGISTER_LOW = 0xF7F0;
+    uint16_t DEVA_REGISTER_HIGH = 0xFFFF;
+    void* DEVA_CONTEXT = (void*)0x1000;
+
+    /* device entry B shares a page with C. */
+    uint16_t DEVB_REGISTER_LOW = 0xF600;
+    uint16_t DEVB_REGISTER_HIGH = 0xF60F;
+    void* DEVB_CONTEXT = (void*)0x2000;
+
+    /* device entry C shares a page with B. */
+    uint16_t DEVC_REGISTER_LOW = 0xF620;
+    uint16_t DEVC_REGISTER_HIGH = 0xF623;
+    void* DEVC_CONTEXT = (void*)0x3000;
+
+    /* device entry D is a single register in page zero. */
+    uint16_t DEVD_REGISTER_LOW = 0x0000;
+    uint16_t DEVD_REGISTER_HIGH = 0x0000;
+    void* DEVD_CONTEXT = (void*)0x4000;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* register the devices out of order. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, DEVA_REGISTER_LOW, DEVA_REGISTER_HIGH,
+                    DEVA_CONTEXT));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, DEVB_REGISTER_LOW, DEVB_REGISTER_HIGH,
+                    DEVB_CONTEXT));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, DEVC_REGISTER_LOW, DEVC_REGISTER_HIGH,
+                    DEVC_CONTEXT));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, DEVD_REGISTER_LOW, DEVD_REGISTER_HIGH,
+                    DEVD_CONTEXT));
+
+    /* finalize the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+    TEST_ASSERT(virt->finalized);
+
+    /* pages 00, F6, F7, F8 through FF, plus the empty table. */
+    TEST_EXPECT(12 == virt->dispatch_tables);
+
+    /* every address resolves to the entry covering it. */
+    for (uint32_t reg = 0; reg <= 0xFFFF; ++reg)
+    {
+        virtual_device_entry* entry =
+            virtual_device_manager_device_find(virt, (uint16_t)reg);
+
+        if (reg == DEVD_REGISTER_LOW)
+        {
+            TEST_ASSERT(NULL != entry);
+            TEST_EXPECT(DEVD_CONTEXT == entry->context);
+        }
+        else if (reg >= DEVB_REGISTER_LOW && reg <= DEVB_REGISTER_HIGH)
+        {
+            TEST_ASSERT(NULL != entry);
+            TEST_EXPECT(DEVB_CONTEXT == entry->context);
+        }
+        else if (reg >= DEVC_REGISTER_LOW && reg <= DEVC_REGISTER_HIGH)
+        {
+            TEST_ASSERT(NULL != entry);
+            TEST_EXPECT(DEVC_CONTEXT == entry->context);
+        }
+        else if (reg >= DEVA_REGISTER_LOW)
+        {
+            TEST_ASSERT(NULL != entry);
+            TEST_EXPECT(DEVA_CONTEXT == entry->context);
+        }
+        else
+        {
+            TEST_EXPECT(NULL == entry);
+        }
+    }
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Registering a device after finalization clears the finalized flag.
+ */
+TEST(register_after_finalize)
+{
+    virtual_device_manager* virt;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* register a device and finalize. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+    TEST_EXPECT(virt->finalized);
+    TEST_EXPECT(NULL == virtual_device_manager_device_find(virt, 0xF610));
+
+    /* register a second device. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF610, 0xF61F, NULL));
+    TEST_EXPECT(!virt->finalized);
+
+    /* finalize again; the new device is found. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+    TEST_EXPECT(virt->devices + 1
+        == virtual_device_manager_device_find(virt, 0xF610));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Re-finalizing, attaching, and detaching within the pages the dispatch
+ * table was built for reuse it, and a table that is the arena's most recent
+ * allocation grows in place.
+ */
+TEST(refinalize_budget)
+{
+    virtual_device_arena* arena;
+    virtual_device_manager* virt;
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_arena_create(
+                    &arena, virtual_device_manager_arena_size(4, 2)));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_create_in_arena(&virt, arena, 4));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+    TEST_EXPECT(2 == virt->dispatch_capacity);
+
+    /* a device instance is carved after the table. */
+    TEST_ASSERT(NULL != virtual_device_arena_alloc(arena, 16));
+    size_t offset = arena->offset;
+
+    /* rebuilding within the same page costs nothing. */
+    for (int i = 0; i < 8; ++i)
+    {
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_manager_device_attach(
+                        virt, NULL, NULL, 0xF610, 0xF61F, NULL));
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_manager_device_detach(
+                        virt, 0xF610, 0xF61F));
+        TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+    }
+
+    TEST_EXPECT(offset == arena->offset);
+    TEST_EXPECT(virt->finalized);
+    TEST_EXPECT(
+        virt->devices == virtual_device_manager_device_find(virt, 0xF600));
+    TEST_EXPECT(NULL == virtual_device_manager_device_find(virt, 0xF610));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+
+    /* with the table last in the arena, a second page grows it in place. */
+    virtual_device_arena_reset(arena);
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_create_in_arena(&virt, arena, 4));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0x8000, 0x800F, NULL));
+    TEST_EXPECT(3 == virt->dispatch_tables);
+    TEST_EXPECT(arena->offset == arena->size);
+    TEST_EXPECT(
+        virt->devices == virtual_device_manager_device_find(virt, 0x8000));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_arena_release(arena));
+}
@@ -0,0 +1,167 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_manager_region_register);
+
+/**
+ * \brief A region must have memory covering its range, unless mirrored.
+ */
+TEST(fail_invalid)
+{
+    virtual_device_manager* virt;
+    uint8_t memory[0x10];
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* no memory. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_INVALID_REGION
+            == virtual_device_manager_region_register(
+                    virt, 0x0200, 0x020F, NULL, sizeof(memory), 0));
+
+    /* memory too small for the range. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_INVALID_REGION
+            == virtual_device_manager_region_register(
+                    virt, 0x0200, 0x0210, memory, sizeof(memory), 0));
+
+    /* a mirrored region may be smaller than its range. */
+    TEST_EXPECT(
+        STATUS_SUCCESS
+            == virtual_device_manager_region_register(
+                    virt, 0x0200, 0x02FF, memory, sizeof(memory),
+                    VIRTUAL_DEVICE_REGION_MIRRORED));
+    TEST_EXPECT(1 == virt->device_entries);
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief RAM, ROM, and mirrored regions are read and written directly by the
+ * emulator callbacks.
+ */
+TEST(access)
+{
+    virtual_device_manager* virt;
+    uint8_t ram[0x100];
+    uint8_t rom[0x800];
+    uint8_t mirror[0x04];
+    uint8_t flash[0x10];
+    uint8_t byte = 0;
+
+    memset(ram, 0, sizeof(ram));
+    memset(rom, 0xEA, sizeof(rom));
+    memset(mirror, 0, sizeof(mirror));
+    memset(flash, 0x5A, sizeof(flash));
+    rom[0x7FC] = 0x00;
+    rom[0x7FD] = 0xF8;
+
+    /* create the manager and register the regions. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_region_register(
+                    virt, 0x0200, 0x02FF, ram, sizeof(ram), 0));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_region_register(
+                    virt, 0xF800, 0xFFFF, rom, sizeof(rom),
+                    VIRTUAL_DEVICE_REGION_WRITE_PROTECTED));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_region_register(
+                    virt, 0x0300, 0x03FF, mirror, sizeof(mirror),
+                    VIRTUAL_DEVICE_REGION_MIRRORED));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_region_register(
+                    virt, 0x0400, 0x040F, flash, sizeof(flash),
+                    VIRTUAL_DEVICE_REGION_READ_ONLY));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    /* RAM is written and read back. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(virt, 0x0234, 0x77));
+    TEST_EXPECT(0x77 == ram[0x34]);
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0x0234, &byte));
+    TEST_EXPECT(0x77 == byte);
+
+    /* the ROM reads its reset vector, and ignores writes. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0xFFFD, &byte));
+    TEST_EXPECT(0xF8 == byte);
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(virt, 0xFFFD, 0x00));
+    TEST_EXPECT(0xF8 == rom[0x7FD]);
+
+    /* the mirror repeats every four bytes. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(virt, 0x03F6, 0x42));
+    TEST_EXPECT(0x42 == mirror[2]);
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0x0302, &byte));
+    TEST_EXPECT(0x42 == byte);
+
+    /* writing a read-only region fails. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_REGION_READ_ONLY
+            == virtual_device_manager_emu_write_callback(virt, 0x0400, 0x00));
+    TEST_EXPECT(0x5A == flash[0]);
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Block transfers copy memory regions directly, wrapping mirrors.
+ */
+TEST(block)
+{
+    virtual_device_manager* virt;
+    uint8_t mirror[0x04] = { 1, 2, 3, 4 };
+    uint8_t buffer[0x0A];
+
+    /* create the manager and register a mirrored region. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_region_register(
+                    virt, 0x0300, 0x03FF, mirror, sizeof(mirror),
+                    VIRTUAL_DEVICE_REGION_MIRRORED));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    /* a burst starting mid-mirror wraps around the memory. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_block_read(
+                    virt, 0x0302, buffer, sizeof(buffer)));
+    TEST_EXPECT(3 == buffer[0]);
+    TEST_EXPECT(4 == buffer[1]);
+    TEST_EXPECT(1 == buffer[2]);
+    TEST_EXPECT(4 == buffer[9]);
+
+    /* a burst write lands in the mirror. */
+    memset(buffer, 9, sizeof(buffer));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_block_write(virt, 0x03FE, buffer, 2));
+    TEST_EXPECT(9 == mirror[2] && 9 == mirror[3]);
+    TEST_EXPECT(1 == mirror[0]);
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
@@ -0,0 +1,615 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/scheduler.h"
+#include "../../../src/demo_phone/virtual_devices/snapshot.h"
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_manager_snapshot_save);
+
+/**
+ * \brief A board with 16K of RAM, a ROM, and a VIA.
+ */
+struct test_board
+{
+    virtual_device_manager* virt;
+    virtual_device_via* via;
+    uint8_t ram[0x4000];
+    uint8_t rom[0x800];
+};
+
+/**
+ * \brief Build the test board.
+ */
+static bool test_board_create(test_board* board)
+{
+    virtual_device_entry entry;
+
+    memset(board->ram, 0x11, sizeof(board->ram));
+    memset(board->rom, 0xEA, sizeof(board->rom));
+
+    if (STATUS_SUCCESS != virtual_device_manager_create(&board->virt)
+     || STATUS_SUCCESS != virtual_device_via_create(&board->via))
+    {
+        return false;
+    }
+
+    virtual_device_via_entry_init(board->via, &entry, VIA_REGISTER_IORB);
+
+    return
+        STATUS_SUCCESS
+            == virtual_device_manager_region_register(
+                    board->virt, 0x0000, 0x3FFF, board->ram,
+                    sizeof(board->ram), 0)
+     && STATUS_SUCCESS
+            == virtual_device_manager_region_register(
+                    board->virt, 0xF800, 0xFFFF, board->rom,
+                    sizeof(board->rom), VIRTUAL_DEVICE_REGION_READ_ONLY)
+     && STATUS_SUCCESS
+            == virtual_device_manager_entry_register(board->virt, &entry)
+     && STATUS_SUCCESS == virtual_device_manager_finalize(board->virt);
+}
+
+/**
+ * \brief Tear down the test board.
+ */
+static bool test_board_release(test_board* board)
+{
+    return
+        STATUS_SUCCESS == virtual_device_manager_release(board->virt)
+     && STATUS_SUCCESS == virtual_device_via_release(board->via);
+}
+
+/**
+ * \brief A snapshot saves writable memory and device state, and restoring it
+ * only copies the pages written since.
+ */
+TEST(save_restore)
+{
+    test_board board;
+    virtual_device_snapshot* snapshot;
+
+    TEST_ASSERT(test_board_create(&board));
+
+    /* boot: program the VIA and touch some RAM. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, VIA_REGISTER_DDRB, 0xF0));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, VIA_REGISTER_IORB, 0x50));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, 0x0200, 0x42));
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_save(board.virt, &snapshot));
+
+    /* the ROM is not saved; the RAM and VIA are. */
+    TEST_ASSERT(3 == snapshot->device_entries);
+    TEST_EXPECT(0 == virtual_device_manager_snapshot_dirty(board.virt));
+
+    /* run a scenario touching two pages, the VIA, and a block of RAM. */
+    uint8_t block[4] = { 1, 2, 3, 4 };
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, 0x0201, 0x99));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_block_write(
+                    board.virt, 0x20FE, block, sizeof(block)));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, VIA_REGISTER_DDRB, 0x0F));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, VIA_REGISTER_IORB, 0x05));
+    TEST_EXPECT(3 == virtual_device_manager_snapshot_dirty(board.virt));
+
+    /* tamper with a clean page in the snapshot, to see that it is skipped. */
+    snapshot->entries[0].memory[0x1000] = 0x77;
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_restore(board.virt, snapshot));
+    TEST_EXPECT(0 == virtual_device_manager_snapshot_dirty(board.virt));
+
+    /* the written pages are back, and the clean page was not copied. */
+    TEST_EXPECT(0x42 == board.ram[0x0200]);
+    TEST_EXPECT(0x11 == board.ram[0x0201]);
+    TEST_EXPECT(0x11 == board.ram[0x20FE]);
+    TEST_EXPECT(0x11 == board.ram[0x2101]);
+    TEST_EXPECT(0x11 == board.ram[0x1000]);
+
+    /* the VIA registers are back. */
+    TEST_EXPECT(0xF0 == VIA_SHADOW(board.via, VIA_REGISTER_DDRB));
+    TEST_EXPECT(0x50 == board.via->orb);
+
+    virtual_device_snapshot_release(snapshot);
+    TEST_EXPECT(test_board_release(&board));
+}
+
+/**
+ * \brief A direct write pointer marks its page dirty, and stops at the end of
+ * the page.
+ */
+TEST(direct_access)
+{
+    test_board board;
+    virtual_device_snapshot* snapshot;
+    size_t contiguous = 0;
+
+    TEST_ASSERT(test_board_create(&board));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_save(board.virt, &snapshot));
+
+    /* a read pointer leaves the page clean. */
+    TEST_EXPECT(
+        board.ram + 0x0310
+            == virtual_device_manager_direct_access(
+                    board.virt, 0x0310, false, &contiguous));
+    TEST_EXPECT(0x3CF0 == contiguous);
+    TEST_EXPECT(0 == virtual_device_manager_snapshot_dirty(board.virt));
+
+    /* a write pointer dirties its page, and covers only the page. */
+    uint8_t* ptr =
+        virtual_device_manager_direct_access(
+            board.virt, 0x0310, true, &contiguous);
+    TEST_ASSERT(board.ram + 0x0310 == ptr);
+    TEST_EXPECT(0xF0 == contiguous);
+    TEST_EXPECT(1 == virtual_device_manager_snapshot_dirty(board.virt));
+
+    memset(ptr, 0xAB, contiguous);
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_restore(board.virt, snapshot));
+    TEST_EXPECT(0x11 == board.ram[0x0310]);
+    TEST_EXPECT(0x11 == board.ram[0x03FF]);
+
+    virtual_device_snapshot_release(snapshot);
+    TEST_EXPECT(test_board_release(&board));
+}
+
+/**
+ * \brief A serialized snapshot restores in full into a matching board, and is
+ * refused by a board with a different device map.
+ */
+TEST(serialize)
+{
+    test_board board;
+    test_board other;
+    virtual_device_snapshot* snapshot;
+    virtual_device_snapshot* loaded;
+
+    TEST_ASSERT(test_board_create(&board));
+    TEST_ASSERT(test_board_create(&other));
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, 0x3FFF, 0x5A));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, VIA_REGISTER_ACR, 0x40));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_save(board.virt, &snapshot));
+
+    /* write the snapshot out and read it back. */
+    FILE* stream = tmpfile();
+    TEST_ASSERT(NULL != stream);
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_snapshot_write(snapshot, stream));
+    rewind(stream);
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_snapshot_read(&loaded, stream));
+    fclose(stream);
+
+    /* another board with the same map takes the whole snapshot. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_restore(other.virt, loaded));
+    TEST_EXPECT(0 == memcmp(board.ram, other.ram, sizeof(board.ram)));
+    TEST_EXPECT(0x40 == VIA_SHADOW(other.via, VIA_REGISTER_ACR));
+
+    /* a board without the VIA does not match. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_detach(
+                    other.virt, VIA_REGISTER_IORB, VIA_REGISTER_IORA2));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_SNAPSHOT_MISMATCH
+            == virtual_device_manager_snapshot_restore(other.virt, loaded));
+
+    virtual_device_snapshot_release(loaded);
+    virtual_device_snapshot_release(snapshot);
+    TEST_EXPECT(test_board_release(&other));
+    TEST_EXPECT(test_board_release(&board));
+}
+
+/**
+ * \brief Count the bytes exchanged over the shift register.
+ */
+static uint8_t test_sr_transfer(void* context, bool, uint8_t)
+{
+    *(int*)context += 1;
+
+    return 0;
+}
+
+/**
+ * \brief Restoring a VIA in the middle of a shift posts its shift register
+ * event again, so that the byte finishes at its original cycle.
+ */
+TEST(restore_shift)
+{
+    test_board board;
+    virtual_device_scheduler* scheduler;
+    virtual_device_snapshot* snapshot;
+    uint64_t cycle = 0;
+    int transfers = 0;
+
+    TEST_ASSERT(test_board_create(&board));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_via_timer_attach(board.via, scheduler));
+    virtual_device_via_sr_attach(board.via, &test_sr_transfer, &transfers);
+
+    /* a byte shifted out under phi2 finishes sixteen cycles later. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, VIA_REGISTER_ACR, VIA_SR_OUT_PHI2));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, VIA_REGISTER_SR, 0xA5));
+
+    cycle = 8;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_save(board.virt, &snapshot));
+
+    cycle = 16;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(1 == transfers);
+    TEST_EXPECT(board.via->ifr & VIA_IFR_SR);
+
+    /* going back puts the shift in flight again. */
+    cycle = 8;
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_restore(board.virt, snapshot));
+    TEST_EXPECT(!(board.via->ifr & VIA_IFR_SR));
+    TEST_EXPECT(16 == scheduler->next_deadline);
+
+    cycle = 16;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(2 == transfers);
+    TEST_EXPECT(board.via->ifr & VIA_IFR_SR);
+
+    virtual_device_snapshot_release(snapshot);
+    TEST_EXPECT(test_board_release(&board));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
+
+/**
+ * \brief Record the last levels published on a VIA port.
+ */
+static void test_pins_notify(
+    void* context, uint8_t, uint8_t levels, uint8_t)
+{
+    *(uint8_t*)context = levels;
+}
+
+/**
+ * \brief Restoring a VIA publishes its restored port levels to subscribers.
+ */
+TEST(restore_pins)
+{
+    test_board board;
+    virtual_device_via_subscription sub;
+    virtual_device_snapshot* snapshot;
+    uint8_t levels = 0;
+
+    TEST_ASSERT(test_board_create(&board));
+    virtual_device_via_subscribe(
+        board.via, &sub, VIA_PORT_B, 0xFF, &test_pins_notify, &levels);
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, VIA_REGISTER_DDRB, 0xFF));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, VIA_REGISTER_IORB, 0x0F));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_save(board.virt, &snapshot));
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, VIA_REGISTER_IORB, 0xF0));
+    TEST_EXPECT(0xF0 == levels);
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_restore(board.virt, snapshot));
+    TEST_EXPECT(0x0F == levels);
+
+    virtual_device_via_unsubscribe(board.via, &sub);
+    virtual_device_snapshot_release(snapshot);
+    TEST_EXPECT(test_board_release(&board));
+}
+
+/**
+ * \brief A device with a value derived from its state block.
+ */
+struct test_device
+{
+    uint8_t state;
+    uint8_t derived;
+    int restores;
+};
+
+/**
+ * \brief Work out the derived value again from the restored state.
+ */
+static status test_device_restore(void* context)
+{
+    test_device* device = (test_device*)context;
+
+    device->derived = device->state * 2;
+    device->restores += 1;
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief After restoring, the manager calls each entry's restore handler, with
+ * the state block already restored.
+ */
+TEST(restore_handler)
+{
+    virtual_device_manager* virt;
+    virtual_device_entry entry;
+    virtual_device_snapshot* snapshot;
+    test_device device = { 7, 14, 0 };
+
+    memset(&entry, 0, sizeof(entry));
+    entry.register_low = 0xF700;
+    entry.register_high = 0xF70F;
+    entry.context = &device;
+    entry.state = &device.state;
+    entry.state_size = sizeof(device.state);
+    entry.restore = &test_device_restore;
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_manager_entry_register(virt, &entry));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_save(virt, &snapshot));
+    TEST_EXPECT(0 == device.restores);
+
+    device.state = 9;
+    device.derived = 18;
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_restore(virt, snapshot));
+    TEST_EXPECT(7 == device.state);
+    TEST_EXPECT(14 == device.derived);
+    TEST_EXPECT(1 == device.restores);
+
+    virtual_device_snapshot_release(snapshot);
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Record the level driven onto the CPU's IRQ input.
+ */
+static void test_line_drive(void* context, bool asserted)
+{
+    *(bool*)context = asserted;
+}
+
+/**
+ * \brief Restoring a VIA with a running timer posts its event again and drives
+ * its IRQ output to match the restored flags.
+ */
+TEST(restore_timer)
+{
+    test_board board;
+    virtual_device_scheduler* scheduler;
+    virtual_device_snapshot* snapshot;
+    uint64_t cycle = 0;
+    bool line = false;
+
+    TEST_ASSERT(test_board_create(&board));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_via_timer_attach(board.via, scheduler));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_via_irq_attach(board.via, &board.virt->irq));
+    virtual_device_irq_connect(&board.virt->irq, &test_line_drive, &line);
+
+    /* a one-shot of 100 cycles, with its interrupt enabled. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, VIA_REGISTER_IER, 0x80 | VIA_IFR_T1));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, VIA_REGISTER_T1C1L, 100));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, VIA_REGISTER_T1C1H, 0));
+
+    cycle = 50;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_save(board.virt, &snapshot));
+
+    /* the timer underflows after the snapshot. */
+    cycle = 101;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_ASSERT(line);
+
+    /* going back releases the line and rearms the timer. */
+    cycle = 50;
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_restore(board.virt, snapshot));
+    TEST_EXPECT(!line);
+    TEST_EXPECT(50 == virtual_device_via_t1_counter(board.via));
+
+    /* the timer underflows again, at its original deadline. */
+    cycle = 100;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(!line);
+    cycle = 101;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(line);
+
+    virtual_device_snapshot_release(snapshot);
+    TEST_EXPECT(test_board_release(&board));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
+
+/**
+ * \brief A stream that is not a complete snapshot is rejected.
+ */
+TEST(fail_format)
+{
+    virtual_device_snapshot* snapshot;
+    const uint16_t byte_order = VIRTUAL_DEVICE_SNAPSHOT_BYTE_ORDER;
+    const uint8_t header[] = {
+        'V', 'D', 'S', 'S', VIRTUAL_DEVICE_SNAPSHOT_VERSION };
+    const uint8_t bytes[] = {
+        /* one entry, cut off in its description. */
+        0x01, 0x00, 0x00, 0x00, 0x00, 0x02,
+    };
+
+    FILE* stream = tmpfile();
+    TEST_ASSERT(NULL != stream);
+    fwrite(header, 1, sizeof(header), stream);
+    fwrite(&byte_order, 1, sizeof(byte_order), stream);
+    fwrite(bytes, 1, sizeof(bytes), stream);
+    rewind(stream);
+
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_SNAPSHOT_FORMAT
+            == virtual_device_snapshot_read(&snapshot, stream));
+
+    fclose(stream);
+}
+
+/**
+ * \brief A snapshot written with the other byte order is rejected, since its
+ * state blocks would be misread.
+ */
+TEST(fail_byte_order)
+{
+    test_board board;
+    virtual_device_snapshot* snapshot;
+    virtual_device_snapshot* loaded;
+    uint8_t order[2];
+
+    TEST_ASSERT(test_board_create(&board));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_save(board.virt, &snapshot));
+
+    FILE* stream = tmpfile();
+    TEST_ASSERT(NULL != stream);
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_snapshot_write(snapshot, stream));
+
+    /* swap the byte order marker. */
+    TEST_ASSERT(0 == fseek(stream, 5, SEEK_SET));
+    TEST_ASSERT(sizeof(order) == fread(order, 1, sizeof(order), stream));
+    TEST_ASSERT(0 == fseek(stream, 5, SEEK_SET));
+    TEST_ASSERT(EOF != fputc(order[1], stream));
+    TEST_ASSERT(EOF != fputc(order[0], stream));
+    rewind(stream);
+
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_SNAPSHOT_FORMAT
+            == virtual_device_snapshot_read(&loaded, stream));
+
+    fclose(stream);
+    virtual_device_snapshot_release(snapshot);
+    TEST_EXPECT(test_board_release(&board));
+}
+
+/**
+ * \brief A snapshot whose state block has another layout version than the
+ * device's is refused, and nothing is restored.
+ */
+TEST(fail_state_version)
+{
+    test_board board;
+    virtual_device_snapshot* snapshot;
+
+    TEST_ASSERT(test_board_create(&board));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_save(board.virt, &snapshot));
+
+    /* find the VIA's saved state, and make it an older layout. */
+    virtual_device_snapshot_entry* saved = NULL;
+    for (size_t i = 0; i < snapshot->device_entries; ++i)
+    {
+        if (VIA_REGISTER_IORB == snapshot->entries[i].register_low)
+        {
+            saved = snapshot->entries + i;
+        }
+    }
+    TEST_ASSERT(NULL != saved);
+    TEST_EXPECT(VIRTUAL_DEVICE_VIA_STATE_VERSION == saved->state_version);
+    saved->state_version -= 1;
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    board.virt, 0x0000, 0x5A));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_SNAPSHOT_MISMATCH
+            == virtual_device_manager_snapshot_restore(board.virt, snapshot));
+    TEST_EXPECT(0x5A == board.ram[0]);
+
+    virtual_device_snapshot_release(snapshot);
+    TEST_EXPECT(test_board_release(&board));
+}
+
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
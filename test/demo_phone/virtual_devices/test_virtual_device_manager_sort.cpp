@@ -1,5 +1,8 @@
 #include <minunit/minunit.h>
+#include <stdlib.h>
+#include <string.h>
 
+#include "../../../src/demo_phone/virtual_devices/merge_sort.h"
 #include "../../../src/demo_phone/virtual_devices/status.h"
 #include "../../../src/demo_phone/virtual_devices/virtual_device.h"
 
@@ -7,6 +10,119 @@ JEMU_IMPORT_jemu65c02;
 
 TEST_SUITE(virtual_device_manager_sort);
 
+/**
+ * \brief The original recursive merge sort, kept as a reference for the
+ * bottom-up sort.
+ */
+static status reference_merge_sort(
+    virtual_device_entry* array, virtual_device_entry* scratch, size_t entries)
+{
+    status retval;
+
+    /* if this array is trivially sorted, then just return. */
+    if (entries <= 1)
+    {
+        return STATUS_SUCCESS;
+    }
+
+    /* compute the left-hand and right-hand array sizes. */
+    size_t lhs_size = entries / 2;
+    size_t rhs_size = entries - lhs_size;
+
+    /* compute the left and right arrays. */
+    virtual_device_entry* left_array = array;
+    virtual_device_entry* right_array = array + lhs_size;
+
+    /* recursively sort the left-hand side array. */
+    retval = reference_merge_sort(left_array, scratch, lhs_size);
+    if (STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* recursively sort the right-hand side array. */
+    retval = reference_merge_sort(right_array, scratch + lhs_size, rhs_size);
+    if (STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* merge the two sorted arrays into the scratch array. */
+    size_t lhs_idx = 0, rhs_idx = 0, out_idx = 0;
+    while (lhs_idx < lhs_size && rhs_idx < rhs_size)
+    {
+        virtual_device_entry* lhs_ent = left_array + lhs_idx;
+        virtual_device_entry* rhs_ent = right_array + rhs_idx;
+
+        /* compare the two entries. */
+        int cmp =
+            register_range_compare(
+                lhs_ent->register_low, lhs_ent->register_high,
+                rhs_ent->register_low, rhs_ent->register_high);
+        if (COMPARE_RESULT_LESSER == cmp)
+        {
+            memcpy(scratch + out_idx, lhs_ent, sizeof(*lhs_ent));
+            ++lhs_idx;
+        }
+        else if (COMPARE_RESULT_GREATER == cmp)
+        {
+            memcpy(scratch + out_idx, rhs_ent, sizeof(*rhs_ent));
+            ++rhs_idx;
+        }
+        else
+        {
+            /* the two register ranges overlap. */
+            return VIRTUAL_DEVICE_ERROR_OVERLAP;
+        }
+
+        /* increment the output index. */
+        ++out_idx;
+    }
+
+    /* copy any remaining entries from the left array. */
+    if (lhs_idx < lhs_size)
+    {
+        size_t remaining = lhs_size - lhs_idx;
+        memcpy(
+            scratch + out_idx, left_array + lhs_idx,
+            remaining * sizeof(virtual_device_entry));
+        out_idx += remaining;
+    }
+
+    /* copy any remaining entries from the right array. */
+    if (rhs_idx < rhs_size)
+    {
+        size_t remaining = rhs_size - rhs_idx;
+        memcpy(
+            scratch + out_idx, right_array + rhs_idx,
+            remaining * sizeof(virtual_device_entry));
+        out_idx += remaining;
+    }
+
+    /* copy the sorted scratch array over top of the array. */
+    memcpy(array, scratch, entries * sizeof(virtual_device_entry));
+
+    /* success. */
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief Overlap callback that counts the overlaps reported.
+ */
+static void count_overlap(
+    void* context, const virtual_device_entry* lhs,
+    const virtual_device_entry* rhs)
+{
+    size_t* count = (size_t*)context;
+
+    /* the reported entries really do overlap. */
+    if (lhs->register_low <= rhs->register_low
+     && rhs->register_low <= lhs->register_high)
+    {
+        *count += 1;
+    }
+}
+
 /**
  * \brief Sort fails when the exact device is added twice.
  */
@@ -292,3 +408,177 @@ TEST(succeed_reverse_sort)
     /* release the manager. */
     TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
 }
+
+/**
+ * \brief Every overlapping entry is reported, not just the first.
+ */
+TEST(report_every_overlap)
+{
+    virtual_device_manager* virt;
+    size_t overlaps = 0;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* A encloses B and C, D duplicates E, and F stands alone. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0x0500, 0x05FF, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0x0120, 0x012F, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0x0100, 0x01FF, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0x0400, 0x040F, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0x0180, 0x018F, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0x0400, 0x040F, NULL));
+
+    /* Sort should fail, reporting three overlaps. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_OVERLAP
+            == virtual_device_manager_sort_with_overlaps(
+                    virt, &count_overlap, &overlaps));
+    TEST_EXPECT(3 == overlaps);
+    TEST_EXPECT(!virt->sorted);
+
+    /* the entries are still ordered by low register. */
+    for (size_t i = 1; i < virt->device_entries; ++i)
+    {
+        TEST_EXPECT(
+            virt->devices[i - 1].register_low
+                <= virt->devices[i].register_low);
+        TEST_EXPECT(virt->devices[i].register_low == virt->register_lows[i]);
+    }
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief Overlapping entries nested inside another entry are reported as a
+ * pair too, not only against the entry enclosing them.
+ */
+TEST(report_nested_overlap)
+{
+    virtual_device_manager* virt;
+    size_t overlaps = 0;
+
+    /* create the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* A encloses B and C, and C is inside B. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0x0100, 0x01FF, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0x0120, 0x012F, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0x0128, 0x012F, NULL));
+
+    /* Sort should fail, reporting A-B, A-C, and B-C. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_OVERLAP
+            == virtual_device_manager_sort_with_overlaps(
+                    virt, &count_overlap, &overlaps));
+    TEST_EXPECT(3 == overlaps);
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief The bottom-up sort produces the same ordering and the same result as
+ * the original recursive merge sort.
+ */
+TEST(matches_reference)
+{
+    virtual_device_entry reference[64], scratch[64];
+
+    srand(0x65C02);
+
+    for (int round = 0; round < 500; ++round)
+    {
+        virtual_device_manager* virt;
+        size_t count = (size_t)(rand() % 64);
+        bool allow_overlap = 0 == round % 4;
+
+        /* create the manager. */
+        TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+        /* create random entries, mostly in distinct slots. */
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint16_t low =
+                allow_overlap
+                    ? (uint16_t)(rand() % 0x1000)
+                    : (uint16_t)((i * 0x400) + rand() % 0x200);
+            uint16_t high = (uint16_t)(low + rand() % 0x100);
+
+            reference[i].register_low = low;
+            reference[i].register_high = high;
+            reference[i].context = (void*)(uintptr_t)(i + 1);
+            reference[i].read = NULL;
+            reference[i].write = NULL;
+        }
+
+        /* shuffle the entries. */
+        for (size_t i = count; i > 1; --i)
+        {
+            size_t j = (size_t)rand() % i;
+            virtual_device_entry tmp = reference[i - 1];
+            reference[i - 1] = reference[j];
+            reference[j] = tmp;
+        }
+
+        /* register the shuffled entries. */
+        for (size_t i = 0; i < count; ++i)
+        {
+            TEST_ASSERT(
+                STATUS_SUCCESS
+                    == virtual_device_manager_device_register(
+                            virt, NULL, NULL, reference[i].register_low,
+                            reference[i].register_high, reference[i].context));
+        }
+
+        /* both sorts agree on the result. */
+        status expected = reference_merge_sort(reference, scratch, count);
+        TEST_EXPECT(expected == virtual_device_manager_sort(virt));
+
+        /* on success, both sorts agree on the ordering. */
+        if (STATUS_SUCCESS == expected)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                TEST_EXPECT(
+                    reference[i].register_low
+                        == virt->devices[i].register_low);
+                TEST_EXPECT(
+                    reference[i].register_high
+                        == virt->devices[i].register_high);
+                TEST_EXPECT(
+                    reference[i].context == virt->devices[i].context);
+            }
+        }
+
+        /* release the manager. */
+        TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+    }
+}
@@ -0,0 +1,260 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/stats.h"
+#include "../../../src/demo_phone/virtual_devices/status.h"
+
+#if defined(VIRTUAL_DEVICE_STATS)
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_manager_stats_enable);
+
+/**
+ * \brief A test device that returns the low byte of the address it is read at.
+ */
+static status test_read(void*, uint16_t addr, uint8_t* byte)
+{
+    *byte = (uint8_t)(addr & 0xFF);
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief A test device that accepts every write.
+ */
+static status test_write(void*, uint16_t, uint8_t)
+{
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief Return the number of samples in a latency histogram.
+ */
+static uint64_t test_samples(const uint64_t* buckets)
+{
+    uint64_t samples = 0;
+
+    for (size_t i = 0; i < VIRTUAL_DEVICE_STATS_BUCKETS; ++i)
+    {
+        samples += buckets[i];
+    }
+
+    return samples;
+}
+
+/**
+ * \brief Durations land in their log2 bucket, clamped to the histogram.
+ */
+TEST(bucket)
+{
+    TEST_EXPECT(0 == virtual_device_stats_bucket(0));
+    TEST_EXPECT(0 == virtual_device_stats_bucket(1));
+    TEST_EXPECT(1 == virtual_device_stats_bucket(2));
+    TEST_EXPECT(1 == virtual_device_stats_bucket(3));
+    TEST_EXPECT(10 == virtual_device_stats_bucket(1024));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_STATS_BUCKETS - 1
+            == virtual_device_stats_bucket(UINT64_MAX));
+}
+
+/**
+ * \brief Nothing is counted until statistics are enabled; then every entry,
+ * existing or new, is counted per device and per register.
+ */
+TEST(count)
+{
+    virtual_device_manager* virt;
+    uint8_t buffer[4];
+    uint8_t byte = 0;
+
+    /* create the manager with one device. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, &test_read, &test_write, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_sort(virt));
+
+    /* not counted yet. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0xF600, &byte));
+    TEST_EXPECT(NULL == virtual_device_manager_stats_find(virt, 0xF600));
+
+    /* enable statistics, then attach a second device. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_stats_enable(virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_attach(
+                    virt, &test_read, &test_write, 0xF620, 0xF623, NULL));
+
+    /* spin on one register, as a busy-poll loop would. */
+    for (int i = 0; i < 2 * VIRTUAL_DEVICE_STATS_SAMPLE_PERIOD; ++i)
+    {
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_manager_emu_read_callback(
+                        virt, 0xF60D, &byte));
+    }
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(virt, 0xF60E, 0x7F));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_block_read(
+                    virt, 0xF620, buffer, sizeof(buffer)));
+
+    /* the first device. */
+    const virtual_device_stats* stats =
+        virtual_device_manager_stats_find(virt, 0xF600);
+    TEST_ASSERT(NULL != stats);
+    TEST_EXPECT(16 == stats->registers);
+    TEST_EXPECT(2 * VIRTUAL_DEVICE_STATS_SAMPLE_PERIOD == stats->reads);
+    TEST_EXPECT(1 == stats->writes);
+    TEST_EXPECT(
+        2 * VIRTUAL_DEVICE_STATS_SAMPLE_PERIOD == stats->register_reads[0x0D]);
+    TEST_EXPECT(1 == stats->register_writes[0x0E]);
+    TEST_EXPECT(0 == stats->register_reads[0x00]);
+    TEST_EXPECT(2 == test_samples(stats->read_latency));
+
+    /* the second device. */
+    stats = virtual_device_manager_stats_find(virt, 0xF623);
+    TEST_ASSERT(NULL != stats);
+    TEST_EXPECT(4 == stats->reads);
+    TEST_EXPECT(1 == stats->register_reads[3]);
+
+    /* reset clears every counter. */
+    virtual_device_manager_stats_reset(virt);
+    stats = virtual_device_manager_stats_find(virt, 0xF600);
+    TEST_EXPECT(0 == stats->reads);
+    TEST_EXPECT(0 == stats->register_reads[0x0D]);
+    TEST_EXPECT(0 == test_samples(stats->read_latency));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief A partially decoded device is counted per register of its first
+ * copy.
+ */
+TEST(decoded)
+{
+    virtual_device_manager* virt;
+    virtual_device_entry entry;
+    uint8_t byte = 0;
+
+    /* create the manager with counting enabled. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_stats_enable(virt));
+
+    /* four registers, mirrored four times. */
+    memset(&entry, 0, sizeof(entry));
+    entry.register_low = 0xD000;
+    entry.register_high = 0xD003;
+    entry.read = &test_read;
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_decoded_register(
+                    virt, &entry, 0x03, 4));
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0xD001, &byte));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0xD00D, &byte));
+
+    const virtual_device_stats* stats =
+        virtual_device_manager_stats_find(virt, 0xD000);
+    TEST_ASSERT(NULL != stats);
+    TEST_EXPECT(4 == stats->registers);
+    TEST_EXPECT(2 == stats->register_reads[1]);
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief The dump lists each counted device and the registers it used.
+ */
+TEST(dump)
+{
+    virtual_device_manager* virt;
+    char report[512];
+    uint8_t byte = 0;
+
+    /* create the manager with one counted device. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_stats_enable(virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, &test_read, &test_write, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0xF60D, &byte));
+
+    /* write the report. */
+    FILE* out = tmpfile();
+    TEST_ASSERT(NULL != out);
+    virtual_device_manager_stats_dump(virt, out);
+    rewind(out);
+    size_t size = fread(report, 1, sizeof(report) - 1, out);
+    report[size] = 0;
+    fclose(out);
+
+    TEST_EXPECT(NULL != strstr(report, "device F600-F60F: 1 reads, 0 writes"));
+    TEST_EXPECT(NULL != strstr(report, "  F60D: 1 reads, 0 writes"));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief The per-register counters and histograms do not wrap at 32 bits.
+ */
+TEST(wide_counters)
+{
+    virtual_device_manager* virt;
+    char report[512];
+    uint8_t byte = 0;
+
+    /* create the manager with one counted device. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_stats_enable(virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, &test_read, &test_write, 0xF600, 0xF60F, NULL));
+    virtual_device_stats* stats =
+        (virtual_device_stats*)virtual_device_manager_stats_find(virt, 0xF600);
+    TEST_ASSERT(NULL != stats);
+
+    /* bring a register and a bucket to the 32-bit limit. */
+    stats->register_reads[0x0D] = UINT32_MAX;
+    stats->read_latency[0] = UINT32_MAX;
+    stats->sample_countdown = 1;
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0xF60D, &byte));
+    TEST_EXPECT(UINT64_C(0x100000000) == stats->register_reads[0x0D]);
+    TEST_EXPECT(UINT64_C(0x100000000) == test_samples(stats->read_latency));
+
+    /* the dump prints the full count. */
+    FILE* out = tmpfile();
+    TEST_ASSERT(NULL != out);
+    virtual_device_manager_stats_dump(virt, out);
+    rewind(out);
+    size_t size = fread(report, 1, sizeof(report) - 1, out);
+    report[size] = 0;
+    fclose(out);
+
+    TEST_EXPECT(NULL != strstr(report, "  F60D: 4294967296 reads, 0 writes"));
+
+    /* release the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+#endif /*defined(VIRTUAL_DEVICE_STATS)*/
@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <minunit/minunit.h>
+#include <random>
+#include <vector>
+
+#include "../../../src/demo_phone/virtual_devices/scheduler.h"
+#include "../../../src/demo_phone/virtual_devices/status.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_scheduler_run);
+
+/**
+ * \brief A test device with one event, recording when it fires.
+ */
+struct test_device
+{
+    virtual_device_event event;
+    virtual_device_scheduler* scheduler;
+    std::vector<uint64_t>* log;
+    uint64_t period;
+    int id;
+};
+
+/**
+ * \brief Log the event, and post it again if the device is periodic.
+ */
+static status test_fire(void* context, uint64_t deadline)
+{
+    test_device* dev = (test_device*)context;
+
+    dev->log->push_back(deadline * 16 + dev->id);
+
+    if (dev->period > 0)
+    {
+        return
+            virtual_device_scheduler_post(
+                dev->scheduler, &dev->event, deadline + dev->period);
+    }
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief Set up a test device.
+ */
+static void test_device_init(
+    test_device* dev, virtual_device_scheduler* scheduler,
+    std::vector<uint64_t>* log, int id, uint64_t period)
+{
+    virtual_device_event_init(&dev->event, &test_fire, dev);
+    dev->scheduler = scheduler;
+    dev->log = log;
+    dev->period = period;
+    dev->id = id;
+}
+
+/**
+ * \brief Events fire in deadline order, and only once their cycle is reached.
+ */
+TEST(deadline_order)
+{
+    virtual_device_scheduler* scheduler;
+    std::vector<uint64_t> log;
+    test_device dev[3];
+    uint64_t cycle = 0;
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_SCHEDULER_NEVER == scheduler->next_deadline);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        test_device_init(&dev[i], scheduler, &log, i, 0);
+    }
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_post(scheduler, &dev[0].event, 300));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_post(scheduler, &dev[1].event, 100));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_post(scheduler, &dev[2].event, 200));
+    TEST_EXPECT(100 == scheduler->next_deadline);
+
+    /* nothing is due yet. */
+    cycle = 99;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(log.empty());
+
+    /* an overshoot fires every event that is due, earliest first. */
+    cycle = 250;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_ASSERT(2 == log.size());
+    TEST_EXPECT(100 * 16 + 1 == log[0]);
+    TEST_EXPECT(200 * 16 + 2 == log[1]);
+    TEST_EXPECT(300 == scheduler->next_deadline);
+    TEST_EXPECT(VIRTUAL_DEVICE_EVENT_IDLE == dev[1].event.index);
+
+    cycle = 300;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_ASSERT(3 == log.size());
+    TEST_EXPECT(300 * 16 + 0 == log[2]);
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_SCHEDULER_NEVER == scheduler->next_deadline);
+
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
+
+/**
+ * \brief A handler that posts its event again makes it periodic, and a late
+ * run catches up on every missed period.
+ */
+TEST(periodic)
+{
+    virtual_device_scheduler* scheduler;
+    std::vector<uint64_t> log;
+    test_device dev;
+    uint64_t cycle = 0;
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 1, &cycle));
+    test_device_init(&dev, scheduler, &log, 0, 10);
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_post(scheduler, &dev.event, 10));
+
+    cycle = 35;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_ASSERT(3 == log.size());
+    TEST_EXPECT(10 * 16 == log[0]);
+    TEST_EXPECT(20 * 16 == log[1]);
+    TEST_EXPECT(30 * 16 == log[2]);
+    TEST_EXPECT(40 == scheduler->next_deadline);
+
+    /* releasing the scheduler leaves the event idle. */
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+    TEST_EXPECT(VIRTUAL_DEVICE_EVENT_IDLE == dev.event.index);
+}
+
+/**
+ * \brief Events can be cancelled and moved, and a full scheduler refuses new
+ * events but still moves pending ones.
+ */
+TEST(cancel_and_full)
+{
+    virtual_device_scheduler* scheduler;
+    std::vector<uint64_t> log;
+    test_device dev[3];
+    uint64_t cycle = 0;
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 2, &cycle));
+
+    for (int i = 0; i < 3; ++i)
+    {
+        test_device_init(&dev[i], scheduler, &log, i, 0);
+    }
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_post(scheduler, &dev[0].event, 50));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_post(scheduler, &dev[1].event, 60));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_SCHEDULER_FULL
+            == virtual_device_scheduler_post(scheduler, &dev[2].event, 70));
+    TEST_EXPECT(VIRTUAL_DEVICE_EVENT_IDLE == dev[2].event.index);
+
+    /* moving a pending event does not need room. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_post(scheduler, &dev[0].event, 80));
+    TEST_EXPECT(60 == scheduler->next_deadline);
+
+    /* cancelling is idempotent. */
+    virtual_device_scheduler_cancel(scheduler, &dev[1].event);
+    virtual_device_scheduler_cancel(scheduler, &dev[1].event);
+    TEST_EXPECT(80 == scheduler->next_deadline);
+    TEST_EXPECT(1 == scheduler->count);
+
+    cycle = 100;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_ASSERT(1 == log.size());
+    TEST_EXPECT(80 * 16 + 0 == log[0]);
+
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
+
+/**
+ * \brief Random posts, moves, and cancels fire in the same order as a sorted
+ * reference.
+ */
+TEST(random_against_reference)
+{
+    virtual_device_scheduler* scheduler;
+    std::vector<uint64_t> log;
+    std::vector<uint64_t> expected;
+    test_device dev[16];
+    uint64_t deadline[16];
+    std::mt19937 rng(6502);
+    uint64_t cycle = 0;
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 16, &cycle));
+
+    for (int i = 0; i < 16; ++i)
+    {
+        test_device_init(&dev[i], scheduler, &log, i, 0);
+        deadline[i] = VIRTUAL_DEVICE_SCHEDULER_NEVER;
+    }
+
+    for (int step = 0; step < 2000; ++step)
+    {
+        int i = rng() % 16;
+
+        /* the reference keeps the cycle and the device id together. */
+        if (rng() % 4)
+        {
+            deadline[i] = (cycle + 1 + rng() % 1000) * 16 + i;
+            TEST_ASSERT(
+                STATUS_SUCCESS
+                    == virtual_device_scheduler_post(
+                            scheduler, &dev[i].event, deadline[i] / 16));
+        }
+        else
+        {
+            virtual_device_scheduler_cancel(scheduler, &dev[i].event);
+            deadline[i] = VIRTUAL_DEVICE_SCHEDULER_NEVER;
+        }
+
+        /* run forward, and fire the reference's due events in order. */
+        cycle += rng() % 50;
+        for (;;)
+        {
+            uint64_t* next = std::min_element(deadline, deadline + 16);
+            if (*next == VIRTUAL_DEVICE_SCHEDULER_NEVER
+             || *next / 16 > cycle)
+            {
+                break;
+            }
+
+            expected.push_back(*next);
+            *next = VIRTUAL_DEVICE_SCHEDULER_NEVER;
+        }
+
+        TEST_ASSERT(
+            STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    }
+
+    /* the same events fire at the same cycles; ties may fire in any order. */
+    TEST_ASSERT(expected.size() == log.size());
+    std::vector<uint64_t> sorted_log = log;
+    for (size_t i = 0; i < log.size(); ++i)
+    {
+        TEST_EXPECT(log[i] / 16 == expected[i] / 16);
+    }
+    std::sort(sorted_log.begin(), sorted_log.end());
+    std::vector<uint64_t> sorted_expected = expected;
+    std::sort(sorted_expected.begin(), sorted_expected.end());
+    TEST_EXPECT(sorted_log == sorted_expected);
+
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
@@ -0,0 +1,238 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/trace.h"
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_trace_create);
+
+/**
+ * \brief A test device that returns the low byte of the address it is read at.
+ */
+static status test_read(void*, uint16_t addr, uint8_t* byte)
+{
+    *byte = (uint8_t)(addr & 0xFF);
+
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief A test device that accepts every write.
+ */
+static status test_write(void*, uint16_t, uint8_t)
+{
+    return STATUS_SUCCESS;
+}
+
+/**
+ * \brief The ring capacity must be a power of two.
+ */
+TEST(fail_capacity)
+{
+    virtual_device_trace* trace;
+    FILE* out = tmpfile();
+    TEST_ASSERT(NULL != out);
+
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_INVALID_TRACE
+            == virtual_device_trace_create(&trace, out, 0, NULL));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_INVALID_TRACE
+            == virtual_device_trace_create(&trace, out, 100, NULL));
+
+    fclose(out);
+}
+
+/**
+ * \brief Accesses through the manager are traced with their cycle, device, and
+ * value, and read back in order by the reader.
+ */
+TEST(round_trip)
+{
+    virtual_device_manager* virt;
+    virtual_device_trace* trace;
+    virtual_device_trace_reader reader;
+    virtual_device_trace_event event;
+    uint64_t cycle = 1000;
+    uint8_t byte = 0;
+    uint8_t buffer[2] = { 0xAA, 0xBB };
+
+    FILE* out = tmpfile();
+    TEST_ASSERT(NULL != out);
+
+    /* create the manager with two devices, and trace it. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, &test_read, &test_write, 0xF600, 0xF60F, NULL));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_device_register(
+                    virt, &test_read, &test_write, 0xF620, 0xF623, NULL));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_sort(virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_trace_create(&trace, out, 1024, &cycle));
+    virtual_device_manager_trace_attach(virt, trace);
+
+    /* a write, a read, and a block write. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(virt, 0xF602, 0x0F));
+    cycle += 4;
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(virt, 0xF621, &byte));
+    cycle += 6;
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_block_write(
+                    virt, 0xF60E, buffer, sizeof(buffer)));
+
+    /* unmapped accesses are not traced. */
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_UNMAPPED
+            == virtual_device_manager_emu_read_callback(virt, 0x0000, &byte));
+
+    /* stop tracing and write the trace out. */
+    virtual_device_manager_trace_attach(virt, NULL);
+    TEST_EXPECT(0 == virtual_device_trace_dropped(trace));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_trace_release(trace));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+
+    /* read it back. */
+    rewind(out);
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_trace_reader_init(&reader, out));
+
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_trace_reader_next(&reader, &event));
+    TEST_EXPECT(1000 == event.cycle);
+    TEST_EXPECT(0xF602 == event.address);
+    TEST_EXPECT(0xF600 == event.device);
+    TEST_EXPECT(0x0F == event.value);
+    TEST_EXPECT(event.write);
+
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_trace_reader_next(&reader, &event));
+    TEST_EXPECT(1004 == event.cycle);
+    TEST_EXPECT(0xF621 == event.address);
+    TEST_EXPECT(0xF620 == event.device);
+    TEST_EXPECT(0x21 == event.value);
+    TEST_EXPECT(!event.write);
+
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_trace_reader_next(&reader, &event));
+    TEST_EXPECT(1010 == event.cycle);
+    TEST_EXPECT(0xF60E == event.address);
+    TEST_EXPECT(0xAA == event.value);
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_trace_reader_next(&reader, &event));
+    TEST_EXPECT(1010 == event.cycle);
+    TEST_EXPECT(0xF60F == event.address);
+    TEST_EXPECT(0xBB == event.value);
+    TEST_EXPECT(event.write);
+
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_TRACE_END
+            == virtual_device_trace_reader_next(&reader, &event));
+    TEST_EXPECT(0 == reader.dropped);
+
+    fclose(out);
+}
+
+/**
+ * \brief A busy-poll loop compresses to a single run record.
+ */
+TEST(busy_poll)
+{
+    virtual_device_trace* trace;
+    virtual_device_trace_reader reader;
+    virtual_device_trace_event event;
+    uint64_t cycle = 0;
+    const int polls = 10000;
+
+    FILE* out = tmpfile();
+    TEST_ASSERT(NULL != out);
+
+    /* poll the same register every seven cycles, with room for every poll. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_trace_create(&trace, out, 16384, &cycle));
+    for (int i = 0; i < polls; ++i)
+    {
+        cycle += 7;
+        virtual_device_trace_record(trace, 0xF60D, 0x80, false, 0xF600);
+    }
+    TEST_EXPECT(0 == virtual_device_trace_dropped(trace));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_trace_release(trace));
+
+    /* the header and one run record. */
+    TEST_EXPECT(ftell(out) < 32);
+
+    /* every poll reads back. */
+    rewind(out);
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_trace_reader_init(&reader, out));
+    int events = 0;
+    while (STATUS_SUCCESS
+                == virtual_device_trace_reader_next(&reader, &event))
+    {
+        events += 1;
+        TEST_EXPECT((uint64_t)events * 7 == event.cycle);
+        TEST_EXPECT(0xF60D == event.address);
+        TEST_EXPECT(0x80 == event.value);
+    }
+    TEST_EXPECT(polls == events);
+
+    fclose(out);
+}
+
+/**
+ * \brief When the ring is full, events are dropped rather than blocking, and
+ * every drop is counted in the trace.
+ */
+TEST(dropped)
+{
+    virtual_device_trace* trace;
+    virtual_device_trace_reader reader;
+    virtual_device_trace_event event;
+    const uint64_t records = 1000;
+
+    FILE* out = tmpfile();
+    TEST_ASSERT(NULL != out);
+
+    /* a tiny ring, numbering events instead of counting cycles. */
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_trace_create(&trace, out, 2, NULL));
+    for (uint64_t i = 0; i < records; ++i)
+    {
+        virtual_device_trace_record(
+            trace, (uint16_t)i, (uint8_t)i, true, 0x0000);
+    }
+    uint64_t dropped = virtual_device_trace_dropped(trace);
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_trace_release(trace));
+
+    /* each event is either in the trace or counted as dropped. */
+    rewind(out);
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_trace_reader_init(&reader, out));
+    uint64_t events = 0;
+    while (STATUS_SUCCESS
+                == virtual_device_trace_reader_next(&reader, &event))
+    {
+        TEST_EXPECT((uint8_t)event.address == event.value);
+        events += 1;
+    }
+    TEST_EXPECT(dropped == reader.dropped);
+    TEST_EXPECT(records == events + reader.dropped);
+
+    fclose(out);
+}
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
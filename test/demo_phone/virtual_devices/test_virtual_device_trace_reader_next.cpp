@@ -0,0 +1,123 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/trace.h"
+
+#if defined(VIRTUAL_DEVICE_TRACE)
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_trace_reader_next);
+
+/**
+ * \brief Return a stream holding the given bytes.
+ */
+static FILE* test_stream(const uint8_t* bytes, size_t size)
+{
+    FILE* stream = tmpfile();
+
+    if (NULL != stream)
+    {
+        fwrite(bytes, 1, size, stream);
+        rewind(stream);
+    }
+
+    return stream;
+}
+
+/**
+ * \brief A stream without the trace header is rejected.
+ */
+TEST(fail_header)
+{
+    virtual_device_trace_reader reader;
+    const uint8_t bytes[] = { 'V', 'D', 'T', 'R', 0x7F };
+
+    FILE* in = test_stream(bytes, sizeof(bytes));
+    TEST_ASSERT(NULL != in);
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_TRACE_FORMAT
+            == virtual_device_trace_reader_init(&reader, in));
+
+    fclose(in);
+}
+
+/**
+ * \brief Records decode against the previous event, runs repeat, and dropped
+ * counts accumulate.
+ */
+TEST(decode)
+{
+    virtual_device_trace_reader reader;
+    virtual_device_trace_event event;
+    const uint8_t bytes[] = {
+        'V', 'D', 'T', 'R', VIRTUAL_DEVICE_TRACE_VERSION,
+        /* a write at cycle 5 to 0x0002, device 0x0100, value 0x42. */
+        VIRTUAL_DEVICE_TRACE_TAG_WRITE, 0x05, 0x04, 0x80, 0x02, 0x42,
+        /* three dropped events. */
+        VIRTUAL_DEVICE_TRACE_TAG_DROPPED, 0x03,
+        /* two reads of 0x0001, ten cycles apart, with the same value. */
+        VIRTUAL_DEVICE_TRACE_TAG_RUN | VIRTUAL_DEVICE_TRACE_TAG_SAME_DEVICE
+            | VIRTUAL_DEVICE_TRACE_TAG_SAME_VALUE,
+        0x01, 0x0A, 0x01,
+    };
+
+    FILE* in = test_stream(bytes, sizeof(bytes));
+    TEST_ASSERT(NULL != in);
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_trace_reader_init(&reader, in));
+
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_trace_reader_next(&reader, &event));
+    TEST_EXPECT(5 == event.cycle);
+    TEST_EXPECT(0x0002 == event.address);
+    TEST_EXPECT(0x0100 == event.device);
+    TEST_EXPECT(0x42 == event.value);
+    TEST_EXPECT(event.write);
+
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_trace_reader_next(&reader, &event));
+    TEST_EXPECT(15 == event.cycle);
+    TEST_EXPECT(0x0001 == event.address);
+    TEST_EXPECT(0x0100 == event.device);
+    TEST_EXPECT(0x42 == event.value);
+    TEST_EXPECT(!event.write);
+    TEST_EXPECT(3 == reader.dropped);
+
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_trace_reader_next(&reader, &event));
+    TEST_EXPECT(25 == event.cycle);
+    TEST_EXPECT(0x0001 == event.address);
+
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_TRACE_END
+            == virtual_device_trace_reader_next(&reader, &event));
+
+    fclose(in);
+}
+
+/**
+ * \brief A truncated record is reported as corrupt.
+ */
+TEST(fail_truncated)
+{
+    virtual_device_trace_reader reader;
+    virtual_device_trace_event event;
+    const uint8_t bytes[] = {
+        'V', 'D', 'T', 'R', VIRTUAL_DEVICE_TRACE_VERSION,
+        VIRTUAL_DEVICE_TRACE_TAG_WRITE, 0x85,
+    };
+
+    FILE* in = test_stream(bytes, sizeof(bytes));
+    TEST_ASSERT(NULL != in);
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_trace_reader_init(&reader, in));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_TRACE_FORMAT
+            == virtual_device_trace_reader_next(&reader, &event));
+
+    fclose(in);
+}
+
+#endif /*defined(VIRTUAL_DEVICE_TRACE)*/
@@ -0,0 +1,265 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/scheduler.h"
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/uart.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+#include "test_device_bus.h"
+
+#include <cstring>
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_uart_receive);
+
+/**
+ * \brief Record the level driven onto the CPU's IRQ input.
+ */
+static void test_line_drive(void* context, bool asserted)
+{
+    *(bool*)context = asserted;
+}
+
+/**
+ * \brief In instant mode, received characters can be read at once, and
+ * interrupt while receive interrupts are enabled.
+ */
+TEST(instant)
+{
+    virtual_device_uart* uart;
+    virtual_device_manager* bus;
+    virtual_device_irq irq;
+    bool asserted = false;
+    const uint8_t response[] = { 'O', 'K' };
+
+    memset(&irq, 0, sizeof(irq));
+    virtual_device_irq_connect(&irq, &test_line_drive, &asserted);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_create(&uart, 4, 4));
+    TEST_ASSERT(test_bus_create(&bus, uart));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_irq_attach(uart, &irq));
+
+    /* 9600 N 8 1, with the receiver on and receive interrupts enabled. */
+    TEST_ASSERT(
+        test_write(
+            bus, UART_REGISTER_CONTROL,
+            UART_CONTROL_BAUD_9600 | UART_CONTROL_RCS));
+    TEST_ASSERT(test_write(bus, UART_REGISTER_COMMAND, UART_COMMAND_DTR));
+    TEST_EXPECT(!asserted);
+    TEST_EXPECT(
+        UART_STATUS_TDRE == test_read(bus, UART_REGISTER_STATUS));
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_uart_receive(uart, response, sizeof(response)));
+    TEST_EXPECT(asserted);
+    TEST_EXPECT(
+        (UART_STATUS_RDRF | UART_STATUS_TDRE | UART_STATUS_IRQ)
+            == test_read(bus, UART_REGISTER_STATUS));
+
+    TEST_EXPECT('O' == test_read(bus, UART_REGISTER_DATA));
+    TEST_EXPECT(asserted);
+    TEST_EXPECT('K' == test_read(bus, UART_REGISTER_DATA));
+    TEST_EXPECT(!asserted);
+    TEST_EXPECT(
+        0 == (UART_STATUS_RDRF & test_read(bus, UART_REGISTER_STATUS)));
+
+    /* an empty FIFO reads the last character again. */
+    TEST_EXPECT('K' == test_read(bus, UART_REGISTER_DATA));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_release(uart));
+    TEST_EXPECT(0 == irq.sources);
+}
+
+/**
+ * \brief A full receive FIFO loses characters, and sets the overrun flag until
+ * the next character is read.
+ */
+TEST(overrun)
+{
+    virtual_device_uart* uart;
+    virtual_device_manager* bus;
+    const uint8_t response[] = { 'O', 'K', '\r' };
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_create(&uart, 2, 1));
+    TEST_ASSERT(test_bus_create(&bus, uart));
+
+    /* with DTR off, the receiver is disabled. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_uart_receive(uart, response, sizeof(response)));
+    TEST_EXPECT(
+        0 == (UART_STATUS_RDRF & test_read(bus, UART_REGISTER_STATUS)));
+    TEST_EXPECT(2 == virtual_device_uart_rx_space(uart));
+
+    TEST_ASSERT(test_write(bus, UART_REGISTER_COMMAND, UART_COMMAND_DTR));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_uart_receive(uart, response, sizeof(response)));
+    TEST_EXPECT(0 == virtual_device_uart_rx_space(uart));
+    TEST_EXPECT(UART_STATUS_OVERRUN & test_read(bus, UART_REGISTER_STATUS));
+
+    TEST_EXPECT('O' == test_read(bus, UART_REGISTER_DATA));
+    TEST_EXPECT(
+        0 == (UART_STATUS_OVERRUN & test_read(bus, UART_REGISTER_STATUS)));
+    TEST_EXPECT('K' == test_read(bus, UART_REGISTER_DATA));
+
+    /* a programmed reset clears the flag, and the low command bits. */
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_uart_receive(uart, response, 3));
+    TEST_ASSERT(test_write(bus, UART_REGISTER_STATUS, 0));
+    TEST_EXPECT(
+        0 == (UART_STATUS_OVERRUN & test_read(bus, UART_REGISTER_STATUS)));
+    TEST_EXPECT(0 == test_read(bus, UART_REGISTER_COMMAND));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_release(uart));
+}
+
+/**
+ * \brief In timed mode, each character arrives a character time after the
+ * one before it.
+ */
+TEST(timed)
+{
+    virtual_device_scheduler* scheduler;
+    virtual_device_uart* uart;
+    virtual_device_manager* bus;
+    uint64_t cycle = 100;
+    const uint8_t response[] = { 'O', 'K' };
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_create(&uart, 4, 4));
+    TEST_ASSERT(test_bus_create(&bus, uart));
+    TEST_ASSERT(
+        test_write(
+            bus, UART_REGISTER_CONTROL,
+            UART_CONTROL_BAUD_9600 | UART_CONTROL_RCS));
+    TEST_ASSERT(test_write(bus, UART_REGISTER_COMMAND, UART_COMMAND_DTR));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_uart_clock_attach(uart, scheduler, 1000000));
+
+    /* ten bits at 9600 baud on a 1 MHz clock. */
+    TEST_EXPECT(1041 == virtual_device_uart_char_cycles(uart));
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_uart_receive(uart, response, sizeof(response)));
+    TEST_EXPECT(1141 == scheduler->next_deadline);
+    TEST_EXPECT(2 == uart->line_count);
+    TEST_EXPECT(2 == virtual_device_uart_rx_space(uart));
+
+    cycle = 1140;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(
+        0 == (UART_STATUS_RDRF & test_read(bus, UART_REGISTER_STATUS)));
+
+    cycle = 1141;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(UART_STATUS_RDRF & test_read(bus, UART_REGISTER_STATUS));
+    TEST_EXPECT('O' == test_read(bus, UART_REGISTER_DATA));
+    TEST_EXPECT(
+        0 == (UART_STATUS_RDRF & test_read(bus, UART_REGISTER_STATUS)));
+
+    cycle = 2182;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT('K' == test_read(bus, UART_REGISTER_DATA));
+    TEST_EXPECT(0 == scheduler->count);
+
+    /* switching to instant mode delivers the line at once. */
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_uart_receive(uart, response, 1));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_uart_clock_attach(uart, scheduler, UART_INSTANT));
+    TEST_EXPECT(0 == scheduler->count);
+    TEST_EXPECT('O' == test_read(bus, UART_REGISTER_DATA));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_release(uart));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
+
+/**
+ * \brief In timed mode, a burst longer than the receive FIFO waits on the line,
+ * and a reader keeping up with the line gets all of it without an overrun.
+ */
+TEST(timed_burst)
+{
+    virtual_device_scheduler* scheduler;
+    virtual_device_uart* uart;
+    virtual_device_manager* bus;
+    uint64_t cycle = 0;
+    const char response[] = "AT+CREG: 0,1\r\n";
+    const size_t size = sizeof(response) - 1;
+    char received[sizeof(response)] = { 0 };
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_create(&uart, 4, 4));
+    TEST_ASSERT(test_bus_create(&bus, uart));
+    TEST_ASSERT(
+        test_write(
+            bus, UART_REGISTER_CONTROL,
+            UART_CONTROL_BAUD_9600 | UART_CONTROL_RCS));
+    TEST_ASSERT(test_write(bus, UART_REGISTER_COMMAND, UART_COMMAND_DTR));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_uart_clock_attach(uart, scheduler, 1000000));
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_uart_receive(
+                    uart, (const uint8_t*)response, size));
+    TEST_EXPECT(size == uart->line_count);
+    TEST_EXPECT(
+        0 == (UART_STATUS_OVERRUN & test_read(bus, UART_REGISTER_STATUS)));
+
+    /* read each character as it arrives. */
+    for (size_t i = 0; i < size; ++i)
+    {
+        cycle += virtual_device_uart_char_cycles(uart);
+        TEST_ASSERT(
+            STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+        TEST_ASSERT(UART_STATUS_RDRF & test_read(bus, UART_REGISTER_STATUS));
+        received[i] = (char)test_read(bus, UART_REGISTER_DATA);
+    }
+
+    TEST_EXPECT(0 == strcmp(response, received));
+    TEST_EXPECT(
+        0 == (UART_STATUS_OVERRUN & test_read(bus, UART_REGISTER_STATUS)));
+    TEST_EXPECT(0 == scheduler->count);
+
+    /* a reader that falls behind loses what arrives to a full FIFO. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_uart_receive(
+                    uart, (const uint8_t*)response, size));
+    cycle += size * virtual_device_uart_char_cycles(uart);
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(UART_STATUS_OVERRUN & test_read(bus, UART_REGISTER_STATUS));
+    TEST_EXPECT('A' == test_read(bus, UART_REGISTER_DATA));
+    TEST_EXPECT('T' == test_read(bus, UART_REGISTER_DATA));
+    TEST_EXPECT('+' == test_read(bus, UART_REGISTER_DATA));
+    TEST_EXPECT('C' == test_read(bus, UART_REGISTER_DATA));
+    TEST_EXPECT(0 == uart->line_count);
+
+    /* a burst that does not fit on the line is refused whole. */
+    uint8_t flood[UART_LINE_DEPTH + 1];
+    memset(flood, 'x', sizeof(flood));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_ERROR_UART_LINE_FULL
+            == virtual_device_uart_receive(uart, flood, sizeof(flood)));
+    TEST_EXPECT(0 == uart->line_count);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_release(uart));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
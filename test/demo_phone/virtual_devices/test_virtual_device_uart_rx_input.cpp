@@ -0,0 +1,213 @@
+#include <minunit/minunit.h>
+#include <string>
+
+#include "../../../src/demo_phone/virtual_devices/journal.h"
+#include "../../../src/demo_phone/virtual_devices/scheduler.h"
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/uart.h"
+#include "test_device_bus.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_uart_rx_input);
+
+/**
+ * \brief A modem link: a timed UART with a 2-deep receive FIFO on a bus.
+ */
+struct test_modem
+{
+    uint64_t cycle;
+    virtual_device_scheduler* scheduler;
+    virtual_device_uart* uart;
+    virtual_device_manager* bus;
+};
+
+/**
+ * \brief Build the modem link at 9600 N 8 1, on a 1 MHz clock.
+ */
+static bool test_modem_create(test_modem* modem)
+{
+    modem->cycle = 0;
+
+    return
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(
+                    &modem->scheduler, NULL, 4, &modem->cycle)
+     && STATUS_SUCCESS == virtual_device_uart_create(&modem->uart, 2, 2)
+     && test_bus_create(&modem->bus, modem->uart)
+     && test_write(
+            modem->bus, UART_REGISTER_CONTROL,
+            UART_CONTROL_BAUD_9600 | UART_CONTROL_RCS)
+     && test_write(modem->bus, UART_REGISTER_COMMAND, UART_COMMAND_DTR)
+     && STATUS_SUCCESS
+            == virtual_device_uart_clock_attach(
+                    modem->uart, modem->scheduler, 1000000);
+}
+
+/**
+ * \brief Tear down the modem link.
+ */
+static bool test_modem_release(test_modem* modem)
+{
+    return
+        STATUS_SUCCESS == virtual_device_manager_release(modem->bus)
+     && STATUS_SUCCESS == virtual_device_uart_release(modem->uart)
+     && STATUS_SUCCESS == virtual_device_scheduler_release(modem->scheduler);
+}
+
+/**
+ * \brief Run the modem link up to a cycle, reading each character as it
+ * arrives.
+ */
+static bool test_modem_run(
+    test_modem* modem, uint64_t until, std::string* received)
+{
+    while (modem->scheduler->next_deadline <= until)
+    {
+        modem->cycle = modem->scheduler->next_deadline;
+        if (STATUS_SUCCESS
+                != virtual_device_scheduler_advance(modem->scheduler))
+        {
+            return false;
+        }
+
+        while (UART_STATUS_RDRF & test_read(modem->bus, UART_REGISTER_STATUS))
+        {
+            received->push_back(
+                (char)test_read(modem->bus, UART_REGISTER_DATA));
+        }
+    }
+
+    modem->cycle = until;
+
+    return
+        0 == (UART_STATUS_OVERRUN
+                & test_read(modem->bus, UART_REGISTER_STATUS));
+}
+
+/**
+ * \brief A character sent through the device input arrives a character time
+ * later, like one sent with virtual_device_uart_receive.
+ */
+TEST(input)
+{
+    test_modem modem;
+    std::string received;
+
+    TEST_ASSERT(test_modem_create(&modem));
+
+    modem.cycle = 100;
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_uart_rx_input(modem.uart, 'O'));
+    TEST_EXPECT(1 == modem.uart->line_count);
+    TEST_EXPECT(1141 == modem.scheduler->next_deadline);
+
+    TEST_ASSERT(test_modem_run(&modem, 1140, &received));
+    TEST_EXPECT(received.empty());
+    TEST_ASSERT(test_modem_run(&modem, 1141, &received));
+    TEST_EXPECT("O" == received);
+
+    TEST_EXPECT(test_modem_release(&modem));
+}
+
+#if defined(VIRTUAL_DEVICE_JOURNAL)
+
+/**
+ * \brief Run the modem link up to a cycle, delivering the journaled inputs as
+ * they fall due.
+ */
+static bool test_modem_replay(
+    test_modem* modem, virtual_device_journal* journal, uint64_t until,
+    std::string* received)
+{
+    while (virtual_device_journal_next_cycle(journal) <= until)
+    {
+        if (!test_modem_run(
+                modem, virtual_device_journal_next_cycle(journal), received)
+         || STATUS_SUCCESS != virtual_device_journal_poll(journal))
+        {
+            return false;
+        }
+    }
+
+    return test_modem_run(modem, until, received);
+}
+
+/**
+ * \brief Modem traffic recorded through a journal replays onto another UART
+ * at the same cycles, and the firmware reads the same characters.
+ */
+TEST(journal_round_trip)
+{
+    test_modem recorded;
+    test_modem replayed;
+    virtual_device_journal* journal;
+    uint8_t channel;
+    std::string recorded_text;
+    std::string replayed_text;
+    const std::string response = "OK\r\n";
+    const std::string ring = "RING";
+
+    FILE* stream = tmpfile();
+    TEST_ASSERT(NULL != stream);
+
+    /* record bursts longer than the FIFO, read as they arrive. */
+    TEST_ASSERT(test_modem_create(&recorded));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_create(
+                    &journal, stream, false, &recorded.cycle));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_channel_add(
+                    journal, &virtual_device_uart_rx_input, recorded.uart,
+                    &channel));
+
+    TEST_ASSERT(test_modem_run(&recorded, 100, &recorded_text));
+    for (char c : response)
+    {
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_journal_input(journal, channel, (uint8_t)c));
+    }
+    TEST_ASSERT(test_modem_run(&recorded, 20000, &recorded_text));
+    for (char c : ring)
+    {
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_journal_input(journal, channel, (uint8_t)c));
+    }
+    TEST_ASSERT(test_modem_run(&recorded, 100000, &recorded_text));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_journal_release(journal));
+    TEST_EXPECT(response + ring == recorded_text);
+
+    /* replay onto a fresh link. */
+    rewind(stream);
+    TEST_ASSERT(test_modem_create(&replayed));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_create(
+                    &journal, stream, true, &replayed.cycle));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_journal_channel_add(
+                    journal, &virtual_device_uart_rx_input, replayed.uart,
+                    &channel));
+
+    /* the response has fully arrived by the time the ring starts. */
+    TEST_ASSERT(test_modem_replay(&replayed, journal, 19999, &replayed_text));
+    TEST_EXPECT(response == replayed_text);
+    TEST_ASSERT(test_modem_replay(&replayed, journal, 100000, &replayed_text));
+    TEST_EXPECT(recorded_text == replayed_text);
+    TEST_EXPECT(recorded.uart->rx_next == replayed.uart->rx_next);
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_JOURNAL_NEVER
+            == virtual_device_journal_next_cycle(journal));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_journal_release(journal));
+    fclose(stream);
+    TEST_EXPECT(test_modem_release(&replayed));
+    TEST_EXPECT(test_modem_release(&recorded));
+}
+
+#endif /*defined(VIRTUAL_DEVICE_JOURNAL)*/
@@ -0,0 +1,218 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/scheduler.h"
+#include "../../../src/demo_phone/virtual_devices/snapshot.h"
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/uart.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+#include "test_device_bus.h"
+
+#include <cstring>
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_uart_transmit);
+
+/**
+ * \brief A modem model on the UART's transmit line.
+ */
+struct test_modem
+{
+    int count;
+    uint8_t line[8];
+};
+
+/**
+ * \brief Record a character sent to the modem.
+ */
+static void test_modem_take(void* context, uint8_t byte)
+{
+    test_modem* modem = (test_modem*)context;
+
+    if (modem->count < (int)sizeof(modem->line))
+    {
+        modem->line[modem->count] = byte;
+    }
+    modem->count += 1;
+}
+
+/**
+ * \brief Record the level driven onto the CPU's IRQ input.
+ */
+static void test_line_drive(void* context, bool asserted)
+{
+    *(bool*)context = asserted;
+}
+
+/**
+ * \brief In instant mode, written characters reach the peripheral at once.
+ */
+TEST(instant)
+{
+    virtual_device_uart* uart;
+    virtual_device_manager* bus;
+    test_modem modem;
+
+    memset(&modem, 0, sizeof(modem));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_create(&uart, 1, 1));
+    TEST_ASSERT(test_bus_create(&bus, uart));
+    virtual_device_uart_connect(uart, &test_modem_take, &modem);
+
+    TEST_ASSERT(test_write(bus, UART_REGISTER_DATA, 'A'));
+    TEST_ASSERT(test_write(bus, UART_REGISTER_DATA, 'T'));
+    TEST_EXPECT(2 == modem.count);
+    TEST_EXPECT(0 == memcmp(modem.line, "AT", 2));
+    TEST_EXPECT(UART_STATUS_TDRE & test_read(bus, UART_REGISTER_STATUS));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_release(uart));
+}
+
+/**
+ * \brief In timed mode, characters leave the transmit FIFO a character time
+ * apart, and the transmit interrupt asks for more while the FIFO has room.
+ */
+TEST(timed)
+{
+    virtual_device_scheduler* scheduler;
+    virtual_device_uart* uart;
+    virtual_device_manager* bus;
+    virtual_device_irq irq;
+    test_modem modem;
+    bool asserted = false;
+    uint64_t cycle = 0;
+
+    memset(&modem, 0, sizeof(modem));
+    memset(&irq, 0, sizeof(irq));
+    virtual_device_irq_connect(&irq, &test_line_drive, &asserted);
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_create(&uart, 2, 2));
+    TEST_ASSERT(test_bus_create(&bus, uart));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_irq_attach(uart, &irq));
+    virtual_device_uart_connect(uart, &test_modem_take, &modem);
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_uart_clock_attach(uart, scheduler, 1000000));
+
+    /* 9600 8 N 1, with transmit interrupts enabled. */
+    TEST_ASSERT(
+        test_write(
+            bus, UART_REGISTER_CONTROL,
+            UART_CONTROL_BAUD_9600 | UART_CONTROL_RCS));
+    TEST_ASSERT(
+        test_write(
+            bus, UART_REGISTER_COMMAND,
+            UART_COMMAND_DTR | UART_COMMAND_RX_IRQ_OFF
+          | UART_COMMAND_TX_IRQ));
+    TEST_EXPECT(asserted);
+
+    /* filling the FIFO releases IRQ, and a third character is lost. */
+    TEST_ASSERT(test_write(bus, UART_REGISTER_DATA, 'A'));
+    TEST_ASSERT(test_write(bus, UART_REGISTER_DATA, 'T'));
+    TEST_ASSERT(test_write(bus, UART_REGISTER_DATA, 'Z'));
+    TEST_EXPECT(!asserted);
+    TEST_EXPECT(
+        0 == (UART_STATUS_TDRE & test_read(bus, UART_REGISTER_STATUS)));
+    TEST_EXPECT(1041 == scheduler->next_deadline);
+
+    cycle = 1040;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(0 == modem.count);
+
+    cycle = 1041;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(1 == modem.count);
+    TEST_EXPECT(asserted);
+    TEST_EXPECT(2082 == scheduler->next_deadline);
+
+    /* a second stop bit lengthens the character. */
+    TEST_ASSERT(
+        test_write(
+            bus, UART_REGISTER_CONTROL,
+            UART_CONTROL_BAUD_9600 | UART_CONTROL_RCS | UART_CONTROL_STOP));
+    TEST_EXPECT(1145 == virtual_device_uart_char_cycles(uart));
+
+    cycle = 5000;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(2 == modem.count);
+    TEST_EXPECT(0 == memcmp(modem.line, "AT", 2));
+    TEST_EXPECT(0 == scheduler->count);
+
+    /* disabling the transmit interrupt releases IRQ. */
+    TEST_ASSERT(test_write(bus, UART_REGISTER_COMMAND, UART_COMMAND_DTR));
+    TEST_EXPECT(!asserted);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_release(uart));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
+
+#if defined(VIRTUAL_DEVICE_SNAPSHOT)
+
+/**
+ * \brief Restoring a UART with a character on the line posts its transmit
+ * event again, so that the character is sent at its original deadline.
+ */
+TEST(restore)
+{
+    virtual_device_scheduler* scheduler;
+    virtual_device_uart* uart;
+    virtual_device_manager* bus;
+    virtual_device_snapshot* snapshot;
+    test_modem modem;
+    uint64_t cycle = 0;
+
+    memset(&modem, 0, sizeof(modem));
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_create(&uart, 2, 2));
+    TEST_ASSERT(test_bus_create(&bus, uart));
+    virtual_device_uart_connect(uart, &test_modem_take, &modem);
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_uart_clock_attach(uart, scheduler, 1000000));
+
+    TEST_ASSERT(
+        test_write(
+            bus, UART_REGISTER_CONTROL,
+            UART_CONTROL_BAUD_9600 | UART_CONTROL_RCS));
+    TEST_ASSERT(test_write(bus, UART_REGISTER_COMMAND, UART_COMMAND_DTR));
+    TEST_ASSERT(test_write(bus, UART_REGISTER_DATA, 'A'));
+
+    cycle = 500;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_manager_snapshot_save(bus, &snapshot));
+
+    cycle = 1041;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(1 == modem.count);
+    TEST_EXPECT(0 == scheduler->count);
+
+    /* going back puts the character on the line again. */
+    cycle = 500;
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_snapshot_restore(bus, snapshot));
+    TEST_EXPECT(1041 == scheduler->next_deadline);
+
+    cycle = 1041;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(2 == modem.count);
+    TEST_EXPECT(0 == memcmp(modem.line, "AA", 2));
+
+    virtual_device_snapshot_release(snapshot);
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_uart_release(uart));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
+
+#endif /*defined(VIRTUAL_DEVICE_SNAPSHOT)*/
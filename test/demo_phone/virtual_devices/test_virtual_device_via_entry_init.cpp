@@ -0,0 +1,170 @@
+#include <minunit/minunit.h>
+#include <string.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_via_entry_init);
+
+/* the number of device callbacks made. */
+static int test_reads;
+static int test_writes;
+
+/**
+ * \brief Count reads, then defer to the VIA.
+ */
+static status test_read(void* via, uint16_t addr, uint8_t* byte)
+{
+    test_reads += 1;
+
+    return virtual_device_via_read_callback(via, addr, byte);
+}
+
+/**
+ * \brief Count writes, then defer to the VIA.
+ */
+static status test_write(void* via, uint16_t addr, uint8_t byte)
+{
+    test_writes += 1;
+
+    return virtual_device_via_write_callback(via, addr, byte);
+}
+
+/**
+ * \brief The entry covers the VIA register file and its shadow.
+ */
+TEST(entry)
+{
+    virtual_device_via* via;
+    virtual_device_entry entry;
+
+    /* create the VIA. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+
+    virtual_device_via_entry_init(via, &entry, VIA_REGISTER_IORB);
+    TEST_EXPECT(VIA_REGISTER_IORB == entry.register_low);
+    TEST_EXPECT(VIA_REGISTER_IORA2 == entry.register_high);
+    TEST_EXPECT(via == entry.context);
+    TEST_EXPECT(via->shadow == entry.shadow);
+    TEST_EXPECT(virtual_device_via_shadow_flags == entry.shadow_flags);
+    TEST_EXPECT(NULL == entry.memory);
+
+    /* release the VIA. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
+
+/**
+ * \brief Shadowed registers are served without calling the VIA, and every
+ * other register still goes through its callbacks.
+ */
+TEST(shadow)
+{
+    virtual_device_manager* virt;
+    virtual_device_via* via;
+    virtual_device_entry entry;
+    uint8_t byte = 0;
+
+    /* create the VIA and the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* register the VIA with counting callbacks. */
+    virtual_device_via_entry_init(via, &entry, VIA_REGISTER_IORB);
+    entry.read = &test_read;
+    entry.write = &test_write;
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_manager_entry_register(virt, &entry));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+    test_reads = test_writes = 0;
+
+    /* the data direction register is read from the shadow, and its writes
+     * reach the VIA, which may have pins to move. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    virt, VIA_REGISTER_DDRB, 0x0F));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(
+                    virt, VIA_REGISTER_DDRB, &byte));
+    TEST_EXPECT(0x0F == byte);
+    TEST_EXPECT(0 == test_reads);
+    TEST_EXPECT(1 == test_writes);
+
+    /* the port goes through the VIA, and sees the shadowed direction. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    virt, VIA_REGISTER_IORB, 0xA5));
+    via->irb = 0x3C;
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(
+                    virt, VIA_REGISTER_IORB, &byte));
+    TEST_EXPECT(0x35 == byte);
+    TEST_EXPECT(1 == test_reads);
+    TEST_EXPECT(2 == test_writes);
+
+    /* the latch is written through, and loading timer 1 reads it. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    virt, VIA_REGISTER_T1LL, 0x34));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    virt, VIA_REGISTER_T1C1H, 0x12));
+    TEST_EXPECT(0x1234 == virtual_device_via_t1_counter(via));
+    TEST_EXPECT(4 == test_writes);
+
+    /* release the manager and the VIA. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
+
+/**
+ * \brief A write-through register is stored in the shadow and still reaches
+ * the device.
+ */
+TEST(write_through)
+{
+    virtual_device_manager* virt;
+    virtual_device_via* via;
+    virtual_device_entry entry;
+    uint8_t flags[VIA_REGISTER_COUNT];
+    uint8_t byte = 0;
+
+    /* create the VIA and the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+
+    /* ACR is read from the shadow, but written through. */
+    memset(flags, 0, sizeof(flags));
+    flags[VIA_REGISTER_ACR - VIA_REGISTER_IORB] =
+        VIRTUAL_DEVICE_SHADOW_READ | VIRTUAL_DEVICE_SHADOW_WRITE_THROUGH;
+    virtual_device_via_entry_init(via, &entry, VIA_REGISTER_IORB);
+    entry.read = &test_read;
+    entry.write = &test_write;
+    entry.shadow_flags = flags;
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_manager_entry_register(virt, &entry));
+    test_reads = test_writes = 0;
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_write_callback(
+                    virt, VIA_REGISTER_ACR, 0x40));
+    TEST_EXPECT(1 == test_writes);
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_manager_emu_read_callback(
+                    virt, VIA_REGISTER_ACR, &byte));
+    TEST_EXPECT(0x40 == byte);
+    TEST_EXPECT(0 == test_reads);
+
+    /* release the manager and the VIA. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
@@ -0,0 +1,202 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+#include "test_device_bus.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_via_handshake);
+
+/**
+ * \brief A peripheral model watching the handshake lines.
+ */
+struct test_peripheral
+{
+    int calls;
+    int strobes;
+    uint8_t levels;
+};
+
+/**
+ * \brief Record a change on the handshake lines, counting falling edges.
+ */
+static void test_notify(
+    void* context, uint8_t port, uint8_t levels, uint8_t changed)
+{
+    test_peripheral* model = (test_peripheral*)context;
+
+    (void)port;
+    model->calls += 1;
+    if (!(levels & changed))
+    {
+        model->strobes += 1;
+    }
+    model->levels = levels;
+}
+
+/**
+ * \brief In handshake mode, writing port A drops CA2 until the peripheral
+ * acknowledges on CA1, and IORA2 skips the handshake.
+ */
+TEST(write_handshake)
+{
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+    virtual_device_via_subscription sub;
+    test_peripheral display = { 0, 0, 0 };
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    virtual_device_via_subscribe(
+        via, &sub, VIA_PORT_CONTROL, VIA_CONTROL_CA2, &test_notify, &display);
+
+    /* CA1 positive edge, CA2 handshake output, which starts high. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_DDRA, 0xFF));
+    TEST_ASSERT(
+        test_write(
+            bus, VIA_REGISTER_PCR,
+            VIA_PCR_C1_POSITIVE | VIA_PCR_C2_HANDSHAKE));
+    TEST_EXPECT(VIA_CONTROL_CA2 & display.levels);
+
+    /* writing a byte signals data ready. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IORA, 0x41));
+    TEST_EXPECT(1 == display.strobes);
+    TEST_EXPECT(!(VIA_CONTROL_CA2 & display.levels));
+
+    /* the display takes the byte and acknowledges. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_ca1_input(via, 1));
+    TEST_EXPECT(VIA_CONTROL_CA2 & display.levels);
+    TEST_EXPECT(VIA_IFR_CA1 & via->ifr);
+
+    /* the next write clears the flag and signals again. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IORA, 0x42));
+    TEST_EXPECT(2 == display.strobes);
+    TEST_EXPECT(0 == (VIA_IFR_CA1 & via->ifr));
+
+    /* the acknowledging edge is the rising one. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_ca1_input(via, 0));
+    TEST_EXPECT(!(VIA_CONTROL_CA2 & display.levels));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_ca1_input(via, 1));
+    TEST_EXPECT(VIA_CONTROL_CA2 & display.levels);
+
+    /* IORA2 writes without a handshake. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IORA2, 0x43));
+    TEST_EXPECT(2 == display.strobes);
+    TEST_EXPECT(VIA_IFR_CA1 & via->ifr);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
+
+/**
+ * \brief In pulse mode, writing port B strobes CB2 once, and reading it does
+ * not.
+ */
+TEST(pulse)
+{
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+    virtual_device_via_subscription sub;
+    test_peripheral model = { 0, 0, 0 };
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    virtual_device_via_subscribe(
+        via, &sub, VIA_PORT_CONTROL, VIA_CONTROL_CB2, &test_notify, &model);
+
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_PCR, VIA_PCR_C2_PULSE << 4));
+    TEST_EXPECT(1 == model.calls);
+
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IORB, 0x99));
+    TEST_EXPECT(3 == model.calls);
+    TEST_EXPECT(1 == model.strobes);
+    TEST_EXPECT(VIA_CONTROL_CB2 & model.levels);
+
+    (void)test_read(bus, VIA_REGISTER_IORB);
+    TEST_EXPECT(3 == model.calls);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
+
+/**
+ * \brief A CA1 edge latches port A when ACR enables latching, and an enabled
+ * CA1 flag interrupts until port A is read.
+ */
+TEST(latch_and_interrupt)
+{
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_ACR, VIA_ACR_PA_LATCH));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IER, 0x80 | VIA_IFR_CA1));
+
+    /* the keypad presents a code and strobes CA1 low. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_port_a_input(via, 0x12));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_ca1_input(via, 1));
+    TEST_EXPECT(0 == via->ifr);
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_ca1_input(via, 0));
+    TEST_EXPECT(
+        (VIA_IFR_IRQ | VIA_IFR_CA1) == test_read(bus, VIA_REGISTER_IFR));
+
+    /* later changes are not seen until the next edge. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_port_a_input(via, 0x34));
+    TEST_EXPECT(0x12 == test_read(bus, VIA_REGISTER_IORA2));
+    TEST_EXPECT(VIA_IFR_CA1 & via->ifr);
+    TEST_EXPECT(0x12 == test_read(bus, VIA_REGISTER_IORA));
+    TEST_EXPECT(0 == via->ifr);
+
+    /* without latching, the pins read live. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_ACR, 0));
+    TEST_EXPECT(0x34 == test_read(bus, VIA_REGISTER_IORA));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
+
+/**
+ * \brief An independent C2 input is not cleared by port accesses, and manual
+ * modes drive C2 directly.
+ */
+TEST(c2_modes)
+{
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+
+    /* independent negative edge on CB2, plain negative edge on CA2. */
+    TEST_ASSERT(
+        test_write(
+            bus, VIA_REGISTER_PCR,
+            (VIA_PCR_C2_IND_NEGATIVE << 4) | VIA_PCR_C2_INPUT_NEGATIVE));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_cb2_input(via, 1));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_ca2_input(via, 1));
+    TEST_EXPECT(0 == via->ifr);
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_cb2_input(via, 0));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_ca2_input(via, 0));
+    TEST_EXPECT((VIA_IFR_CB2 | VIA_IFR_CA2) == via->ifr);
+
+    (void)test_read(bus, VIA_REGISTER_IORB);
+    (void)test_read(bus, VIA_REGISTER_IORA);
+    TEST_EXPECT(VIA_IFR_CB2 == via->ifr);
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IFR, VIA_IFR_CB2));
+    TEST_EXPECT(0 == via->ifr);
+
+    /* manual output modes. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_PCR, VIA_PCR_C2_HIGH << 4));
+    TEST_EXPECT(
+        VIA_CONTROL_CB2
+            & virtual_device_via_port_levels(via, VIA_PORT_CONTROL));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_PCR, VIA_PCR_C2_LOW << 4));
+    TEST_EXPECT(
+        !(VIA_CONTROL_CB2
+            & virtual_device_via_port_levels(via, VIA_PORT_CONTROL)));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
@@ -0,0 +1,113 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/scheduler.h"
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+#include "test_device_bus.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_via_irq_attach);
+
+/**
+ * \brief Record the level driven onto the CPU's IRQ input.
+ */
+static void test_line_drive(void* context, bool asserted)
+{
+    *(bool*)context = asserted;
+}
+
+/**
+ * \brief IER bits are set and cleared by bit 7 of the write, and bit 7 reads
+ * as set.
+ */
+TEST(ier)
+{
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IER, 0x80 | VIA_IFR_T1));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IER, 0x80 | VIA_IFR_T2));
+    TEST_EXPECT(0xE0 == test_read(bus, VIA_REGISTER_IER));
+
+    /* without bit 7, the ones clear. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IER, VIA_IFR_T1));
+    TEST_EXPECT(0xA0 == test_read(bus, VIA_REGISTER_IER));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IER, 0x7F));
+    TEST_EXPECT(0x80 == test_read(bus, VIA_REGISTER_IER));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
+
+/**
+ * \brief A timer underflow pulls the manager's IRQ line low only while its
+ * flag is enabled, and writing a one to the flag releases it.
+ */
+TEST(timer_irq)
+{
+    virtual_device_manager* virt;
+    virtual_device_scheduler* scheduler;
+    virtual_device_via* via;
+    virtual_device_via* other;
+    uint64_t cycle = 0;
+    bool line = false;
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&other));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_via_timer_attach(via, scheduler));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_via_irq_attach(via, &virt->irq));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_via_irq_attach(other, &virt->irq));
+    virtual_device_irq_connect(&virt->irq, &test_line_drive, &line);
+    TEST_ASSERT(test_bus_attach(virt, via));
+
+    /* a disabled flag is visible, but does not interrupt. */
+    TEST_ASSERT(test_write(virt, VIA_REGISTER_T1C1L, 10));
+    TEST_ASSERT(test_write(virt, VIA_REGISTER_T1C1H, 0));
+    cycle = 11;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(VIA_IFR_T1 == test_read(virt, VIA_REGISTER_IFR));
+    TEST_EXPECT(!line);
+
+    /* enabling it interrupts, and sets bit 7 of IFR. */
+    TEST_ASSERT(test_write(virt, VIA_REGISTER_IER, 0x80 | VIA_IFR_T1));
+    TEST_EXPECT(line);
+    TEST_EXPECT(
+        (VIA_IFR_IRQ | VIA_IFR_T1) == test_read(virt, VIA_REGISTER_IFR));
+
+    /* writing zeros leaves the flag; writing a one clears it. */
+    TEST_ASSERT(test_write(virt, VIA_REGISTER_IFR, VIA_IFR_T2));
+    TEST_EXPECT(line);
+    TEST_ASSERT(test_write(virt, VIA_REGISTER_IFR, VIA_IFR_T1));
+    TEST_EXPECT(!line);
+    TEST_EXPECT(0 == test_read(virt, VIA_REGISTER_IFR));
+
+    /* the next underflow interrupts again, at its deadline. */
+    TEST_ASSERT(test_write(virt, VIA_REGISTER_T1C1H, 0));
+    cycle = 21;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(!line);
+    cycle = 22;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(line);
+
+    /* releasing the VIA releases its request. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+    TEST_EXPECT(!line);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(other));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
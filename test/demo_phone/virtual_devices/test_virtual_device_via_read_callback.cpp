@@ -0,0 +1,75 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_via_read_callback);
+
+/**
+ * \brief Reading a port combines the output register for output pins with the
+ * input level for input pins.
+ */
+TEST(ports)
+{
+    virtual_device_via* via;
+    uint8_t byte = 0;
+
+    /* create the VIA. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+
+    /* the low nibble of port B is output, the high nibble input. */
+    VIA_SHADOW(via, VIA_REGISTER_DDRB) = 0x0F;
+    via->orb = 0xA5;
+    via->irb = 0x3C;
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_via_read_callback(via, VIA_REGISTER_IORB, &byte));
+    TEST_EXPECT(0x35 == byte);
+
+    /* port A reads the same through both of its registers. */
+    VIA_SHADOW(via, VIA_REGISTER_DDRA) = 0xF0;
+    via->ora = 0x5A;
+    via->ira = 0xC3;
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_via_read_callback(via, VIA_REGISTER_IORA, &byte));
+    TEST_EXPECT(0x53 == byte);
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_via_read_callback(
+                    via, VIA_REGISTER_IORA2, &byte));
+    TEST_EXPECT(0x53 == byte);
+
+    /* the data direction registers read back. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_via_read_callback(via, VIA_REGISTER_DDRB, &byte));
+    TEST_EXPECT(0x0F == byte);
+
+    /* release the VIA. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
+
+/**
+ * \brief The VIA decodes only the low four address bits, so its registers
+ * repeat across any aligned base.
+ */
+TEST(register_decode)
+{
+    virtual_device_via* via;
+    uint8_t byte = 0;
+
+    /* create the VIA. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+
+    /* 0x0012 decodes as DDRB. */
+    VIA_SHADOW(via, VIA_REGISTER_DDRB) = 0x5A;
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_via_read_callback(via, 0x0012, &byte));
+    TEST_EXPECT(0x5A == byte);
+
+    /* release the VIA. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
@@ -0,0 +1,318 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+#include "test_device_bus.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_via_sr_start);
+
+/**
+ * \brief A peripheral model on the other end of the shift register.
+ */
+struct test_peripheral
+{
+    int transfers;
+    uint8_t received;
+    uint8_t reply;
+    int bits;
+};
+
+/**
+ * \brief Exchange a byte with the model.
+ */
+static uint8_t test_transfer(void* context, bool shift_out, uint8_t byte)
+{
+    test_peripheral* model = (test_peripheral*)context;
+
+    model->transfers += 1;
+    if (shift_out)
+    {
+        model->received = byte;
+    }
+
+    return model->reply;
+}
+
+/**
+ * \brief Sample CB2 on each rising edge of CB1.
+ */
+static void test_notify(
+    void* context, uint8_t port, uint8_t levels, uint8_t changed)
+{
+    test_peripheral* model = (test_peripheral*)context;
+
+    (void)port;
+    if ((changed & VIA_CONTROL_CB1) && (levels & VIA_CONTROL_CB1))
+    {
+        model->received =
+            (uint8_t)(
+                (model->received << 1)
+              | (levels & VIA_CONTROL_CB2 ? 1 : 0));
+        model->bits += 1;
+    }
+}
+
+/**
+ * \brief With a transfer attached, a byte shifted out under phi2 moves in one
+ * event, sixteen cycles after the write.
+ */
+TEST(fast_out_phi2)
+{
+    virtual_device_scheduler* scheduler;
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+    uint64_t cycle = 0;
+    test_peripheral model = { 0, 0, 0, 0 };
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_via_timer_attach(via, scheduler));
+    virtual_device_via_sr_attach(via, &test_transfer, &model);
+
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_ACR, VIA_SR_OUT_PHI2));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_SR, 0xA5));
+    TEST_EXPECT(16 == scheduler->next_deadline);
+
+    cycle = 15;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(0 == model.transfers);
+    TEST_EXPECT(0 == (VIA_IFR_SR & via->ifr));
+
+    cycle = 16;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(1 == model.transfers);
+    TEST_EXPECT(0xA5 == model.received);
+    TEST_EXPECT(VIA_IFR_SR & via->ifr);
+    TEST_EXPECT(0 == scheduler->count);
+
+    /* the next access clears the flag. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_SR, 0x5A));
+    TEST_EXPECT(0 == (VIA_IFR_SR & via->ifr));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+    TEST_EXPECT(0 == scheduler->count);
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
+
+/**
+ * \brief With a transfer attached, a byte shifted in under T2 is the byte the
+ * peripheral returns, sixteen half periods after the read.
+ */
+TEST(fast_in_t2)
+{
+    virtual_device_scheduler* scheduler;
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+    uint64_t cycle = 0;
+    test_peripheral model = { 0, 0, 0x3C, 0 };
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_via_timer_attach(via, scheduler));
+    virtual_device_via_sr_attach(via, &test_transfer, &model);
+
+    /* a half period of 6 + 2 cycles. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T2CL, 6));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_ACR, VIA_SR_IN_T2));
+    (void)test_read(bus, VIA_REGISTER_SR);
+
+    cycle = 127;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(0 == model.transfers);
+
+    cycle = 128;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(1 == model.transfers);
+    TEST_EXPECT(VIA_IFR_SR & via->ifr);
+    TEST_EXPECT(0x3C == test_read(bus, VIA_REGISTER_SR));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
+
+/**
+ * \brief Without a transfer, a byte shifted out under T2 is clocked out on
+ * CB1 and CB2, most significant bit first.
+ */
+TEST(bits_out_t2)
+{
+    virtual_device_scheduler* scheduler;
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+    virtual_device_via_subscription sub;
+    uint64_t cycle = 0;
+    test_peripheral model = { 0, 0, 0, 0 };
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_via_timer_attach(via, scheduler));
+    virtual_device_via_subscribe(
+        via, &sub, VIA_PORT_CONTROL, VIA_CONTROL_CB1 | VIA_CONTROL_CB2,
+        &test_notify, &model);
+
+    /* a half period of 0 + 2 cycles. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T2CL, 0));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_ACR, VIA_SR_OUT_T2));
+
+    /* the VIA now drives CB1, which idles high. */
+    TEST_EXPECT(1 == model.bits);
+    model.bits = 0;
+
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_SR, 0xA5));
+
+    cycle = 31;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(7 == model.bits);
+    TEST_EXPECT(0 == (VIA_IFR_SR & via->ifr));
+
+    cycle = 32;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(8 == model.bits);
+    TEST_EXPECT(0xA5 == model.received);
+    TEST_EXPECT(VIA_IFR_SR & via->ifr);
+    TEST_EXPECT(0 == scheduler->count);
+
+    /* the register rotates, leaving the byte in place. */
+    TEST_EXPECT(0xA5 == via->sr);
+
+    virtual_device_via_unsubscribe(via, &sub);
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
+
+/**
+ * \brief Under an external clock on CB1, bits are shifted in from CB2 at each
+ * rising edge.
+ */
+TEST(bits_in_cb1)
+{
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+    uint8_t byte = 0x3C;
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_ACR, VIA_SR_IN_CB1));
+    (void)test_read(bus, VIA_REGISTER_SR);
+
+    for (int i = 7; i >= 0; --i)
+    {
+        TEST_EXPECT(0 == (VIA_IFR_SR & via->ifr));
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_via_cb2_input(via, (byte >> i) & 1));
+        TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_cb1_input(via, 0));
+        TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_cb1_input(via, 1));
+    }
+
+    TEST_EXPECT(VIA_IFR_SR & via->ifr);
+    TEST_EXPECT(0x3C == via->sr);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
+
+/**
+ * \brief Shifting out in free-running mode repeats the byte and never raises
+ * the flag.
+ */
+TEST(out_free)
+{
+    virtual_device_scheduler* scheduler;
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+    uint64_t cycle = 0;
+    test_peripheral model = { 0, 0, 0, 0 };
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_via_timer_attach(via, scheduler));
+    virtual_device_via_sr_attach(via, &test_transfer, &model);
+
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T2CL, 0));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_ACR, VIA_SR_OUT_FREE));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_SR, 0x55));
+
+    cycle = 96;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(3 == model.transfers);
+    TEST_EXPECT(0x55 == model.received);
+    TEST_EXPECT(0 == (VIA_IFR_SR & via->ifr));
+    TEST_EXPECT(via->sr_running);
+
+    /* disabling the shift register stops it. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_ACR, VIA_SR_DISABLED));
+    TEST_EXPECT(!via->sr_running);
+    TEST_EXPECT(0 == scheduler->count);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
+
+/**
+ * \brief Changing the shift register mode through the device manager stops a
+ * running shift, even though the manager stores ACR before the VIA sees it.
+ */
+TEST(mode_change)
+{
+    virtual_device_scheduler* scheduler;
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+    uint64_t cycle = 0;
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_via_timer_attach(via, scheduler));
+
+    /* the peripheral pulls CB2 high while it is not driven. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_cb2_input(via, 1));
+
+    /* start shifting 0x5A out under T2, and clock out its first bit. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_ACR, VIA_SR_OUT_T2));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_SR, 0x5A));
+    cycle = 4;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(via->sr_running);
+    TEST_EXPECT(0 == (VIA_CONTROL_CB2 & via->pins[VIA_PORT_CONTROL]));
+
+    /* disabling it stops the shift and releases CB2. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_ACR, VIA_SR_DISABLED));
+    TEST_EXPECT(!via->sr_running);
+    TEST_EXPECT(0 == scheduler->count);
+    TEST_EXPECT(VIA_CONTROL_CB2 & via->pins[VIA_PORT_CONTROL]);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
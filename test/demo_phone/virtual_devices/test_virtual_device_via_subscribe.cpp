@@ -0,0 +1,124 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+#include "test_device_bus.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_via_subscribe);
+
+/**
+ * \brief A peripheral model, recording its last notification.
+ */
+struct test_peripheral
+{
+    int calls;
+    uint8_t port;
+    uint8_t levels;
+    uint8_t changed;
+};
+
+/**
+ * \brief Record a pin change.
+ */
+static void test_notify(
+    void* context, uint8_t port, uint8_t levels, uint8_t changed)
+{
+    test_peripheral* model = (test_peripheral*)context;
+
+    model->calls += 1;
+    model->port = port;
+    model->levels = levels;
+    model->changed = changed;
+}
+
+/**
+ * \brief Subscribers are only called when their own pins change.
+ */
+TEST(masked_changes)
+{
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+    virtual_device_via_subscription display_sub, ringer_sub;
+    test_peripheral display = { 0, 0, 0, 0 };
+    test_peripheral ringer = { 0, 0, 0, 0 };
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    virtual_device_via_subscribe(
+        via, &display_sub, VIA_PORT_B, 0x0F, &test_notify, &display);
+    virtual_device_via_subscribe(
+        via, &ringer_sub, VIA_PORT_B, 0x80, &test_notify, &ringer);
+
+    /* writing an input-only port moves no pins. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IORB, 0xFF));
+    TEST_EXPECT(0 == display.calls);
+
+    /* turning pins to outputs drives the output register onto them. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_DDRB, 0x8F));
+    TEST_EXPECT(1 == display.calls);
+    TEST_EXPECT(VIA_PORT_B == display.port);
+    TEST_EXPECT(0x8F == display.levels);
+    TEST_EXPECT(0x0F == display.changed);
+    TEST_EXPECT(1 == ringer.calls);
+    TEST_EXPECT(0x80 == ringer.changed);
+
+    /* rewriting the same value notifies nobody. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IORB, 0xFF));
+    TEST_EXPECT(1 == display.calls);
+    TEST_EXPECT(1 == ringer.calls);
+
+    /* only the subscriber to the changed pin hears about it. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IORB, 0x7F));
+    TEST_EXPECT(1 == display.calls);
+    TEST_EXPECT(2 == ringer.calls);
+    TEST_EXPECT(0x0F == ringer.levels);
+
+    /* input pins driven from outside are published too. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_port_b_input(via, 0x70));
+    TEST_EXPECT(1 == display.calls);
+    TEST_EXPECT(2 == ringer.calls);
+
+    /* an unsubscribed model is not called. */
+    virtual_device_via_unsubscribe(via, &display_sub);
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IORB, 0x70));
+    TEST_EXPECT(1 == display.calls);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
+
+/**
+ * \brief The two ports publish separately, and IORA2 drives port A too.
+ */
+TEST(ports)
+{
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+    virtual_device_via_subscription sub;
+    test_peripheral model = { 0, 0, 0, 0 };
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    virtual_device_via_subscribe(
+        via, &sub, VIA_PORT_A, 0xFF, &test_notify, &model);
+
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_DDRA, 0xF0));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_DDRB, 0xFF));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IORB, 0x55));
+    TEST_EXPECT(0 == model.calls);
+
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_IORA2, 0x3C));
+    TEST_EXPECT(1 == model.calls);
+    TEST_EXPECT(VIA_PORT_A == model.port);
+    TEST_EXPECT(0x30 == model.levels);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_port_a_input(via, 0x0A));
+    TEST_EXPECT(2 == model.calls);
+    TEST_EXPECT(0x3A == model.levels);
+    TEST_EXPECT(0x0A == model.changed);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
@@ -0,0 +1,263 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/scheduler.h"
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+#include "test_device_bus.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_via_timer_update);
+
+/**
+ * \brief A one-shot timer 1 counts down from the cycle it is loaded, and
+ * interrupts once, the cycle after it reaches zero.
+ */
+TEST(t1_one_shot)
+{
+    virtual_device_scheduler* scheduler;
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+    uint64_t cycle = 10;
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_via_timer_attach(via, scheduler));
+
+    /* load 100 at cycle 10. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T1C1L, 100));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T1C1H, 0));
+    TEST_EXPECT(111 == scheduler->next_deadline);
+
+    /* the counter is computed from the cycle delta. */
+    cycle = 60;
+    TEST_EXPECT(50 == test_read(bus, VIA_REGISTER_T1C1L));
+    TEST_EXPECT(0 == test_read(bus, VIA_REGISTER_T1C1H));
+
+    cycle = 110;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(0 == (VIA_IFR_T1 & test_read(bus, VIA_REGISTER_IFR)));
+    TEST_EXPECT(0 == virtual_device_via_t1_counter(via));
+
+    /* the underflow raises the flag, and the counter keeps going. */
+    cycle = 111;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(VIA_IFR_T1 & via->ifr);
+    TEST_EXPECT(0xFFFF == virtual_device_via_t1_counter(via));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_SCHEDULER_NEVER == scheduler->next_deadline);
+
+    /* reading the low counter byte clears the flag, for good. */
+    cycle = 112;
+    TEST_EXPECT(0xFE == test_read(bus, VIA_REGISTER_T1C1L));
+    TEST_EXPECT(0 == (VIA_IFR_T1 & test_read(bus, VIA_REGISTER_IFR)));
+    cycle = 100000;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(0 == (VIA_IFR_T1 & test_read(bus, VIA_REGISTER_IFR)));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+    TEST_EXPECT(0 == scheduler->count);
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
+
+/**
+ * \brief A free-running timer 1 reloads from its latches, interrupting every
+ * latch + 2 cycles, and a late reader still sees the right count.
+ */
+TEST(t1_free_run)
+{
+    virtual_device_scheduler* scheduler;
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+    uint64_t cycle = 0;
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_via_timer_attach(via, scheduler));
+
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_ACR, VIA_ACR_T1_FREE_RUN));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T1C1L, 10));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T1C1H, 0));
+
+    /* underflows at 11, reloads at 12. */
+    cycle = 11;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(VIA_IFR_T1 & via->ifr);
+    TEST_EXPECT(0xFFFF == virtual_device_via_t1_counter(via));
+    TEST_EXPECT(23 == scheduler->next_deadline);
+    cycle = 12;
+    TEST_EXPECT(10 == test_read(bus, VIA_REGISTER_T1C1L));
+    TEST_EXPECT(0 == (VIA_IFR_T1 & via->ifr));
+
+    /* a run that overshoots several periods lands in the right one. */
+    cycle = 40;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(VIA_IFR_T1 & via->ifr);
+    TEST_EXPECT(47 == scheduler->next_deadline);
+    TEST_EXPECT(6 == virtual_device_via_t1_counter(via));
+
+    /* a new latch takes effect at the next reload. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T1LL, 20));
+    cycle = 47;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(69 == scheduler->next_deadline);
+
+    /* writing the high latch clears the flag. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T1LH, 0));
+    TEST_EXPECT(0 == (VIA_IFR_T1 & via->ifr));
+
+    /* dropping back to one-shot carries on from the current count. */
+    cycle = 50;
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_ACR, 0));
+    TEST_EXPECT(18 == virtual_device_via_t1_counter(via));
+    TEST_EXPECT(69 == scheduler->next_deadline);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
+
+/**
+ * \brief A latch written through the device manager only takes effect at the
+ * next reload, even though the manager stores it before the VIA sees it.
+ */
+TEST(t1_latch_write_through)
+{
+    virtual_device_scheduler* scheduler;
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+    uint64_t cycle = 0;
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 4, &cycle));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_via_timer_attach(via, scheduler));
+
+    /* free-run from a latch of 100, reloading at 102, 204, and 306. */
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_ACR, VIA_ACR_T1_FREE_RUN));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T1C1L, 100));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T1C1H, 0));
+
+    /* the periods missed before the new latch ran under the old one. */
+    cycle = 350;
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T1LH, 0x10));
+    TEST_EXPECT(0x38 == test_read(bus, VIA_REGISTER_T1C1L));
+    TEST_EXPECT(0x00 == test_read(bus, VIA_REGISTER_T1C1H));
+
+    /* the period after runs under the new one, from 408. */
+    cycle = 408;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(0x1064 == virtual_device_via_t1_counter(via));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
+
+/**
+ * \brief A one-shot timer 2 interrupts once, and timer 1 and timer 2 share the
+ * VIA's single scheduler event.
+ */
+TEST(t2_one_shot)
+{
+    virtual_device_scheduler* scheduler;
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+    uint64_t cycle = 0;
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 1, &cycle));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_via_timer_attach(via, scheduler));
+
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T1C1L, 0x00));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T1C1H, 0x01));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T2CL, 0x20));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T2CH, 0x00));
+    TEST_EXPECT(1 == scheduler->count);
+    TEST_EXPECT(0x21 == scheduler->next_deadline);
+
+    cycle = 0x21;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(VIA_IFR_T2 == via->ifr);
+    TEST_EXPECT(0x101 == scheduler->next_deadline);
+
+    /* reading the low counter byte clears the flag. */
+    TEST_EXPECT(0xFF == test_read(bus, VIA_REGISTER_T2CL));
+    TEST_EXPECT(0xFF == test_read(bus, VIA_REGISTER_T2CH));
+    TEST_EXPECT(0 == via->ifr);
+
+    cycle = 0x101;
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_scheduler_advance(scheduler));
+    TEST_EXPECT(VIA_IFR_T1 == via->ifr);
+    TEST_EXPECT(0 == scheduler->count);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
+
+/**
+ * \brief In pulse counting mode, timer 2 counts falling edges on PB6, and
+ * interrupts when it reaches zero.
+ */
+TEST(t2_pulse_count)
+{
+    virtual_device_scheduler* scheduler;
+    virtual_device_via* via;
+    virtual_device_manager* bus;
+    uint64_t cycle = 0;
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_scheduler_create(&scheduler, NULL, 1, &cycle));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    TEST_ASSERT(test_bus_create(&bus, via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_via_timer_attach(via, scheduler));
+
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_ACR, VIA_ACR_T2_PULSE_COUNT));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T2CL, 2));
+    TEST_ASSERT(test_write(bus, VIA_REGISTER_T2CH, 0));
+
+    /* time alone does not count, and nothing is scheduled. */
+    cycle = 1000;
+    TEST_EXPECT(2 == virtual_device_via_t2_counter(via));
+    TEST_EXPECT(0 == scheduler->count);
+
+    /* only falling edges count. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_port_b_input(via, 0x40));
+    TEST_EXPECT(2 == virtual_device_via_t2_counter(via));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_port_b_input(via, 0x00));
+    TEST_EXPECT(1 == virtual_device_via_t2_counter(via));
+    TEST_EXPECT(0 == via->ifr);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_port_b_input(via, 0x40));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_port_b_input(via, 0x00));
+    TEST_EXPECT(0 == virtual_device_via_t2_counter(via));
+    TEST_EXPECT(VIA_IFR_T2 == via->ifr);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(bus));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+    TEST_ASSERT(
+        STATUS_SUCCESS == virtual_device_scheduler_release(scheduler));
+}
@@ -0,0 +1,83 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_via_write_callback);
+
+/**
+ * \brief Writing the ports and data direction registers updates the VIA.
+ */
+TEST(ports)
+{
+    virtual_device_via* via;
+
+    /* create the VIA. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_via_write_callback(via, VIA_REGISTER_DDRA, 0xFF));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_via_write_callback(
+                    via, VIA_REGISTER_IORA2, 0x12));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_via_write_callback(via, VIA_REGISTER_IORB, 0x34));
+    TEST_EXPECT(0xFF == VIA_SHADOW(via, VIA_REGISTER_DDRA));
+    TEST_EXPECT(0x12 == via->ora);
+    TEST_EXPECT(0x34 == via->orb);
+
+    /* release the VIA. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
+
+/**
+ * \brief Writing the high byte of timer 1 loads the counter from the latch,
+ * and writing the high byte of timer 2 loads its counter.
+ */
+TEST(timers)
+{
+    virtual_device_via* via;
+    uint8_t byte = 0;
+
+    /* create the VIA. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+
+    /* the low byte only sets the latch. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_via_write_callback(
+                    via, VIA_REGISTER_T1C1L, 0x34));
+    TEST_EXPECT(0x34 == VIA_SHADOW(via, VIA_REGISTER_T1LL));
+    TEST_EXPECT(0x00 == VIA_SHADOW(via, VIA_REGISTER_T1LH));
+    TEST_EXPECT(0x0000 == virtual_device_via_t1_counter(via));
+
+    /* the high byte loads the counter. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_via_write_callback(
+                    via, VIA_REGISTER_T1C1H, 0x12));
+    TEST_EXPECT(0x12 == VIA_SHADOW(via, VIA_REGISTER_T1LH));
+    TEST_EXPECT(0x1234 == virtual_device_via_t1_counter(via));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_via_read_callback(
+                    via, VIA_REGISTER_T1C1H, &byte));
+    TEST_EXPECT(0x12 == byte);
+
+    /* timer 2 loads its counter from the low latch and the high byte. */
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_via_write_callback(via, VIA_REGISTER_T2CL, 0x78));
+    TEST_ASSERT(
+        STATUS_SUCCESS
+            == virtual_device_via_write_callback(via, VIA_REGISTER_T2CH, 0x56));
+    TEST_EXPECT(0x5678 == virtual_device_via_t2_counter(via));
+
+    /* release the VIA. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+}
@@ -0,0 +1,138 @@
+#include <minunit/minunit.h>
+
+#include "../../../src/demo_phone/virtual_devices/status.h"
+#include "../../../src/demo_phone/virtual_devices/via.h"
+#include "../../../src/demo_phone/virtual_devices/virtual_device.h"
+
+JEMU_IMPORT_jemu65c02;
+
+TEST_SUITE(virtual_device_static_arena);
+
+/**
+ * \brief Register the given number of devices on one page, 64 bytes apart.
+ */
+static bool test_fill_devices(virtual_device_manager* virt, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint16_t low = (uint16_t)(0xF000 + 0x40 * i);
+
+        if (STATUS_SUCCESS
+                != virtual_device_manager_device_register(
+                        virt, NULL, NULL, low, (uint16_t)(low + 0x0F),
+                        NULL))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * \brief The default manager and a VIA fit in the static pool, and devices can
+ * then be hot-plugged within the page budget without allocating.
+ */
+TEST(budget)
+{
+    virtual_device_manager* virt;
+    virtual_device_via* via;
+
+    virtual_device_arena_reset(&virtual_device_static_arena);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_STATIC_MAX_DEVICES == virt->max_device_entries);
+    TEST_ASSERT(test_fill_devices(virt, 2));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    /* a device instance is carved after the manager. */
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_create(&via));
+    size_t offset = virtual_device_static_arena.offset;
+
+    /* attaching and detaching within the budget does not allocate. */
+    for (int i = 0; i < 20; ++i)
+    {
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_manager_device_attach(
+                        virt, NULL, NULL, 0xF300, 0xF30F, via));
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_manager_device_detach(virt, 0xF300, 0xF30F));
+    }
+    TEST_EXPECT(offset == virtual_device_static_arena.offset);
+
+    /* the remaining devices fit on the remaining budget pages. */
+    for (size_t i = 2; i < VIRTUAL_DEVICE_STATIC_MAX_DEVICES; ++i)
+    {
+        uint16_t low = (uint16_t)(0xF000 + 0x100 * (i % 4) + 0x80 * (i / 4));
+
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_manager_device_attach(
+                        virt, NULL, NULL, low, (uint16_t)(low + 0x0F), NULL));
+    }
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_STATIC_MAX_DEVICES == virt->device_entries);
+    TEST_EXPECT(offset == virtual_device_static_arena.offset);
+    TEST_EXPECT(virt->finalized);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_via_release(via));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}
+
+/**
+ * \brief A device past the page budget or the device budget is refused, and
+ * the manager is left as it was.
+ */
+TEST(fail_past_budget)
+{
+    virtual_device_manager* virt;
+
+    virtual_device_arena_reset(&virtual_device_static_arena);
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_create(&virt));
+    TEST_ASSERT(test_fill_devices(virt, 1));
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_finalize(virt));
+
+    /* a device spanning more pages than are left does not fit. */
+    TEST_EXPECT(
+        JEMU_ERROR_OUT_OF_MEMORY
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0x8000, 0x84FF, NULL));
+    TEST_EXPECT(1 == virt->device_entries);
+    TEST_EXPECT(virt->finalized);
+    TEST_EXPECT(NULL == virtual_device_manager_device_find(virt, 0x8000));
+    TEST_EXPECT(
+        virt->devices == virtual_device_manager_device_find(virt, 0xF000));
+
+    /* fill the device budget on the pages already in use. */
+    for (size_t i = 1; i < VIRTUAL_DEVICE_STATIC_MAX_DEVICES; ++i)
+    {
+        uint16_t low = (uint16_t)(0xF000 + 0x10 * i);
+
+        TEST_ASSERT(
+            STATUS_SUCCESS
+                == virtual_device_manager_device_attach(
+                        virt, NULL, NULL, low, (uint16_t)(low + 0x0F), NULL));
+    }
+    size_t offset = virtual_device_static_arena.offset;
+
+    /* one more device does not fit, and takes nothing from the pool. */
+    TEST_EXPECT(
+        JEMU_ERROR_OUT_OF_MEMORY
+            == virtual_device_manager_device_attach(
+                    virt, NULL, NULL, 0xF0F0, 0xF0FF, NULL));
+    TEST_EXPECT(
+        JEMU_ERROR_OUT_OF_MEMORY
+            == virtual_device_manager_device_register(
+                    virt, NULL, NULL, 0xF0F0, 0xF0FF, NULL));
+    TEST_EXPECT(
+        VIRTUAL_DEVICE_STATIC_MAX_DEVICES == virt->device_entries);
+    TEST_EXPECT(offset == virtual_device_static_arena.offset);
+    TEST_EXPECT(virt->finalized);
+    TEST_EXPECT(NULL == virtual_device_manager_device_find(virt, 0xF0F0));
+
+    TEST_ASSERT(STATUS_SUCCESS == virtual_device_manager_release(virt));
+}